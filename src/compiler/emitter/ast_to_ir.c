@@ -1,3 +1,6 @@
+// strdup is hidden under -std=c99
+#define _DEFAULT_SOURCE
+
 #include "ast_to_ir.h"
 #include <stdlib.h>
 #include <string.h>
@@ -10,6 +13,7 @@
 #define TYPE_ID_STRING     4
 #define TYPE_ID_OBJECT     5
 #define TYPE_ID_VOID       6
+#define TYPE_ID_STRING_BUILDER 7
 
 // Symbol table entry
 typedef struct SymbolEntry {
@@ -42,6 +46,12 @@ typedef struct TypeTable {
     uint32_t capacity;
 } TypeTable;
 
+// String local accumulated through a hidden StringBuilder local
+typedef struct StringAccumulator {
+    const char* name;               // Accumulated string local
+    uint32_t builder_local;         // Local index of the StringBuilder
+} StringAccumulator;
+
 // AST to IR translator implementation
 AstToIRTranslator* ast_to_ir_translator_create(void) {
     AstToIRTranslator* translator = malloc(sizeof(AstToIRTranslator));
@@ -86,10 +96,14 @@ AstToIRTranslator* ast_to_ir_translator_create(void) {
     ast_to_ir_add_type(translator, "string", TYPE_ID_STRING, 8);
     ast_to_ir_add_type(translator, "object", TYPE_ID_OBJECT, 8);
     ast_to_ir_add_type(translator, "void", TYPE_ID_VOID, 0);
+    ast_to_ir_add_type(translator, "StringBuilder", TYPE_ID_STRING_BUILDER, 8);
     
     translator->current_function = NULL;
     translator->current_block = NULL;
     translator->current_scope_depth = 0;
+    translator->string_accumulators = NULL;
+    translator->string_accumulator_count = 0;
+    translator->string_accumulator_capacity = 0;
     translator->error_message = NULL;
     translator->has_error = false;
     
@@ -126,6 +140,8 @@ void ast_to_ir_translator_destroy(AstToIRTranslator* translator) {
         free(translator->type_table);
     }
     
+    free(translator->string_accumulators);
+    
     if (translator->error_message) {
         free(translator->error_message);
     }
@@ -352,12 +368,392 @@ IRValue ast_to_ir_translate_expression(AstToIRTranslator* translator, Ast* ast)
     }
 }
 
+// ============================================================================
+// STRING CONCATENATION
+// ============================================================================
+
+static uint32_t ast_to_ir_find_symbol_type(AstToIRTranslator* translator, const char* name) {
+    if (!translator || !translator->symbol_table || !name) return 0;
+    
+    SymbolTable* table = translator->symbol_table;
+    for (int32_t i = table->count - 1; i >= 0; i--) {
+        if (strcmp(table->entries[i].name, name) == 0) {
+            return table->entries[i].type_id;
+        }
+    }
+    return 0;
+}
+
+static void ast_to_ir_add_stack_instruction(AstToIRTranslator* translator, IROp op) {
+    IRInstruction* instruction = ir_builder_create_instruction(translator->ir_builder, op);
+    if (instruction) {
+        ir_builder_add_instruction(translator->ir_builder, instruction);
+    }
+}
+
+static void ast_to_ir_add_local_instruction(AstToIRTranslator* translator, IROp op, uint32_t local_index) {
+    IRInstruction* instruction = ir_builder_create_instruction(translator->ir_builder, op);
+    if (instruction) {
+        IRValue local = {0};
+        local.type = IR_VALUE_TEMP;
+        local.data.temp_id = local_index;
+        ir_instruction_add_operand(instruction, local);
+        ir_builder_add_instruction(translator->ir_builder, instruction);
+    }
+}
+
+static bool ast_to_ir_is_plus(Ast* ast) {
+    return ast && ast->kind == AST_BINARY && ast->child_count >= 2 &&
+           ast->text && strcmp(ast->text, "PLUS") == 0;
+}
+
+// Receiver name of a StringBuilder method call (`sb.append(x)`), or NULL
+static const char* ast_to_ir_string_builder_receiver(AstToIRTranslator* translator, Ast* call) {
+    if (!call || call->kind != AST_CALL || call->child_count < 1) return NULL;
+    
+    Ast* callee = call->children[0];
+    if (callee->kind != AST_FIELD_ACCESS || callee->child_count < 1 || !callee->identifier) return NULL;
+    
+    Ast* object = callee->children[0];
+    if (object->kind != AST_IDENTIFIER || !object->identifier) return NULL;
+    if (ast_to_ir_find_symbol_type(translator, object->identifier) != TYPE_ID_STRING_BUILDER) return NULL;
+    return object->identifier;
+}
+
+static bool ast_to_ir_is_string_expression(AstToIRTranslator* translator, Ast* ast);
+
+// Methods of System.String implemented by string opcodes
+static const char* string_method_names[] = {
+    "substring", "indexOf", "length", "equalsIgnoreCase", "indexOfIgnoreCase"
+};
+
+// Name of a native string method call (`s.substring(a, b)`, `s.indexOf(x)`)
+// on a receiver statically known to be a string, or NULL
+static const char* ast_to_ir_string_method(AstToIRTranslator* translator, Ast* call) {
+    if (!call || call->kind != AST_CALL || call->child_count < 2) return NULL;
+    
+    Ast* callee = call->children[0];
+    if (callee->kind != AST_FIELD_ACCESS || callee->child_count < 1 || !callee->identifier) return NULL;
+    for (size_t i = 0; i < sizeof(string_method_names) / sizeof(string_method_names[0]); i++) {
+        if (strcmp(callee->identifier, string_method_names[i]) == 0) {
+            return ast_to_ir_is_string_expression(translator, callee->children[0]) ? callee->identifier : NULL;
+        }
+    }
+    return NULL;
+}
+
+// Whether an expression is statically known to be a string
+static bool ast_to_ir_is_string_expression(AstToIRTranslator* translator, Ast* ast) {
+    if (!ast) return false;
+    
+    switch (ast->kind) {
+        case AST_LITERAL:
+            return ast_to_ir_create_literal_value(ast).type == IR_VALUE_STRING;
+        case AST_IDENTIFIER:
+            return ast_to_ir_find_symbol_type(translator, ast->identifier) == TYPE_ID_STRING;
+        case AST_BINARY:
+            return ast_to_ir_is_plus(ast) &&
+                   (ast_to_ir_is_string_expression(translator, ast->children[0]) ||
+                    ast_to_ir_is_string_expression(translator, ast->children[1]));
+        case AST_CALL: {
+            const char* string_method = ast_to_ir_string_method(translator, ast);
+            if (string_method) return strcmp(string_method, "substring") == 0;
+            return ast_to_ir_string_builder_receiver(translator, ast) &&
+                   strcmp(ast->children[0]->identifier, "toString") == 0;
+        }
+        default:
+            return false;
+    }
+}
+
+// Operands of a chain of string `+`, left to right. Numeric `+` inside the
+// chain stays a single operand.
+static bool ast_to_ir_collect_concat_operands(AstToIRTranslator* translator, Ast* ast,
+                                              Ast*** operands, uint32_t* count, uint32_t* capacity) {
+    if (ast_to_ir_is_plus(ast) && ast_to_ir_is_string_expression(translator, ast)) {
+        return ast_to_ir_collect_concat_operands(translator, ast->children[0], operands, count, capacity) &&
+               ast_to_ir_collect_concat_operands(translator, ast->children[1], operands, count, capacity);
+    }
+    
+    if (*count >= *capacity) {
+        uint32_t new_capacity = *capacity == 0 ? 8 : *capacity * 2;
+        Ast** grown = realloc(*operands, sizeof(Ast*) * new_capacity);
+        if (!grown) return false;
+        *operands = grown;
+        *capacity = new_capacity;
+    }
+    (*operands)[(*count)++] = ast;
+    return true;
+}
+
+// `a + b` becomes one STRING_CONCAT; longer chains append every operand to
+// a single StringBuilder and allocate the result once
+static IRValue ast_to_ir_translate_string_concat(AstToIRTranslator* translator, Ast* ast) {
+    Ast** operands = NULL;
+    uint32_t count = 0;
+    uint32_t capacity = 0;
+    if (!ast_to_ir_collect_concat_operands(translator, ast, &operands, &count, &capacity)) {
+        free(operands);
+        ast_to_ir_translator_set_error(translator, "Out of memory translating string concatenation");
+        IRValue null_value = {0};
+        return null_value;
+    }
+    
+    if (count <= 2) {
+        for (uint32_t i = 0; i < count; i++) {
+            ast_to_ir_translate_expression(translator, operands[i]);
+        }
+        ir_builder_add_string_concat(translator->ir_builder);
+    } else {
+        ir_builder_add_string_builder_new(translator->ir_builder);
+        for (uint32_t i = 0; i < count; i++) {
+            ast_to_ir_add_stack_instruction(translator, IR_DUP);
+            ast_to_ir_translate_expression(translator, operands[i]);
+            ir_builder_add_string_builder_append(translator->ir_builder);
+        }
+        ir_builder_add_string_builder_to_string(translator->ir_builder);
+    }
+    free(operands);
+    
+    return ast_to_ir_create_temp_value(translator, IR_VALUE_STRING);
+}
+
+static StringAccumulator* ast_to_ir_find_string_accumulator(AstToIRTranslator* translator, const char* name) {
+    for (uint32_t i = 0; i < translator->string_accumulator_count; i++) {
+        if (strcmp(translator->string_accumulators[i].name, name) == 0) {
+            return &translator->string_accumulators[i];
+        }
+    }
+    return NULL;
+}
+
+// `s = s + ...` on a local string `s`; returns the name of `s`
+static const char* ast_to_ir_string_accumulation_target(AstToIRTranslator* translator, Ast* assign) {
+    if (!assign || assign->kind != AST_ASSIGN || assign->child_count < 2) return NULL;
+    
+    Ast* target = assign->children[0];
+    if (target->kind != AST_IDENTIFIER || !target->identifier) return NULL;
+    if (!ast_to_ir_is_local_symbol(translator, target->identifier) ||
+        ast_to_ir_find_symbol_type(translator, target->identifier) != TYPE_ID_STRING) {
+        return NULL;
+    }
+    
+    Ast* leftmost = assign->children[1];
+    if (!ast_to_ir_is_plus(leftmost)) return NULL;
+    while (ast_to_ir_is_plus(leftmost)) {
+        leftmost = leftmost->children[0];
+    }
+    if (leftmost->kind != AST_IDENTIFIER || !leftmost->identifier ||
+        strcmp(leftmost->identifier, target->identifier) != 0) {
+        return NULL;
+    }
+    return target->identifier;
+}
+
+// Statement-level accumulations of `name` (every accumulation when NULL),
+// reporting each target to `found`
+static uint32_t ast_to_ir_count_string_accumulations(AstToIRTranslator* translator, Ast* ast, const char* name,
+                                                     void (*found)(AstToIRTranslator*, const char*)) {
+    if (!ast) return 0;
+    
+    Ast* assign = NULL;
+    switch (ast->kind) {
+        case AST_EXPR_STMT:
+            assign = ast->child_count > 0 ? ast->children[0] : NULL;
+            break;
+        case AST_ASSIGN:
+            assign = ast;
+            break;
+        case AST_BLOCK:
+        case AST_IF:
+        case AST_WHILE:
+        case AST_FOR: {
+            uint32_t count = 0;
+            for (uint32_t i = 0; i < ast->child_count; i++) {
+                count += ast_to_ir_count_string_accumulations(translator, ast->children[i], name, found);
+            }
+            return count;
+        }
+        default:
+            return 0;
+    }
+    
+    const char* target = ast_to_ir_string_accumulation_target(translator, assign);
+    if (!target || (name && strcmp(target, name) != 0)) return 0;
+    if (found) found(translator, target);
+    return 1;
+}
+
+// Every mention of `name` in a subtree, declarations included
+static uint32_t ast_to_ir_count_name_uses(Ast* ast, const char* name) {
+    if (!ast) return 0;
+    
+    uint32_t count = ast->kind != AST_FIELD_ACCESS && ast->identifier &&
+                     strcmp(ast->identifier, name) == 0 ? 1 : 0;
+    for (uint32_t i = 0; i < ast->child_count; i++) {
+        count += ast_to_ir_count_name_uses(ast->children[i], name);
+    }
+    return count;
+}
+
+static void ast_to_ir_add_string_accumulator(AstToIRTranslator* translator, const char* name) {
+    if (ast_to_ir_find_string_accumulator(translator, name)) return;
+    
+    if (translator->string_accumulator_count >= translator->string_accumulator_capacity) {
+        uint32_t new_capacity = translator->string_accumulator_capacity == 0 ? 4 : translator->string_accumulator_capacity * 2;
+        StringAccumulator* grown = realloc(translator->string_accumulators, sizeof(StringAccumulator) * new_capacity);
+        if (!grown) return;
+        translator->string_accumulators = grown;
+        translator->string_accumulator_capacity = new_capacity;
+    }
+    
+    StringAccumulator* accumulator = &translator->string_accumulators[translator->string_accumulator_count++];
+    accumulator->name = name;
+    accumulator->builder_local = 0;
+}
+
+// Find the strings a loop only ever extends (`s = s + x` and no other
+// mention of `s` inside the loop) and move them into StringBuilders before
+// the loop starts. Returns the index of the first new accumulator.
+static uint32_t ast_to_ir_begin_string_accumulators(AstToIRTranslator* translator, Ast* loop) {
+    uint32_t first = translator->string_accumulator_count;
+    ast_to_ir_count_string_accumulations(translator, loop, NULL, ast_to_ir_add_string_accumulator);
+    
+    uint32_t kept = first;
+    for (uint32_t i = first; i < translator->string_accumulator_count; i++) {
+        StringAccumulator accumulator = translator->string_accumulators[i];
+        uint32_t accumulations = ast_to_ir_count_string_accumulations(translator, loop, accumulator.name, NULL);
+        if (ast_to_ir_count_name_uses(loop, accumulator.name) != 2 * accumulations) {
+            continue;
+        }
+        
+        // builder = new StringBuilder(); builder.append(s)
+        ast_to_ir_add_symbol(translator, "$builder", TYPE_ID_STRING_BUILDER, true);
+        accumulator.builder_local = translator->symbol_table->entries[translator->symbol_table->count - 1].local_index;
+        ir_builder_add_string_builder_new(translator->ir_builder);
+        ast_to_ir_add_stack_instruction(translator, IR_DUP);
+        ast_to_ir_add_local_instruction(translator, IR_LOAD_LOCAL, ast_to_ir_find_symbol(translator, accumulator.name) - 1);
+        ir_builder_add_string_builder_append(translator->ir_builder);
+        ast_to_ir_add_local_instruction(translator, IR_STORE_LOCAL, accumulator.builder_local);
+        
+        translator->string_accumulators[kept++] = accumulator;
+    }
+    translator->string_accumulator_count = kept;
+    return first;
+}
+
+// At the loop exit: s = builder.toString()
+static void ast_to_ir_end_string_accumulators(AstToIRTranslator* translator, uint32_t first) {
+    for (uint32_t i = first; i < translator->string_accumulator_count; i++) {
+        StringAccumulator* accumulator = &translator->string_accumulators[i];
+        ast_to_ir_add_local_instruction(translator, IR_LOAD_LOCAL, accumulator->builder_local);
+        ir_builder_add_string_builder_to_string(translator->ir_builder);
+        ast_to_ir_add_local_instruction(translator, IR_STORE_LOCAL, ast_to_ir_find_symbol(translator, accumulator->name) - 1);
+    }
+    translator->string_accumulator_count = first;
+}
+
+// `s = s + a + b` on an accumulated string: builder.append(a); builder.append(b)
+static bool ast_to_ir_translate_string_accumulation(AstToIRTranslator* translator, Ast* assign) {
+    const char* target = ast_to_ir_string_accumulation_target(translator, assign);
+    StringAccumulator* accumulator = target ? ast_to_ir_find_string_accumulator(translator, target) : NULL;
+    if (!accumulator) return false;
+    
+    Ast** operands = NULL;
+    uint32_t count = 0;
+    uint32_t capacity = 0;
+    if (!ast_to_ir_collect_concat_operands(translator, assign->children[1], &operands, &count, &capacity)) {
+        free(operands);
+        return false;
+    }
+    
+    // operands[0] is the accumulated string itself
+    for (uint32_t i = 1; i < count; i++) {
+        ast_to_ir_add_local_instruction(translator, IR_LOAD_LOCAL, accumulator->builder_local);
+        ast_to_ir_translate_expression(translator, operands[i]);
+        ir_builder_add_string_builder_append(translator->ir_builder);
+    }
+    free(operands);
+    return true;
+}
+
+// StringBuilder methods: append(string) and toString()
+static IRValue ast_to_ir_translate_string_builder_call(AstToIRTranslator* translator, Ast* ast) {
+    Ast* callee = ast->children[0];
+    Ast* args_ast = ast->children[1];
+    const char* method_name = callee->identifier;
+    
+    ast_to_ir_translate_expression(translator, callee->children[0]);
+    if (strcmp(method_name, "append") == 0 && args_ast->child_count == 1) {
+        ast_to_ir_translate_expression(translator, args_ast->children[0]);
+        ir_builder_add_string_builder_append(translator->ir_builder);
+        IRValue result = {0};
+        return result;
+    }
+    if (strcmp(method_name, "toString") == 0 && args_ast->child_count == 0) {
+        ir_builder_add_string_builder_to_string(translator->ir_builder);
+        return ast_to_ir_create_temp_value(translator, IR_VALUE_STRING);
+    }
+    
+    ast_to_ir_translator_set_error(translator, "Unknown StringBuilder method");
+    IRValue null_value = {0};
+    return null_value;
+}
+
+// String methods: substring(start, length), indexOf(string), length(),
+// equalsIgnoreCase(string) and indexOfIgnoreCase(string)
+static IRValue ast_to_ir_translate_string_method_call(AstToIRTranslator* translator, Ast* ast) {
+    Ast* callee = ast->children[0];
+    Ast* args_ast = ast->children[1];
+    const char* method_name = callee->identifier;
+    
+    if (strcmp(method_name, "substring") == 0 && args_ast->child_count == 2) {
+        ast_to_ir_translate_expression(translator, callee->children[0]);
+        ast_to_ir_translate_expression(translator, args_ast->children[0]);
+        ast_to_ir_translate_expression(translator, args_ast->children[1]);
+        ir_builder_add_string_substring(translator->ir_builder);
+        return ast_to_ir_create_temp_value(translator, IR_VALUE_STRING);
+    }
+    if (strcmp(method_name, "indexOf") == 0 && args_ast->child_count == 1) {
+        ast_to_ir_translate_expression(translator, callee->children[0]);
+        ast_to_ir_translate_expression(translator, args_ast->children[0]);
+        ir_builder_add_string_index_of(translator->ir_builder);
+        return ast_to_ir_create_temp_value(translator, IR_VALUE_I64);
+    }
+    if (strcmp(method_name, "length") == 0 && args_ast->child_count == 0) {
+        ast_to_ir_translate_expression(translator, callee->children[0]);
+        ir_builder_add_string_length(translator->ir_builder);
+        return ast_to_ir_create_temp_value(translator, IR_VALUE_I64);
+    }
+    if (strcmp(method_name, "equalsIgnoreCase") == 0 && args_ast->child_count == 1) {
+        ast_to_ir_translate_expression(translator, callee->children[0]);
+        ast_to_ir_translate_expression(translator, args_ast->children[0]);
+        ir_builder_add_string_equals_ignore_case(translator->ir_builder);
+        return ast_to_ir_create_temp_value(translator, IR_VALUE_BOOL);
+    }
+    if (strcmp(method_name, "indexOfIgnoreCase") == 0 && args_ast->child_count == 1) {
+        ast_to_ir_translate_expression(translator, callee->children[0]);
+        ast_to_ir_translate_expression(translator, args_ast->children[0]);
+        ir_builder_add_string_index_of_ignore_case(translator->ir_builder);
+        return ast_to_ir_create_temp_value(translator, IR_VALUE_I64);
+    }
+    
+    ast_to_ir_translator_set_error(translator, "Wrong number of arguments to string method");
+    IRValue null_value = {0};
+    return null_value;
+}
+
 IRValue ast_to_ir_translate_binary_expression(AstToIRTranslator* translator, Ast* ast) {
     if (!translator || !ast || ast->child_count < 2) {
         IRValue null_value = {0};
         return null_value;
     }
     
+    // String `+` chains are lowered as a whole
+    if (ast_to_ir_is_plus(ast) && ast_to_ir_is_string_expression(translator, ast)) {
+        return ast_to_ir_translate_string_concat(translator, ast);
+    }
+    
     // Translate left and right operands - these will add LOAD_LOCAL instructions to IR
     ast_to_ir_translate_expression(translator, ast->children[0]);
     ast_to_ir_translate_expression(translator, ast->children[1]);
@@ -523,6 +919,16 @@ IRValue ast_to_ir_translate_method_call(AstToIRTranslator* translator, Ast* ast)
         return null_value;
     }
     
+    // StringBuilder methods map onto the builder opcodes
+    if (ast_to_ir_string_builder_receiver(translator, ast)) {
+        return ast_to_ir_translate_string_builder_call(translator, ast);
+    }
+    
+    // As do substring and indexOf on strings
+    if (ast_to_ir_string_method(translator, ast)) {
+        return ast_to_ir_translate_string_method_call(translator, ast);
+    }
+    
     // Count arguments
     uint32_t arg_count = args_ast->child_count;
     
@@ -588,6 +994,12 @@ IRValue ast_to_ir_translate_method_call(AstToIRTranslator* translator, Ast* ast)
             callee.data.i64 = 3; // Sys.println method ID
         } else if (strcmp(method_name, "currentTimeMillis") == 0) {
             callee.data.i64 = 12; // Sys.currentTimeMillis method ID
+        } else if (strcmp(method_name, "readFile") == 0) {
+            callee.data.i64 = 6; // Sys.readFile method ID
+        } else if (strcmp(method_name, "argc") == 0) {
+            callee.data.i64 = 14; // Sys.argc method ID
+        } else if (strcmp(method_name, "argv") == 0) {
+            callee.data.i64 = 15; // Sys.argv method ID
         } else {
             callee.data.i64 = 0; // Unknown method
         }
@@ -808,6 +1220,8 @@ void ast_to_ir_translate_declaration(AstToIRTranslator* translator, Ast* ast) {
 void ast_to_ir_translate_assignment(AstToIRTranslator* translator, Ast* ast) {
     if (!translator || !ast || ast->child_count < 2) return;
     
+    if (ast_to_ir_translate_string_accumulation(translator, ast)) return;
+    
     // Translate right-hand side
     IRValue value = ast_to_ir_translate_expression(translator, ast->children[1]);
     
@@ -912,6 +1326,8 @@ IRValue ast_to_ir_translate_assignment_expression(AstToIRTranslator* translator,
 void ast_to_ir_translate_expression_statement(AstToIRTranslator* translator, Ast* ast) {
     if (!translator || !ast || ast->child_count < 1) return;
     
+    if (ast_to_ir_translate_string_accumulation(translator, ast->children[0])) return;
+    
     // Just translate the expression (result is discarded)
     ast_to_ir_translate_expression(translator, ast->children[0]);
 }
@@ -1011,6 +1427,8 @@ void ast_to_ir_translate_while_statement(AstToIRTranslator* translator, Ast* ast
     IRBlock* loop_exit = ir_builder_create_block(translator->ir_builder, "loop_exit");
     if (!loop_exit) return;
     
+    uint32_t first_accumulator = ast_to_ir_begin_string_accumulators(translator, ast);
+    
     // Jump to loop header
     ir_builder_add_jump(translator->ir_builder, loop_header);
     
@@ -1043,6 +1461,7 @@ void ast_to_ir_translate_while_statement(AstToIRTranslator* translator, Ast* ast
     // Set current block to loop exit
     ir_builder_set_current_block(translator->ir_builder, loop_exit);
     translator->current_block = loop_exit;
+    ast_to_ir_end_string_accumulators(translator, first_accumulator);
 }
 
 void ast_to_ir_translate_for_statement(AstToIRTranslator* translator, Ast* ast) {
@@ -1064,6 +1483,8 @@ void ast_to_ir_translate_for_statement(AstToIRTranslator* translator, Ast* ast)
     IRBlock* exit_block = ir_builder_create_block(translator->ir_builder, "for_exit");
     if (!exit_block) return;
     
+    uint32_t first_accumulator = ast_to_ir_begin_string_accumulators(translator, ast);
+    
     // Jump to initialization
     ir_builder_add_jump(translator->ir_builder, init_block);
     
@@ -1118,6 +1539,7 @@ void ast_to_ir_translate_for_statement(AstToIRTranslator* translator, Ast* ast)
     // Set current block to exit
     ir_builder_set_current_block(translator->ir_builder, exit_block);
     translator->current_block = exit_block;
+    ast_to_ir_end_string_accumulators(translator, first_accumulator);
 }
 
 void ast_to_ir_translate_match_statement(AstToIRTranslator* translator, Ast* ast) {
@@ -1156,6 +1578,7 @@ uint32_t ast_to_ir_get_builtin_type_id(const char* type_name) {
     if (strcmp(type_name, "string") == 0) return TYPE_ID_STRING;
     if (strcmp(type_name, "object") == 0) return TYPE_ID_OBJECT;
     if (strcmp(type_name, "void") == 0) return TYPE_ID_VOID;
+    if (strcmp(type_name, "StringBuilder") == 0) return TYPE_ID_STRING_BUILDER;
     
     return TYPE_ID_INTEGER; // Default
 }
@@ -1239,6 +1662,11 @@ IRValue ast_to_ir_translate_new_expression(AstToIRTranslator* translator, Ast* a
         return null_value;
     }
     
+    if (strcmp(ast->identifier, "StringBuilder") == 0) {
+        ir_builder_add_string_builder_new(translator->ir_builder);
+        return ast_to_ir_create_temp_value(translator, IR_VALUE_OBJECT);
+    }
+    
     // Find constructor arguments
     Ast* arguments = NULL;
     for (uint32_t i = 0; i < ast->child_count; i++) {
@@ -1300,8 +1728,8 @@ IRValue ast_to_ir_create_literal_value(Ast* ast) {
     if (!ast) return value;
     
     // Check which literal value is set - prioritize by type
-    if (ast->text && ast->text[0] != '\0') {
-        // String literal (has text content)
+    if (ast->text) {
+        // String literal (the parser sets text for every string, even "")
         value.type = IR_VALUE_STRING;
         // Store the string content directly instead of casting pointer to integer
         value.data.string_value = ast->text;
@@ -19,6 +19,12 @@ typedef struct AstToIRTranslator {
     struct IRBlock* current_block;        // Current block being translated
     uint32_t current_scope_depth;         // Current scope depth
     
+    // Loop string accumulators: `s = s + x` in the loop being translated
+    // appends to a hidden StringBuilder local instead
+    struct StringAccumulator* string_accumulators;
+    uint32_t string_accumulator_count;
+    uint32_t string_accumulator_capacity;
+    
     // Error handling
     char* error_message;
     bool has_error;
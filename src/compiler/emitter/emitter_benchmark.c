@@ -0,0 +1,176 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ir_to_bytecode.h"
+#include "../../shared/bytecode/helium_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Emitter string table benchmark - emits a compilation unit with many
+// distinct identifiers (type and method names) and string literals through
+// the IR to bytecode translator, referencing each name several times the
+// way a translated method body does, then saves the module, loads it back
+// and looks every name up by content as the VM does. Deduplication and
+// lookups go through the string table's hash index; a linear scan over the
+// final table, which is what each of them cost before, is timed for
+// comparison.
+//
+// Usage: emitter_benchmark [identifiers] [literals] [references]
+
+#define DEFAULT_IDENTIFIERS 20000
+#define DEFAULT_LITERALS 20000
+#define DEFAULT_REFERENCES 4
+
+// Methods per synthetic type
+#define METHODS_PER_TYPE 16
+
+// Linear scans are slow; they only look up this many strings
+#define SCAN_LOOKUPS 2000
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Result of the lookups, so the work cannot be optimized away
+static volatile int64_t bench_sink;
+
+// How string_table_add_string and string_table_find_string searched
+// before the hash index
+static int32_t scan_strings(StringTable* table, const char* str) {
+    for (uint32_t i = 0; i < table->count; i++) {
+        if (strcmp(table->data + table->entries[i].offset, str) == 0) {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t identifiers = argc > 1 ? (uint32_t)atol(argv[1]) : DEFAULT_IDENTIFIERS;
+    uint32_t literals = argc > 2 ? (uint32_t)atol(argv[2]) : DEFAULT_LITERALS;
+    uint32_t references = argc > 3 ? (uint32_t)atol(argv[3]) : DEFAULT_REFERENCES;
+    if (identifiers == 0) {
+        fprintf(stderr, "Usage: %s [identifiers] [literals] [references]\n", argv[0]);
+        return 1;
+    }
+
+    printf("He³ Emitter String Table Benchmark\n");
+    printf("==================================\n");
+    printf("Identifiers: %u, literals: %u, references each: %u\n\n", identifiers, literals, references);
+
+    // Source names: every method belongs to a type, literals are sentences
+    uint32_t types = (identifiers + METHODS_PER_TYPE - 1) / METHODS_PER_TYPE;
+    uint32_t names = types + identifiers + literals;
+    char** strings = malloc(names * sizeof(char*));
+    for (uint32_t i = 0; i < names; i++) {
+        char buffer[96];
+        if (i < types) {
+            snprintf(buffer, sizeof(buffer), "app.generated.module%u.Type%u", i / 64, i);
+        } else if (i < types + identifiers) {
+            uint32_t method = i - types;
+            snprintf(buffer, sizeof(buffer), "compute%uWith%uArguments", method, method % 7);
+        } else {
+            snprintf(buffer, sizeof(buffer), "Literal %u: the quick brown fox", i - types - identifiers);
+        }
+        strings[i] = strdup(buffer);
+    }
+
+    // Emission: declare the types, methods and literals, then reference
+    // each name again as method bodies do
+    IRToBytecodeTranslator* translator = ir_to_bytecode_translator_create();
+    double start = now_us();
+    for (uint32_t t = 0; t < types; t++) {
+        uint32_t type_id = ir_to_bytecode_add_type(translator, strings[t], 0, 0);
+        for (uint32_t m = t * METHODS_PER_TYPE; m < identifiers && m < (t + 1) * METHODS_PER_TYPE; m++) {
+            ir_to_bytecode_add_method(translator, strings[types + m], "()I", type_id);
+        }
+    }
+    for (uint32_t i = types + identifiers; i < names; i++) {
+        ir_to_bytecode_add_string_constant(translator, strings[i]);
+    }
+    uint64_t adds = (uint64_t)identifiers * 2 + types + literals;
+    unsigned int seed = 42;
+    for (uint32_t r = 0; r < references; r++) {
+        for (uint32_t i = 0; i < names; i++) {
+            ir_to_bytecode_add_string(translator, strings[(uint32_t)rand_r(&seed) % names]);
+        }
+        adds += names;
+    }
+    double emit_us = now_us() - start;
+    StringTable* emitted = translator->string_table;
+    printf("Emission:            %8.1f ms  %7.1f ns/string  (%u unique of %llu added)\n",
+           emit_us / 1e3, emit_us * 1e3 / adds, emitted->count, (unsigned long long)adds);
+
+    // The same additions resolved by a linear scan
+    uint32_t scans = names < SCAN_LOOKUPS ? names : SCAN_LOOKUPS;
+    start = now_us();
+    for (uint32_t i = 0; i < scans; i++) {
+        bench_sink += scan_strings(emitted, strings[(uint64_t)i * names / scans]);
+    }
+    double scan_ns = (now_us() - start) * 1e3 / scans;
+    printf("Linear scan:         %8.1f ns/string  (emission would take up to ~%.0f ms)\n",
+           scan_ns, scan_ns * adds / 1e6);
+
+    // Save the unit as a module; its string index is persisted with it
+    HeliumModule* module = helium_module_create();
+    string_table_destroy(module->string_table_obj);
+    constant_table_destroy(module->constant_table);
+    type_table_destroy(module->type_table);
+    method_table_destroy(module->method_table);
+    module->string_table_obj = translator->string_table;
+    module->constant_table = translator->constant_table;
+    module->type_table = translator->type_table;
+    module->method_table = translator->method_table;
+    translator->string_table = NULL;
+    translator->constant_table = NULL;
+    translator->type_table = NULL;
+    translator->method_table = NULL;
+    ir_to_bytecode_translator_destroy(translator);
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/he3_emitter_benchmark_%d.helium3", (int)getpid());
+    if (!helium_module_save(module, path)) {
+        fprintf(stderr, "Failed to save %s\n", path);
+        return 1;
+    }
+    helium_module_destroy(module);
+
+    // Load it back and look every name up by content
+    start = now_us();
+    HeliumModule* loaded = helium_module_load(path);
+    double load_us = now_us() - start;
+    unlink(path);
+    if (!loaded) {
+        fprintf(stderr, "Failed to load %s\n", path);
+        return 1;
+    }
+    StringTable* strings_loaded = loaded->string_table_obj;
+    printf("Module load:         %8.1f ms  (%u strings, %u index slots persisted)\n",
+           load_us / 1e3, strings_loaded->count, strings_loaded->index_size);
+
+    start = now_us();
+    for (uint32_t i = 0; i < names; i++) {
+        bench_sink += helium_module_find_string(loaded, strings[i]);
+    }
+    printf("Name lookup:         %8.1f ns/string\n", (now_us() - start) * 1e3 / names);
+
+    // What building the index at load would cost instead of persisting it
+    StringTable view = *strings_loaded;
+    view.index = NULL;
+    view.index_owned = false;
+    start = now_us();
+    string_table_build_index(&view);
+    printf("Index build:         %8.1f ms  (not needed with the persisted index)\n", (now_us() - start) / 1e3);
+    free(view.index);
+
+    helium_module_destroy(loaded);
+    for (uint32_t i = 0; i < names; i++) {
+        free(strings[i]);
+    }
+    free(strings);
+    return 0;
+}
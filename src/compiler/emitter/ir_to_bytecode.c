@@ -34,6 +34,11 @@ IRToBytecodeTranslator* ir_to_bytecode_translator_create(void) {
     translator->current_bytecode_size = 0;
     translator->current_bytecode_capacity = 0;
     
+    translator->jumps = NULL;
+    translator->jump_count = 0;
+    translator->jump_capacity = 0;
+    translator->compact_operands = true;
+    
     translator->current_function = NULL;
     translator->current_block = NULL;
     translator->error_message = NULL;
@@ -69,6 +74,8 @@ void ir_to_bytecode_translator_destroy(IRToBytecodeTranslator* translator) {
         free(translator->current_bytecode);
     }
     
+    free(translator->jumps);
+    
     if (translator->error_message) {
         free(translator->error_message);
     }
@@ -89,69 +96,131 @@ IRBlock* ir_to_bytecode_find_block_by_id(IRToBytecodeTranslator* translator, uin
     return NULL;
 }
 
-// Calculate byte offsets for each block in the function
-bool ir_to_bytecode_calculate_block_offsets(IRToBytecodeTranslator* translator, IRFunction* function) {
+// Short form of an operand-bearing opcode, or 0 if it has none
+static uint8_t ir_to_bytecode_short_form(uint8_t opcode) {
+    switch (opcode) {
+        case OP_PUSH_CONSTANT: return OP_PUSH_CONSTANT_S;
+        case OP_LOAD_LOCAL: return OP_LOAD_LOCAL_S;
+        case OP_STORE_LOCAL: return OP_STORE_LOCAL_S;
+        case OP_CALL_STATIC: return OP_CALL_STATIC_S;
+        case OP_JUMP: return OP_JUMP_S;
+        case OP_JUMP_IF_TRUE: return OP_JUMP_IF_TRUE_S;
+        case OP_JUMP_IF_FALSE: return OP_JUMP_IF_FALSE_S;
+        default: return 0;
+    }
+}
+
+// Bytes a jump needs to reach `delta` from its end
+static uint8_t ir_to_bytecode_jump_size(IRToBytecodeTranslator* translator, int64_t delta) {
+    if (!translator->compact_operands) return 5;
+    if (delta >= INT8_MIN && delta <= INT8_MAX) return 2;
+    if (delta >= INT16_MIN && delta <= INT16_MAX) return 4;
+    return 5;
+}
+
+// Growth of the jumps emitted before `offset`; `shift[i]` is the growth of
+// the first i jumps
+static size_t ir_to_bytecode_shift_at(IRToBytecodeTranslator* translator, const size_t* shift, size_t offset) {
+    size_t low = 0;
+    size_t high = translator->jump_count;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (translator->jumps[mid].offset < offset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return shift[low];
+}
+
+// Give every jump of the function the smallest encoding that reaches its
+// target and move the code after it accordingly. Jumps were emitted at their
+// smallest size; growing one can push others out of range, so sizes only
+// grow until they are stable.
+bool ir_to_bytecode_layout_jumps(IRToBytecodeTranslator* translator, IRFunction* function) {
     if (!translator || !function) return false;
+    if (translator->jump_count == 0) return true;
     
-    // Reset current bytecode position
-    translator->current_bytecode_size = 0;
+    size_t count = translator->jump_count;
+    size_t* shift = malloc((count + 1) * sizeof(size_t));
+    if (!shift) {
+        ir_to_bytecode_translator_set_error(translator, "Failed to allocate jump layout");
+        return false;
+    }
+    
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        shift[0] = 0;
+        for (size_t i = 0; i < count; i++) {
+            IRToBytecodeJump* jump = &translator->jumps[i];
+            shift[i + 1] = shift[i] + (jump->size - jump->emitted_size);
+        }
+        for (size_t i = 0; i < count; i++) {
+            IRToBytecodeJump* jump = &translator->jumps[i];
+            size_t end = jump->offset + shift[i] + jump->size;
+            size_t target = jump->target->bytecode_offset +
+                ir_to_bytecode_shift_at(translator, shift, jump->target->bytecode_offset);
+            uint8_t size = ir_to_bytecode_jump_size(translator, (int64_t)target - (int64_t)end);
+            if (size > jump->size) {
+                jump->size = size;
+                changed = true;
+            }
+        }
+    }
     
-    // Calculate offsets for each block
+    // Copy the code between jumps and encode each jump at its final size
+    size_t old_size = translator->current_bytecode_size;
+    size_t new_size = old_size + shift[count];
+    uint8_t* bytecode = malloc(new_size > 0 ? new_size : 1);
+    if (!bytecode) {
+        free(shift);
+        ir_to_bytecode_translator_set_error(translator, "Failed to allocate bytecode memory");
+        return false;
+    }
+    size_t from = 0;
+    size_t to = 0;
+    for (size_t i = 0; i < count; i++) {
+        IRToBytecodeJump* jump = &translator->jumps[i];
+        memcpy(bytecode + to, translator->current_bytecode + from, jump->offset - from);
+        to += jump->offset - from;
+        from = jump->offset + jump->emitted_size;
+        
+        // Offsets are relative to the end of the jump
+        size_t target = jump->target->bytecode_offset +
+            ir_to_bytecode_shift_at(translator, shift, jump->target->bytecode_offset);
+        int32_t delta = (int32_t)((int64_t)target - (int64_t)(to + jump->size));
+        uint8_t short_form = ir_to_bytecode_short_form(jump->opcode);
+        if (jump->size == 2) {
+            bytecode[to++] = short_form;
+            bytecode[to++] = (uint8_t)(int8_t)delta;
+        } else if (jump->size == 4) {
+            bytecode[to++] = OP_WIDE;
+            bytecode[to++] = short_form;
+            bytecode[to++] = (uint8_t)(delta & 0xFF);
+            bytecode[to++] = (uint8_t)((delta >> 8) & 0xFF);
+        } else {
+            bytecode[to++] = jump->opcode;
+            memcpy(bytecode + to, &delta, sizeof(int32_t));
+            to += sizeof(int32_t);
+        }
+    }
+    memcpy(bytecode + to, translator->current_bytecode + from, old_size - from);
+    
+    // Blocks move with the code before them
     for (size_t i = 0; i < function->block_count; i++) {
         IRBlock* block = function->blocks[i];
-        if (!block) continue;
-        
-        // Store the current bytecode position as this block's offset
-        block->bytecode_offset = translator->current_bytecode_size;
-        
-        // Calculate the size this block will take
-        size_t block_size = 0;
-        for (size_t j = 0; j < block->instruction_count; j++) {
-            IRInstruction* instruction = block->instructions[j];
-            if (!instruction) continue;
-            
-            // Calculate instruction size (opcode + operands)
-            size_t instruction_size = 1; // opcode
-            switch (instruction->op) {
-                case IR_LOAD_CONST:
-                case IR_LOAD_LOCAL:
-                case IR_LOAD_STATIC:
-                case IR_STORE_LOCAL:
-                case IR_STORE_STATIC:
-                case IR_CALL:
-                case IR_CALL_STATIC:
-                case IR_CALLV:
-                case IR_CALLI:
-                case IR_JMP:
-                case IR_JMPT:
-                case IR_JMPF:
-                case IR_NEW:
-                case IR_NEW_ARRAY:
-                case IR_LOAD_FIELD:
-                case IR_STORE_FIELD:
-                case IR_LOAD_ARRAY:
-                case IR_STORE_ARRAY:
-                case IR_CAST:
-                case IR_INSTANCEOF:
-                case IR_GET_TYPE:
-                case IR_LOAD_ARG:
-                case IR_MATCH_SOME:
-                case IR_MATCH_NONE:
-                case IR_MATCH_OK:
-                case IR_MATCH_ERR:
-                    instruction_size += 4; // 4-byte operand
-                    break;
-                default:
-                    // No operands
-                    break;
-            }
-            block_size += instruction_size;
+        if (block) {
+            block->bytecode_offset += ir_to_bytecode_shift_at(translator, shift, block->bytecode_offset);
         }
-        
-        // Update the current bytecode position
-        translator->current_bytecode_size += block_size;
     }
     
+    free(translator->current_bytecode);
+    translator->current_bytecode = bytecode;
+    translator->current_bytecode_size = new_size;
+    translator->current_bytecode_capacity = new_size;
+    free(shift);
     return true;
 }
 
@@ -159,20 +228,22 @@ bool ir_to_bytecode_translate_function(IRToBytecodeTranslator* translator, IRFun
     if (!translator || !function) return false;
     
     translator->current_function = function;
+    translator->current_bytecode_size = 0;
+    translator->jump_count = 0;
     
-    // First pass: Calculate byte offsets for each block
-    if (!ir_to_bytecode_calculate_block_offsets(translator, function)) {
-        return false;
-    }
-    
-    // Second pass: Translate all blocks in the function
+    // Emit all blocks, recording where each starts; jumps get their
+    // smallest encoding as a placeholder
     for (size_t i = 0; i < function->block_count; i++) {
+        if (function->blocks[i]) {
+            function->blocks[i]->bytecode_offset = translator->current_bytecode_size;
+        }
         if (!ir_to_bytecode_translate_block(translator, function->blocks[i])) {
             return false;
         }
     }
     
-    return true;
+    // Then size and resolve the jumps now that every block is placed
+    return ir_to_bytecode_layout_jumps(translator, function);
 }
 
 bool ir_to_bytecode_translate_block(IRToBytecodeTranslator* translator, IRBlock* block) {
@@ -222,26 +293,20 @@ bool ir_to_bytecode_translate_instruction(IRToBytecodeTranslator* translator, IR
                     ir_to_bytecode_translator_set_error(translator, "Unsupported constant type in IR_LOAD_CONST");
                     return false;
             }
-            return ir_to_bytecode_emit_instruction(translator, OP_PUSH_CONSTANT, 
-                                                 (uint8_t*)&constant_index, sizeof(uint32_t));
+            return ir_to_bytecode_emit_operand(translator, OP_PUSH_CONSTANT, constant_index);
         }
         
         case IR_LOAD_STATIC:
             // For built-in functions, we'll push a special built-in function reference
             // This will be handled by the VM when the function is called
             uint32_t builtin_id = 0; // Built-in function ID (0 = print)
-            return ir_to_bytecode_emit_instruction(translator, OP_PUSH_CONSTANT, 
-                                                 (uint8_t*)&builtin_id, sizeof(uint32_t));
+            return ir_to_bytecode_emit_operand(translator, OP_PUSH_CONSTANT, builtin_id);
         
         case IR_LOAD_LOCAL:
-            return ir_to_bytecode_emit_instruction(translator, OP_LOAD_LOCAL, 
-                                                 (uint8_t*)&instruction->operands[0].data.temp_id, 
-                                                 sizeof(uint32_t));
+            return ir_to_bytecode_emit_operand(translator, OP_LOAD_LOCAL, instruction->operands[0].data.temp_id);
         
         case IR_STORE_LOCAL:
-            return ir_to_bytecode_emit_instruction(translator, OP_STORE_LOCAL, 
-                                                 (uint8_t*)&instruction->operands[0].data.temp_id, 
-                                                 sizeof(uint32_t));
+            return ir_to_bytecode_emit_operand(translator, OP_STORE_LOCAL, instruction->operands[0].data.temp_id);
         
         case IR_ADD:
             return ir_to_bytecode_emit_instruction(translator, OP_ADD, NULL, 0);
@@ -300,19 +365,7 @@ bool ir_to_bytecode_translate_instruction(IRToBytecodeTranslator* translator, IR
         case IR_JMP: {
             // Unconditional jump
             if (instruction->target > 0) {
-                uint32_t target_block_id = instruction->target;
-                // Find the target block and calculate byte offset
-                IRBlock* target_block = ir_to_bytecode_find_block_by_id(translator, target_block_id);
-                if (!target_block) {
-                    ir_to_bytecode_translator_set_error(translator, "Target block not found for jump");
-                    return false;
-                }
-                
-                // Calculate relative offset from position after jump instruction to target
-                // Jump instruction is 5 bytes: 1 byte opcode + 4 bytes offset
-                int32_t offset = (int32_t)(target_block->bytecode_offset - (translator->current_bytecode_size + 5));
-                return ir_to_bytecode_emit_instruction(translator, OP_JUMP, 
-                                                     (uint8_t*)&offset, sizeof(int32_t));
+                return ir_to_bytecode_emit_jump(translator, OP_JUMP, instruction->target);
             }
             return ir_to_bytecode_emit_instruction(translator, OP_JUMP, NULL, 0);
         }
@@ -320,19 +373,7 @@ bool ir_to_bytecode_translate_instruction(IRToBytecodeTranslator* translator, IR
         case IR_JMPF: {
             // Jump if false
             if (instruction->target > 0) {
-                uint32_t target_block_id = instruction->target;
-                // Find the target block and calculate byte offset
-                IRBlock* target_block = ir_to_bytecode_find_block_by_id(translator, target_block_id);
-                if (!target_block) {
-                    ir_to_bytecode_translator_set_error(translator, "Target block not found for jump if false");
-                    return false;
-                }
-                
-                // Calculate relative offset from position after jump instruction to target
-                // Jump instruction is 5 bytes: 1 byte opcode + 4 bytes offset
-                int32_t offset = (int32_t)(target_block->bytecode_offset - (translator->current_bytecode_size + 5));
-                return ir_to_bytecode_emit_instruction(translator, OP_JUMP_IF_FALSE, 
-                                                     (uint8_t*)&offset, sizeof(int32_t));
+                return ir_to_bytecode_emit_jump(translator, OP_JUMP_IF_FALSE, instruction->target);
             }
             return ir_to_bytecode_emit_instruction(translator, OP_JUMP_IF_FALSE, NULL, 0);
         }
@@ -340,19 +381,7 @@ bool ir_to_bytecode_translate_instruction(IRToBytecodeTranslator* translator, IR
         case IR_JMPT: {
             // Jump if true
             if (instruction->target > 0) {
-                uint32_t target_block_id = instruction->target;
-                // Find the target block and calculate byte offset
-                IRBlock* target_block = ir_to_bytecode_find_block_by_id(translator, target_block_id);
-                if (!target_block) {
-                    ir_to_bytecode_translator_set_error(translator, "Target block not found for jump if true");
-                    return false;
-                }
-                
-                // Calculate relative offset from position after jump instruction to target
-                // Jump instruction is 5 bytes: 1 byte opcode + 4 bytes offset
-                int32_t offset = (int32_t)(target_block->bytecode_offset - (translator->current_bytecode_size + 5));
-                return ir_to_bytecode_emit_instruction(translator, OP_JUMP_IF_TRUE, 
-                                                     (uint8_t*)&offset, sizeof(int32_t));
+                return ir_to_bytecode_emit_jump(translator, OP_JUMP_IF_TRUE, instruction->target);
             }
             return ir_to_bytecode_emit_instruction(translator, OP_JUMP_IF_TRUE, NULL, 0);
         }
@@ -400,8 +429,7 @@ bool ir_to_bytecode_translate_instruction(IRToBytecodeTranslator* translator, IR
             }
             
             // Emit CALL_STATIC instruction with method ID
-            return ir_to_bytecode_emit_instruction(translator, OP_CALL_STATIC, 
-                                                 (uint8_t*)&method_id, sizeof(uint32_t));
+            return ir_to_bytecode_emit_operand(translator, OP_CALL_STATIC, method_id);
         }
         
         case IR_RETURN_VAL:
@@ -503,6 +531,34 @@ bool ir_to_bytecode_translate_instruction(IRToBytecodeTranslator* translator, IR
         case IR_RESULT_UNWRAP_OR:
             return ir_to_bytecode_emit_instruction(translator, OP_RESULT_UNWRAP_OR, NULL, 0);
         
+        // String operations
+        case IR_STRING_CONCAT:
+            return ir_to_bytecode_emit_instruction(translator, OP_STRING_CONCAT, NULL, 0);
+        
+        case IR_STRING_SUBSTRING:
+            return ir_to_bytecode_emit_instruction(translator, OP_STRING_SUBSTRING, NULL, 0);
+        
+        case IR_STRING_INDEX_OF:
+            return ir_to_bytecode_emit_instruction(translator, OP_STRING_INDEX_OF, NULL, 0);
+        
+        case IR_STRING_LENGTH:
+            return ir_to_bytecode_emit_instruction(translator, OP_STRING_LENGTH, NULL, 0);
+        
+        case IR_STRING_EQUALS_IGNORE_CASE:
+            return ir_to_bytecode_emit_instruction(translator, OP_STRING_EQUALS_IGNORE_CASE, NULL, 0);
+        
+        case IR_STRING_INDEX_OF_IGNORE_CASE:
+            return ir_to_bytecode_emit_instruction(translator, OP_STRING_INDEX_OF_IGNORE_CASE, NULL, 0);
+        
+        case IR_STRING_BUILDER_NEW:
+            return ir_to_bytecode_emit_instruction(translator, OP_STRING_BUILDER_NEW, NULL, 0);
+        
+        case IR_STRING_BUILDER_APPEND:
+            return ir_to_bytecode_emit_instruction(translator, OP_STRING_BUILDER_APPEND, NULL, 0);
+        
+        case IR_STRING_BUILDER_TO_STRING:
+            return ir_to_bytecode_emit_instruction(translator, OP_STRING_BUILDER_TO_STRING, NULL, 0);
+        
         // Special operations
         case IR_DUP:
             return ir_to_bytecode_emit_instruction(translator, OP_DUP, NULL, 0);
@@ -552,6 +608,63 @@ bool ir_to_bytecode_emit_instruction(IRToBytecodeTranslator* translator, uint8_t
     return true;
 }
 
+// Emit an instruction with a 4-byte operand in its shortest form: locals 0-3
+// in the opcode, one byte, or OP_WIDE and two bytes
+bool ir_to_bytecode_emit_operand(IRToBytecodeTranslator* translator, uint8_t opcode, uint32_t operand) {
+    if (!translator) return false;
+    
+    uint8_t short_form = translator->compact_operands ? ir_to_bytecode_short_form(opcode) : 0;
+    if (short_form == 0 || operand > UINT16_MAX) {
+        return ir_to_bytecode_emit_instruction(translator, opcode, (uint8_t*)&operand, sizeof(uint32_t));
+    }
+    if (operand < 4 && opcode == OP_LOAD_LOCAL) {
+        return ir_to_bytecode_emit_instruction(translator, (uint8_t)(OP_LOAD_LOCAL_0 + operand), NULL, 0);
+    }
+    if (operand < 4 && opcode == OP_STORE_LOCAL) {
+        return ir_to_bytecode_emit_instruction(translator, (uint8_t)(OP_STORE_LOCAL_0 + operand), NULL, 0);
+    }
+    if (operand <= UINT8_MAX) {
+        uint8_t byte = (uint8_t)operand;
+        return ir_to_bytecode_emit_instruction(translator, short_form, &byte, 1);
+    }
+    uint8_t wide[3] = { short_form, (uint8_t)(operand & 0xFF), (uint8_t)(operand >> 8) };
+    return ir_to_bytecode_emit_instruction(translator, OP_WIDE, wide, sizeof(wide));
+}
+
+// Reserve a jump to a block; its encoding is chosen by
+// ir_to_bytecode_layout_jumps once every block is placed
+bool ir_to_bytecode_emit_jump(IRToBytecodeTranslator* translator, uint8_t opcode, uint32_t target_block_id) {
+    if (!translator) return false;
+    
+    IRBlock* target_block = ir_to_bytecode_find_block_by_id(translator, target_block_id);
+    if (!target_block) {
+        ir_to_bytecode_translator_set_error(translator, "Target block not found for jump");
+        return false;
+    }
+    
+    if (translator->jump_count == translator->jump_capacity) {
+        size_t new_capacity = translator->jump_capacity ? translator->jump_capacity * 2 : 16;
+        IRToBytecodeJump* new_jumps = realloc(translator->jumps, new_capacity * sizeof(IRToBytecodeJump));
+        if (!new_jumps) {
+            ir_to_bytecode_translator_set_error(translator, "Failed to allocate jump table");
+            return false;
+        }
+        translator->jumps = new_jumps;
+        translator->jump_capacity = new_capacity;
+    }
+    
+    IRToBytecodeJump* jump = &translator->jumps[translator->jump_count++];
+    jump->offset = translator->current_bytecode_size;
+    jump->opcode = opcode;
+    jump->emitted_size = ir_to_bytecode_jump_size(translator, 0);
+    jump->size = jump->emitted_size;
+    jump->target = target_block;
+    
+    // Placeholder bytes, rewritten by the layout
+    uint8_t placeholder[4] = {0};
+    return ir_to_bytecode_emit_instruction(translator, opcode, placeholder, jump->emitted_size - 1);
+}
+
 bool ir_to_bytecode_emit_push_constant(IRToBytecodeTranslator* translator, int64_t value) {
     if (!translator) return false;
     
@@ -563,8 +676,7 @@ bool ir_to_bytecode_emit_push_constant(IRToBytecodeTranslator* translator, int64
     }
     
     // Emit PUSH_CONSTANT instruction
-    return ir_to_bytecode_emit_instruction(translator, OP_PUSH_CONSTANT, 
-                                         (uint8_t*)&constant_index, sizeof(uint32_t));
+    return ir_to_bytecode_emit_operand(translator, OP_PUSH_CONSTANT, constant_index);
 }
 
 bool ir_to_bytecode_emit_push_float(IRToBytecodeTranslator* translator, double value) {
@@ -578,8 +690,7 @@ bool ir_to_bytecode_emit_push_float(IRToBytecodeTranslator* translator, double v
     }
     
     // Emit PUSH_CONSTANT instruction
-    return ir_to_bytecode_emit_instruction(translator, OP_PUSH_CONSTANT, 
-                                         (uint8_t*)&constant_index, sizeof(uint32_t));
+    return ir_to_bytecode_emit_operand(translator, OP_PUSH_CONSTANT, constant_index);
 }
 
 bool ir_to_bytecode_emit_push_boolean(IRToBytecodeTranslator* translator, bool value) {
@@ -593,8 +704,7 @@ bool ir_to_bytecode_emit_push_boolean(IRToBytecodeTranslator* translator, bool v
     }
     
     // Emit PUSH_CONSTANT instruction
-    return ir_to_bytecode_emit_instruction(translator, OP_PUSH_CONSTANT, 
-                                         (uint8_t*)&constant_index, sizeof(uint32_t));
+    return ir_to_bytecode_emit_operand(translator, OP_PUSH_CONSTANT, constant_index);
 }
 
 bool ir_to_bytecode_emit_push_string(IRToBytecodeTranslator* translator, const char* value) {
@@ -615,8 +725,7 @@ bool ir_to_bytecode_emit_push_string(IRToBytecodeTranslator* translator, const c
     }
     
     // Emit PUSH_CONSTANT instruction
-    return ir_to_bytecode_emit_instruction(translator, OP_PUSH_CONSTANT, 
-                                         (uint8_t*)&constant_index, sizeof(uint32_t));
+    return ir_to_bytecode_emit_operand(translator, OP_PUSH_CONSTANT, constant_index);
 }
 
 bool ir_to_bytecode_emit_push_null(IRToBytecodeTranslator* translator) {
@@ -630,8 +739,7 @@ bool ir_to_bytecode_emit_push_null(IRToBytecodeTranslator* translator) {
     }
     
     // Emit PUSH_CONSTANT instruction
-    return ir_to_bytecode_emit_instruction(translator, OP_PUSH_CONSTANT, 
-                                         (uint8_t*)&constant_index, sizeof(uint32_t));
+    return ir_to_bytecode_emit_operand(translator, OP_PUSH_CONSTANT, constant_index);
 }
 
 // Table management functions
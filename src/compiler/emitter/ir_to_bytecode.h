@@ -7,6 +7,15 @@
 // Forward declarations
 struct IRToBytecodeTranslator;
 
+// A jump whose offset is resolved once the function's layout is known
+typedef struct IRToBytecodeJump {
+    size_t offset;                  // Offset of the jump in the emitted bytecode
+    uint8_t opcode;                 // 4-byte form of the jump
+    uint8_t emitted_size;           // Bytes reserved for the jump when emitted
+    uint8_t size;                   // Encoded size: 2 short, 4 wide, 5 full
+    IRBlock* target;                // Target block
+} IRToBytecodeJump;
+
 // IR to bytecode translator
 typedef struct IRToBytecodeTranslator {
     BytecodeFile* bytecode_file;    // Shared bytecode file structure
@@ -30,6 +39,14 @@ typedef struct IRToBytecodeTranslator {
     size_t current_bytecode_size;
     size_t current_bytecode_capacity;
     
+    // Jumps of the current function, in emission order
+    IRToBytecodeJump* jumps;
+    size_t jump_count;
+    size_t jump_capacity;
+    
+    // Emit short operand forms (on by default); off emits 4-byte operands
+    bool compact_operands;
+    
     // Error handling
     char* error_message;
     bool has_error;
@@ -44,12 +61,14 @@ bool ir_to_bytecode_translate_function(IRToBytecodeTranslator* translator, IRFun
 bool ir_to_bytecode_translate_block(IRToBytecodeTranslator* translator, IRBlock* block);
 bool ir_to_bytecode_translate_instruction(IRToBytecodeTranslator* translator, IRInstruction* instruction);
 
-// Block offset calculation
-bool ir_to_bytecode_calculate_block_offsets(IRToBytecodeTranslator* translator, IRFunction* function);
+// Block lookup and jump layout
 IRBlock* ir_to_bytecode_find_block_by_id(IRToBytecodeTranslator* translator, uint32_t block_id);
+bool ir_to_bytecode_layout_jumps(IRToBytecodeTranslator* translator, IRFunction* function);
 
 // Bytecode generation
 bool ir_to_bytecode_emit_instruction(IRToBytecodeTranslator* translator, uint8_t opcode, const uint8_t* operands, size_t operand_size);
+bool ir_to_bytecode_emit_operand(IRToBytecodeTranslator* translator, uint8_t opcode, uint32_t operand);
+bool ir_to_bytecode_emit_jump(IRToBytecodeTranslator* translator, uint8_t opcode, uint32_t target_block_id);
 bool ir_to_bytecode_emit_push_constant(IRToBytecodeTranslator* translator, int64_t value);
 bool ir_to_bytecode_emit_push_float(IRToBytecodeTranslator* translator, double value);
 bool ir_to_bytecode_emit_push_boolean(IRToBytecodeTranslator* translator, bool value);
@@ -1,3 +1,6 @@
+// strdup is hidden under -std=c99
+#define _DEFAULT_SOURCE
+
 #include "ir.h"
 #include <stdlib.h>
 #include <string.h>
@@ -434,6 +437,88 @@ void ir_builder_add_result_unwrap_or(IRBuilder* builder) {
     ir_builder_add_instruction(builder, instruction);
 }
 
+// String operations
+void ir_builder_add_string_concat(IRBuilder* builder) {
+    if (!builder) return;
+    
+    IRInstruction* instruction = ir_builder_create_instruction(builder, IR_STRING_CONCAT);
+    if (!instruction) return;
+    
+    ir_builder_add_instruction(builder, instruction);
+}
+
+void ir_builder_add_string_substring(IRBuilder* builder) {
+    if (!builder) return;
+    
+    IRInstruction* instruction = ir_builder_create_instruction(builder, IR_STRING_SUBSTRING);
+    if (!instruction) return;
+    
+    ir_builder_add_instruction(builder, instruction);
+}
+
+void ir_builder_add_string_index_of(IRBuilder* builder) {
+    if (!builder) return;
+    
+    IRInstruction* instruction = ir_builder_create_instruction(builder, IR_STRING_INDEX_OF);
+    if (!instruction) return;
+    
+    ir_builder_add_instruction(builder, instruction);
+}
+
+void ir_builder_add_string_length(IRBuilder* builder) {
+    if (!builder) return;
+    
+    IRInstruction* instruction = ir_builder_create_instruction(builder, IR_STRING_LENGTH);
+    if (!instruction) return;
+    
+    ir_builder_add_instruction(builder, instruction);
+}
+
+void ir_builder_add_string_equals_ignore_case(IRBuilder* builder) {
+    if (!builder) return;
+    
+    IRInstruction* instruction = ir_builder_create_instruction(builder, IR_STRING_EQUALS_IGNORE_CASE);
+    if (!instruction) return;
+    
+    ir_builder_add_instruction(builder, instruction);
+}
+
+void ir_builder_add_string_index_of_ignore_case(IRBuilder* builder) {
+    if (!builder) return;
+    
+    IRInstruction* instruction = ir_builder_create_instruction(builder, IR_STRING_INDEX_OF_IGNORE_CASE);
+    if (!instruction) return;
+    
+    ir_builder_add_instruction(builder, instruction);
+}
+
+void ir_builder_add_string_builder_new(IRBuilder* builder) {
+    if (!builder) return;
+    
+    IRInstruction* instruction = ir_builder_create_instruction(builder, IR_STRING_BUILDER_NEW);
+    if (!instruction) return;
+    
+    ir_builder_add_instruction(builder, instruction);
+}
+
+void ir_builder_add_string_builder_append(IRBuilder* builder) {
+    if (!builder) return;
+    
+    IRInstruction* instruction = ir_builder_create_instruction(builder, IR_STRING_BUILDER_APPEND);
+    if (!instruction) return;
+    
+    ir_builder_add_instruction(builder, instruction);
+}
+
+void ir_builder_add_string_builder_to_string(IRBuilder* builder) {
+    if (!builder) return;
+    
+    IRInstruction* instruction = ir_builder_create_instruction(builder, IR_STRING_BUILDER_TO_STRING);
+    if (!instruction) return;
+    
+    ir_builder_add_instruction(builder, instruction);
+}
+
 // Error handling
 void ir_builder_set_error(IRBuilder* builder, const char* message) {
     if (!builder) return;
@@ -625,6 +710,15 @@ const char* ir_op_to_string(IROp op) {
         case IR_RESULT_IS_OK: return "RESULT_IS_OK";
         case IR_RESULT_UNWRAP: return "RESULT_UNWRAP";
         case IR_RESULT_UNWRAP_OR: return "RESULT_UNWRAP_OR";
+        case IR_STRING_CONCAT: return "STRING_CONCAT";
+        case IR_STRING_SUBSTRING: return "STRING_SUBSTRING";
+        case IR_STRING_INDEX_OF: return "STRING_INDEX_OF";
+        case IR_STRING_LENGTH: return "STRING_LENGTH";
+        case IR_STRING_EQUALS_IGNORE_CASE: return "STRING_EQUALS_IGNORE_CASE";
+        case IR_STRING_INDEX_OF_IGNORE_CASE: return "STRING_INDEX_OF_IGNORE_CASE";
+        case IR_STRING_BUILDER_NEW: return "STRING_BUILDER_NEW";
+        case IR_STRING_BUILDER_APPEND: return "STRING_BUILDER_APPEND";
+        case IR_STRING_BUILDER_TO_STRING: return "STRING_BUILDER_TO_STRING";
         case IR_PHI: return "PHI";
         case IR_COPY: return "COPY";
         case IR_DUP: return "DUP";
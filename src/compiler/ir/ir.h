@@ -106,6 +106,17 @@ typedef enum {
     IR_RESULT_UNWRAP,   // Unwrap Ok value
     IR_RESULT_UNWRAP_OR, // Unwrap Ok value or return default
     
+    // String operations
+    IR_STRING_CONCAT,   // Concatenate two strings
+    IR_STRING_SUBSTRING, // Substring (string, start, length)
+    IR_STRING_INDEX_OF, // Index of substring, or -1 (string, substring)
+    IR_STRING_LENGTH,   // Length in code points
+    IR_STRING_EQUALS_IGNORE_CASE, // Equality ignoring ASCII case
+    IR_STRING_INDEX_OF_IGNORE_CASE, // Index of substring ignoring ASCII case, or -1
+    IR_STRING_BUILDER_NEW, // Create empty StringBuilder
+    IR_STRING_BUILDER_APPEND, // Append string to builder (consumes both)
+    IR_STRING_BUILDER_TO_STRING, // Builder contents as a new string
+    
     // Special operations
     IR_PHI,             // Phi function (for SSA)
     IR_COPY,            // Copy value
@@ -262,6 +273,17 @@ void ir_builder_add_result_is_ok(IRBuilder* builder);
 void ir_builder_add_result_unwrap(IRBuilder* builder);
 void ir_builder_add_result_unwrap_or(IRBuilder* builder);
 
+// String operations
+void ir_builder_add_string_concat(IRBuilder* builder);
+void ir_builder_add_string_substring(IRBuilder* builder);
+void ir_builder_add_string_index_of(IRBuilder* builder);
+void ir_builder_add_string_length(IRBuilder* builder);
+void ir_builder_add_string_equals_ignore_case(IRBuilder* builder);
+void ir_builder_add_string_index_of_ignore_case(IRBuilder* builder);
+void ir_builder_add_string_builder_new(IRBuilder* builder);
+void ir_builder_add_string_builder_append(IRBuilder* builder);
+void ir_builder_add_string_builder_to_string(IRBuilder* builder);
+
 // Error handling
 void ir_builder_set_error(IRBuilder* builder, const char* message);
 const char* ir_builder_get_error(IRBuilder* builder);
@@ -1,3 +1,6 @@
+// strdup is hidden under -std=c99
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -349,6 +352,11 @@ int compile_file(const char* input_filename, const char* output_filename,
             strcat(helium_filename, ".helium3");
         }
         
+        // Index the tables so the VM can adopt them at load
+        if (!helium_module_build_link_index(helium_module)) {
+            fprintf(stderr, "Warning: Failed to build link index\n");
+        }
+        
         // Save helium module
         if (!helium_module_save(helium_module, helium_filename)) {
             fprintf(stderr, "Error: Failed to save helium module\n");
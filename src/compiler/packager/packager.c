@@ -1,3 +1,6 @@
+// strdup is hidden under -std=c99
+#define _DEFAULT_SOURCE
+
 #include "packager.h"
 #include "../parser/parser.h"
 #include "../emitter/ast_to_ir.h"
@@ -326,6 +329,11 @@ bool project_packager_save(ProjectPackager* packager, const char* output_path) {
     const char* path = output_path ? output_path : packager->project->output_path;
     fflush(stdout);
     
+    // The tables are final: index them so the VM can adopt them at load
+    if (!helium_module_build_link_index(packager->final_module)) {
+        fprintf(stderr, "Warning: Failed to build link index for %s\n", path);
+    }
+    
     fflush(stdout);
     if (!helium_module_save(packager->final_module, path)) {
         fprintf(stderr, "Error: Failed to save final module to %s\n", path);
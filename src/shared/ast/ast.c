@@ -1,3 +1,6 @@
+// strdup is hidden under -std=c99
+#define _DEFAULT_SOURCE
+
 #include "ast.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -75,14 +75,28 @@ typedef struct {
     uint32_t hash;               // String hash for fast lookup
 } StringEntry;
 
-// String table
+// String table. `index` is an open-addressing hash index over the entries,
+// keyed by StringEntry.hash: each slot holds an entry number plus one, or 0
+// when empty. Tables built by the compiler maintain it as strings are added;
+// tables read from a file adopt the module's persisted index or build one
+// on the first lookup. Entries or data with a capacity below their size
+// are borrowed (e.g. they point into a module image) and are copied before
+// the table grows; a borrowed index is rebuilt.
 typedef struct {
     uint32_t count;              // Number of strings
     uint32_t total_size;         // Total size of all strings
     StringEntry* entries;        // String entries
     char* data;                  // String data (UTF-8, null-terminated)
+    uint32_t* index;             // Hash index slots (NULL = not built)
+    uint32_t index_size;         // Slots in the index, a power of two
+    uint32_t entry_capacity;     // Entries allocated (0 = borrowed)
+    uint32_t data_capacity;      // Data bytes allocated (0 = borrowed)
+    bool index_owned;            // Index was allocated by the table
 } StringTable;
 
+// The string index is kept at most half full
+#define STRING_INDEX_MIN_SIZE 16
+
 // ============================================================================
 // CONSTANT TABLE
 // ============================================================================
@@ -96,9 +110,11 @@ typedef enum {
     CONSTANT_TYPE_NULL = 4,         // Null reference
 } ConstantType;
 
-// Constant table entry
+// Constant table entry. Fixed-width with no padding, so that modules can
+// use constant tables in place (see helium_format.h).
 typedef struct {
-    ConstantType type;              // Type of constant
+    uint32_t type;                  // ConstantType
+    uint32_t reserved;              // Zero; aligns the value
     union {
         int64_t int_value;          // Integer value
         double float_value;         // Float value
@@ -277,12 +293,21 @@ void string_table_destroy(StringTable* table);
 // Add string to table
 uint32_t string_table_add_string(StringTable* table, const char* str);
 
+// Add the first `length` bytes of a string to table
+uint32_t string_table_add_string_with_length(StringTable* table, const char* str, size_t length);
+
 // Get string from table
 const char* string_table_get_string(StringTable* table, uint32_t index);
 
 // Find string in table
 int32_t string_table_find_string(StringTable* table, const char* str);
 
+// Build the hash index of a table read from a file
+bool string_table_build_index(StringTable* table);
+
+// Slots needed to index `count` strings
+uint32_t string_table_index_size_for(uint32_t count);
+
 // ============================================================================
 // CONSTANT TABLE OPERATIONS
 // ============================================================================
@@ -378,6 +403,9 @@ int32_t field_table_find_field(FieldTable* table, uint32_t type_id, const char*
 // Calculate string hash
 uint32_t string_hash(const char* str);
 
+// Calculate the hash of `length` bytes (same value as string_hash)
+uint32_t string_hash_with_length(const char* str, size_t length);
+
 // Align size to boundary
 size_t align_size(size_t size, size_t alignment);
 
@@ -61,7 +61,7 @@ const ConstantEntry* constant_table_get_constant(ConstantTable* table, uint32_t
 uint32_t constant_table_add_int64(ConstantTable* table, int64_t value) {
     if (!table) return 0;
     
-    ConstantEntry entry;
+    ConstantEntry entry = {0};
     entry.type = CONSTANT_TYPE_INT64;
     entry.value.int_value = value;
     
@@ -71,7 +71,7 @@ uint32_t constant_table_add_int64(ConstantTable* table, int64_t value) {
 uint32_t constant_table_add_float64(ConstantTable* table, double value) {
     if (!table) return 0;
     
-    ConstantEntry entry;
+    ConstantEntry entry = {0};
     entry.type = CONSTANT_TYPE_FLOAT64;
     entry.value.float_value = value;
     
@@ -81,7 +81,7 @@ uint32_t constant_table_add_float64(ConstantTable* table, double value) {
 uint32_t constant_table_add_boolean(ConstantTable* table, bool value) {
     if (!table) return 0;
     
-    ConstantEntry entry;
+    ConstantEntry entry = {0};
     entry.type = CONSTANT_TYPE_BOOLEAN;
     entry.value.bool_value = value;
     
@@ -93,7 +93,7 @@ uint32_t constant_table_add_string(ConstantTable* table, uint32_t string_offset)
         return UINT32_MAX;
     }
     
-    ConstantEntry entry;
+    ConstantEntry entry = {0};
     entry.type = CONSTANT_TYPE_STRING;
     entry.value.string_offset = string_offset;
     
@@ -103,7 +103,7 @@ uint32_t constant_table_add_string(ConstantTable* table, uint32_t string_offset)
 uint32_t constant_table_add_null(ConstantTable* table) {
     if (!table) return 0;
     
-    ConstantEntry entry;
+    ConstantEntry entry = {0};
     entry.type = CONSTANT_TYPE_NULL;
     entry.value.string_offset = 0; // Not used for null
     
@@ -11,9 +11,22 @@
 #define HELIUM_MAGIC "HELIUM3"
 #define HELIUM_MAGIC_SIZE 8
 
-// Version information
-#define HELIUM_VERSION_MAJOR 1
+// Version information. Modules are written in version 2; version 1
+// modules can still be loaded.
+#define HELIUM_VERSION_MAJOR 2
 #define HELIUM_VERSION_MINOR 0
+#define HELIUM_VERSION_MAJOR_V1 1
+
+// Sections are placed so that their entries start at a multiple of this
+// many bytes, which lets a loaded module use them in place. Version 2
+// aligns bytecode to HELIUM_BYTECODE_ALIGNMENT.
+#define HELIUM_SECTION_ALIGNMENT 8
+#define HELIUM_BYTECODE_ALIGNMENT 16
+
+// Version 2 modules are little-endian. The writer stores this value as a
+// native uint32_t, so a reader on a host of the other byte order sees it
+// reversed.
+#define HELIUM_BYTE_ORDER_MARK 0x01020304u
 
 // Module flags
 #define HELIUM_FLAG_EXECUTABLE    0x0001  // Module contains executable code
@@ -54,9 +67,102 @@ typedef struct HeliumHeader {
     uint32_t reserved[8];
 } HeliumHeader;
 
+// Version 2 section kinds
+typedef enum {
+    HELIUM_SECTION_STRING_ENTRIES = 1,  // StringEntry records
+    HELIUM_SECTION_STRING_DATA = 2,     // NUL-terminated UTF-8 strings
+    HELIUM_SECTION_CONSTANTS = 3,       // ConstantEntry records
+    HELIUM_SECTION_TYPES = 4,           // TypeEntry records
+    HELIUM_SECTION_METHODS = 5,         // MethodEntry records
+    HELIUM_SECTION_FIELDS = 6,          // FieldEntry records
+    HELIUM_SECTION_BYTECODE = 7,        // Bytecode of all methods
+    HELIUM_SECTION_STRING_INDEX = 8,    // uint32_t hash index slots over the string entries
+    HELIUM_SECTION_LINK_INDEX = 9       // HeliumLinkHeader and its records (bytes)
+} HeliumSectionKind;
+
+// Number of section kinds
+#define HELIUM_SECTION_KIND_COUNT 9
+
+// Version 2 section directory entry. Records are the in-memory table
+// entry structs, which hold only fixed-width fields and no padding, so a
+// section can be used in place when record_size matches.
+typedef struct HeliumSection {
+    uint32_t kind;                    // HeliumSectionKind (unknown kinds are skipped)
+    uint32_t record_size;             // Bytes per record (1 for byte sections)
+    uint32_t count;                   // Number of records
+    uint32_t alignment;               // Alignment of offset
+    uint64_t offset;                  // Offset from the start of the file
+    uint64_t size;                    // count * record_size
+} HeliumSection;
+
+// Version 2 link index: what registry discovery computes from the type,
+// method and field tables, precomputed by the packager so the VM can adopt
+// it at load. The header is followed by one HeliumLinkType per type table
+// entry (in table order), then HeliumLinkMember records for the methods and
+// HeliumLinkField records for the fields. Members are grouped by owning
+// type; each type's group is the range it names, and members whose owner is
+// not in the type table follow the last group. Name hashes are string_hash
+// of the name.
+typedef struct HeliumLinkHeader {
+    uint32_t type_count;              // Type table entries
+    uint32_t method_count;            // Method table entries
+    uint32_t field_count;             // Field table entries
+    uint32_t max_type_id;             // Largest type ID in the type table
+    uint32_t max_method_id;           // Largest method ID in the method table
+    uint32_t max_field_id;            // Largest field ID in the field table
+} HeliumLinkHeader;
+
+typedef struct HeliumLinkType {
+    uint32_t name_hash;               // Hash of the type name
+    uint32_t first_method;            // First of the type's method records
+    uint32_t method_count;            // Number of methods the type declares
+    uint32_t first_field;             // First of the type's field records
+    uint32_t field_count;             // Number of fields the type declares
+} HeliumLinkType;
+
+typedef struct HeliumLinkMember {
+    uint32_t table_index;             // Index in the method table
+    uint32_t name_hash;               // Hash of the method name
+} HeliumLinkMember;
+
+typedef struct HeliumLinkField {
+    uint32_t table_index;             // Index in the field table
+    uint32_t name_hash;               // Hash of the field name
+    uint32_t offset;                  // Offset in the object's data
+    uint32_t size;                    // Bytes of storage (helium_field_size)
+    uint32_t flags;                   // FIELD_FLAG_* of the field
+} HeliumLinkField;
+
+// Records of a link index
+#define HELIUM_LINK_TYPES(index) ((const HeliumLinkType*)((const HeliumLinkHeader*)(index) + 1))
+#define HELIUM_LINK_METHODS(index) \
+    ((const HeliumLinkMember*)(HELIUM_LINK_TYPES(index) + (index)->type_count))
+#define HELIUM_LINK_FIELDS(index) \
+    ((const HeliumLinkField*)(HELIUM_LINK_METHODS(index) + (index)->method_count))
+
+// Version 2 module header. The fields up to module_version_offset are
+// shared with HeliumHeader, so readers can check the version first. All
+// offsets are from the start of the file; the sections follow the
+// directory in any order.
+typedef struct HeliumHeaderV2 {
+    char magic[8];                    // "HELIUM3"
+    uint16_t version_major;           // 2
+    uint16_t version_minor;           // Minor version
+    uint32_t flags;                   // Module flags
+    uint32_t module_name_offset;      // Offset to module name in string data
+    uint32_t module_version_offset;   // Offset to module version in string data
+    uint32_t byte_order;              // HELIUM_BYTE_ORDER_MARK
+    uint32_t header_size;             // sizeof(HeliumHeaderV2)
+    uint32_t entry_point_method_id;   // Method ID of entry point
+    uint32_t section_count;           // Entries in the section directory
+    uint64_t section_directory_offset; // Offset to HeliumSection[section_count]
+    uint32_t reserved[6];             // Zero
+} HeliumHeaderV2;
+
 // Helium3 module structure
 typedef struct HeliumModule {
-    HeliumHeader header;              // Module header
+    HeliumHeader header;              // Module header (for a version 2 module, only the
+                                      // fields shared with HeliumHeaderV2 and the entry point)
     
     // String table
     char* string_table;               // String table data
@@ -72,6 +178,18 @@ typedef struct HeliumModule {
     // Bytecode
     uint8_t* bytecode;                // Bytecode data
     uint32_t bytecode_size;           // Size of bytecode
+    
+    // File image of a loaded module. Table entries, string data and
+    // bytecode point into it instead of being copied.
+    void* image;                      // Read-only mapping or heap copy (NULL = none)
+    size_t image_size;                // Size of the image in bytes
+    bool image_mapped;                // image is an mmap rather than a malloc
+    bool image_borrowed;              // image belongs to the caller (see helium_module_load_image)
+    
+    // Link index, in the image or built by helium_module_build_link_index.
+    // Changing the type, method or field table discards a built one.
+    HeliumLinkHeader* link_index;     // NULL = discover links from the tables
+    uint32_t link_index_size;         // Size of the link index in bytes
 } HeliumModule;
 
 // Function declarations
@@ -79,11 +197,18 @@ HeliumModule* helium_module_create(void);
 void helium_module_destroy(HeliumModule* module);
 bool helium_module_save(HeliumModule* module, const char* filename);
 HeliumModule* helium_module_load(const char* filename);
+HeliumModule* helium_module_load_image(const void* image, size_t size);
 bool helium_module_validate(HeliumModule* module);
 const char* helium_module_get_string(HeliumModule* module, uint32_t offset);
 uint32_t helium_module_add_string(HeliumModule* module, const char* str);
+uint32_t helium_module_find_string(HeliumModule* module, const char* str);
 uint32_t helium_module_add_type(HeliumModule* module, const char* name, const char* module_name);
 uint32_t helium_module_add_method(HeliumModule* module, const char* name, const char* signature, uint32_t type_id, bool is_static);
 bool helium_module_add_sys_class_from_info(HeliumModule* module);
 bool helium_module_add_sys_class(HeliumModule* module);
 void helium_module_print_info(HeliumModule* module);
+
+// Link index
+bool helium_module_build_link_index(HeliumModule* module);
+void helium_module_discard_link_index(HeliumModule* module);
+uint32_t helium_field_size(uint32_t field_type_id);
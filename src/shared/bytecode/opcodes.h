@@ -14,8 +14,13 @@
 // INSTRUCTION FORMAT
 // ============================================================================
 
-// All instructions are 1 byte opcode followed by 0-4 bytes of operands
+// All instructions are 1 byte opcode followed by 0-8 bytes of operands
 // Operands are stored in little-endian format
+//
+// Local, constant, static call and jump operands have compact forms: the
+// first four locals are encoded in the opcode, other small operands take one
+// byte, and an OP_WIDE prefix gives the following compact instruction a
+// 2-byte operand. Larger operands use the 4-byte forms.
 
 // ============================================================================
 // STACK OPERATIONS
@@ -36,6 +41,7 @@
 #define OP_PUSH_FLOAT64       0x0C  // Push 64-bit float (8 byte operand)
 #define OP_PUSH_STRING        0x0D  // Push string (4 byte string index)
 #define OP_PUSH_CONSTANT      0x0E  // Push constant (4 byte constant index)
+#define OP_PUSH_CONSTANT_S    0x1A  // Push constant (1 byte constant index)
 
 #define OP_POP                0x0F  // Pop value from stack
 #define OP_DUP                0x10  // Duplicate top of stack
@@ -93,6 +99,9 @@
 #define OP_JUMP_IF_FALSE      0x52  // Jump if false (4 byte offset)
 #define OP_JUMP_IF_NULL       0x53  // Jump if null (4 byte offset)
 #define OP_JUMP_IF_NOT_NULL   0x54  // Jump if not null (4 byte offset)
+#define OP_JUMP_S             0x55  // Unconditional jump (1 byte signed offset)
+#define OP_JUMP_IF_TRUE_S     0x56  // Jump if true (1 byte signed offset)
+#define OP_JUMP_IF_FALSE_S    0x57  // Jump if false (1 byte signed offset)
 
 // ============================================================================
 // FUNCTION CALLS
@@ -104,6 +113,7 @@
 #define OP_CALL_INTERFACE     0x63  // Call interface method (4 byte method ID)
 #define OP_RETURN             0x64  // Return from function
 #define OP_RETURN_VALUE       0x65  // Return value from function
+#define OP_CALL_STATIC_S      0x66  // Call static method (1 byte method ID)
 
 // ============================================================================
 // LOCAL VARIABLES
@@ -113,6 +123,16 @@
 #define OP_STORE_LOCAL        0x71  // Store local variable (4 byte local index)
 #define OP_LOAD_ARG           0x72  // Load argument (4 byte arg index)
 #define OP_STORE_ARG          0x73  // Store argument (4 byte arg index)
+#define OP_LOAD_LOCAL_0       0x74  // Load local variable 0
+#define OP_LOAD_LOCAL_1       0x75  // Load local variable 1
+#define OP_LOAD_LOCAL_2       0x76  // Load local variable 2
+#define OP_LOAD_LOCAL_3       0x77  // Load local variable 3
+#define OP_STORE_LOCAL_0      0x78  // Store local variable 0
+#define OP_STORE_LOCAL_1      0x79  // Store local variable 1
+#define OP_STORE_LOCAL_2      0x7A  // Store local variable 2
+#define OP_STORE_LOCAL_3      0x7B  // Store local variable 3
+#define OP_LOAD_LOCAL_S       0x7C  // Load local variable (1 byte local index)
+#define OP_STORE_LOCAL_S      0x7D  // Store local variable (1 byte local index)
 
 // ============================================================================
 // GLOBAL VARIABLES
@@ -153,10 +173,15 @@
 // STRING OPERATIONS
 // ============================================================================
 
-#define OP_STRING_LENGTH      0xC0  // Get string length
+#define OP_STRING_LENGTH      0xC0  // Get string length in code points
 #define OP_STRING_CONCAT      0xC1  // Concatenate strings
 #define OP_STRING_SUBSTRING   0xC2  // Get substring (string, start, length)
 #define OP_STRING_INDEX_OF    0xC3  // Find substring index (string, substring)
+#define OP_STRING_BUILDER_NEW 0xC4  // Create empty StringBuilder
+#define OP_STRING_BUILDER_APPEND 0xC5  // Append string to builder (builder, string)
+#define OP_STRING_BUILDER_TO_STRING 0xC6  // Copy builder contents to a new string
+#define OP_STRING_EQUALS_IGNORE_CASE 0xC7  // Compare strings ignoring ASCII case (string, string)
+#define OP_STRING_INDEX_OF_IGNORE_CASE 0xC8  // Find substring index ignoring ASCII case (string, substring)
 
 // ============================================================================
 // BUILT-IN FUNCTIONS
@@ -204,6 +229,7 @@
 // ============================================================================
 
 #define OP_NOP                0xEB  // No operation
+#define OP_WIDE               0xEE  // Next compact instruction has a 2 byte operand
 
 // ============================================================================
 // SECURITY OPERATIONS
@@ -250,6 +276,16 @@ bool opcode_has_operands(uint8_t opcode);
 // Get instruction category
 const char* opcode_get_category(uint8_t opcode);
 
+// Get the 4-byte form of a compact instruction that may follow OP_WIDE,
+// or 0 if the opcode cannot be widened
+uint8_t opcode_get_wide_form(uint8_t opcode);
+
+// Check if instruction is a relative jump; inline as the interpreter asks
+// for every instruction
+static inline bool opcode_is_jump(uint8_t opcode) {
+    return opcode >= OP_JUMP && opcode <= OP_JUMP_IF_FALSE_S;
+}
+
 // ============================================================================
 // INSTRUCTION CATEGORIES
 // ============================================================================
@@ -284,7 +320,7 @@ void opcode_disassemble(uint8_t* bytecode, size_t offset, char* buffer, size_t b
 // Disassemble instruction with operands
 void opcode_disassemble_with_operands(uint8_t* bytecode, size_t offset, char* buffer, size_t buffer_size);
 
-// Get instruction size including operands
+// Get instruction size including operands and any OP_WIDE prefix
 size_t opcode_get_size(uint8_t* bytecode, size_t offset);
 
 // ============================================================================
@@ -30,6 +30,20 @@ static const SysClassInfo sys_class_info = {
     .method_count = sizeof(sys_methods) / sizeof(sys_methods[0])
 };
 
+// StringBuilder instance methods - implemented by the VM's string builder
+// opcodes
+static const SysMethodInfo string_builder_methods[] = {
+    {"append", "(string)void", false},
+    {"toString", "()string", false}
+};
+
+static const SysClassInfo string_builder_class_info = {
+    .class_name = "StringBuilder",
+    .module_name = "System",
+    .methods = (SysMethodInfo*)string_builder_methods,
+    .method_count = sizeof(string_builder_methods) / sizeof(string_builder_methods[0])
+};
+
 const SysClassInfo* sys_get_class_info(void) {
     return &sys_class_info;
 }
@@ -44,3 +58,7 @@ const SysMethodInfo* sys_get_method_info(const char* method_name) {
     }
     return NULL;
 }
+
+const SysClassInfo* sys_get_string_builder_class_info(void) {
+    return &string_builder_class_info;
+}
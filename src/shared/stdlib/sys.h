@@ -32,6 +32,9 @@ const SysClassInfo* sys_get_class_info(void);
 // Get method information by name
 const SysMethodInfo* sys_get_method_info(const char* method_name);
 
+// Get StringBuilder class information
+const SysClassInfo* sys_get_string_builder_class_info(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,3 +1,6 @@
+// strdup is hidden under -std=c99
+#define _DEFAULT_SOURCE
+
 #include "bytecode.h"
 #include <stdlib.h>
 #include <string.h>
@@ -160,12 +160,17 @@ typedef struct StringEntry {
     uint32_t hash;           // String hash for fast lookup
 } StringEntry;
 
-// String table
+// String table (same layout as in shared/bytecode/bytecode_format.h)
 typedef struct StringTable {
     uint32_t count;          // Number of strings
     uint32_t total_size;     // Total size of all strings
     StringEntry* entries;    // String entries
     char* data;              // String data
+    uint32_t* index;         // Hash index slots (NULL = not built)
+    uint32_t index_size;     // Slots in the index, a power of two
+    uint32_t entry_capacity; // Entries allocated (0 = borrowed)
+    uint32_t data_capacity;  // Data bytes allocated (0 = borrowed)
+    bool index_owned;        // Index was allocated by the table
 } StringTable;
 
 // Relocation entry
@@ -128,6 +128,8 @@ BytecodeFile* bytecode_file_load(const char* filename) {
                 
                 bytecode_file->string_table->count = count;
                 bytecode_file->string_table->total_size = total_size;
+                bytecode_file->string_table->entry_capacity = count;
+                bytecode_file->string_table->data_capacity = total_size;
                 
                 // Allocate and read entries
                 if (count > 0) {
@@ -395,6 +397,11 @@ StringTable* string_table_create(void) {
     table->total_size = 0;
     table->entries = NULL;
     table->data = NULL;
+    table->index = NULL;
+    table->index_size = 0;
+    table->entry_capacity = 0;
+    table->data_capacity = 0;
+    table->index_owned = false;
     
     return table;
 }
@@ -408,97 +415,158 @@ void string_table_destroy(StringTable* table) {
     if (table->data) {
         free(table->data);
     }
+    if (table->index_owned) {
+        free(table->index);
+    }
     
     free(table);
 }
 
-uint32_t string_table_add_string(StringTable* table, const char* str) {
-    if (!table || !str) {
-        return 0;
+uint32_t string_table_index_size_for(uint32_t count) {
+    uint64_t size = STRING_INDEX_MIN_SIZE;
+    while (size < (uint64_t)count * 2) {
+        size *= 2;
     }
+    return size > UINT32_MAX / 2 ? 0 : (uint32_t)size;
+}
+
+// Put entry `i` in the first free slot of its probe sequence
+static void string_table_index_insert(StringTable* table, uint32_t i) {
+    uint32_t mask = table->index_size - 1;
+    uint32_t slot = table->entries[i].hash & mask;
+    while (table->index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    table->index[slot] = i + 1;
+}
+
+// Replace the index with an owned one of `size` slots holding every entry
+static bool string_table_rehash(StringTable* table, uint32_t size) {
+    if (size == 0) return false;
+    uint32_t* index = calloc(size, sizeof(uint32_t));
+    if (!index) return false;
     
-    
-    // Check if string already exists
+    if (table->index_owned) {
+        free(table->index);
+    }
+    table->index = index;
+    table->index_size = size;
+    table->index_owned = true;
     for (uint32_t i = 0; i < table->count; i++) {
-        if (strcmp(table->data + table->entries[i].offset, str) == 0) {
-            return i;
-        }
+        string_table_index_insert(table, i);
     }
+    return true;
+}
+
+bool string_table_build_index(StringTable* table) {
+    if (!table) return false;
+    if (table->index) return true;
+    return string_table_rehash(table, string_table_index_size_for(table->count));
+}
+
+// Entry number of the string of `length` bytes, or -1. Probing stops at an
+// empty slot or after visiting every slot, so a persisted index with no
+// empty slot cannot loop.
+static int32_t string_table_lookup(StringTable* table, const char* str, size_t length, uint32_t hash) {
+    if (!table->index && !string_table_build_index(table)) return -1;
     
-    // Add new string
-    size_t len = strlen(str) + 1; // Include null terminator
-    
-    // Resize data buffer
-    char* new_data = realloc(table->data, table->total_size + len);
-    if (!new_data) {
-        return 0;
+    uint32_t mask = table->index_size - 1;
+    uint32_t slot = hash & mask;
+    for (uint32_t probes = 0; probes < table->index_size; probes++) {
+        uint32_t entry_number = table->index[slot];
+        if (entry_number == 0) break;
+        
+        const StringEntry* entry = &table->entries[entry_number - 1];
+        if (entry->hash == hash && entry->length == length &&
+            memcmp(table->data + entry->offset, str, length) == 0) {
+            return (int32_t)(entry_number - 1);
+        }
+        slot = (slot + 1) & mask;
     }
-    
-    table->data = new_data;
-    
-    // Resize entries array
-    StringEntry* new_entries = realloc(table->entries, (table->count + 1) * sizeof(StringEntry));
-    if (!new_entries) {
-        return 0;
+    return -1;
+}
+
+// Make room for one more entry and `length` more bytes of data. Borrowed
+// entries and data are copied into storage of their own.
+static bool string_table_reserve(StringTable* table, size_t length) {
+    if (table->count >= table->entry_capacity) {
+        uint32_t capacity = table->count < 8 ? 16 : table->count * 2;
+        StringEntry* entries;
+        if (table->entry_capacity < table->count) {
+            entries = malloc(capacity * sizeof(StringEntry));
+            if (entries) memcpy(entries, table->entries, table->count * sizeof(StringEntry));
+        } else {
+            entries = realloc(table->entries, capacity * sizeof(StringEntry));
+        }
+        if (!entries) return false;
+        table->entries = entries;
+        table->entry_capacity = capacity;
     }
     
-    table->entries = new_entries;
+    if ((uint64_t)table->total_size + length > table->data_capacity) {
+        uint64_t capacity = table->data_capacity < 256 ? 256 : table->data_capacity;
+        while (capacity < (uint64_t)table->total_size + length) {
+            capacity *= 2;
+        }
+        if (capacity > UINT32_MAX) return false;
+        char* data;
+        if (table->data_capacity < table->total_size) {
+            data = malloc(capacity);
+            if (data) memcpy(data, table->data, table->total_size);
+        } else {
+            data = realloc(table->data, capacity);
+        }
+        if (!data) return false;
+        table->data = data;
+        table->data_capacity = (uint32_t)capacity;
+    }
+    return true;
+}
+
+// Append a string that is not in the table and index it
+static uint32_t string_table_append(StringTable* table, const char* str, size_t length, uint32_t hash) {
+    if (!string_table_reserve(table, length + 1)) return 0;
     
-    // Add string data
-    strcpy(table->data + table->total_size, str);
+    memcpy(table->data + table->total_size, str, length);
+    table->data[table->total_size + length] = '\0';
     
-    // Add entry
-    table->entries[table->count].offset = table->total_size;
-    table->entries[table->count].length = len - 1; // Exclude null terminator
-    table->entries[table->count].hash = string_hash(str);
+    StringEntry* entry = &table->entries[table->count];
+    entry->offset = table->total_size;
+    entry->length = (uint32_t)length;
+    entry->hash = hash;
     
     uint32_t index = table->count;
     table->count++;
-    table->total_size += len;
+    table->total_size += length + 1;
     
+    // Keep the index at most half full; a borrowed index is replaced
+    if (!table->index_owned || (uint64_t)table->count * 2 > table->index_size) {
+        string_table_rehash(table, string_table_index_size_for(table->count));
+    } else {
+        string_table_index_insert(table, index);
+    }
     return index;
 }
 
+uint32_t string_table_add_string(StringTable* table, const char* str) {
+    if (!table || !str) {
+        return 0;
+    }
+    
+    return string_table_add_string_with_length(table, str, strlen(str));
+}
+
 uint32_t string_table_add_string_with_length(StringTable* table, const char* str, size_t length) {
     if (!table || !str) return 0;
     
     // Check if string already exists
-    for (uint32_t i = 0; i < table->count; i++) {
-        if (table->entries[i].length == length &&
-            strncmp(table->data + table->entries[i].offset, str, length) == 0) {
-            return i;
-        }
+    uint32_t hash = string_hash_with_length(str, length);
+    int32_t existing = string_table_lookup(table, str, length, hash);
+    if (existing >= 0) {
+        return (uint32_t)existing;
     }
     
-    // Add new string
-    size_t len = length + 1; // Include null terminator
-    
-    // Resize data buffer
-    char* new_data = realloc(table->data, table->total_size + len);
-    if (!new_data) return 0;
-    
-    table->data = new_data;
-    
-    // Resize entries array
-    StringEntry* new_entries = realloc(table->entries, (table->count + 1) * sizeof(StringEntry));
-    if (!new_entries) return 0;
-    
-    table->entries = new_entries;
-    
-    // Add string data
-    memcpy(table->data + table->total_size, str, length);
-    table->data[table->total_size + length] = '\0'; // Null terminate
-    
-    // Add entry
-    table->entries[table->count].offset = table->total_size;
-    table->entries[table->count].length = length;
-    table->entries[table->count].hash = string_hash(str);
-    
-    uint32_t index = table->count;
-    table->count++;
-    table->total_size += len;
-    
-    return index;
+    return string_table_append(table, str, length, hash);
 }
 
 const char* string_table_get_string(StringTable* table, uint32_t index) {
@@ -512,13 +580,8 @@ const char* string_table_get_string(StringTable* table, uint32_t index) {
 int32_t string_table_find_string(StringTable* table, const char* str) {
     if (!table || !str) return -1;
     
-    for (uint32_t i = 0; i < table->count; i++) {
-        if (strcmp(table->data + table->entries[i].offset, str) == 0) {
-            return i;
-        }
-    }
-    
-    return -1;
+    size_t length = strlen(str);
+    return string_table_lookup(table, str, length, string_hash_with_length(str, length));
 }
 
 // ============================================================================
@@ -724,11 +787,14 @@ int32_t field_table_find_field(FieldTable* table, uint32_t type_id, const char*
 uint32_t string_hash(const char* str) {
     if (!str) return 0;
     
+    return string_hash_with_length(str, strlen(str));
+}
+
+uint32_t string_hash_with_length(const char* str, size_t length) {
     uint32_t hash = 5381;
-    int c;
     
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+    for (size_t i = 0; i < length; i++) {
+        hash = ((hash << 5) + hash) + (uint32_t)(int)str[i]; // hash * 33 + c
     }
     
     return hash;
@@ -1,8 +1,13 @@
 #include "../../shared/bytecode/helium_format.h"
 #include "../../shared/stdlib/sys.h"
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // Create a new helium module
 HeliumModule* helium_module_create(void) {
@@ -29,14 +34,69 @@ HeliumModule* helium_module_create(void) {
     module->string_table_size = 0;
     module->bytecode = NULL;
     module->bytecode_size = 0;
+    module->image = NULL;
+    module->image_size = 0;
+    module->image_mapped = false;
+    module->image_borrowed = false;
+    module->link_index = NULL;
+    module->link_index_size = 0;
     
     return module;
 }
 
+// Whether `ptr` points into the module's file image
+static bool helium_module_in_image(const HeliumModule* module, const void* ptr) {
+    uintptr_t start = (uintptr_t)module->image;
+    return module->image && (uintptr_t)ptr >= start && (uintptr_t)ptr < start + module->image_size;
+}
+
+// Detach the tables from the file image and release it
+static void helium_module_release_image(HeliumModule* module) {
+    if (!module->image) return;
+    
+    if (module->string_table_obj) {
+        if (helium_module_in_image(module, module->string_table_obj->entries)) module->string_table_obj->entries = NULL;
+        if (helium_module_in_image(module, module->string_table_obj->data)) module->string_table_obj->data = NULL;
+        if (!module->string_table_obj->index_owned) module->string_table_obj->index = NULL;
+    }
+    if (module->constant_table && helium_module_in_image(module, module->constant_table->entries)) {
+        module->constant_table->entries = NULL;
+    }
+    if (module->type_table && helium_module_in_image(module, module->type_table->entries)) {
+        module->type_table->entries = NULL;
+    }
+    if (module->method_table && helium_module_in_image(module, module->method_table->entries)) {
+        module->method_table->entries = NULL;
+    }
+    if (module->field_table && helium_module_in_image(module, module->field_table->entries)) {
+        module->field_table->entries = NULL;
+    }
+    if (helium_module_in_image(module, module->bytecode)) {
+        module->bytecode = NULL;
+    }
+    if (helium_module_in_image(module, module->link_index)) {
+        module->link_index = NULL;
+        module->link_index_size = 0;
+    }
+    
+    if (module->image_borrowed) {
+        // Owned by whoever passed it to helium_module_load_image
+    } else if (module->image_mapped) {
+        munmap(module->image, module->image_size);
+    } else {
+        free(module->image);
+    }
+    module->image = NULL;
+    module->image_size = 0;
+}
+
 // Destroy helium module
 void helium_module_destroy(HeliumModule* module) {
     if (!module) return;
     
+    helium_module_release_image(module);
+    helium_module_discard_link_index(module);
+    
     if (module->string_table) {
         free(module->string_table);
     }
@@ -68,383 +128,476 @@ void helium_module_destroy(HeliumModule* module) {
     free(module);
 }
 
-// Save helium module to file
+// Version 2 sections of a module being saved
+typedef struct HeliumSaveSection {
+    HeliumSection section;            // Directory entry
+    const void* data;                 // Contents
+} HeliumSaveSection;
+
+static void helium_save_section(HeliumSaveSection* sections, uint32_t* count, HeliumSectionKind kind,
+                                uint32_t record_size, uint32_t records, uint32_t alignment, const void* data) {
+    if (records == 0 || !data) return;
+    HeliumSaveSection* entry = &sections[(*count)++];
+    memset(&entry->section, 0, sizeof(HeliumSection));
+    entry->section.kind = kind;
+    entry->section.record_size = record_size;
+    entry->section.count = records;
+    entry->section.alignment = alignment;
+    entry->section.size = (uint64_t)records * record_size;
+    entry->data = data;
+}
+
+// Write zero bytes up to `offset`
+static bool helium_save_pad(FILE* file, uint64_t* position, uint64_t offset) {
+    static const uint8_t zeros[HELIUM_BYTECODE_ALIGNMENT];
+    while (*position < offset) {
+        size_t n = offset - *position < sizeof(zeros) ? (size_t)(offset - *position) : sizeof(zeros);
+        if (fwrite(zeros, 1, n, file) != n) return false;
+        *position += n;
+    }
+    return true;
+}
+
+static bool helium_host_is_little_endian(void) {
+    uint32_t mark = HELIUM_BYTE_ORDER_MARK;
+    return *(const uint8_t*)&mark == 0x04;
+}
+
+// Save helium module to file (version 2 layout)
 bool helium_module_save(HeliumModule* module, const char* filename) {
     if (!module || !filename) return false;
     
-    FILE* file = fopen(filename, "wb");
-    if (!file) return false;
+    // Version 2 modules are little-endian
+    if (!helium_host_is_little_endian()) return false;
     
-    // Calculate offsets
-    size_t current_offset = sizeof(HeliumHeader);
-    
-    // String table offset
-    module->header.string_table_offset = current_offset;
+    HeliumSaveSection sections[HELIUM_SECTION_KIND_COUNT];
+    uint32_t section_count = 0;
     if (module->string_table_obj) {
-        module->header.string_table_size = 
-            sizeof(uint32_t) * 2 + 
-            sizeof(StringEntry) * module->string_table_obj->count + 
-            module->string_table_obj->total_size;
-        current_offset += module->header.string_table_size;
-    }
-    
-    // Constant table offset
-    module->header.constant_table_offset = current_offset;
+        // Persist the string index so loading does not rebuild it
+        string_table_build_index(module->string_table_obj);
+        helium_save_section(sections, &section_count, HELIUM_SECTION_STRING_ENTRIES, sizeof(StringEntry),
+                            module->string_table_obj->count, HELIUM_SECTION_ALIGNMENT,
+                            module->string_table_obj->entries);
+        helium_save_section(sections, &section_count, HELIUM_SECTION_STRING_DATA, 1,
+                            module->string_table_obj->total_size, HELIUM_SECTION_ALIGNMENT,
+                            module->string_table_obj->data);
+        helium_save_section(sections, &section_count, HELIUM_SECTION_STRING_INDEX, sizeof(uint32_t),
+                            module->string_table_obj->index_size, HELIUM_SECTION_ALIGNMENT,
+                            module->string_table_obj->index);
+    }
+    helium_save_section(sections, &section_count, HELIUM_SECTION_LINK_INDEX, 1,
+                        module->link_index_size, HELIUM_SECTION_ALIGNMENT, module->link_index);
     if (module->constant_table) {
-        module->header.constant_table_size = 
-            sizeof(uint32_t) + 
-            sizeof(ConstantEntry) * module->constant_table->count;
-        current_offset += module->header.constant_table_size;
+        helium_save_section(sections, &section_count, HELIUM_SECTION_CONSTANTS, sizeof(ConstantEntry),
+                            module->constant_table->count, HELIUM_SECTION_ALIGNMENT,
+                            module->constant_table->entries);
     }
-    
-    // Type table offset
-    module->header.type_table_offset = current_offset;
     if (module->type_table) {
-        module->header.type_table_size = 
-            sizeof(uint32_t) + 
-            sizeof(TypeEntry) * module->type_table->count;
-        current_offset += module->header.type_table_size;
+        helium_save_section(sections, &section_count, HELIUM_SECTION_TYPES, sizeof(TypeEntry),
+                            module->type_table->count, HELIUM_SECTION_ALIGNMENT,
+                            module->type_table->entries);
     }
-    
-    // Method table offset
-    module->header.method_table_offset = current_offset;
     if (module->method_table) {
-        module->header.method_table_size = 
-            sizeof(uint32_t) + 
-            sizeof(MethodEntry) * module->method_table->count;
-        current_offset += module->header.method_table_size;
+        helium_save_section(sections, &section_count, HELIUM_SECTION_METHODS, sizeof(MethodEntry),
+                            module->method_table->count, HELIUM_SECTION_ALIGNMENT,
+                            module->method_table->entries);
     }
-    
-    // Field table offset
-    module->header.field_table_offset = current_offset;
     if (module->field_table) {
-        module->header.field_table_size = 
-            sizeof(uint32_t) + 
-            sizeof(FieldEntry) * module->field_table->count;
-        current_offset += module->header.field_table_size;
+        helium_save_section(sections, &section_count, HELIUM_SECTION_FIELDS, sizeof(FieldEntry),
+                            module->field_table->count, HELIUM_SECTION_ALIGNMENT,
+                            module->field_table->entries);
+    }
+    helium_save_section(sections, &section_count, HELIUM_SECTION_BYTECODE, 1,
+                        module->bytecode_size, HELIUM_BYTECODE_ALIGNMENT, module->bytecode);
+    
+    // Header, directory, then each section at its alignment
+    HeliumHeaderV2 header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HELIUM_MAGIC, sizeof(HELIUM_MAGIC));
+    header.version_major = HELIUM_VERSION_MAJOR;
+    header.version_minor = HELIUM_VERSION_MINOR;
+    header.flags = module->header.flags;
+    header.module_name_offset = module->header.module_name_offset;
+    header.module_version_offset = module->header.module_version_offset;
+    header.byte_order = HELIUM_BYTE_ORDER_MARK;
+    header.header_size = sizeof(HeliumHeaderV2);
+    header.entry_point_method_id = module->header.entry_point_method_id;
+    header.section_count = section_count;
+    header.section_directory_offset = sizeof(HeliumHeaderV2);
+    
+    uint64_t offset = header.section_directory_offset + (uint64_t)section_count * sizeof(HeliumSection);
+    for (uint32_t i = 0; i < section_count; i++) {
+        uint64_t alignment = sections[i].section.alignment;
+        offset = (offset + alignment - 1) & ~(alignment - 1);
+        sections[i].section.offset = offset;
+        offset += sections[i].section.size;
+    }
+    if (offset > UINT32_MAX) return false;
+    
+    FILE* file = fopen(filename, "wb");
+    if (!file) return false;
+    
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (uint32_t i = 0; ok && i < section_count; i++) {
+        ok = fwrite(&sections[i].section, sizeof(HeliumSection), 1, file) == 1;
+    }
+    uint64_t position = header.section_directory_offset + (uint64_t)section_count * sizeof(HeliumSection);
+    for (uint32_t i = 0; ok && i < section_count; i++) {
+        ok = helium_save_pad(file, &position, sections[i].section.offset) &&
+             fwrite(sections[i].data, 1, sections[i].section.size, file) == sections[i].section.size;
+        position += sections[i].section.size;
     }
     
-    // Bytecode offset
-    module->header.bytecode_offset = current_offset;
-    module->header.bytecode_size = module->bytecode_size;
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+// Map a module file read-only, or read it into memory when it cannot be
+// mapped. Returns NULL if the file cannot be opened or read.
+static void* helium_module_map_file(const char* filename, size_t* size, bool* mapped) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
     
-    // Write header
-    if (fwrite(&module->header, sizeof(HeliumHeader), 1, file) != 1) {
-        fclose(file);
-        return false;
+    void* image = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (image != MAP_FAILED) {
+        *mapped = true;
+        close(fd);
+        return image;
     }
     
-    // Write string table
-    if (module->string_table_obj && module->header.string_table_size > 0) {
-        if (fwrite(&module->string_table_obj->count, sizeof(uint32_t), 1, file) != 1) {
-            fclose(file);
-            return false;
-        }
-        
-        if (fwrite(&module->string_table_obj->total_size, sizeof(uint32_t), 1, file) != 1) {
-            fclose(file);
-            return false;
-        }
-        
-        if (fwrite(module->string_table_obj->entries, sizeof(StringEntry), module->string_table_obj->count, file) != module->string_table_obj->count) {
-            fclose(file);
-            return false;
-        }
-        
-        if (fwrite(module->string_table_obj->data, 1, module->string_table_obj->total_size, file) != module->string_table_obj->total_size) {
-            fclose(file);
-            return false;
+    // Fall back to a private copy
+    image = malloc(*size);
+    size_t done = 0;
+    while (image && done < *size) {
+        ssize_t n = read(fd, (char*)image + done, *size - done);
+        if (n <= 0) {
+            free(image);
+            image = NULL;
+            break;
         }
+        done += (size_t)n;
     }
+    *mapped = false;
+    close(fd);
+    return image;
+}
+
+// Locate the `count` entries of a table section: a uint32_t count followed,
+// after `prefix` bytes in all, by the entries. Entries aligned for their
+// type are used in place; others (modules saved before sections were
+// aligned) are copied. Fails if the section does not fit in the image.
+static bool helium_module_load_entries(HeliumModule* module, uint32_t offset, uint32_t size, size_t prefix,
+                                       size_t entry_size, size_t alignment, uint32_t* count, void** entries) {
+    *count = 0;
+    *entries = NULL;
+    if (size == 0) return true;
+    
+    const uint8_t* image = module->image;
+    if ((uint64_t)offset + size > module->image_size || size < prefix) {
+        return false;
+    }
+    memcpy(count, image + offset, sizeof(uint32_t));
+    if ((uint64_t)*count * entry_size > size - prefix) {
+        *count = 0;
+        return false;
+    }
+    if (*count == 0) return true;
     
-    // Write constant table
-    if (module->constant_table && module->header.constant_table_size > 0) {
-        if (fwrite(&module->constant_table->count, sizeof(uint32_t), 1, file) != 1) {
-            fclose(file);
-            return false;
-        }
-        
-        if (fwrite(module->constant_table->entries, sizeof(ConstantEntry), module->constant_table->count, file) != module->constant_table->count) {
-            fclose(file);
-            return false;
-        }
+    const uint8_t* first = image + offset + prefix;
+    if ((uintptr_t)first % alignment == 0) {
+        *entries = (void*)first;
+        return true;
+    }
+    *entries = malloc(*count * entry_size);
+    if (!*entries) return false;
+    memcpy(*entries, first, *count * entry_size);
+    return true;
+}
+
+// Check that a link index describes this module's tables: its counts match
+// them, and every range and table index lies inside them
+static bool helium_module_check_link_index(HeliumModule* module) {
+    const HeliumLinkHeader* index = module->link_index;
+    if (module->link_index_size < sizeof(HeliumLinkHeader) ||
+        index->type_count != module->type_table->count ||
+        index->method_count != module->method_table->count ||
+        index->field_count != module->field_table->count ||
+        module->link_index_size != sizeof(HeliumLinkHeader) +
+            (uint64_t)index->type_count * sizeof(HeliumLinkType) +
+            (uint64_t)index->method_count * sizeof(HeliumLinkMember) +
+            (uint64_t)index->field_count * sizeof(HeliumLinkField)) {
+        return false;
     }
     
-    // Write type table
-    if (module->type_table && module->header.type_table_size > 0) {
-        if (fwrite(&module->type_table->count, sizeof(uint32_t), 1, file) != 1) {
-            fclose(file);
+    const HeliumLinkType* types = HELIUM_LINK_TYPES(index);
+    for (uint32_t i = 0; i < index->type_count; i++) {
+        if ((uint64_t)types[i].first_method + types[i].method_count > index->method_count ||
+            (uint64_t)types[i].first_field + types[i].field_count > index->field_count) {
             return false;
         }
-        
-        if (fwrite(module->type_table->entries, sizeof(TypeEntry), module->type_table->count, file) != module->type_table->count) {
-            fclose(file);
+    }
+    const HeliumLinkMember* methods = HELIUM_LINK_METHODS(index);
+    for (uint32_t i = 0; i < index->method_count; i++) {
+        if (methods[i].table_index >= index->method_count) return false;
+    }
+    const HeliumLinkField* fields = HELIUM_LINK_FIELDS(index);
+    for (uint32_t i = 0; i < index->field_count; i++) {
+        if (fields[i].table_index >= index->field_count) return false;
+    }
+    return true;
+}
+
+// Check that strings, string constants and method bodies lie inside their
+// sections, and that the string and link indexes only name existing
+// entries, so the VM can use offsets from the file without rechecking them
+static bool helium_module_check_references(HeliumModule* module) {
+    StringTable* strings = module->string_table_obj;
+    if (strings->total_size > 0 && strings->data[strings->total_size - 1] != '\0') {
+        return false;
+    }
+    for (uint32_t i = 0; i < strings->count; i++) {
+        if ((uint64_t)strings->entries[i].offset + strings->entries[i].length >= strings->total_size) {
             return false;
         }
     }
-    
-    // Write method table
-    if (module->method_table && module->header.method_table_size > 0) {
-        if (fwrite(&module->method_table->count, sizeof(uint32_t), 1, file) != 1) {
-            fclose(file);
+    if (strings->index) {
+        if ((strings->index_size & (strings->index_size - 1)) != 0) {
             return false;
         }
-        
-        if (fwrite(module->method_table->entries, sizeof(MethodEntry), module->method_table->count, file) != module->method_table->count) {
-            fclose(file);
+        for (uint32_t i = 0; i < strings->index_size; i++) {
+            if (strings->index[i] > strings->count) {
+                return false;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < module->constant_table->count; i++) {
+        const ConstantEntry* constant = &module->constant_table->entries[i];
+        if (constant->type == CONSTANT_TYPE_STRING && constant->value.string_offset >= strings->total_size) {
             return false;
         }
     }
-    
-    // Write field table
-    if (module->field_table && module->header.field_table_size > 0) {
-        if (fwrite(&module->field_table->count, sizeof(uint32_t), 1, file) != 1) {
-            fclose(file);
+    for (uint32_t i = 0; i < module->method_table->count; i++) {
+        const MethodEntry* method = &module->method_table->entries[i];
+        if ((uint64_t)method->bytecode_offset + method->bytecode_size > module->bytecode_size) {
             return false;
         }
-        
-        if (fwrite(module->field_table->entries, sizeof(FieldEntry), module->field_table->count, file) != module->field_table->count) {
-            fclose(file);
+    }
+    return !module->link_index || helium_module_check_link_index(module);
+}
+
+// Read the tables of a version 1 module from the image
+static bool helium_module_load_v1(HeliumModule* module) {
+    if (module->image_size < sizeof(HeliumHeader)) return false;
+    memcpy(&module->header, module->image, sizeof(HeliumHeader));
+    
+    // Tables
+    StringTable* strings = module->string_table_obj;
+    uint32_t string_prefix = sizeof(uint32_t) * 2;
+    bool ok =
+        helium_module_load_entries(module, module->header.string_table_offset, module->header.string_table_size,
+                                   string_prefix, sizeof(StringEntry), __alignof__(StringEntry),
+                                   &strings->count, (void**)&strings->entries) &&
+        helium_module_load_entries(module, module->header.constant_table_offset, module->header.constant_table_size,
+                                   sizeof(uint32_t), sizeof(ConstantEntry), __alignof__(ConstantEntry),
+                                   &module->constant_table->count, (void**)&module->constant_table->entries) &&
+        helium_module_load_entries(module, module->header.type_table_offset, module->header.type_table_size,
+                                   sizeof(uint32_t), sizeof(TypeEntry), __alignof__(TypeEntry),
+                                   &module->type_table->count, (void**)&module->type_table->entries) &&
+        helium_module_load_entries(module, module->header.method_table_offset, module->header.method_table_size,
+                                   sizeof(uint32_t), sizeof(MethodEntry), __alignof__(MethodEntry),
+                                   &module->method_table->count, (void**)&module->method_table->entries) &&
+        helium_module_load_entries(module, module->header.field_table_offset, module->header.field_table_size,
+                                   sizeof(uint32_t), sizeof(FieldEntry), __alignof__(FieldEntry),
+                                   &module->field_table->count, (void**)&module->field_table->entries);
+    if (!ok) return false;
+    if (!helium_module_in_image(module, strings->entries)) {
+        strings->entry_capacity = strings->count;
+    }
+    
+    // String data follows the string entries
+    if (module->header.string_table_size > 0) {
+        const char* section = (const char*)module->image + module->header.string_table_offset;
+        uint64_t data_offset = string_prefix + (uint64_t)strings->count * sizeof(StringEntry);
+        memcpy(&strings->total_size, section + sizeof(uint32_t), sizeof(uint32_t));
+        if (data_offset + strings->total_size > module->header.string_table_size) {
             return false;
         }
+        strings->data = (char*)section + data_offset;
     }
     
-    // Write bytecode
-    if (module->bytecode && module->header.bytecode_size > 0) {
-        if (fwrite(module->bytecode, 1, module->header.bytecode_size, file) != module->header.bytecode_size) {
-            fclose(file);
+    // Bytecode
+    if (module->header.bytecode_size > 0) {
+        if ((uint64_t)module->header.bytecode_offset + module->header.bytecode_size > module->image_size) {
             return false;
         }
+        module->bytecode = (uint8_t*)module->image + module->header.bytecode_offset;
+        module->bytecode_size = module->header.bytecode_size;
     }
-    
-    fclose(file);
     return true;
 }
 
-// Load helium module from file
-HeliumModule* helium_module_load(const char* filename) {
-    if (!filename) return NULL;
-    
-    FILE* file = fopen(filename, "rb");
-    if (!file) return NULL;
-    
-    HeliumModule* module = malloc(sizeof(HeliumModule));
-    if (!module) {
-        fclose(file);
-        return NULL;
-    }
-    
-    // Read header
-    if (fread(&module->header, sizeof(HeliumHeader), 1, file) != 1) {
-        free(module);
-        fclose(file);
-        return NULL;
+// Point the tables of a version 2 module at their sections. Every section
+// must be aligned, lie inside the image and hold records of the expected
+// size; there is no per-table parsing or copying.
+static bool helium_module_load_v2(HeliumModule* module) {
+    if (module->image_size < sizeof(HeliumHeaderV2)) return false;
+    const uint8_t* image = module->image;
+    const HeliumHeaderV2* header = (const HeliumHeaderV2*)image;
+    
+    if (header->byte_order != HELIUM_BYTE_ORDER_MARK) {
+        fprintf(stderr, "Module byte order does not match this host\n");
+        return false;
     }
-    
-    // Validate magic number
-    if (strncmp(module->header.magic, HELIUM_MAGIC, 7) != 0) {
-        free(module);
-        fclose(file);
-        return NULL;
+    if (header->header_size < sizeof(HeliumHeaderV2) || header->header_size > module->image_size ||
+        header->section_directory_offset % __alignof__(HeliumSection) != 0 ||
+        header->section_directory_offset > module->image_size ||
+        (uint64_t)header->section_count * sizeof(HeliumSection) > module->image_size - header->section_directory_offset) {
+        return false;
     }
     
-    // Load string table
-    if (module->header.string_table_size > 0) {
-        fseek(file, module->header.string_table_offset, SEEK_SET);
-        module->string_table_obj = string_table_create();
-        if (!module->string_table_obj) {
-            free(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(&module->string_table_obj->count, sizeof(uint32_t), 1, file) != 1) {
-            string_table_destroy(module->string_table_obj);
-            free(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(&module->string_table_obj->total_size, sizeof(uint32_t), 1, file) != 1) {
-            string_table_destroy(module->string_table_obj);
-            free(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        module->string_table_obj->entries = malloc(sizeof(StringEntry) * module->string_table_obj->count);
-        if (!module->string_table_obj->entries) {
-            string_table_destroy(module->string_table_obj);
-            free(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(module->string_table_obj->entries, sizeof(StringEntry), module->string_table_obj->count, file) != module->string_table_obj->count) {
-            string_table_destroy(module->string_table_obj);
-            free(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        module->string_table_obj->data = malloc(module->string_table_obj->total_size);
-        if (!module->string_table_obj->data) {
-            string_table_destroy(module->string_table_obj);
-            free(module);
-            fclose(file);
-            return NULL;
+    // The shared header fields
+    memset(&module->header, 0, sizeof(HeliumHeader));
+    memcpy(&module->header, header, offsetof(HeliumHeader, string_table_offset));
+    module->header.entry_point_method_id = header->entry_point_method_id;
+    
+    const HeliumSection* directory = (const HeliumSection*)(image + header->section_directory_offset);
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        const HeliumSection* section = &directory[i];
+        uint32_t record_size;
+        switch (section->kind) {
+            case HELIUM_SECTION_STRING_ENTRIES: record_size = sizeof(StringEntry); break;
+            case HELIUM_SECTION_STRING_INDEX:   record_size = sizeof(uint32_t); break;
+            case HELIUM_SECTION_CONSTANTS:      record_size = sizeof(ConstantEntry); break;
+            case HELIUM_SECTION_TYPES:          record_size = sizeof(TypeEntry); break;
+            case HELIUM_SECTION_METHODS:        record_size = sizeof(MethodEntry); break;
+            case HELIUM_SECTION_FIELDS:         record_size = sizeof(FieldEntry); break;
+            case HELIUM_SECTION_STRING_DATA:
+            case HELIUM_SECTION_BYTECODE:
+            case HELIUM_SECTION_LINK_INDEX:     record_size = 1; break;
+            default: continue;
+        }
+        if ((seen & (1u << section->kind)) || section->record_size != record_size ||
+            section->size != (uint64_t)section->count * record_size ||
+            section->alignment < HELIUM_SECTION_ALIGNMENT || (section->alignment & (section->alignment - 1)) ||
+            section->offset % section->alignment != 0 ||
+            section->offset > module->image_size || section->size > module->image_size - section->offset) {
+            return false;
         }
+        seen |= 1u << section->kind;
         
-        if (fread(module->string_table_obj->data, 1, module->string_table_obj->total_size, file) != module->string_table_obj->total_size) {
-            string_table_destroy(module->string_table_obj);
-            free(module);
-            fclose(file);
-            return NULL;
+        void* data = (void*)(image + section->offset);
+        switch (section->kind) {
+            case HELIUM_SECTION_STRING_ENTRIES:
+                module->string_table_obj->entries = data;
+                module->string_table_obj->count = section->count;
+                break;
+            case HELIUM_SECTION_STRING_DATA:
+                module->string_table_obj->data = data;
+                module->string_table_obj->total_size = section->count;
+                break;
+            case HELIUM_SECTION_STRING_INDEX:
+                module->string_table_obj->index = data;
+                module->string_table_obj->index_size = section->count;
+                break;
+            case HELIUM_SECTION_CONSTANTS:
+                module->constant_table->entries = data;
+                module->constant_table->count = section->count;
+                break;
+            case HELIUM_SECTION_TYPES:
+                module->type_table->entries = data;
+                module->type_table->count = section->count;
+                break;
+            case HELIUM_SECTION_METHODS:
+                module->method_table->entries = data;
+                module->method_table->count = section->count;
+                break;
+            case HELIUM_SECTION_FIELDS:
+                module->field_table->entries = data;
+                module->field_table->count = section->count;
+                break;
+            case HELIUM_SECTION_BYTECODE:
+                module->bytecode = data;
+                module->bytecode_size = section->count;
+                break;
+            case HELIUM_SECTION_LINK_INDEX:
+                module->link_index = data;
+                module->link_index_size = section->count;
+                break;
         }
-        
     }
-    
-    // Load constant table
-    if (module->header.constant_table_size > 0) {
-        fseek(file, module->header.constant_table_offset, SEEK_SET);
-        module->constant_table = constant_table_create();
-        if (!module->constant_table) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(&module->constant_table->count, sizeof(uint32_t), 1, file) != 1) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        module->constant_table->entries = malloc(sizeof(ConstantEntry) * module->constant_table->count);
-        if (!module->constant_table->entries) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(module->constant_table->entries, sizeof(ConstantEntry), module->constant_table->count, file) != module->constant_table->count) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
+    return true;
+}
+
+// Read the tables of a module whose image is set, validating them; the
+// module is destroyed if they are invalid
+static HeliumModule* helium_module_open_image(HeliumModule* module) {
+    // Validate magic number, then read the layout of the module's version
+    const HeliumHeader* header = module->image;
+    bool ok = module->image && module->image_size >= offsetof(HeliumHeader, module_name_offset) &&
+              strncmp(header->magic, HELIUM_MAGIC, 7) == 0;
+    if (ok) {
+        if (header->version_major == HELIUM_VERSION_MAJOR) {
+            ok = helium_module_load_v2(module);
+        } else if (header->version_major == HELIUM_VERSION_MAJOR_V1) {
+            ok = helium_module_load_v1(module);
+        } else {
+            ok = false;
+        }
+    }
+    
+    if (!ok || !helium_module_check_references(module)) {
+        helium_module_destroy(module);
+        return NULL;
     }
     
-    // Load type table
-    if (module->header.type_table_size > 0) {
-        fseek(file, module->header.type_table_offset, SEEK_SET);
-        module->type_table = type_table_create();
-        if (!module->type_table) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(&module->type_table->count, sizeof(uint32_t), 1, file) != 1) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        module->type_table->entries = malloc(sizeof(TypeEntry) * module->type_table->count);
-        if (!module->type_table->entries) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(module->type_table->entries, sizeof(TypeEntry), module->type_table->count, file) != module->type_table->count) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
+    return module;
+}
+
+static HeliumModule* helium_module_create_for_image(void) {
+    HeliumModule* module = helium_module_create();
+    if (!module) return NULL;
+    if (!module->string_table_obj || !module->constant_table || !module->type_table ||
+        !module->method_table || !module->field_table) {
+        helium_module_destroy(module);
+        return NULL;
     }
+    return module;
+}
+
+// Load helium module from file. The file is mapped read-only and the
+// tables, string data and bytecode point into the mapping, so processes
+// running the same module share its pages and loading does not copy it.
+HeliumModule* helium_module_load(const char* filename) {
+    if (!filename) return NULL;
     
-    // Load method table
-    if (module->header.method_table_size > 0) {
-        fseek(file, module->header.method_table_offset, SEEK_SET);
-        module->method_table = method_table_create();
-        if (!module->method_table) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(&module->method_table->count, sizeof(uint32_t), 1, file) != 1) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        module->method_table->entries = malloc(sizeof(MethodEntry) * module->method_table->count);
-        if (!module->method_table->entries) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(module->method_table->entries, sizeof(MethodEntry), module->method_table->count, file) != module->method_table->count) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-    }
+    HeliumModule* module = helium_module_create_for_image();
+    if (!module) return NULL;
     
-    // Load field table
-    if (module->header.field_table_size > 0) {
-        fseek(file, module->header.field_table_offset, SEEK_SET);
-        module->field_table = field_table_create();
-        if (!module->field_table) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(&module->field_table->count, sizeof(uint32_t), 1, file) != 1) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        module->field_table->entries = malloc(sizeof(FieldEntry) * module->field_table->count);
-        if (!module->field_table->entries) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(module->field_table->entries, sizeof(FieldEntry), module->field_table->count, file) != module->field_table->count) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-    }
+    module->image = helium_module_map_file(filename, &module->image_size, &module->image_mapped);
+    return helium_module_open_image(module);
+}
+
+// Load a module from a file image in memory, used in place like a mapped
+// file. The image is borrowed: it must outlive the module, which does not
+// release it.
+HeliumModule* helium_module_load_image(const void* image, size_t size) {
+    if (!image || size == 0) return NULL;
     
-    // Load bytecode
-    if (module->header.bytecode_size > 0) {
-        fseek(file, module->header.bytecode_offset, SEEK_SET);
-        module->bytecode = malloc(module->header.bytecode_size);
-        if (!module->bytecode) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        if (fread(module->bytecode, 1, module->header.bytecode_size, file) != module->header.bytecode_size) {
-            helium_module_destroy(module);
-            fclose(file);
-            return NULL;
-        }
-        
-        module->bytecode_size = module->header.bytecode_size;
-    }
+    HeliumModule* module = helium_module_create_for_image();
+    if (!module) return NULL;
     
-    fclose(file);
-    return module;
+    module->image = (void*)image;
+    module->image_size = size;
+    module->image_borrowed = true;
+    return helium_module_open_image(module);
 }
 
 // Validate helium module
@@ -497,10 +650,21 @@ uint32_t helium_module_add_string(HeliumModule* module, const char* str) {
     return module->string_table_obj->entries[index].offset;
 }
 
+// Offset of a string in the module's string table, or UINT32_MAX
+uint32_t helium_module_find_string(HeliumModule* module, const char* str) {
+    if (!module || !str) return UINT32_MAX;
+    
+    int32_t index = string_table_find_string(module->string_table_obj, str);
+    if (index < 0) return UINT32_MAX;
+    return module->string_table_obj->entries[index].offset;
+}
+
 // Add type to module
 uint32_t helium_module_add_type(HeliumModule* module, const char* name, const char* module_name) {
     if (!module || !name || !module->type_table) return 0;
     
+    helium_module_discard_link_index(module);
+    
     TypeEntry type_entry;
     type_entry.type_id = module->type_table->count + 1; // Assign next available ID
     type_entry.name_offset = helium_module_add_string(module, name);
@@ -523,6 +687,8 @@ uint32_t helium_module_add_type(HeliumModule* module, const char* name, const ch
 uint32_t helium_module_add_method(HeliumModule* module, const char* name, const char* signature, uint32_t type_id, bool is_static) {
     if (!module || !name || !signature || !module->method_table) return 0;
     
+    helium_module_discard_link_index(module);
+    
     MethodEntry method_entry;
     method_entry.method_id = module->method_table->count + 1; // Assign next available ID
     method_entry.type_id = type_id;
@@ -610,3 +776,155 @@ void helium_module_print_info(HeliumModule* module) {
     printf("  Bytecode Size: %u bytes\n", module->bytecode_size);
     printf("  Entry Point: Method %u\n", module->header.entry_point_method_id);
 }
+
+// Bytes of object storage for a field of the given type (see the
+// FIELD_TYPE_* storage kinds of the VM: booleans take one byte, integers,
+// floats and references eight)
+uint32_t helium_field_size(uint32_t field_type_id) {
+    return field_type_id == 3 ? 1 : 8;
+}
+
+void helium_module_discard_link_index(HeliumModule* module) {
+    if (!module || !module->link_index) return;
+    
+    if (!helium_module_in_image(module, module->link_index)) {
+        free(module->link_index);
+    }
+    module->link_index = NULL;
+    module->link_index_size = 0;
+}
+
+static uint32_t helium_link_name_hash(HeliumModule* module, uint32_t name_offset) {
+    const char* name = helium_module_get_string(module, name_offset);
+    return name ? string_hash(name) : 0;
+}
+
+// Largest ID in a table of `count` records of `record_size` bytes whose
+// first field is the ID
+static uint32_t helium_link_max_id(const void* entries, uint32_t count, size_t record_size) {
+    uint32_t max_id = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t id;
+        memcpy(&id, (const char*)entries + i * record_size, sizeof(uint32_t));
+        if (id > max_id) max_id = id;
+    }
+    return max_id;
+}
+
+// Group the indexes of `count` members by owning type: `owners` gives each
+// member's type position (type_count = no owner in the table), `first` and
+// `counts` receive each type's range, and `order` the member indexes
+static void helium_link_group(const uint32_t* owners, uint32_t count, uint32_t type_count,
+                              uint32_t* first, uint32_t* counts, uint32_t* order) {
+    memset(counts, 0, (type_count + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        counts[owners[i]]++;
+    }
+    uint32_t position = 0;
+    for (uint32_t t = 0; t <= type_count; t++) {
+        first[t] = position;
+        position += counts[t];
+    }
+    uint32_t* cursor = first + type_count + 1;
+    memcpy(cursor, first, (type_count + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        order[cursor[owners[i]]++] = i;
+    }
+}
+
+// Build the link index the VM adopts instead of discovering the tables at
+// load. The packager calls this once the tables are final.
+bool helium_module_build_link_index(HeliumModule* module) {
+    if (!module || !module->type_table || !module->method_table || !module->field_table) return false;
+    helium_module_discard_link_index(module);
+    
+    TypeTable* types = module->type_table;
+    MethodTable* methods = module->method_table;
+    FieldTable* fields = module->field_table;
+    uint32_t max_type_id = helium_link_max_id(types->entries, types->count, sizeof(TypeEntry));
+    if (max_type_id > types->count + 4096) return false;
+    
+    size_t size = sizeof(HeliumLinkHeader) + (size_t)types->count * sizeof(HeliumLinkType) +
+                  (size_t)methods->count * sizeof(HeliumLinkMember) +
+                  (size_t)fields->count * sizeof(HeliumLinkField);
+    if (size > UINT32_MAX) return false;
+    
+    // Scratch: type ID -> type position, member owners, ranges and order
+    uint32_t members = methods->count > fields->count ? methods->count : fields->count;
+    uint32_t* positions = malloc(((size_t)max_type_id + 1) * sizeof(uint32_t));
+    uint32_t* owners = malloc(((size_t)members + 1) * sizeof(uint32_t));
+    uint32_t* order = malloc(((size_t)members + 1) * sizeof(uint32_t));
+    uint32_t* method_first = malloc(((size_t)types->count + 1) * 2 * sizeof(uint32_t));
+    uint32_t* method_counts = malloc(((size_t)types->count + 1) * sizeof(uint32_t));
+    uint32_t* field_first = malloc(((size_t)types->count + 1) * 2 * sizeof(uint32_t));
+    uint32_t* field_counts = malloc(((size_t)types->count + 1) * sizeof(uint32_t));
+    HeliumLinkHeader* index = calloc(1, size);
+    bool ok = positions && owners && order && method_first && method_counts && field_first && field_counts && index;
+    
+    if (ok) {
+        index->type_count = types->count;
+        index->method_count = methods->count;
+        index->field_count = fields->count;
+        index->max_type_id = max_type_id;
+        index->max_method_id = helium_link_max_id(methods->entries, methods->count, sizeof(MethodEntry));
+        index->max_field_id = helium_link_max_id(fields->entries, fields->count, sizeof(FieldEntry));
+        
+        for (uint32_t id = 0; id <= max_type_id; id++) {
+            positions[id] = types->count;
+        }
+        for (uint32_t t = types->count; t > 0; t--) {
+            positions[types->entries[t - 1].type_id] = t - 1;
+        }
+        
+        // Methods grouped by owning type
+        HeliumLinkMember* method_records = (HeliumLinkMember*)HELIUM_LINK_METHODS(index);
+        for (uint32_t i = 0; i < methods->count; i++) {
+            uint32_t type_id = methods->entries[i].type_id;
+            owners[i] = type_id <= max_type_id ? positions[type_id] : types->count;
+        }
+        helium_link_group(owners, methods->count, types->count, method_first, method_counts, order);
+        for (uint32_t i = 0; i < methods->count; i++) {
+            method_records[i].table_index = order[i];
+            method_records[i].name_hash = helium_link_name_hash(module, methods->entries[order[i]].name_offset);
+        }
+        
+        // Fields grouped by owning type, with their storage
+        HeliumLinkField* field_records = (HeliumLinkField*)HELIUM_LINK_FIELDS(index);
+        for (uint32_t i = 0; i < fields->count; i++) {
+            uint32_t type_id = fields->entries[i].type_id;
+            owners[i] = type_id <= max_type_id ? positions[type_id] : types->count;
+        }
+        helium_link_group(owners, fields->count, types->count, field_first, field_counts, order);
+        for (uint32_t i = 0; i < fields->count; i++) {
+            const FieldEntry* field = &fields->entries[order[i]];
+            field_records[i].table_index = order[i];
+            field_records[i].name_hash = helium_link_name_hash(module, field->name_offset);
+            field_records[i].offset = field->offset;
+            field_records[i].size = helium_field_size(field->field_type_id);
+            field_records[i].flags = field->flags;
+        }
+        
+        HeliumLinkType* type_records = (HeliumLinkType*)HELIUM_LINK_TYPES(index);
+        for (uint32_t t = 0; t < types->count; t++) {
+            type_records[t].name_hash = helium_link_name_hash(module, types->entries[t].name_offset);
+            type_records[t].first_method = method_first[t];
+            type_records[t].method_count = method_counts[t];
+            type_records[t].first_field = field_first[t];
+            type_records[t].field_count = field_counts[t];
+        }
+        
+        module->link_index = index;
+        module->link_index_size = (uint32_t)size;
+    } else {
+        free(index);
+    }
+    
+    free(positions);
+    free(owners);
+    free(order);
+    free(method_first);
+    free(method_counts);
+    free(field_first);
+    free(field_counts);
+    return ok;
+}
@@ -24,6 +24,7 @@ const char* opcode_get_name(uint8_t opcode) {
         case OP_PUSH_FLOAT64: return "PUSH_FLOAT64";
         case OP_PUSH_STRING: return "PUSH_STRING";
         case OP_PUSH_CONSTANT: return "PUSH_CONSTANT";
+        case OP_PUSH_CONSTANT_S: return "PUSH_CONSTANT_S";
         case OP_POP: return "POP";
         case OP_DUP: return "DUP";
         case OP_SWAP: return "SWAP";
@@ -49,16 +50,30 @@ const char* opcode_get_name(uint8_t opcode) {
         case OP_JUMP_IF_FALSE: return "JUMP_IF_FALSE";
         case OP_JUMP_IF_NULL: return "JUMP_IF_NULL";
         case OP_JUMP_IF_NOT_NULL: return "JUMP_IF_NOT_NULL";
+        case OP_JUMP_S: return "JUMP_S";
+        case OP_JUMP_IF_TRUE_S: return "JUMP_IF_TRUE_S";
+        case OP_JUMP_IF_FALSE_S: return "JUMP_IF_FALSE_S";
         case OP_CALL: return "CALL";
         case OP_CALL_VIRTUAL: return "CALL_VIRTUAL";
         case OP_CALL_STATIC: return "CALL_STATIC";
         case OP_CALL_INTERFACE: return "CALL_INTERFACE";
         case OP_RETURN: return "RETURN";
         case OP_RETURN_VALUE: return "RETURN_VALUE";
+        case OP_CALL_STATIC_S: return "CALL_STATIC_S";
         case OP_LOAD_LOCAL: return "LOAD_LOCAL";
         case OP_STORE_LOCAL: return "STORE_LOCAL";
         case OP_LOAD_ARG: return "LOAD_ARG";
         case OP_STORE_ARG: return "STORE_ARG";
+        case OP_LOAD_LOCAL_0: return "LOAD_LOCAL_0";
+        case OP_LOAD_LOCAL_1: return "LOAD_LOCAL_1";
+        case OP_LOAD_LOCAL_2: return "LOAD_LOCAL_2";
+        case OP_LOAD_LOCAL_3: return "LOAD_LOCAL_3";
+        case OP_STORE_LOCAL_0: return "STORE_LOCAL_0";
+        case OP_STORE_LOCAL_1: return "STORE_LOCAL_1";
+        case OP_STORE_LOCAL_2: return "STORE_LOCAL_2";
+        case OP_STORE_LOCAL_3: return "STORE_LOCAL_3";
+        case OP_LOAD_LOCAL_S: return "LOAD_LOCAL_S";
+        case OP_STORE_LOCAL_S: return "STORE_LOCAL_S";
         case OP_LOAD_GLOBAL: return "LOAD_GLOBAL";
         case OP_STORE_GLOBAL: return "STORE_GLOBAL";
         case OP_NEW_OBJECT: return "NEW_OBJECT";
@@ -78,6 +93,11 @@ const char* opcode_get_name(uint8_t opcode) {
         case OP_STRING_CONCAT: return "STRING_CONCAT";
         case OP_STRING_SUBSTRING: return "STRING_SUBSTRING";
         case OP_STRING_INDEX_OF: return "STRING_INDEX_OF";
+        case OP_STRING_BUILDER_NEW: return "STRING_BUILDER_NEW";
+        case OP_STRING_BUILDER_APPEND: return "STRING_BUILDER_APPEND";
+        case OP_STRING_BUILDER_TO_STRING: return "STRING_BUILDER_TO_STRING";
+        case OP_STRING_EQUALS_IGNORE_CASE: return "STRING_EQUALS_IGNORE_CASE";
+        case OP_STRING_INDEX_OF_IGNORE_CASE: return "STRING_INDEX_OF_IGNORE_CASE";
         case OP_PRINT: return "PRINT";
         case OP_PRINTLN: return "PRINTLN";
         case OP_READ_LINE: return "READ_LINE";
@@ -89,6 +109,7 @@ const char* opcode_get_name(uint8_t opcode) {
         case OP_MATCH: return "MATCH";
         case OP_MATCH_CASE: return "MATCH_CASE";
         case OP_MATCH_WHEN: return "MATCH_WHEN";
+        case OP_WIDE: return "WIDE";
         case OP_SECURE_CALL: return "SECURE_CALL";
         case OP_CHECK_PERMISSION: return "CHECK_PERMISSION";
         case OP_DOMAIN_CALL: return "DOMAIN_CALL";
@@ -134,6 +155,11 @@ uint8_t opcode_get_operand_count(uint8_t opcode) {
         case OP_STRING_CONCAT:
         case OP_STRING_SUBSTRING:
         case OP_STRING_INDEX_OF:
+        case OP_STRING_BUILDER_NEW:
+        case OP_STRING_BUILDER_APPEND:
+        case OP_STRING_BUILDER_TO_STRING:
+        case OP_STRING_EQUALS_IGNORE_CASE:
+        case OP_STRING_INDEX_OF_IGNORE_CASE:
         case OP_PRINT:
         case OP_PRINTLN:
         case OP_READ_LINE:
@@ -143,11 +169,27 @@ uint8_t opcode_get_operand_count(uint8_t opcode) {
         case OP_YIELD:
         case OP_BREAKPOINT:
         case OP_TRACE:
+        case OP_LOAD_LOCAL_0:
+        case OP_LOAD_LOCAL_1:
+        case OP_LOAD_LOCAL_2:
+        case OP_LOAD_LOCAL_3:
+        case OP_STORE_LOCAL_0:
+        case OP_STORE_LOCAL_1:
+        case OP_STORE_LOCAL_2:
+        case OP_STORE_LOCAL_3:
+        case OP_WIDE:
             return 0;
             
         // 1 byte operand
         case OP_PUSH_INT8:
         case OP_PUSH_UINT8:
+        case OP_PUSH_CONSTANT_S:
+        case OP_JUMP_S:
+        case OP_JUMP_IF_TRUE_S:
+        case OP_JUMP_IF_FALSE_S:
+        case OP_CALL_STATIC_S:
+        case OP_LOAD_LOCAL_S:
+        case OP_STORE_LOCAL_S:
             return 1;
             
         // 2 byte operand
@@ -222,8 +264,21 @@ bool opcode_has_operands(uint8_t opcode) {
     return opcode_get_operand_count(opcode) > 0;
 }
 
+uint8_t opcode_get_wide_form(uint8_t opcode) {
+    switch (opcode) {
+        case OP_PUSH_CONSTANT_S: return OP_PUSH_CONSTANT;
+        case OP_JUMP_S: return OP_JUMP;
+        case OP_JUMP_IF_TRUE_S: return OP_JUMP_IF_TRUE;
+        case OP_JUMP_IF_FALSE_S: return OP_JUMP_IF_FALSE;
+        case OP_CALL_STATIC_S: return OP_CALL_STATIC;
+        case OP_LOAD_LOCAL_S: return OP_LOAD_LOCAL;
+        case OP_STORE_LOCAL_S: return OP_STORE_LOCAL;
+        default: return 0;
+    }
+}
+
 const char* opcode_get_category(uint8_t opcode) {
-    if (opcode >= OP_PUSH_NULL && opcode <= OP_SWAP) {
+    if ((opcode >= OP_PUSH_NULL && opcode <= OP_SWAP) || opcode == OP_PUSH_CONSTANT_S) {
         return OPCODE_CATEGORY_STACK;
     } else if (opcode >= OP_ADD && opcode <= OP_DEC) {
         return OPCODE_CATEGORY_ARITHMETIC;
@@ -231,11 +286,11 @@ const char* opcode_get_category(uint8_t opcode) {
         return OPCODE_CATEGORY_COMPARISON;
     } else if (opcode >= OP_AND && opcode <= OP_NOT) {
         return OPCODE_CATEGORY_LOGICAL;
-    } else if (opcode >= OP_JUMP && opcode <= OP_JUMP_IF_NOT_NULL) {
+    } else if (opcode >= OP_JUMP && opcode <= OP_JUMP_IF_FALSE_S) {
         return OPCODE_CATEGORY_CONTROL;
-    } else if (opcode >= OP_CALL && opcode <= OP_RETURN_VALUE) {
+    } else if (opcode >= OP_CALL && opcode <= OP_CALL_STATIC_S) {
         return OPCODE_CATEGORY_CALL;
-    } else if (opcode >= OP_LOAD_LOCAL && opcode <= OP_STORE_ARG) {
+    } else if (opcode >= OP_LOAD_LOCAL && opcode <= OP_STORE_LOCAL_S) {
         return OPCODE_CATEGORY_LOCAL;
     } else if (opcode >= OP_LOAD_GLOBAL && opcode <= OP_STORE_GLOBAL) {
         return OPCODE_CATEGORY_GLOBAL;
@@ -245,7 +300,7 @@ const char* opcode_get_category(uint8_t opcode) {
         return OPCODE_CATEGORY_ARRAY;
     } else if (opcode >= OP_TYPE_OF && opcode <= OP_CAST) {
         return OPCODE_CATEGORY_TYPE;
-    } else if (opcode >= OP_STRING_LENGTH && opcode <= OP_STRING_INDEX_OF) {
+    } else if (opcode >= OP_STRING_LENGTH && opcode <= OP_STRING_INDEX_OF_IGNORE_CASE) {
         return OPCODE_CATEGORY_STRING;
     } else if (opcode >= OP_PRINT && opcode <= OP_READ_FLOAT) {
         return OPCODE_CATEGORY_BUILTIN;
@@ -280,6 +335,13 @@ void opcode_disassemble_with_operands(uint8_t* bytecode, size_t offset, char* bu
     const char* name = opcode_get_name(opcode);
     uint8_t operand_count = opcode_get_operand_count(opcode);
     
+    // A widened instruction is shown with its 2-byte operand
+    if (opcode == OP_WIDE && opcode_get_wide_form(bytecode[offset + 1])) {
+        snprintf(buffer, buffer_size, "WIDE %s %02X %02X ", opcode_get_name(bytecode[offset + 1]),
+                 bytecode[offset + 2], bytecode[offset + 3]);
+        return;
+    }
+    
     if (operand_count == 0) {
         snprintf(buffer, buffer_size, "%s", name);
     } else {
@@ -304,6 +366,9 @@ size_t opcode_get_size(uint8_t* bytecode, size_t offset) {
     if (!bytecode) return 0;
     
     uint8_t opcode = bytecode[offset];
+    if (opcode == OP_WIDE) {
+        return 4; // prefix, compact opcode and 2-byte operand
+    }
     return 1 + opcode_get_operand_count(opcode);
 }
 
@@ -313,6 +378,11 @@ bool opcode_validate(uint8_t* bytecode, size_t offset, size_t bytecode_size) {
     uint8_t opcode = bytecode[offset];
     if (!opcode_is_valid(opcode)) return false;
     
+    // OP_WIDE only prefixes a compact instruction
+    if (opcode == OP_WIDE) {
+        return offset + 4 <= bytecode_size && opcode_get_wide_form(bytecode[offset + 1]) != 0;
+    }
+    
     uint8_t operand_count = opcode_get_operand_count(opcode);
     return (offset + 1 + operand_count) <= bytecode_size;
 }
@@ -353,8 +423,7 @@ void opcode_write_operand(uint8_t* bytecode, size_t offset, uint8_t operand_size
 size_t opcode_get_next_offset(uint8_t* bytecode, size_t offset) {
     if (!bytecode) return offset;
     
-    uint8_t opcode = bytecode[offset];
-    return offset + 1 + opcode_get_operand_count(opcode);
+    return offset + opcode_get_size(bytecode, offset);
 }
 
 void opcode_count_by_category(uint8_t* bytecode, size_t bytecode_size, uint32_t* counts) {
@@ -369,18 +438,18 @@ void opcode_count_by_category(uint8_t* bytecode, size_t bytecode_size, uint32_t*
         const char* category = opcode_get_category(opcode);
         
         // Simple category counting - just increment based on opcode range
-        if (opcode >= OP_PUSH_NULL && opcode <= OP_SWAP) counts[0]++;
+        if ((opcode >= OP_PUSH_NULL && opcode <= OP_SWAP) || opcode == OP_PUSH_CONSTANT_S) counts[0]++;
         else if (opcode >= OP_ADD && opcode <= OP_DEC) counts[1]++;
         else if (opcode >= OP_EQ && opcode <= OP_GE) counts[2]++;
         else if (opcode >= OP_AND && opcode <= OP_NOT) counts[3]++;
-        else if (opcode >= OP_JUMP && opcode <= OP_JUMP_IF_NOT_NULL) counts[4]++;
-        else if (opcode >= OP_CALL && opcode <= OP_RETURN_VALUE) counts[5]++;
-        else if (opcode >= OP_LOAD_LOCAL && opcode <= OP_STORE_ARG) counts[6]++;
+        else if (opcode >= OP_JUMP && opcode <= OP_JUMP_IF_FALSE_S) counts[4]++;
+        else if (opcode >= OP_CALL && opcode <= OP_CALL_STATIC_S) counts[5]++;
+        else if (opcode >= OP_LOAD_LOCAL && opcode <= OP_STORE_LOCAL_S) counts[6]++;
         else if (opcode >= OP_LOAD_GLOBAL && opcode <= OP_STORE_GLOBAL) counts[7]++;
         else if (opcode >= OP_NEW_OBJECT && opcode <= OP_STORE_STATIC_FIELD) counts[8]++;
         else if (opcode >= OP_LOAD_ARRAY && opcode <= OP_ARRAY_RESIZE) counts[9]++;
         else if (opcode >= OP_TYPE_OF && opcode <= OP_CAST) counts[10]++;
-        else if (opcode >= OP_STRING_LENGTH && opcode <= OP_STRING_INDEX_OF) counts[11]++;
+        else if (opcode >= OP_STRING_LENGTH && opcode <= OP_STRING_INDEX_OF_IGNORE_CASE) counts[11]++;
         else if (opcode >= OP_PRINT && opcode <= OP_READ_FLOAT) counts[12]++;
         else if (opcode >= OP_AWAIT && opcode <= OP_ASYNC_CALL) counts[13]++;
         else if (opcode >= OP_MATCH && opcode <= OP_MATCH_WHEN) counts[14]++;
@@ -0,0 +1,220 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../vm.h"
+#include "emitter/ir_to_bytecode.h"
+#include "../../shared/bytecode/helium_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Bytecode encoding benchmark - builds a loop kernel in IR the way the
+// compiler lowers locals and arithmetic: a counter, an accumulator and a set
+// of locals, with a body that adds each local into the accumulator. The
+// kernel is translated twice, once with compact operands (short local and
+// constant forms, 1- and 2-byte jumps) and once with the 4-byte operands
+// every instruction used before, then each module is saved, loaded and
+// interpreted. Reports the bytecode size, the 64-byte cache lines it spans
+// and the time per interpreted instruction.
+//
+// Usage: bytecode_benchmark [locals] [statements] [iterations]
+
+#define DEFAULT_LOCALS 12
+#define DEFAULT_STATEMENTS 48
+#define DEFAULT_ITERATIONS 200000
+
+#define CACHE_LINE 64
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Size and run time of one encoding
+typedef struct {
+    uint32_t bytecode_size;
+    uint64_t instructions;
+    double run_us;
+    int result;
+} EncodingTiming;
+
+static IRValue local_value(uint32_t index) {
+    IRValue value;
+    value.type = IR_VALUE_TEMP;
+    value.data.temp_id = index;
+    return value;
+}
+
+static void add_local_op(IRBuilder* builder, IROp op, uint32_t index) {
+    IRValue value = local_value(index);
+    ir_builder_add_instruction_with_operands(builder, op, &value, 1);
+}
+
+static void add_constant(IRBuilder* builder, int64_t constant) {
+    IRValue value = ir_builder_create_i64_value(constant);
+    ir_builder_add_instruction_with_operands(builder, IR_LOAD_CONST, &value, 1);
+}
+
+// main(): local 0 counts iterations, local 1 accumulates the others
+static IRFunction* make_kernel(IRBuilder* builder, uint32_t locals, uint32_t statements, uint32_t iterations,
+                               uint64_t* instructions) {
+    IRFunction* function = ir_builder_create_function(builder, "main", 0);
+    function->local_count = locals;
+    IRBlock* entry = ir_builder_create_block(builder, "entry");
+    IRBlock* cond = ir_builder_create_block(builder, "cond");
+    IRBlock* body = ir_builder_create_block(builder, "body");
+    IRBlock* exit = ir_builder_create_block(builder, "exit");
+
+    ir_builder_set_current_block(builder, entry);
+    for (uint32_t k = 0; k < locals; k++) {
+        add_constant(builder, k == 1 ? 0 : k);
+        add_local_op(builder, IR_STORE_LOCAL, k);
+    }
+    ir_builder_add_jump(builder, cond);
+
+    ir_builder_set_current_block(builder, cond);
+    add_local_op(builder, IR_LOAD_LOCAL, 0);
+    add_constant(builder, iterations);
+    ir_builder_add_instruction(builder, ir_builder_create_instruction(builder, IR_LT));
+    ir_builder_add_conditional_jump_op(builder, IR_JMPF, exit);
+
+    ir_builder_set_current_block(builder, body);
+    for (uint32_t s = 0; s < statements; s++) {
+        add_local_op(builder, IR_LOAD_LOCAL, 1);
+        add_local_op(builder, IR_LOAD_LOCAL, 2 + s % (locals - 2));
+        ir_builder_add_instruction(builder, ir_builder_create_instruction(builder, IR_ADD));
+        add_local_op(builder, IR_STORE_LOCAL, 1);
+    }
+    add_local_op(builder, IR_LOAD_LOCAL, 0);
+    add_constant(builder, 1);
+    ir_builder_add_instruction(builder, ir_builder_create_instruction(builder, IR_ADD));
+    add_local_op(builder, IR_STORE_LOCAL, 0);
+    ir_builder_add_jump(builder, cond);
+
+    ir_builder_set_current_block(builder, exit);
+    add_local_op(builder, IR_LOAD_LOCAL, 1);
+    ir_builder_add_instruction(builder, ir_builder_create_instruction(builder, IR_RETURN));
+
+    // Entry, every pass through cond and body, then the final cond and exit
+    *instructions = 2 * (uint64_t)locals + 1 + (uint64_t)iterations * (9 + 4 * (uint64_t)statements) + 4 + 2;
+    return function;
+}
+
+// Translate the kernel with or without compact operands and save it
+static bool save_kernel(IRFunction* function, bool compact, const char* path, uint32_t* bytecode_size) {
+    IRToBytecodeTranslator* translator = ir_to_bytecode_translator_create();
+    if (!translator) {
+        return false;
+    }
+    translator->compact_operands = compact;
+    translator->current_function = function;
+    BytecodeFile* file = NULL;
+    if (ir_to_bytecode_add_method(translator, "main", "()I", 1) != 0 &&
+        ir_to_bytecode_translate_function(translator, function)) {
+        file = ir_to_bytecode_generate_file(translator);
+    }
+    if (!file) {
+        fprintf(stderr, "Translation failed: %s\n", ir_to_bytecode_translator_get_error(translator));
+        ir_to_bytecode_translator_destroy(translator);
+        return false;
+    }
+
+    // Hand the tables and bytecode to a module, as the packager does
+    HeliumModule* module = helium_module_create();
+    string_table_destroy(module->string_table_obj);
+    constant_table_destroy(module->constant_table);
+    type_table_destroy(module->type_table);
+    method_table_destroy(module->method_table);
+    module->string_table_obj = translator->string_table;
+    module->constant_table = translator->constant_table;
+    module->type_table = translator->type_table;
+    module->method_table = translator->method_table;
+    module->bytecode = file->bytecode;
+    module->bytecode_size = (uint32_t)file->bytecode_size;
+    module->header.bytecode_size = module->bytecode_size;
+    module->header.entry_point_method_id = 1;
+    file->bytecode = NULL;
+    file->string_table = NULL;
+    file->constant_table = NULL;
+    file->type_table = NULL;
+    file->method_table = NULL;
+    translator->string_table = NULL;
+    translator->constant_table = NULL;
+    translator->type_table = NULL;
+    translator->method_table = NULL;
+    ir_to_bytecode_translator_destroy(translator);
+
+    *bytecode_size = module->bytecode_size;
+    bool saved = helium_module_save(module, path);
+    helium_module_destroy(module);
+    return saved;
+}
+
+static bool time_kernel(const char* path, EncodingTiming* timing) {
+    VM* vm = vm_create();
+    if (!vm) {
+        return false;
+    }
+    vm_initialize_object_system(vm);
+    if (!vm_load_helium3_module(vm, path)) {
+        vm_destroy(vm);
+        return false;
+    }
+    double start = now_us();
+    timing->result = vm_execute(vm);
+    timing->run_us = now_us() - start;
+    vm_destroy(vm);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t locals = argc > 1 ? (uint32_t)atol(argv[1]) : DEFAULT_LOCALS;
+    uint32_t statements = argc > 2 ? (uint32_t)atol(argv[2]) : DEFAULT_STATEMENTS;
+    uint32_t iterations = argc > 3 ? (uint32_t)atol(argv[3]) : DEFAULT_ITERATIONS;
+    if (locals < 3 || statements == 0 || iterations == 0) {
+        fprintf(stderr, "Usage: %s [locals >= 3] [statements] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    printf("He³ Bytecode Encoding Benchmark\n");
+    printf("===============================\n");
+    printf("Locals: %u, statements: %u, iterations: %u\n\n", locals, statements, iterations);
+
+    IRBuilder* builder = ir_builder_create();
+    uint64_t instructions = 0;
+    IRFunction* function = make_kernel(builder, locals, statements, iterations, &instructions);
+
+    EncodingTiming timings[2];
+    const char* names[2] = { "4-byte operands", "compact" };
+    bool ok = true;
+    for (int compact = 0; ok && compact < 2; compact++) {
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/he3_bytecode_benchmark_%d_%d.helium3", (int)getpid(), compact);
+        EncodingTiming* timing = &timings[compact];
+        timing->instructions = instructions;
+        ok = save_kernel(function, compact == 1, path, &timing->bytecode_size) && time_kernel(path, timing);
+        unlink(path);
+    }
+    ir_builder_destroy(builder);
+    if (!ok) {
+        fprintf(stderr, "Failed to build or run the benchmark kernel\n");
+        return 1;
+    }
+    if (timings[0].result != timings[1].result) {
+        fprintf(stderr, "Encodings disagree: %d and %d\n", timings[0].result, timings[1].result);
+        return 1;
+    }
+
+    printf("\n                     bytes  cache lines      run     ns/instruction\n");
+    for (int i = 0; i < 2; i++) {
+        EncodingTiming* timing = &timings[i];
+        printf("%-16s  %8u  %11u  %8.2f ms  %8.2f\n", names[i], timing->bytecode_size,
+               (timing->bytecode_size + CACHE_LINE - 1) / CACHE_LINE, timing->run_us / 1e3,
+               timing->run_us * 1e3 / timing->instructions);
+    }
+    printf("\nCompact size: %.1f%% of 4-byte operands, run time %.2fx\n",
+           100.0 * timings[1].bytecode_size / timings[0].bytecode_size, timings[0].run_us / timings[1].run_us);
+    return 0;
+}
@@ -12,6 +12,8 @@ ExecutionContext* execution_context_create(void) {
     context->frame_count = 0;
     context->frame_capacity = 0;
     context->current_frame = NULL;
+    slab_pool_init(&context->frame_pool,
+                   sizeof(CallFrame) + sizeof(Value) * CALL_FRAME_INLINE_LOCALS, 0);
     
     return context;
 }
@@ -24,20 +26,26 @@ void execution_context_destroy(ExecutionContext* context) {
     while (context->frame_count > 0) {
         CallFrame* frame = execution_context_pop_frame(context);
         if (frame) {
-            call_frame_destroy(frame);
+            call_frame_destroy(context, frame);
         }
     }
     
     if (context->frames) {
         free(context->frames);
     }
+    slab_pool_destroy(&context->frame_pool);
     
     free(context);
 }
 
 // Create call frame
-CallFrame* call_frame_create(uint8_t* ip, size_t local_count) {
-    CallFrame* frame = malloc(sizeof(CallFrame));
+// Locals stored in the same pool block as the frame
+static Value* call_frame_inline_locals(CallFrame* frame) {
+    return (Value*)(frame + 1);
+}
+
+CallFrame* call_frame_create(ExecutionContext* context, uint8_t* ip, size_t local_count) {
+    CallFrame* frame = slab_pool_alloc(&context->frame_pool);
     if (!frame) return NULL;
     
     frame->ip = ip;
@@ -47,9 +55,11 @@ CallFrame* call_frame_create(uint8_t* ip, size_t local_count) {
     
     // Allocate local variables
     if (local_count > 0) {
-        frame->locals = malloc(sizeof(Value) * local_count);
+        frame->locals = local_count <= CALL_FRAME_INLINE_LOCALS
+            ? call_frame_inline_locals(frame)
+            : malloc(sizeof(Value) * local_count);
         if (!frame->locals) {
-            free(frame);
+            slab_pool_free(&context->frame_pool, frame);
             return NULL;
         }
         
@@ -65,7 +75,7 @@ CallFrame* call_frame_create(uint8_t* ip, size_t local_count) {
 }
 
 // Destroy call frame
-void call_frame_destroy(CallFrame* frame) {
+void call_frame_destroy(ExecutionContext* context, CallFrame* frame) {
     if (!frame) return;
     
     // Destroy local variables
@@ -73,10 +83,12 @@ void call_frame_destroy(CallFrame* frame) {
         for (size_t i = 0; i < frame->local_count; i++) {
             value_destroy(&frame->locals[i]);
         }
-        free(frame->locals);
+        if (frame->locals != call_frame_inline_locals(frame)) {
+            free(frame->locals);
+        }
     }
     
-    free(frame);
+    slab_pool_free(&context->frame_pool, frame);
 }
 
 // Push frame onto execution context
@@ -161,8 +173,8 @@ bool call_frame_has_local(CallFrame* frame, uint32_t index) {
 }
 
 // Create call frame for method call
-CallFrame* call_frame_create_for_method(uint8_t* ip, size_t local_count, size_t arg_count, Value* args, Object* this_object) {
-    CallFrame* frame = call_frame_create(ip, local_count);
+CallFrame* call_frame_create_for_method(ExecutionContext* context, uint8_t* ip, size_t local_count, size_t arg_count, Value* args, Object* this_object) {
+    CallFrame* frame = call_frame_create(context, ip, local_count);
     if (!frame) return NULL;
     
     frame->this_object = this_object;
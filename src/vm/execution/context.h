@@ -12,8 +12,9 @@ ExecutionContext* execution_context_create(void);
 void execution_context_destroy(ExecutionContext* context);
 
 // Call frame management
-CallFrame* call_frame_create(uint8_t* ip, size_t local_count);
-void call_frame_destroy(CallFrame* frame);
+// Frames come from the context's frame pool and are released with it
+CallFrame* call_frame_create(ExecutionContext* context, uint8_t* ip, size_t local_count);
+void call_frame_destroy(ExecutionContext* context, CallFrame* frame);
 
 // Frame stack operations
 bool execution_context_push_frame(ExecutionContext* context, CallFrame* frame);
@@ -26,4 +27,4 @@ Value call_frame_get_local(CallFrame* frame, uint32_t index);
 bool call_frame_has_local(CallFrame* frame, uint32_t index);
 
 // Method call support
-CallFrame* call_frame_create_for_method(uint8_t* ip, size_t local_count, size_t arg_count, Value* args, Object* this_object);
+CallFrame* call_frame_create_for_method(ExecutionContext* context, uint8_t* ip, size_t local_count, size_t arg_count, Value* args, Object* this_object);
@@ -4,6 +4,8 @@
 #include "stack.h"
 #include "context.h"
 #include "../modules/module_registry.h"
+#include "../objects/string_object.h"
+#include "../objects/utf8.h"
 #include "../../shared/bytecode/helium_format.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -25,6 +27,8 @@ InterpretResult interpret_instruction(VM* vm, uint8_t opcode, uint8_t* operands)
         case OP_PUSH_CONSTANT:
             DEBUG_PRINT(vm, "DEBUG: About to execute OP_PUSH_CONSTANT with index %u\n", *(uint32_t*)operands);
             return op_push_constant(vm, *(uint32_t*)operands);
+        case OP_PUSH_CONSTANT_S:
+            return op_push_constant(vm, *operands);
         case OP_PUSH_INT8:
             return op_push_int8(vm, *(int8_t*)operands);
         case OP_PUSH_INT16:
@@ -76,6 +80,20 @@ InterpretResult interpret_instruction(VM* vm, uint8_t opcode, uint8_t* operands)
         case OP_STORE_LOCAL:
             DEBUG_PRINT(vm, "DEBUG: About to execute OP_STORE_LOCAL with index %u\n", *(uint32_t*)operands);
             return op_store_local(vm, *(uint32_t*)operands);
+        case OP_LOAD_LOCAL_0:
+        case OP_LOAD_LOCAL_1:
+        case OP_LOAD_LOCAL_2:
+        case OP_LOAD_LOCAL_3:
+            return op_load_local(vm, opcode - OP_LOAD_LOCAL_0);
+        case OP_STORE_LOCAL_0:
+        case OP_STORE_LOCAL_1:
+        case OP_STORE_LOCAL_2:
+        case OP_STORE_LOCAL_3:
+            return op_store_local(vm, opcode - OP_STORE_LOCAL_0);
+        case OP_LOAD_LOCAL_S:
+            return op_load_local(vm, *operands);
+        case OP_STORE_LOCAL_S:
+            return op_store_local(vm, *operands);
         case OP_INC:
             return op_inc(vm);
         case OP_DEC:
@@ -109,6 +127,8 @@ InterpretResult interpret_instruction(VM* vm, uint8_t opcode, uint8_t* operands)
             return op_call_virtual(vm, *(uint32_t*)operands);
         case OP_CALL_STATIC:
             return op_call_static(vm, *(uint32_t*)operands);
+        case OP_CALL_STATIC_S:
+            return op_call_static(vm, *operands);
         case OP_LOAD_FIELD:
             return op_load_field(vm, *(uint32_t*)operands);
         case OP_STORE_FIELD:
@@ -124,6 +144,12 @@ InterpretResult interpret_instruction(VM* vm, uint8_t opcode, uint8_t* operands)
             return op_jmp_if_null(vm, *(int32_t*)operands);
         case OP_JUMP_IF_NOT_NULL:
             return op_jmp_if_not_null(vm, *(int32_t*)operands);
+        case OP_JUMP_S:
+            return op_jmp(vm, *(int8_t*)operands);
+        case OP_JUMP_IF_TRUE_S:
+            return op_jmp_if_true(vm, *(int8_t*)operands);
+        case OP_JUMP_IF_FALSE_S:
+            return op_jmp_if_false(vm, *(int8_t*)operands);
         
         // Option operations
         case OP_OPTION_SOME:
@@ -150,6 +176,26 @@ InterpretResult interpret_instruction(VM* vm, uint8_t opcode, uint8_t* operands)
         case OP_RESULT_UNWRAP_OR:
             return op_result_unwrap_or(vm);
         
+        // String operations
+        case OP_STRING_CONCAT:
+            return op_string_concat(vm);
+        case OP_STRING_SUBSTRING:
+            return op_string_substring(vm);
+        case OP_STRING_INDEX_OF:
+            return op_string_index_of(vm);
+        case OP_STRING_LENGTH:
+            return op_string_length(vm);
+        case OP_STRING_EQUALS_IGNORE_CASE:
+            return op_string_equals_ignore_case(vm);
+        case OP_STRING_INDEX_OF_IGNORE_CASE:
+            return op_string_index_of_ignore_case(vm);
+        case OP_STRING_BUILDER_NEW:
+            return op_string_builder_new(vm);
+        case OP_STRING_BUILDER_APPEND:
+            return op_string_builder_append(vm);
+        case OP_STRING_BUILDER_TO_STRING:
+            return op_string_builder_to_string(vm);
+        
         // Pattern matching
         case OP_MATCH:
             return op_match(vm, *(uint32_t*)operands);
@@ -167,6 +213,22 @@ InterpretResult interpret_instruction(VM* vm, uint8_t opcode, uint8_t* operands)
     }
 }
 
+// Bytes of a string, flattening a rope on first use. The caller keeps the
+// string rooted (it is usually still on the operand stack). Only a plain
+// string is NUL-terminated, so print with the string's length.
+static const char* interpret_string_chars(VM* vm, StringObject* string) {
+    const char* bytes = string_flatten(vm->heap, string);
+    return bytes ? bytes : "";
+}
+
+// Flatten a rope on the operand stack so its bytes can be compared
+static void interpret_flatten_operand(VM* vm, size_t offset) {
+    Value* slot = &vm->stack->values[vm->stack->top - 1 - offset];
+    if (slot->type == VALUE_STRING && slot->data.string_value) {
+        string_flatten(vm->heap, slot->data.string_value);
+    }
+}
+
 // ============================================================================
 // STACK OPERATIONS
 // ============================================================================
@@ -198,8 +260,9 @@ InterpretResult op_push_constant(VM* vm, uint32_t constant_index) {
             // Resolve string offset to actual string data
             if (vm->current_module) {
                 const char* string_data = helium_module_get_string(vm->current_module, entry->value.string_offset);
-                if (string_data) {
-                    val = value_create_string(string_data);
+                StringObject* string = string_data ? vm_intern_literal(vm, constant_index, string_data) : NULL;
+                if (string) {
+                    val = value_create_string_object(string);
                 } else {
                     fprintf(stderr, "Runtime error: Could not resolve string at offset %u\n", entry->value.string_offset);
                     return INTERPRET_RUNTIME_ERROR;
@@ -386,6 +449,11 @@ InterpretResult op_add(VM* vm) {
         return INTERPRET_STACK_UNDERFLOW;
     }
     
+    // String addition is concatenation
+    if (stack_peek(vm->stack, 0).type == VALUE_STRING && stack_peek(vm->stack, 1).type == VALUE_STRING) {
+        return op_string_concat(vm);
+    }
+    
     Value val2 = stack_pop(vm->stack);
     Value val1 = stack_pop(vm->stack);
     
@@ -655,7 +723,7 @@ InterpretResult op_ret(VM* vm) {
         if (return_value.type == VALUE_I64) {
             DEBUG_PRINT(vm, "DEBUG: op_ret: i64 value=%lld\n", return_value.data.i64_value);
         } else if (return_value.type == VALUE_OPTION) {
-            DEBUG_PRINT(vm, "DEBUG: op_ret: Option value (some=%p)\n", return_value.data.option_value);
+            DEBUG_PRINT(vm, "DEBUG: op_ret: Option value (some=%d)\n", return_value.variant == VALUE_VARIANT_SOME);
         } else {
             DEBUG_PRINT(vm, "DEBUG: op_ret: other value type\n");
         }
@@ -676,6 +744,51 @@ InterpretResult op_ret(VM* vm) {
 // BYTECODE INTERPRETATION
 // ============================================================================
 
+// Operand bytes that follow an opcode in the instruction stream
+static size_t interpret_operand_size(uint8_t opcode) {
+    switch (opcode) {
+        case OP_PUSH_INT8:
+        case OP_PUSH_CONSTANT_S:
+        case OP_LOAD_LOCAL_S:
+        case OP_STORE_LOCAL_S:
+        case OP_CALL_STATIC_S:
+        case OP_JUMP_S:
+        case OP_JUMP_IF_TRUE_S:
+        case OP_JUMP_IF_FALSE_S:
+            return 1;
+        case OP_PUSH_INT16:
+            return 2;
+        case OP_PUSH_INT32:
+        case OP_PUSH_UINT32:
+        case OP_PUSH_FLOAT32:
+            return 4;
+        case OP_PUSH_INT64:
+        case OP_PUSH_UINT64:
+        case OP_PUSH_FLOAT64:
+            return 8;
+        case OP_PUSH_CONSTANT:
+        case OP_LOAD_LOCAL:
+        case OP_STORE_LOCAL:
+        case OP_CALL:
+        case OP_CALL_VIRTUAL:
+        case OP_CALL_STATIC:
+        case OP_LOAD_FIELD:
+        case OP_STORE_FIELD:
+        case OP_NEW_OBJECT:
+        case OP_JUMP:
+        case OP_JUMP_IF_TRUE:
+        case OP_JUMP_IF_FALSE:
+        case OP_JUMP_IF_NULL:
+        case OP_JUMP_IF_NOT_NULL:
+        case OP_MATCH:
+        case OP_MATCH_CASE:
+        case OP_MATCH_WHEN:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
 InterpretResult interpret_bytecode(VM* vm, uint8_t* bytecode, size_t size) {
     
     if (!vm || !bytecode) {
@@ -683,80 +796,84 @@ InterpretResult interpret_bytecode(VM* vm, uint8_t* bytecode, size_t size) {
     }
     
     size_t ip = 0; // Instruction pointer
+    AllocProfiler* profiler = vm->heap ? vm->heap->profiler : NULL;
     
     while (ip < size) {
+        // Allocations made by this instruction are charged to its offset
+        if (profiler) {
+            profiler->site_offset = (uint32_t)ip;
+        }
         uint8_t opcode = bytecode[ip++];
         
         // Get operands based on opcode
         uint8_t* operands = NULL;
-        size_t operand_size = 0;
-        
-        // Determine operand size based on opcode
-        switch (opcode) {
-            case OP_PUSH_INT8:
-                operand_size = 1;
-                break;
-            case OP_PUSH_INT16:
-                operand_size = 2;
-                break;
-            case OP_PUSH_INT32:
-            case OP_PUSH_UINT32:
-            case OP_PUSH_FLOAT32:
-                operand_size = 4;
-                break;
-            case OP_PUSH_INT64:
-            case OP_PUSH_UINT64:
-            case OP_PUSH_FLOAT64:
-                operand_size = 8;
-                break;
-            case OP_PUSH_CONSTANT:
-            case OP_LOAD_LOCAL:
-            case OP_STORE_LOCAL:
-            case OP_CALL:
-            case OP_CALL_VIRTUAL:
-            case OP_CALL_STATIC:
-            case OP_LOAD_FIELD:
-            case OP_STORE_FIELD:
-            case OP_NEW_OBJECT:
-            case OP_JUMP:
-            case OP_JUMP_IF_TRUE:
-            case OP_JUMP_IF_FALSE:
-            case OP_JUMP_IF_NULL:
-            case OP_JUMP_IF_NOT_NULL:
-            case OP_MATCH:
-            case OP_MATCH_CASE:
-            case OP_MATCH_WHEN:
-                operand_size = 4;
-                break;
-            default:
-                operand_size = 0;
-                break;
-        }
-        
-        // Check if we have enough bytes for operands
-        if (ip + operand_size > size) {
-            fprintf(stderr, "Runtime error: Incomplete instruction at offset %zu\n", ip - 1);
-            return INTERPRET_RUNTIME_ERROR;
+        uint32_t wide_operand;
+        if (opcode == OP_WIDE) {
+            // A widened compact instruction runs as its 4-byte form
+            opcode = ip < size ? opcode_get_wide_form(bytecode[ip]) : 0;
+            if (opcode == 0 || ip + 3 > size) {
+                fprintf(stderr, "Runtime error: Invalid WIDE instruction at offset %zu\n", ip - 1);
+                return INTERPRET_RUNTIME_ERROR;
+            }
+            uint16_t value = (uint16_t)(bytecode[ip + 1] | (bytecode[ip + 2] << 8));
+            wide_operand = opcode_is_jump(opcode) ? (uint32_t)(int32_t)(int16_t)value : value;
+            operands = (uint8_t*)&wide_operand;
+            ip += 3;
+        } else {
+            size_t operand_size = interpret_operand_size(opcode);
+            
+            // Check if we have enough bytes for operands
+            if (ip + operand_size > size) {
+                fprintf(stderr, "Runtime error: Incomplete instruction at offset %zu\n", ip - 1);
+                return INTERPRET_RUNTIME_ERROR;
+            }
+            
+            // Set operands pointer
+            if (operand_size > 0) {
+                operands = &bytecode[ip];
+                ip += operand_size;
+            }
         }
         
-        // Set operands pointer
-        if (operand_size > 0) {
-            operands = &bytecode[ip];
-            ip += operand_size;
+        // Jumps move the frame's instruction pointer, relative to the end
+        // of the jump instruction
+        CallFrame* frame = vm->context ? vm->context->current_frame : NULL;
+        bool jump = frame && opcode_is_jump(opcode);
+        if (jump) {
+            frame->ip = bytecode + ip;
         }
         
         // Execute instruction
-        if (operands) {
-        }
         InterpretResult result = interpret_instruction(vm, opcode, operands);
         if (result != INTERPRET_OK) {
             return result;
         }
         
+        if (jump) {
+            ip = (size_t)(frame->ip - bytecode);
+            if (ip > size) {
+                fprintf(stderr, "Runtime error: Jump out of method bytecode\n");
+                return INTERPRET_RUNTIME_ERROR;
+            }
+        }
+        
         // Check if VM should stop
         if (!vm->running) {
             break;
         }
+        
+        // Let the collector remark at a safepoint
+        gc_safepoint(vm->heap);
+        
+        // Write the allocation profile if a signal asked for it
+        if (profiler && vm_heap_profile_requested) {
+            vm_write_heap_profile(vm);
+        }
+        
+        // Write a heap snapshot if a signal asked for it
+        if (vm_heap_snapshot_requested) {
+            vm_write_heap_snapshot(vm);
+        }
     }
     
     return INTERPRET_OK;
@@ -848,6 +965,10 @@ InterpretResult op_eq(VM* vm) {
         return INTERPRET_STACK_UNDERFLOW;
     }
     
+    // Ropes are flattened while both operands are still rooted
+    interpret_flatten_operand(vm, 0);
+    interpret_flatten_operand(vm, 1);
+    
     Value b = stack_pop(vm->stack);
     Value a = stack_pop(vm->stack);
     
@@ -859,7 +980,7 @@ InterpretResult op_eq(VM* vm) {
     } else if (a.type == VALUE_BOOL && b.type == VALUE_BOOL) {
         result = a.data.bool_value == b.data.bool_value;
     } else if (a.type == VALUE_STRING && b.type == VALUE_STRING) {
-        result = strcmp(a.data.string_value, b.data.string_value) == 0;
+        result = string_equals(a.data.string_value, b.data.string_value);
     } else if ((a.type == VALUE_I64 && b.type == VALUE_F64) || 
                (a.type == VALUE_F64 && b.type == VALUE_I64)) {
         // Mixed types: convert both to float
@@ -887,6 +1008,10 @@ InterpretResult op_ne(VM* vm) {
         return INTERPRET_STACK_UNDERFLOW;
     }
     
+    // Ropes are flattened while both operands are still rooted
+    interpret_flatten_operand(vm, 0);
+    interpret_flatten_operand(vm, 1);
+    
     Value b = stack_pop(vm->stack);
     Value a = stack_pop(vm->stack);
     
@@ -898,7 +1023,7 @@ InterpretResult op_ne(VM* vm) {
     } else if (a.type == VALUE_BOOL && b.type == VALUE_BOOL) {
         result = a.data.bool_value != b.data.bool_value;
     } else if (a.type == VALUE_STRING && b.type == VALUE_STRING) {
-        result = strcmp(a.data.string_value, b.data.string_value) != 0;
+        result = !string_equals(a.data.string_value, b.data.string_value);
     } else if ((a.type == VALUE_I64 && b.type == VALUE_F64) || 
                (a.type == VALUE_F64 && b.type == VALUE_I64)) {
         // Mixed types: convert both to float
@@ -1115,14 +1240,19 @@ InterpretResult op_new_object(VM* vm, uint32_t type_id) {
         return INTERPRET_RUNTIME_ERROR;
     }
     
-    // For now, create a simple object with the given type ID
-    // In a full implementation, we'd look up the class definition
-    // and allocate the proper amount of memory
+    // Allocate an instance of a registered class. The compiler still emits
+    // the placeholder type ID 0, which yields a null reference.
+    struct Class* class_info = type_id ? vm_find_class_by_id(vm, type_id) : NULL;
+    Object* object = NULL;
+    if (class_info) {
+        object = object_create(vm->heap, class_info);
+        if (!object) {
+            printf("Runtime error: Out of memory allocating %s\n", class_info->name);
+            return INTERPRET_RUNTIME_ERROR;
+        }
+    }
     
-    // Create a basic object structure
-    // This is a simplified implementation - in reality we'd need
-    // to look up the class definition and allocate proper memory
-    Value object_value = value_create_object(NULL); // NULL for now
+    Value object_value = value_create_object(object);
     if (!stack_push(vm->stack, object_value)) {
         return INTERPRET_STACK_OVERFLOW;
     }
@@ -1151,7 +1281,7 @@ InterpretResult op_call_builtin(VM* vm) {
     }
     
     // Print the string
-    printf("%s", arg.data.string_value);
+    printf("%.*s", (int)arg.data.string_value->length, interpret_string_chars(vm, arg.data.string_value));
     
     // Push a default return value (void)
     Value void_result = {0};
@@ -1162,6 +1292,25 @@ InterpretResult op_call_builtin(VM* vm) {
     return INTERPRET_OK;
 }
 
+// Run a method with its own module current, since the IDs and constants in
+// its bytecode are those of the module it was loaded from
+static InterpretResult interpret_call_method(VM* vm, MethodRegistryEntry* method_entry, Method* method_info, Value object) {
+    HeliumModule* caller_module = vm->current_module;
+    ModuleEntry* caller_module_entry = vm->current_module_entry;
+    if (method_entry->module) {
+        vm->current_module_entry = method_entry->module;
+        if (method_entry->module->helium_module) {
+            vm->current_module = method_entry->module->helium_module;
+        }
+    }
+    
+    InterpretResult result = execute_method_bytecode(vm, method_info, object);
+    
+    vm->current_module = caller_module;
+    vm->current_module_entry = caller_module_entry;
+    return result;
+}
+
 InterpretResult op_call(VM* vm, uint32_t method_id) {
     if (!vm || !vm->stack) {
         return INTERPRET_RUNTIME_ERROR;
@@ -1173,15 +1322,16 @@ InterpretResult op_call(VM* vm, uint32_t method_id) {
     }
     
     // Look up the method in the module registry
-    MethodRegistryEntry* method_entry = method_registry_find_method_by_id(method_id);
+    MethodRegistryEntry* method_entry = method_registry_find_module_method(vm->current_module_entry, method_id);
     if (!method_entry) {
         printf("Runtime error: Method with id=%u not found\n", method_id);
         return INTERPRET_RUNTIME_ERROR;
     }
     
     
-    // Check if this is a static method
-    if (method_entry->method_info && method_entry->method_info->is_static) {
+    // Check if this is a static method; the first call links the method
+    Method* method_info = method_registry_materialize(method_entry);
+    if (method_info && method_info->is_static) {
         return op_call_static(vm, method_id);
     } else {
         return op_call_virtual(vm, method_id);
@@ -1194,7 +1344,7 @@ InterpretResult op_call_virtual(VM* vm, uint32_t method_id) {
     }
     
     // Look up the method in the module registry
-    MethodRegistryEntry* method_entry = method_registry_find_method_by_id(method_id);
+    MethodRegistryEntry* method_entry = method_registry_find_module_method(vm->current_module_entry, method_id);
     if (!method_entry) {
         printf("Runtime error: Virtual method with id=%u not found\n", method_id);
         return INTERPRET_RUNTIME_ERROR;
@@ -1213,15 +1363,87 @@ InterpretResult op_call_virtual(VM* vm, uint32_t method_id) {
         return INTERPRET_RUNTIME_ERROR;
     }
     
-    // Get the method information
-    Method* method_info = method_entry->method_info;
+    // Get the method information, linking the method on its first call
+    Method* method_info = method_registry_materialize(method_entry);
     if (!method_info) {
         printf("Runtime error: Method info not available for method %u\n", method_id);
         return INTERPRET_RUNTIME_ERROR;
     }
     
     // Execute the method bytecode
-    return execute_method_bytecode(vm, method_info, object);
+    return interpret_call_method(vm, method_entry, method_info, object);
+}
+
+// Sys.readFile: the whole file as a string. Text entering the VM must be
+// valid UTF-8; the path stays on the stack until the result is allocated.
+static InterpretResult interpret_sys_read_file(VM* vm) {
+    if (vm->stack->top == 0) {
+        printf("Runtime error: No argument on stack for Sys.readFile\n");
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    Value path_value = stack_peek(vm->stack, 0);
+    if (path_value.type != VALUE_STRING || !path_value.data.string_value) {
+        printf("Runtime error: Sys.readFile() expects a string argument\n");
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    // The path may be a slice, whose bytes are not NUL-terminated
+    StringObject* path_string = path_value.data.string_value;
+    const char* path_bytes = string_flatten(vm->heap, path_string);
+    char* path = path_bytes ? malloc(path_string->length + 1) : NULL;
+    if (!path) {
+        printf("Runtime error: Cannot allocate string\n");
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    memcpy(path, path_bytes, path_string->length);
+    path[path_string->length] = '\0';
+    
+    FILE* file = fopen(path, "rb");
+    char* contents = NULL;
+    size_t length = 0;
+    if (file) {
+        size_t capacity = 4096;
+        contents = malloc(capacity);
+        size_t read;
+        while (contents && (read = fread(contents + length, 1, capacity - length, file)) > 0) {
+            length += read;
+            if (length == capacity) {
+                capacity *= 2;
+                char* grown = realloc(contents, capacity);
+                if (!grown) free(contents);
+                contents = grown;
+            }
+        }
+        if (ferror(file)) {
+            free(contents);
+            contents = NULL;
+        }
+        fclose(file);
+    }
+    if (!contents) {
+        printf("Runtime error: Sys.readFile() cannot read '%s'\n", path);
+        free(path);
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    size_t error_offset = 0;
+    if (!utf8_validate(contents, length, &error_offset)) {
+        printf("Runtime error: Sys.readFile() '%s' is not valid UTF-8 (byte %zu)\n", path, error_offset);
+        free(contents);
+        free(path);
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    free(path);
+    
+    StringObject* string = string_create(vm->heap, vm->string_class, contents, length);
+    free(contents);
+    if (!string) {
+        printf("Runtime error: Cannot allocate string\n");
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    stack_pop(vm->stack);
+    stack_push(vm->stack, value_create_string_object(string));
+    return INTERPRET_OK;
 }
 
 InterpretResult op_call_static(VM* vm, uint32_t method_id) {
@@ -1231,7 +1453,7 @@ InterpretResult op_call_static(VM* vm, uint32_t method_id) {
     }
     
     // Look up the method in the module registry
-    MethodRegistryEntry* method_entry = method_registry_find_method_by_id(method_id);
+    MethodRegistryEntry* method_entry = method_registry_find_module_method(vm->current_module_entry, method_id);
     if (!method_entry) {
         printf("Runtime error: Static method with id=%u not found\n", method_id);
         method_registry_print_info();
@@ -1240,8 +1462,8 @@ InterpretResult op_call_static(VM* vm, uint32_t method_id) {
     
     
     
-    // Get the method information
-    Method* method_info = method_entry->method_info;
+    // Get the method information, linking the method on its first call
+    Method* method_info = method_registry_materialize(method_entry);
     if (!method_info) {
         printf("Runtime error: Method info not available for method %u\n", method_id);
         return INTERPRET_RUNTIME_ERROR;
@@ -1259,7 +1481,7 @@ InterpretResult op_call_static(VM* vm, uint32_t method_id) {
             printf("Runtime error: Sys.print() expects a string argument, got type %d\n", arg.type);
             return INTERPRET_RUNTIME_ERROR;
         }
-        printf("%s", arg.data.string_value);
+        printf("%.*s", (int)arg.data.string_value->length, interpret_string_chars(vm, arg.data.string_value));
         fflush(stdout);
         return INTERPRET_OK;
     } else if (method_id == 3) { // Sys.println
@@ -1273,9 +1495,33 @@ InterpretResult op_call_static(VM* vm, uint32_t method_id) {
             printf("Runtime error: Sys.println() expects a string argument\n");
             return INTERPRET_RUNTIME_ERROR;
         }
-        printf("%s\n", arg.data.string_value);
+        printf("%.*s\n", (int)arg.data.string_value->length, interpret_string_chars(vm, arg.data.string_value));
         fflush(stdout);
         return INTERPRET_OK;
+    } else if (method_id == 6) { // Sys.readFile
+        return interpret_sys_read_file(vm);
+    } else if (method_id == 14) { // Sys.argc
+        stack_push(vm->stack, value_create_i64(vm->program_argc));
+        return INTERPRET_OK;
+    } else if (method_id == 15) { // Sys.argv
+        if (vm->stack->top == 0) {
+            printf("Runtime error: No argument on stack for Sys.argv\n");
+            return INTERPRET_RUNTIME_ERROR;
+        }
+        Value index = stack_pop(vm->stack);
+        if (index.type != VALUE_I64 || index.data.i64_value < 0 || index.data.i64_value >= vm->program_argc) {
+            printf("Runtime error: Sys.argv() index out of range (argc=%d)\n", vm->program_argc);
+            return INTERPRET_RUNTIME_ERROR;
+        }
+        // Arguments were validated as UTF-8 when the VM started
+        const char* arg = vm->program_argv[index.data.i64_value];
+        StringObject* string = string_create(vm->heap, vm->string_class, arg, strlen(arg));
+        if (!string) {
+            printf("Runtime error: Cannot allocate string\n");
+            return INTERPRET_RUNTIME_ERROR;
+        }
+        stack_push(vm->stack, value_create_string_object(string));
+        return INTERPRET_OK;
     } else if (method_id == 12) { // Sys.currentTimeMillis
         // Push current time in milliseconds
         Value time_value = value_create_i64((int64_t)time(NULL) * 1000);
@@ -1285,7 +1531,7 @@ InterpretResult op_call_static(VM* vm, uint32_t method_id) {
     
     // Execute the method bytecode (no object for static methods)
     Value null_object = value_create_null();
-    return execute_method_bytecode(vm, method_info, null_object);
+    return interpret_call_method(vm, method_entry, method_info, null_object);
 }
 
 InterpretResult op_load_field(VM* vm, uint32_t field_id) {
@@ -1294,7 +1540,7 @@ InterpretResult op_load_field(VM* vm, uint32_t field_id) {
     }
     
     // Look up the field in the module registry
-    FieldRegistryEntry* field_entry = field_registry_find_field_by_id(field_id);
+    FieldRegistryEntry* field_entry = field_registry_find_module_field(vm->current_module_entry, field_id);
     if (!field_entry) {
         printf("Runtime error: Field with id=%u not found\n", field_id);
         return INTERPRET_RUNTIME_ERROR;
@@ -1328,9 +1574,9 @@ InterpretResult op_load_field(VM* vm, uint32_t field_id) {
     }
     
     // Check if the field offset is valid
-    if (field_info->offset >= obj->header.size) {
+    if (field_info->offset >= (uint32_t)object_size(obj)) {
         printf("Runtime error: Field offset %u exceeds object size %u\n", 
-               field_info->offset, obj->header.size);
+               field_info->offset, (uint32_t)object_size(obj));
         return INTERPRET_RUNTIME_ERROR;
     }
     
@@ -1348,9 +1594,16 @@ InterpretResult op_load_field(VM* vm, uint32_t field_id) {
         case 3: // bool
             field_value = value_create_bool(*(bool*)field_data);
             break;
-        case 4: // string
-            field_value = value_create_string((char*)field_data);
+        case 4: { // string
+            StringObject* string = *(StringObject**)field_data;
+            field_value = string ? value_create_string_object(string) : value_create_null();
+            break;
+        }
+        case FIELD_TYPE_OBJECT: {
+            Object* referent = *(Object**)field_data;
+            field_value = referent ? value_create_object(referent) : value_create_null();
             break;
+        }
         default:
             printf("Runtime error: Unknown field type %u\n", field_info->type_id);
             return INTERPRET_RUNTIME_ERROR;
@@ -1370,7 +1623,7 @@ InterpretResult op_store_field(VM* vm, uint32_t field_id) {
     }
     
     // Look up the field in the module registry
-    FieldRegistryEntry* field_entry = field_registry_find_field_by_id(field_id);
+    FieldRegistryEntry* field_entry = field_registry_find_module_field(vm->current_module_entry, field_id);
     if (!field_entry) {
         printf("Runtime error: Field with id=%u not found\n", field_id);
         return INTERPRET_RUNTIME_ERROR;
@@ -1406,9 +1659,9 @@ InterpretResult op_store_field(VM* vm, uint32_t field_id) {
     }
     
     // Check if the field offset is valid
-    if (field_info->offset >= obj->header.size) {
+    if (field_info->offset >= (uint32_t)object_size(obj)) {
         printf("Runtime error: Field offset %u exceeds object size %u\n", 
-               field_info->offset, obj->header.size);
+               field_info->offset, (uint32_t)object_size(obj));
         return INTERPRET_RUNTIME_ERROR;
     }
     
@@ -1441,13 +1694,27 @@ InterpretResult op_store_field(VM* vm, uint32_t field_id) {
             *(bool*)field_data = value.data.bool_value;
             break;
         case 4: // string
-            if (value.type != VALUE_STRING) {
+            if (value.type != VALUE_STRING && value.type != VALUE_NULL) {
                 printf("Runtime error: Type mismatch for field %s (expected string, got %d)\n", 
                        field_info->name, value.type);
                 return INTERPRET_RUNTIME_ERROR;
             }
-            // For strings, we need to copy the string data
-            strcpy((char*)field_data, value.data.string_value);
+            // Strings are immutable and shared: store the reference
+            gc_satb_barrier(vm->heap, *(Object**)field_data);
+            *(StringObject**)field_data = value.type == VALUE_STRING ? value.data.string_value : NULL;
+            gc_write_barrier(vm->heap, obj);
+            break;
+        case FIELD_TYPE_OBJECT:
+            if (value.type != VALUE_OBJECT && value.type != VALUE_NULL) {
+                printf("Runtime error: Type mismatch for field %s (expected object, got %d)\n", 
+                       field_info->name, value.type);
+                return INTERPRET_RUNTIME_ERROR;
+            }
+            // Log the overwritten referent for a running concurrent mark
+            gc_satb_barrier(vm->heap, *(Object**)field_data);
+            *(Object**)field_data = value.type == VALUE_OBJECT ? value.data.object_value : NULL;
+            // Record the possible old-to-young reference for minor collections
+            gc_write_barrier(vm->heap, obj);
             break;
         default:
             printf("Runtime error: Unknown field type %u\n", field_info->type_id);
@@ -1488,8 +1755,31 @@ InterpretResult execute_method_bytecode(VM* vm, Method* method, Value object) {
         }
     }
     
-    // Execute the method bytecode using the existing interpreter
+    // The callee gets its own frame so its locals do not overwrite the caller's
+    CallFrame* method_frame = call_frame_create(vm->context, method->bytecode, method->local_count);
+    if (!method_frame || !execution_context_push_frame(vm->context, method_frame)) {
+        if (method_frame) call_frame_destroy(vm->context, method_frame);
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    // Execute the method bytecode using the existing interpreter; its
+    // allocations are profiled under its name
+    AllocProfiler* profiler = vm->heap ? vm->heap->profiler : NULL;
+    const char* caller_method = profiler ? profiler->site_method : NULL;
+    uint32_t caller_offset = profiler ? profiler->site_offset : 0;
+    if (profiler) {
+        profiler->site_method = method->name;
+    }
     InterpretResult result = interpret_bytecode(vm, method->bytecode, method->bytecode_size);
+    if (profiler) {
+        profiler->site_method = caller_method;
+        profiler->site_offset = caller_offset;
+    }
+    
+    // OP_RETURN stops the interpreter loop; the caller keeps running
+    CallFrame* frame = execution_context_pop_frame(vm->context);
+    if (frame) call_frame_destroy(vm->context, frame);
+    vm->running = true;
     
     // If the method didn't return a value, push a default one
     if (result == INTERPRET_OK && vm->stack->top == original_stack_top) {
@@ -1580,9 +1870,11 @@ InterpretResult op_option_some(VM* vm) {
         return INTERPRET_STACK_UNDERFLOW;
     }
     
-    Value value = stack_pop(vm->stack);
-    DEBUG_PRINT(vm, "DEBUG: op_option_some: popped value type=%d, value=%lld\n", value.type, value.data.i64_value);
-    Value option = value_create_option_some(&value);
+    // The payload stays on the stack, and so rooted, in case it needs a box
+    Value value = stack_peek(vm->stack, 0);
+    DEBUG_PRINT(vm, "DEBUG: op_option_some: payload type=%d, value=%lld\n", value.type, value.data.i64_value);
+    Value option = value_create_option_some(vm, &value);
+    stack_pop(vm->stack);
     DEBUG_PRINT(vm, "DEBUG: op_option_some: created option type=%d\n", option.type);
     
     if (!stack_push(vm->stack, option)) {
@@ -1682,8 +1974,9 @@ InterpretResult op_result_ok(VM* vm) {
         return INTERPRET_STACK_UNDERFLOW;
     }
     
-    Value value = stack_pop(vm->stack);
-    Value result = value_create_result_ok(&value);
+    Value value = stack_peek(vm->stack, 0);
+    Value result = value_create_result_ok(vm, &value);
+    stack_pop(vm->stack);
     
     if (!stack_push(vm->stack, result)) {
         return INTERPRET_STACK_OVERFLOW;
@@ -1701,8 +1994,9 @@ InterpretResult op_result_err(VM* vm) {
         return INTERPRET_STACK_UNDERFLOW;
     }
     
-    Value error = stack_pop(vm->stack);
-    Value result = value_create_result_err(&error);
+    Value error = stack_peek(vm->stack, 0);
+    Value result = value_create_result_err(vm, &error);
+    stack_pop(vm->stack);
     
     if (!stack_push(vm->stack, result)) {
         return INTERPRET_STACK_OVERFLOW;
@@ -1812,6 +2106,311 @@ InterpretResult op_match_when(VM* vm, uint32_t condition_index) {
     return INTERPRET_OK;
 }
 
+// ============================================================================
+// STRING OPERATIONS
+// ============================================================================
+
+InterpretResult op_string_concat(VM* vm) {
+    if (!vm || !vm->stack) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    if (stack_size(vm->stack) < 2) {
+        return INTERPRET_STACK_UNDERFLOW;
+    }
+    
+    // Both parts stay on the stack, and so rooted, while the result is allocated
+    Value right = stack_peek(vm->stack, 0);
+    Value left = stack_peek(vm->stack, 1);
+    if (left.type != VALUE_STRING || right.type != VALUE_STRING ||
+        !left.data.string_value || !right.data.string_value) {
+        fprintf(stderr, "Runtime error: Invalid operands for string concatenation (left.type=%d, right.type=%d)\n", left.type, right.type);
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    StringObject* string = string_concat(vm->heap, vm->rope_class,
+                                         left.data.string_value, right.data.string_value);
+    if (!string) {
+        fprintf(stderr, "Runtime error: Cannot allocate string\n");
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    stack_pop(vm->stack);
+    stack_pop(vm->stack);
+    
+    if (!stack_push(vm->stack, value_create_string_object(string))) {
+        return INTERPRET_STACK_OVERFLOW;
+    }
+    
+    return INTERPRET_OK;
+}
+
+// Stack: string, start, length -> substring
+InterpretResult op_string_substring(VM* vm) {
+    if (!vm || !vm->stack) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    if (stack_size(vm->stack) < 3) {
+        return INTERPRET_STACK_UNDERFLOW;
+    }
+    
+    // The string stays on the stack, and so rooted, while the result is allocated
+    Value length = stack_peek(vm->stack, 0);
+    Value start = stack_peek(vm->stack, 1);
+    Value string = stack_peek(vm->stack, 2);
+    if (string.type != VALUE_STRING || !string.data.string_value ||
+        start.type != VALUE_I64 || length.type != VALUE_I64) {
+        fprintf(stderr, "Runtime error: Invalid operands for substring (string.type=%d, start.type=%d, length.type=%d)\n",
+                string.type, start.type, length.type);
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    uint32_t string_length = string.data.string_value->length;
+    if (start.data.i64_value < 0 || length.data.i64_value < 0 ||
+        start.data.i64_value > (int64_t)string_length ||
+        length.data.i64_value > (int64_t)string_length - start.data.i64_value) {
+        fprintf(stderr, "Runtime error: Substring [%lld, +%lld) out of bounds for string of length %u\n",
+                (long long)start.data.i64_value, (long long)length.data.i64_value, string_length);
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    StringObject* substring = string_substring(vm->heap, vm->slice_class, string.data.string_value,
+                                               (size_t)start.data.i64_value, (size_t)length.data.i64_value);
+    if (!substring) {
+        fprintf(stderr, "Runtime error: Cannot allocate string\n");
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    stack_pop(vm->stack);
+    stack_pop(vm->stack);
+    stack_pop(vm->stack);
+    
+    if (!stack_push(vm->stack, value_create_string_object(substring))) {
+        return INTERPRET_STACK_OVERFLOW;
+    }
+    
+    return INTERPRET_OK;
+}
+
+// Bytes of the two strings on top of the stack, for operations that read
+// both. The strings stay on the stack, and so rooted, while either rope is
+// flattened. Reports a runtime error naming `operation` on failure.
+static bool interpret_string_pair(VM* vm, const char* operation, const char** left_bytes, uint32_t* left_length,
+                                  const char** right_bytes, uint32_t* right_length) {
+    Value right = stack_peek(vm->stack, 0);
+    Value left = stack_peek(vm->stack, 1);
+    if (left.type != VALUE_STRING || right.type != VALUE_STRING ||
+        !left.data.string_value || !right.data.string_value) {
+        fprintf(stderr, "Runtime error: Invalid operands for %s (left.type=%d, right.type=%d)\n",
+                operation, left.type, right.type);
+        return false;
+    }
+    
+    *left_bytes = string_flatten(vm->heap, left.data.string_value);
+    *right_bytes = string_flatten(vm->heap, right.data.string_value);
+    if (!*left_bytes || !*right_bytes) {
+        fprintf(stderr, "Runtime error: Cannot allocate string\n");
+        return false;
+    }
+    *left_length = left.data.string_value->length;
+    *right_length = right.data.string_value->length;
+    return true;
+}
+
+// Stack: string, substring -> byte index of the first occurrence, or -1
+InterpretResult op_string_index_of(VM* vm) {
+    if (!vm || !vm->stack) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    if (stack_size(vm->stack) < 2) {
+        return INTERPRET_STACK_UNDERFLOW;
+    }
+    
+    const char* haystack;
+    const char* needle;
+    uint32_t haystack_length, needle_length;
+    if (!interpret_string_pair(vm, "indexOf", &haystack, &haystack_length, &needle, &needle_length)) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    int64_t index = string_index_of(haystack, haystack_length, needle, needle_length);
+    stack_pop(vm->stack);
+    stack_pop(vm->stack);
+    
+    if (!stack_push(vm->stack, value_create_i64(index))) {
+        return INTERPRET_STACK_OVERFLOW;
+    }
+    
+    return INTERPRET_OK;
+}
+
+// Stack: string, substring -> byte index ignoring ASCII case, or -1
+InterpretResult op_string_index_of_ignore_case(VM* vm) {
+    if (!vm || !vm->stack) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    if (stack_size(vm->stack) < 2) {
+        return INTERPRET_STACK_UNDERFLOW;
+    }
+    
+    const char* haystack;
+    const char* needle;
+    uint32_t haystack_length, needle_length;
+    if (!interpret_string_pair(vm, "indexOfIgnoreCase", &haystack, &haystack_length, &needle, &needle_length)) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    int64_t index = utf8_index_of_ignore_case(haystack, haystack_length, needle, needle_length);
+    stack_pop(vm->stack);
+    stack_pop(vm->stack);
+    
+    if (!stack_push(vm->stack, value_create_i64(index))) {
+        return INTERPRET_STACK_OVERFLOW;
+    }
+    
+    return INTERPRET_OK;
+}
+
+// Stack: string, string -> boolean
+InterpretResult op_string_equals_ignore_case(VM* vm) {
+    if (!vm || !vm->stack) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    if (stack_size(vm->stack) < 2) {
+        return INTERPRET_STACK_UNDERFLOW;
+    }
+    
+    const char* left;
+    const char* right;
+    uint32_t left_length, right_length;
+    if (!interpret_string_pair(vm, "equalsIgnoreCase", &left, &left_length, &right, &right_length)) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    bool equal = left_length == right_length &&
+                 utf8_compare_ignore_case(left, left_length, right, right_length) == 0;
+    stack_pop(vm->stack);
+    stack_pop(vm->stack);
+    
+    if (!stack_push(vm->stack, value_create_bool(equal))) {
+        return INTERPRET_STACK_OVERFLOW;
+    }
+    
+    return INTERPRET_OK;
+}
+
+// Stack: string -> length in code points
+InterpretResult op_string_length(VM* vm) {
+    if (!vm || !vm->stack) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    if (stack_is_empty(vm->stack)) {
+        return INTERPRET_STACK_UNDERFLOW;
+    }
+    
+    Value string = stack_peek(vm->stack, 0);
+    if (string.type != VALUE_STRING || !string.data.string_value) {
+        fprintf(stderr, "Runtime error: length() expects a string, got type %d\n", string.type);
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    const char* bytes = string_flatten(vm->heap, string.data.string_value);
+    if (!bytes) {
+        fprintf(stderr, "Runtime error: Cannot allocate string\n");
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    size_t length = utf8_count_code_points(bytes, string.data.string_value->length);
+    stack_pop(vm->stack);
+    
+    if (!stack_push(vm->stack, value_create_i64((int64_t)length))) {
+        return INTERPRET_STACK_OVERFLOW;
+    }
+    
+    return INTERPRET_OK;
+}
+
+InterpretResult op_string_builder_new(VM* vm) {
+    if (!vm || !vm->stack) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    StringBuilderObject* builder = string_builder_create(vm->heap, vm->string_builder_class);
+    if (!builder) {
+        fprintf(stderr, "Runtime error: Cannot allocate StringBuilder\n");
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    if (!stack_push(vm->stack, value_create_object((struct Object*)builder))) {
+        return INTERPRET_STACK_OVERFLOW;
+    }
+    
+    return INTERPRET_OK;
+}
+
+// Stack: builder, string -> (empty)
+InterpretResult op_string_builder_append(VM* vm) {
+    if (!vm || !vm->stack) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    if (stack_size(vm->stack) < 2) {
+        return INTERPRET_STACK_UNDERFLOW;
+    }
+    
+    Value string = stack_peek(vm->stack, 0);
+    Value builder = stack_peek(vm->stack, 1);
+    if (builder.type != VALUE_OBJECT || !builder.data.object_value ||
+        object_class(builder.data.object_value) != vm->string_builder_class) {
+        fprintf(stderr, "Runtime error: StringBuilder.append() called on a non-builder (type=%d)\n", builder.type);
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    if (string.type != VALUE_STRING || !string.data.string_value) {
+        fprintf(stderr, "Runtime error: StringBuilder.append() expects a string argument, got type %d\n", string.type);
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    if (!string_builder_append(vm->heap, vm->string_class,
+                               (StringBuilderObject*)builder.data.object_value, string.data.string_value)) {
+        fprintf(stderr, "Runtime error: Cannot grow StringBuilder\n");
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    stack_pop(vm->stack);
+    stack_pop(vm->stack);
+    
+    return INTERPRET_OK;
+}
+
+InterpretResult op_string_builder_to_string(VM* vm) {
+    if (!vm || !vm->stack) {
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    if (stack_is_empty(vm->stack)) {
+        return INTERPRET_STACK_UNDERFLOW;
+    }
+    
+    Value builder = stack_peek(vm->stack, 0);
+    if (builder.type != VALUE_OBJECT || !builder.data.object_value ||
+        object_class(builder.data.object_value) != vm->string_builder_class) {
+        fprintf(stderr, "Runtime error: StringBuilder.toString() called on a non-builder (type=%d)\n", builder.type);
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    
+    StringObject* string = string_builder_to_string(vm->heap, vm->string_class,
+                                                    (StringBuilderObject*)builder.data.object_value);
+    if (!string) {
+        fprintf(stderr, "Runtime error: Cannot allocate string\n");
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    stack_pop(vm->stack);
+    
+    if (!stack_push(vm->stack, value_create_string_object(string))) {
+        return INTERPRET_STACK_OVERFLOW;
+    }
+    
+    return INTERPRET_OK;
+}
+
 const char* interpret_result_to_string(InterpretResult result) {
     switch (result) {
         case INTERPRET_OK:
@@ -67,6 +67,17 @@ InterpretResult op_result_is_ok(VM* vm);
 InterpretResult op_result_unwrap(VM* vm);
 InterpretResult op_result_unwrap_or(VM* vm);
 
+// String operations
+InterpretResult op_string_concat(VM* vm);
+InterpretResult op_string_substring(VM* vm);
+InterpretResult op_string_index_of(VM* vm);
+InterpretResult op_string_length(VM* vm);
+InterpretResult op_string_equals_ignore_case(VM* vm);
+InterpretResult op_string_index_of_ignore_case(VM* vm);
+InterpretResult op_string_builder_new(VM* vm);
+InterpretResult op_string_builder_append(VM* vm);
+InterpretResult op_string_builder_to_string(VM* vm);
+
 // Pattern matching operations
 InterpretResult op_match(VM* vm, uint32_t pattern_count);
 InterpretResult op_match_case(VM* vm, uint32_t case_index);
@@ -0,0 +1,424 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../vm.h"
+#include "emitter/ir_to_bytecode.h"
+#include "../../shared/bytecode/helium_format.h"
+#include "../../shared/bytecode/opcodes.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+// Interpreter tests - build methods in IR, translate and save them as a
+// module, then load and run them in a fresh VM
+
+static IRValue local_value(uint32_t index) {
+    IRValue value;
+    value.type = IR_VALUE_TEMP;
+    value.data.temp_id = index;
+    return value;
+}
+
+static void add_local_op(IRBuilder* builder, IROp op, uint32_t index) {
+    IRValue value = local_value(index);
+    ir_builder_add_instruction_with_operands(builder, op, &value, 1);
+}
+
+static void add_constant(IRBuilder* builder, int64_t constant) {
+    IRValue value = ir_builder_create_i64_value(constant);
+    ir_builder_add_instruction_with_operands(builder, IR_LOAD_CONST, &value, 1);
+}
+
+static void add_op(IRBuilder* builder, IROp op) {
+    ir_builder_add_instruction(builder, ir_builder_create_instruction(builder, op));
+}
+
+// Translate main() into a module, with compact operands or the 4-byte
+// forms only
+static HeliumModule* translate_main(IRFunction* function, bool compact) {
+    IRToBytecodeTranslator* translator = ir_to_bytecode_translator_create();
+    assert(translator != NULL);
+    translator->compact_operands = compact;
+    translator->current_function = function;
+    uint32_t method_id = ir_to_bytecode_add_method(translator, "main", "()I", 1);
+    assert(method_id != 0);
+    bool translated = ir_to_bytecode_translate_function(translator, function);
+    assert(translated);
+    BytecodeFile* file = ir_to_bytecode_generate_file(translator);
+    assert(file != NULL);
+    
+    // Hand the tables and bytecode to a module, as the packager does
+    HeliumModule* module = helium_module_create();
+    assert(module != NULL);
+    string_table_destroy(module->string_table_obj);
+    constant_table_destroy(module->constant_table);
+    type_table_destroy(module->type_table);
+    method_table_destroy(module->method_table);
+    module->string_table_obj = translator->string_table;
+    module->constant_table = translator->constant_table;
+    module->type_table = translator->type_table;
+    module->method_table = translator->method_table;
+    module->bytecode = file->bytecode;
+    module->bytecode_size = (uint32_t)file->bytecode_size;
+    module->header.bytecode_size = module->bytecode_size;
+    module->header.entry_point_method_id = 1;
+    file->bytecode = NULL;
+    file->string_table = NULL;
+    file->constant_table = NULL;
+    file->type_table = NULL;
+    file->method_table = NULL;
+    translator->string_table = NULL;
+    translator->constant_table = NULL;
+    translator->type_table = NULL;
+    translator->method_table = NULL;
+    ir_to_bytecode_translator_destroy(translator);
+    return module;
+}
+
+// Save a module, release it, and run the file in a fresh VM; returns main's
+// result
+static int run_module(HeliumModule* module) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/he3_interpreter_test_%d.helium3", (int)getpid());
+    bool saved = helium_module_save(module, path);
+    helium_module_destroy(module);
+    assert(saved);
+    
+    VM* vm = vm_create();
+    assert(vm != NULL);
+    vm_initialize_object_system(vm);
+    bool loaded = vm_load_helium3_module(vm, path);
+    assert(loaded);
+    int result = vm_execute(vm);
+    vm_destroy(vm);
+    unlink(path);
+    return result;
+}
+
+// Translate main() with compact operands and run it
+static int run_main(IRFunction* function) {
+    return run_module(translate_main(function, true));
+}
+
+// Instructions of a module's bytecode with this opcode, or with this opcode
+// behind an OP_WIDE prefix
+static uint32_t count_opcode(HeliumModule* module, uint8_t opcode, bool wide) {
+    uint32_t count = 0;
+    for (size_t ip = 0; ip < module->bytecode_size; ip += opcode_get_size(module->bytecode, ip)) {
+        bool is_wide = module->bytecode[ip] == OP_WIDE;
+        uint8_t current = is_wide ? module->bytecode[ip + 1] : module->bytecode[ip];
+        count += current == opcode && is_wide == wide;
+    }
+    return count;
+}
+
+// Test forward, backward and conditional jumps
+void test_jumps(void) {
+    printf("=== Testing Jumps ===\n");
+    
+    IRBuilder* builder = ir_builder_create();
+    assert(builder != NULL);
+    IRFunction* function = ir_builder_create_function(builder, "main", 0);
+    assert(function != NULL);
+    function->local_count = 2;
+    IRBlock* entry = ir_builder_create_block(builder, "entry");
+    IRBlock* cond = ir_builder_create_block(builder, "cond");
+    IRBlock* body = ir_builder_create_block(builder, "body");
+    IRBlock* exit = ir_builder_create_block(builder, "exit");
+    IRBlock* then_block = ir_builder_create_block(builder, "then");
+    IRBlock* else_block = ir_builder_create_block(builder, "else");
+    IRBlock* join = ir_builder_create_block(builder, "join");
+    IRBlock* done = ir_builder_create_block(builder, "done");
+    
+    // i = 0, sum = 0
+    ir_builder_set_current_block(builder, entry);
+    add_constant(builder, 0);
+    add_local_op(builder, IR_STORE_LOCAL, 0);
+    add_constant(builder, 0);
+    add_local_op(builder, IR_STORE_LOCAL, 1);
+    ir_builder_add_jump(builder, cond);
+    
+    // while (i < 10) { sum = sum + i; i = i + 1; }
+    ir_builder_set_current_block(builder, cond);
+    add_local_op(builder, IR_LOAD_LOCAL, 0);
+    add_constant(builder, 10);
+    add_op(builder, IR_LT);
+    ir_builder_add_conditional_jump_op(builder, IR_JMPF, exit);
+    
+    ir_builder_set_current_block(builder, body);
+    add_local_op(builder, IR_LOAD_LOCAL, 1);
+    add_local_op(builder, IR_LOAD_LOCAL, 0);
+    add_op(builder, IR_ADD);
+    add_local_op(builder, IR_STORE_LOCAL, 1);
+    add_local_op(builder, IR_LOAD_LOCAL, 0);
+    add_constant(builder, 1);
+    add_op(builder, IR_ADD);
+    add_local_op(builder, IR_STORE_LOCAL, 0);
+    ir_builder_add_jump(builder, cond);
+    
+    // if (sum > 40) { sum = sum + 100; } else { sum = 0; }
+    ir_builder_set_current_block(builder, exit);
+    add_local_op(builder, IR_LOAD_LOCAL, 1);
+    add_constant(builder, 40);
+    add_op(builder, IR_GT);
+    ir_builder_add_conditional_jump_op(builder, IR_JMPF, else_block);
+    
+    ir_builder_set_current_block(builder, then_block);
+    add_local_op(builder, IR_LOAD_LOCAL, 1);
+    add_constant(builder, 100);
+    add_op(builder, IR_ADD);
+    add_local_op(builder, IR_STORE_LOCAL, 1);
+    ir_builder_add_jump(builder, join);
+    
+    ir_builder_set_current_block(builder, else_block);
+    add_constant(builder, 0);
+    add_local_op(builder, IR_STORE_LOCAL, 1);
+    
+    // if (sum != 145) { sum = 7; }
+    ir_builder_set_current_block(builder, join);
+    add_local_op(builder, IR_LOAD_LOCAL, 1);
+    add_constant(builder, 145);
+    add_op(builder, IR_EQ);
+    ir_builder_add_conditional_jump_op(builder, IR_JMPT, done);
+    add_constant(builder, 7);
+    add_local_op(builder, IR_STORE_LOCAL, 1);
+    
+    ir_builder_set_current_block(builder, done);
+    add_local_op(builder, IR_LOAD_LOCAL, 1);
+    add_op(builder, IR_RETURN);
+    
+    int result = run_main(function);
+    printf("Result: %d\n", result);
+    assert(result == 145);
+    
+    ir_builder_destroy(builder);
+    printf("Jump test passed!\n");
+}
+
+// main(): sum = 0 + 1 + 2 in a loop whose body holds `padding` bytes of
+// NOPs, then a jump over as many bytes of dead code; returns 3
+static IRFunction* make_padded_loop(IRBuilder* builder, uint32_t padding) {
+    IRFunction* function = ir_builder_create_function(builder, "main", 0);
+    assert(function != NULL);
+    function->local_count = 2;
+    IRBlock* entry = ir_builder_create_block(builder, "entry");
+    IRBlock* cond = ir_builder_create_block(builder, "cond");
+    IRBlock* body = ir_builder_create_block(builder, "body");
+    IRBlock* exit = ir_builder_create_block(builder, "exit");
+    IRBlock* dead = ir_builder_create_block(builder, "dead");
+    IRBlock* done = ir_builder_create_block(builder, "done");
+    
+    ir_builder_set_current_block(builder, entry);
+    add_constant(builder, 0);
+    add_local_op(builder, IR_STORE_LOCAL, 0);
+    add_constant(builder, 0);
+    add_local_op(builder, IR_STORE_LOCAL, 1);
+    ir_builder_add_jump(builder, cond);
+    
+    // Forward over the body, which jumps back over itself
+    ir_builder_set_current_block(builder, cond);
+    add_local_op(builder, IR_LOAD_LOCAL, 0);
+    add_constant(builder, 3);
+    add_op(builder, IR_LT);
+    ir_builder_add_conditional_jump_op(builder, IR_JMPF, exit);
+    
+    ir_builder_set_current_block(builder, body);
+    for (uint32_t i = 0; i < padding; i++) {
+        add_op(builder, IR_NOP);
+    }
+    add_local_op(builder, IR_LOAD_LOCAL, 1);
+    add_local_op(builder, IR_LOAD_LOCAL, 0);
+    add_op(builder, IR_ADD);
+    add_local_op(builder, IR_STORE_LOCAL, 1);
+    add_local_op(builder, IR_LOAD_LOCAL, 0);
+    add_constant(builder, 1);
+    add_op(builder, IR_ADD);
+    add_local_op(builder, IR_STORE_LOCAL, 0);
+    ir_builder_add_jump(builder, cond);
+    
+    // Unconditionally forward over code that would change the sum
+    ir_builder_set_current_block(builder, exit);
+    ir_builder_add_jump(builder, done);
+    
+    ir_builder_set_current_block(builder, dead);
+    for (uint32_t i = 0; i < padding; i++) {
+        add_op(builder, IR_NOP);
+    }
+    add_constant(builder, 100);
+    add_local_op(builder, IR_STORE_LOCAL, 1);
+    
+    ir_builder_set_current_block(builder, done);
+    add_local_op(builder, IR_LOAD_LOCAL, 1);
+    add_op(builder, IR_RETURN);
+    return function;
+}
+
+// Jumps, forward and backward, taken or not, by the form they were given
+typedef struct {
+    uint32_t short_jumps;
+    uint32_t wide_jumps;
+    uint32_t long_jumps;
+} JumpForms;
+
+// Run the padded loop for each padding in [first, last] in both encodings
+static void run_padded_loops(uint32_t first, uint32_t last, JumpForms* forms) {
+    static const uint8_t short_jumps[] = { OP_JUMP_S, OP_JUMP_IF_TRUE_S, OP_JUMP_IF_FALSE_S };
+    static const uint8_t long_jumps[] = { OP_JUMP, OP_JUMP_IF_TRUE, OP_JUMP_IF_FALSE };
+    memset(forms, 0, sizeof(*forms));
+    for (uint32_t padding = first; padding <= last; padding++) {
+        IRBuilder* builder = ir_builder_create();
+        assert(builder != NULL);
+        IRFunction* function = make_padded_loop(builder, padding);
+        for (int compact = 0; compact < 2; compact++) {
+            HeliumModule* module = translate_main(function, compact == 1);
+            for (int i = 0; i < 3; i++) {
+                if (compact) {
+                    forms->short_jumps += count_opcode(module, short_jumps[i], false);
+                    forms->wide_jumps += count_opcode(module, short_jumps[i], true);
+                    forms->long_jumps += count_opcode(module, long_jumps[i], false);
+                } else {
+                    assert(count_opcode(module, short_jumps[i], false) == 0);
+                }
+            }
+            int result = run_module(module);
+            if (result != 3) {
+                printf("Padding %u (%s operands): got %d\n", padding, compact ? "compact" : "4-byte", result);
+            }
+            assert(result == 3);
+        }
+        ir_builder_destroy(builder);
+    }
+}
+
+// Test jumps on either side of the 1-byte and 2-byte offset limits
+void test_jump_boundaries(void) {
+    printf("=== Testing Jump Boundaries ===\n");
+    
+    // The jumps over the body cross 127 bytes in this range
+    JumpForms forms;
+    run_padded_loops(100, 140, &forms);
+    printf("Near 127 bytes: %u short, %u wide, %u long jumps\n",
+           forms.short_jumps, forms.wide_jumps, forms.long_jumps);
+    assert(forms.short_jumps > 0 && forms.wide_jumps > 0 && forms.long_jumps == 0);
+    
+    // And 32767 bytes in this one
+    run_padded_loops(32740, 32790, &forms);
+    printf("Near 32767 bytes: %u short, %u wide, %u long jumps\n",
+           forms.short_jumps, forms.wide_jumps, forms.long_jumps);
+    assert(forms.wide_jumps > 0 && forms.long_jumps > 0);
+    
+    printf("Jump boundary test passed!\n");
+}
+
+// Test local and constant operands in each compact form and past them:
+// in the opcode, one byte, OP_WIDE and two bytes, and the 4-byte forms
+void test_wide_operands(void) {
+    printf("=== Testing Wide Operands ===\n");
+    
+    static const uint32_t locals[] = { 0, 3, 4, 255, 256, 65535, 65536 };
+    const uint32_t local_count = sizeof(locals) / sizeof(locals[0]);
+    const uint32_t constant_count = 65600;
+    IRBuilder* builder = ir_builder_create();
+    assert(builder != NULL);
+    IRFunction* function = ir_builder_create_function(builder, "main", 0);
+    assert(function != NULL);
+    function->local_count = 65537;
+    IRBlock* entry = ir_builder_create_block(builder, "entry");
+    ir_builder_set_current_block(builder, entry);
+    
+    // locals[i] = locals[i] + 1, then the sum of enough constants that their
+    // indices pass 255 and 65535, then the sum of the locals
+    int expected = 0;
+    for (uint32_t i = 0; i < local_count; i++) {
+        add_constant(builder, locals[i] + 1);
+        add_local_op(builder, IR_STORE_LOCAL, locals[i]);
+        expected += (int)locals[i] + 1;
+    }
+    for (uint32_t i = 0; i < constant_count; i++) {
+        add_constant(builder, i % 10);
+        if (i > 0) {
+            add_op(builder, IR_ADD);
+        }
+        expected += (int)(i % 10);
+    }
+    for (uint32_t i = 0; i < local_count; i++) {
+        add_local_op(builder, IR_LOAD_LOCAL, locals[i]);
+        add_op(builder, IR_ADD);
+    }
+    add_op(builder, IR_RETURN);
+    
+    HeliumModule* module = translate_main(function, true);
+    assert(count_opcode(module, OP_STORE_LOCAL_0, false) == 1 && count_opcode(module, OP_LOAD_LOCAL_3, false) == 1);
+    assert(count_opcode(module, OP_STORE_LOCAL_S, false) == 2 && count_opcode(module, OP_LOAD_LOCAL_S, false) == 2);
+    assert(count_opcode(module, OP_STORE_LOCAL_S, true) == 2 && count_opcode(module, OP_LOAD_LOCAL_S, true) == 2);
+    assert(count_opcode(module, OP_STORE_LOCAL, false) == 1 && count_opcode(module, OP_LOAD_LOCAL, false) == 1);
+    assert(count_opcode(module, OP_PUSH_CONSTANT_S, false) == 256);
+    assert(count_opcode(module, OP_PUSH_CONSTANT_S, true) == 65536 - 256);
+    assert(count_opcode(module, OP_PUSH_CONSTANT, false) == local_count + constant_count - 65536);
+    int result = run_module(module);
+    printf("Result: %d (expected %d)\n", result, expected);
+    assert(result == expected);
+    
+    result = run_module(translate_main(function, false));
+    assert(result == expected);
+    
+    ir_builder_destroy(builder);
+    printf("Wide operand test passed!\n");
+}
+
+// Test that strings and boxes are allocated on the heap of the VM that
+// creates them while another VM exists, and after it is destroyed
+void test_two_vms(void) {
+    printf("=== Testing Two VMs ===\n");
+    
+    VM* first = vm_create();
+    assert(first != NULL);
+    vm_initialize_object_system(first);
+    VM* second = vm_create();
+    assert(second != NULL);
+    vm_initialize_object_system(second);
+    
+    Value string = value_create_string(first, "first");
+    assert(string.type == VALUE_STRING);
+    assert(heap_is_valid_pointer(first->heap, string.data.string_value));
+    assert(!heap_is_valid_pointer(second->heap, string.data.string_value));
+    
+    // A nested Option is boxed on its VM's heap
+    Value inner = value_create_option_some(second, &string);
+    Value outer = value_create_option_some(second, &inner);
+    assert(outer.type == VALUE_OPTION && outer.payload_type == VALUE_OPTION);
+    assert(heap_is_valid_pointer(second->heap, outer.data.object_value));
+    assert(value_equals(second, value_option_unwrap(&outer), inner));
+    
+    vm_destroy(second);
+    Value later = value_create_string(first, "later");
+    assert(later.type == VALUE_STRING);
+    assert(heap_is_valid_pointer(first->heap, later.data.string_value));
+    Value boxed = value_create_result_ok(first, &inner);
+    assert(heap_is_valid_pointer(first->heap, boxed.data.object_value));
+    assert(value_equals(first, value_result_unwrap(&boxed), inner));
+    vm_destroy(first);
+    
+    printf("Two VMs test passed!\n");
+}
+
+int main(void) {
+    printf("He³ Interpreter Test Suite\n");
+    printf("==========================\n\n");
+    
+    test_jumps();
+    printf("\n");
+    
+    test_jump_boundaries();
+    printf("\n");
+    
+    test_wide_operands();
+    printf("\n");
+    
+    test_two_vms();
+    printf("\n");
+    
+    printf("All interpreter tests passed!\n");
+    return 0;
+}
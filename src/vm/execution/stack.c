@@ -113,7 +113,7 @@ void stack_print(Stack* stack) {
     printf("Stack (size: %zu, capacity: %zu):\n", stack->top, stack->capacity);
     for (size_t i = 0; i < stack->top; i++) {
         printf("  [%zu]: ", i);
-        value_print(stack->values[i]);
+        value_print(NULL, stack->values[i]);
         printf(" (%s)\n", value_type_to_string(stack->values[i].type));
     }
 }
@@ -130,7 +130,7 @@ void stack_print_top_n(Stack* stack, size_t n) {
     for (size_t i = 0; i < print_count; i++) {
         size_t index = stack->top - 1 - i;
         printf("  [%zu]: ", i);
-        value_print(stack->values[index]);
+        value_print(NULL, stack->values[index]);
         printf(" (%s)\n", value_type_to_string(stack->values[index].type));
     }
 }
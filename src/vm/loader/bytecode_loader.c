@@ -74,6 +74,8 @@ BytecodeFile* bytecode_load_file(const char* filename) {
                 
                 bytecode_file->string_table->count = count;
                 bytecode_file->string_table->total_size = total_size;
+                bytecode_file->string_table->entry_capacity = count;
+                bytecode_file->string_table->data_capacity = total_size;
                 
                 // Allocate and read entries
                 if (count > 0) {
@@ -4,11 +4,25 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <signal.h>
+
+// SIGUSR1 asks the running VM to write its allocation profile
+static void handle_profile_signal(int sig) {
+    (void)sig;
+    vm_heap_profile_requested = 1;
+}
+
+// SIGUSR2 asks the running VM to write a heap snapshot
+static void handle_snapshot_signal(int sig) {
+    (void)sig;
+    vm_heap_snapshot_requested = 1;
+}
 
 // Print usage information
 void print_usage(const char* program_name) {
     printf("He³ Virtual Machine (he3vm)\n");
-    printf("Usage: %s [options] <bytecode_file.bx>\n", program_name);
+    printf("Usage: %s [options] <bytecode_file.bx> [options] [-- program arguments]\n", program_name);
+    printf("       %s [options] --snapshot-in=IMAGE [-- program arguments]\n", program_name);
     printf("\n");
     printf("Options:\n");
     printf("  -h, --help     Show this help message\n");
@@ -19,6 +33,24 @@ void print_usage(const char* program_name) {
     printf("  -r, --regions  Show memory regions\n");
     printf("  -o, --objects  Show object system information\n");
     printf("  -c, --classes  Show loaded classes\n");
+    printf("  --gc-concurrent  Mark the heap on a background thread\n");
+    printf("  --gc-threads=N   Mark and sweep full collections with N threads\n");
+    printf("  --gc-incremental Collect the whole heap in short slices\n");
+    printf("  --gc-pause-target=US  Incremental slice budget in microseconds\n");
+    printf("  --gc-log=FILE    Write one JSON line per GC cycle to FILE\n");
+    printf("  --heap-soft-limit=MB  Grow the heap without collecting up to MB\n");
+    printf("  --heap-hard-limit=MB  Never grow the heap past MB (at most 1024)\n");
+    printf("  --heap-huge-pages     Back the heap with transparent huge pages\n");
+    printf("  --heap-profile=FILE   Write a sampled allocation profile to FILE at exit\n");
+    printf("                        (and on SIGUSR1)\n");
+    printf("  --heap-profile-rate=N Sample one allocation in N (default %d)\n", ALLOC_PROFILE_DEFAULT_RATE);
+    printf("  --heap-snapshot=FILE  Write a heap snapshot to FILE at exit\n");
+    printf("                        (and on SIGUSR2 or out of memory)\n");
+    printf("  --snapshot-out=IMAGE  Load, link and initialize the module, write a\n");
+    printf("                        VM image to IMAGE and exit without running it\n");
+    printf("  --snapshot-in=IMAGE   Run the VM image IMAGE instead of a module file\n");
+    printf("  --project=FILE        Load the dependency modules of project FILE first\n");
+    printf("  --load-threads=N      Load project modules on N threads (default: one per core)\n");
     printf("\n");
     printf("Examples:\n");
     printf("  %s program.bx\n", program_name);
@@ -28,6 +60,11 @@ void print_usage(const char* program_name) {
     printf("  %s -r program.bx\n", program_name);
     printf("  %s -o program.bx\n", program_name);
     printf("  %s -c program.bx\n", program_name);
+    printf("  %s program.bx --debug\n", program_name);
+    printf("  %s program.bx -- input.txt\n", program_name);
+    printf("  %s --snapshot-out=program.he3img program.helium3\n", program_name);
+    printf("  %s --snapshot-in=program.he3img -- input.txt\n", program_name);
+    printf("  %s --project=he3project.json program.helium3\n", program_name);
 }
 
 // Print version information
@@ -49,6 +86,23 @@ int main(int argc, char* argv[]) {
     bool show_regions = false;
     bool show_objects = false;
     bool show_classes = false;
+    bool gc_concurrent = false;
+    int gc_threads = 1;
+    bool gc_incremental = false;
+    int gc_pause_target = 0;
+    const char* gc_log_path = NULL;
+    int heap_soft_limit_mb = 0;
+    int heap_hard_limit_mb = 0;
+    bool heap_huge_pages = false;
+    const char* heap_profile_path = NULL;
+    int heap_profile_rate = 0;
+    const char* heap_snapshot_path = NULL;
+    const char* snapshot_out_path = NULL;
+    const char* snapshot_in_path = NULL;
+    const char* project_path = NULL;
+    int load_threads = 0;
+    int program_argc = 0;
+    char** program_argv = NULL;
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -70,9 +124,73 @@ int main(int argc, char* argv[]) {
             show_objects = true;
         } else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--classes") == 0) {
             show_classes = true;
-        } else if (argv[i][0] != '-') {
-            // This is the bytecode file
+        } else if (strcmp(argv[i], "--gc-concurrent") == 0) {
+            gc_concurrent = true;
+        } else if (strncmp(argv[i], "--gc-threads=", 13) == 0) {
+            gc_threads = atoi(argv[i] + 13);
+            if (gc_threads < 1) {
+                fprintf(stderr, "Invalid GC thread count: %s\n", argv[i] + 13);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--gc-incremental") == 0) {
+            gc_incremental = true;
+        } else if (strncmp(argv[i], "--gc-pause-target=", 18) == 0) {
+            gc_pause_target = atoi(argv[i] + 18);
+            if (gc_pause_target < 1) {
+                fprintf(stderr, "Invalid GC pause target: %s\n", argv[i] + 18);
+                return 1;
+            }
+            gc_incremental = true;
+        } else if (strncmp(argv[i], "--gc-log=", 9) == 0) {
+            gc_log_path = argv[i] + 9;
+        } else if (strncmp(argv[i], "--heap-soft-limit=", 18) == 0) {
+            heap_soft_limit_mb = atoi(argv[i] + 18);
+            if (heap_soft_limit_mb < 1) {
+                fprintf(stderr, "Invalid heap soft limit: %s\n", argv[i] + 18);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--heap-hard-limit=", 18) == 0) {
+            heap_hard_limit_mb = atoi(argv[i] + 18);
+            if (heap_hard_limit_mb < 1) {
+                fprintf(stderr, "Invalid heap hard limit: %s\n", argv[i] + 18);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--heap-huge-pages") == 0) {
+            heap_huge_pages = true;
+        } else if (strncmp(argv[i], "--heap-profile=", 15) == 0) {
+            heap_profile_path = argv[i] + 15;
+        } else if (strncmp(argv[i], "--heap-profile-rate=", 20) == 0) {
+            heap_profile_rate = atoi(argv[i] + 20);
+            if (heap_profile_rate < 1) {
+                fprintf(stderr, "Invalid heap profile rate: %s\n", argv[i] + 20);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--heap-snapshot=", 16) == 0) {
+            heap_snapshot_path = argv[i] + 16;
+        } else if (strncmp(argv[i], "--snapshot-out=", 15) == 0) {
+            snapshot_out_path = argv[i] + 15;
+        } else if (strncmp(argv[i], "--snapshot-in=", 14) == 0) {
+            snapshot_in_path = argv[i] + 14;
+        } else if (strncmp(argv[i], "--project=", 10) == 0) {
+            project_path = argv[i] + 10;
+        } else if (strncmp(argv[i], "--load-threads=", 15) == 0) {
+            load_threads = atoi(argv[i] + 15);
+            if (load_threads < 1) {
+                fprintf(stderr, "Invalid load thread count: %s\n", argv[i] + 15);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--") == 0) {
+            // Everything after the separator belongs to the program
+            program_argc = argc - i - 1;
+            program_argv = argv + i + 1;
+            break;
+        } else if (argv[i][0] != '-' && !bytecode_file) {
+            // This is the bytecode file; VM options may still follow it
             bytecode_file = argv[i];
+        } else if (argv[i][0] != '-') {
+            fprintf(stderr, "Unexpected argument: %s (pass program arguments after --)\n", argv[i]);
+            print_usage(program_name);
+            return 1;
         } else {
             fprintf(stderr, "Unknown option: %s\n", argv[i]);
             print_usage(program_name);
@@ -82,15 +200,28 @@ int main(int argc, char* argv[]) {
     
     // Check if bytecode file was provided (only required if not showing help/version)
     // Note: help and version flags already returned above, so this check is only for normal execution
-    if (!bytecode_file) {
+    if (!bytecode_file && !snapshot_in_path) {
         fprintf(stderr, "Error: No bytecode file specified\n");
         print_usage(program_name);
         return 1;
     }
+    if (snapshot_in_path && snapshot_out_path) {
+        fprintf(stderr, "Error: --snapshot-in and --snapshot-out cannot be combined\n");
+        return 1;
+    }
+    if (snapshot_in_path && bytecode_file) {
+        fprintf(stderr, "Error: --snapshot-in replaces the module file; pass program arguments after --\n");
+        return 1;
+    }
+    if (snapshot_in_path && project_path) {
+        fprintf(stderr, "Error: --project cannot be used with a VM image\n");
+        return 1;
+    }
     
     if (debug_mode) {
         printf("Debug mode enabled\n");
-        printf("Loading bytecode file: %s\n", bytecode_file);
+        printf("Loading %s: %s\n", snapshot_in_path ? "VM image" : "bytecode file",
+               snapshot_in_path ? snapshot_in_path : bytecode_file);
     }
     
     // Create VM
@@ -102,6 +233,51 @@ int main(int argc, char* argv[]) {
     
     // Set debug mode
     vm_set_debug(vm, debug_mode);
+    vm_set_gc_concurrent(vm, gc_concurrent);
+    vm_set_gc_threads(vm, (uint32_t)gc_threads);
+    vm_set_load_threads(vm, (uint32_t)load_threads);
+    vm_set_gc_incremental(vm, gc_incremental);
+    if (gc_pause_target > 0) {
+        vm_set_gc_pause_target(vm, (uint32_t)gc_pause_target);
+    }
+    if (heap_soft_limit_mb > 0 || heap_hard_limit_mb > 0) {
+        size_t soft = heap_soft_limit_mb > 0 ? (size_t)heap_soft_limit_mb * 1024 * 1024 : vm->heap->soft_limit;
+        size_t hard = heap_hard_limit_mb > 0 ? (size_t)heap_hard_limit_mb * 1024 * 1024 : vm->heap->hard_limit;
+        if (!vm_set_heap_limits(vm, soft, hard)) {
+            fprintf(stderr, "Error: Invalid heap limits (hard limit must be at most %zu MB)\n",
+                    vm->heap->reserved_size / (1024 * 1024));
+            vm_destroy(vm);
+            return 1;
+        }
+    }
+    if (heap_huge_pages && !vm_set_heap_huge_pages(vm, true)) {
+        fprintf(stderr, "Warning: Transparent huge pages are not available\n");
+    }
+    if (heap_profile_path) {
+        if (!vm_set_heap_profile(vm, heap_profile_path, (uint32_t)heap_profile_rate)) {
+            fprintf(stderr, "Error: Cannot enable the allocation profiler\n");
+            vm_destroy(vm);
+            return 1;
+        }
+        signal(SIGUSR1, handle_profile_signal);
+    }
+    if (heap_snapshot_path) {
+        if (!vm_set_heap_snapshot(vm, heap_snapshot_path)) {
+            fprintf(stderr, "Error: Cannot enable heap snapshots\n");
+            vm_destroy(vm);
+            return 1;
+        }
+        signal(SIGUSR2, handle_snapshot_signal);
+    }
+    if (!vm_set_program_args(vm, program_argc, program_argv)) {
+        vm_destroy(vm);
+        return 1;
+    }
+    if (gc_log_path && !vm_set_gc_log(vm, gc_log_path)) {
+        fprintf(stderr, "Error: Cannot open GC log '%s'\n", gc_log_path);
+        vm_destroy(vm);
+        return 1;
+    }
     
     if (debug_mode) {
         printf("VM created successfully\n");
@@ -113,54 +289,80 @@ int main(int argc, char* argv[]) {
         printf("Object system initialized\n");
     }
     
-    // Check if file exists
-    FILE* file = fopen(bytecode_file, "rb");
-    if (!file) {
-        fprintf(stderr, "Error: Cannot open file '%s'\n", bytecode_file);
-        
-        // Show object system info even if file doesn't exist
-        if (show_objects) {
-            printf("\nObject system (file not found):\n");
-            vm_print_object_system(vm);
+    // A VM image replaces loading the module
+    if (snapshot_in_path) {
+        if (!vm_image_load(vm, snapshot_in_path)) {
+            vm_destroy(vm);
+            return 1;
         }
+    } else {
+        // Check if file exists
+        FILE* file = fopen(bytecode_file, "rb");
+        if (!file) {
+            fprintf(stderr, "Error: Cannot open file '%s'\n", bytecode_file);
         
-        if (show_classes) {
-            printf("\nClasses (file not found):\n");
-            vm_print_classes(vm);
-        }
+            // Show object system info even if file doesn't exist
+            if (show_objects) {
+                printf("\nObject system (file not found):\n");
+                vm_print_object_system(vm);
+            }
         
-        vm_destroy(vm);
-        return 1;
-    }
-    fclose(file);
-    
-    // Load .helium3 module
-    if (!vm_load_helium3_module(vm, bytecode_file)) {
-        fprintf(stderr, "Error: Failed to load bytecode file\n");
+            if (show_classes) {
+                printf("\nClasses (file not found):\n");
+                vm_print_classes(vm);
+            }
         
-        // Show memory stats even if bytecode loading fails
-        if (show_memory) {
-            printf("\nMemory state after failed bytecode load:\n");
-            vm_print_heap_stats(vm);
+            vm_destroy(vm);
+            return 1;
         }
-        
-        if (show_regions) {
-            printf("\nMemory regions after failed bytecode load:\n");
-            vm_print_heap_regions(vm);
+        fclose(file);
+    
+        // Libraries are registered before the program, which stays current
+        if (project_path && !vm_load_project_modules(vm, project_path)) {
+            vm_destroy(vm);
+            return 1;
         }
+    
+        // Load .helium3 module
+        if (!vm_load_helium3_module(vm, bytecode_file)) {
+            fprintf(stderr, "Error: Failed to load bytecode file\n");
         
-        if (show_objects) {
-            printf("\nObject system after failed bytecode load:\n");
-            vm_print_object_system(vm);
-        }
+            // Show memory stats even if bytecode loading fails
+            if (show_memory) {
+                printf("\nMemory state after failed bytecode load:\n");
+                vm_print_heap_stats(vm);
+            }
         
-        if (show_classes) {
-            printf("\nClasses after failed bytecode load:\n");
-            vm_print_classes(vm);
-        }
+            if (show_regions) {
+                printf("\nMemory regions after failed bytecode load:\n");
+                vm_print_heap_regions(vm);
+            }
+        
+            if (show_objects) {
+                printf("\nObject system after failed bytecode load:\n");
+                vm_print_object_system(vm);
+            }
         
+            if (show_classes) {
+                printf("\nClasses after failed bytecode load:\n");
+                vm_print_classes(vm);
+            }
+        
+            vm_destroy(vm);
+            return 1;
+        }
+    }
+    
+    // Write the initialized VM instead of running it
+    if (snapshot_out_path) {
+        bool written = vm_image_write(vm, snapshot_out_path);
+        if (written) {
+            printf("VM image written to %s\n", snapshot_out_path);
+        } else {
+            fprintf(stderr, "Error: Failed to write VM image '%s'\n", snapshot_out_path);
+        }
         vm_destroy(vm);
-        return 1;
+        return written ? 0 : 1;
     }
     
     if (debug_mode) {
@@ -212,6 +414,7 @@ int main(int argc, char* argv[]) {
     if (show_memory) {
         printf("\nFinal memory state:\n");
         vm_print_heap_stats(vm);
+        method_registry_print_stats();
     }
     
         if (show_regions) {
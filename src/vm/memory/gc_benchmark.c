@@ -0,0 +1,481 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "heap.h"
+#include "../objects/object.h"
+#include "../objects/string_object.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// GC benchmark - measures the card-marking write barrier, compares minor
+// (young generation) pauses with full collections, reports the
+// stop-the-world pauses of concurrent marking, the scaling of parallel
+// full collections with the worker count, the slice lengths of
+// incremental collection at different pause targets, the footprint and
+// allocation rate of small objects and the cost per iteration of a string
+// loop as the number of objects allocated between collections grows.
+//
+// Usage: gc_benchmark [old_objects] [young_objects_per_round] [rounds]
+
+#define DEFAULT_OLD_OBJECTS 8000
+#define DEFAULT_YOUNG_OBJECTS 1000
+#define DEFAULT_ROUNDS 20
+#define BARRIER_STORES 20000000
+
+// Benchmark roots: a single old list head plus the young survivors
+static Object** bench_roots = NULL;
+static size_t bench_root_count = 0;
+
+static void bench_root_scanner(Heap* heap, void* context) {
+    (void)context;
+    for (size_t i = 0; i < bench_root_count; i++) {
+        gc_mark_object(heap, bench_roots[i]);
+    }
+}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Node layout: { next: object, child: object, value: i64 }
+#define NODE_NEXT 0
+#define NODE_CHILD sizeof(Object*)
+#define NODE_VALUE (2 * sizeof(Object*))
+
+static void node_set(Heap* heap, Object* node, size_t offset, Object* value) {
+    *(Object**)(node->data + offset) = value;
+    gc_write_barrier(heap, node);
+}
+
+// Store cost with and without the barrier on old holder objects
+static void bench_barrier(Heap* heap, Object** holders, size_t holder_count, Object* target) {
+    volatile Object* sink = NULL;
+
+    // Index with a mask so the loop is not dominated by a division
+    size_t mask = 1;
+    while (mask * 2 <= holder_count) mask *= 2;
+    holder_count = mask;
+    mask--;
+
+    double start = now_us();
+    for (size_t i = 0; i < BARRIER_STORES; i++) {
+        Object* holder = holders[i & mask];
+        *(Object**)(holder->data + NODE_CHILD) = target;
+        sink = holder;
+    }
+    double raw_us = now_us() - start;
+
+    start = now_us();
+    for (size_t i = 0; i < BARRIER_STORES; i++) {
+        Object* holder = holders[i & mask];
+        *(Object**)(holder->data + NODE_CHILD) = target;
+        gc_write_barrier(heap, holder);
+        sink = holder;
+    }
+    double barrier_us = now_us() - start;
+    (void)sink;
+
+    printf("Write barrier (%d stores over %zu holders):\n", BARRIER_STORES, holder_count);
+    printf("  raw store:     %.2f ns/store\n", raw_us * 1000.0 / BARRIER_STORES);
+    printf("  with barrier:  %.2f ns/store\n", barrier_us * 1000.0 / BARRIER_STORES);
+    printf("  overhead:      %.2f ns/store (%.1f%%)\n",
+           (barrier_us - raw_us) * 1000.0 / BARRIER_STORES,
+           raw_us > 0 ? (barrier_us - raw_us) / raw_us * 100.0 : 0.0);
+    printf("  dirty cards:   %zu of %zu\n",
+           card_table_dirty_count(heap->gc->card_table), heap->gc->card_table->card_count);
+}
+
+// Concurrent cycles: time the initial mark and remark pauses while the
+// mutator keeps storing references through both barriers
+static void bench_concurrent(Heap* heap, Object** old_nodes, size_t old_count,
+                             Class* node, int cycles) {
+    double initial_total = 0, initial_max = 0;
+    double remark_total = 0, remark_max = 0;
+    size_t mutator_stores = 0;
+
+    heap->gc->concurrent_mode = true;
+    for (int cycle = 0; cycle < cycles; cycle++) {
+        double start = now_us();
+        gc_collect_concurrent(heap);
+        double pause = now_us() - start;
+        initial_total += pause;
+        if (pause > initial_max) initial_max = pause;
+
+        // Mutator work until the marker asks for a safepoint
+        size_t i = 0;
+        while (!__atomic_load_n(&heap->gc->safepoint_requested, __ATOMIC_ACQUIRE)) {
+            Object* holder = old_nodes[i++ % old_count];
+            Object* object = (i % 64 == 0) ? object_create(heap, node) : NULL;
+            gc_satb_barrier(heap, *(Object**)(holder->data + NODE_CHILD));
+            *(Object**)(holder->data + NODE_CHILD) = object;
+            gc_write_barrier(heap, holder);
+        }
+        mutator_stores += i;
+
+        start = now_us();
+        gc_concurrent_finish(heap);
+        pause = now_us() - start;
+        remark_total += pause;
+        if (pause > remark_max) remark_max = pause;
+    }
+    heap->gc->concurrent_mode = false;
+
+    printf("Concurrent marking (%d cycles):\n", cycles);
+    printf("  initial mark: avg %.1f us, max %.1f us\n", initial_total / cycles, initial_max);
+    printf("  remark+sweep: avg %.1f us, max %.1f us\n", remark_total / cycles, remark_max);
+    printf("  mutator stores during marking: %zu per cycle\n", mutator_stores / cycles);
+}
+
+// Parallel full collections: pause against worker count on a binary tree
+// of tree_size nodes with the same amount of garbage per collection
+static void bench_parallel(size_t tree_size, int collections) {
+    static const uint32_t thread_counts[] = { 1, 2, 4, 8 };
+
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    Class* node = class_create("Bench.Tree", 2, NODE_VALUE + sizeof(int64_t));
+    class_add_field(node, field_create("left", FIELD_TYPE_OBJECT, NODE_NEXT, sizeof(Object*)));
+    class_add_field(node, field_create("right", FIELD_TYPE_OBJECT, NODE_CHILD, sizeof(Object*)));
+    Object** tree = malloc(sizeof(Object*) * tree_size);
+    if (!heap || !node || !tree) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    gc_set_root_scanner(heap, bench_root_scanner, NULL);
+
+    for (size_t i = 0; i < tree_size; i++) {
+        tree[i] = object_create(heap, node);
+    }
+    for (size_t i = 0; 2 * i + 2 < tree_size; i++) {
+        node_set(heap, tree[i], NODE_NEXT, tree[2 * i + 1]);
+        node_set(heap, tree[i], NODE_CHILD, tree[2 * i + 2]);
+    }
+    bench_roots[0] = tree[0];
+    bench_root_count = 1;
+
+    printf("Parallel full collections (%zu live objects, %zu garbage per collection):\n",
+           tree_size, tree_size / 4);
+    printf("  threads   avg pause     max pause     lazy sweep\n");
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        gc_set_worker_count(heap, thread_counts[t]);
+        double total = 0, max = 0, lazy = 0;
+
+        for (int c = 0; c < collections; c++) {
+            for (size_t i = 0; i < tree_size / 4; i++) {
+                object_create(heap, node);
+            }
+
+            double start = now_us();
+            gc_collect_full(heap);
+            double pause = now_us() - start;
+            total += pause;
+            if (pause > max) max = pause;
+
+            start = now_us();
+            gc_lazy_sweep(heap, heap->gc->sweep_pending_count);
+            lazy += now_us() - start;
+        }
+
+        printf("  %7u %9.1f us  %9.1f us  %9.1f us\n", thread_counts[t],
+               total / collections, max, lazy / collections);
+    }
+
+    bench_root_count = 0;
+    free(tree);
+    heap_destroy(heap);
+    class_destroy(node);
+}
+
+// Incremental cycles: slice lengths and total collector time for a range
+// of pause targets, against the same heap collected stop-the-world
+static void bench_incremental(size_t live_objects, int cycles) {
+    static const uint32_t targets[] = { 0, 2000, 500, 100 };
+
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    Class* node = class_create("Bench.Node", 1, NODE_VALUE + sizeof(int64_t));
+    class_add_field(node, field_create("next", FIELD_TYPE_OBJECT, NODE_NEXT, sizeof(Object*)));
+    if (!heap || !node) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    gc_set_root_scanner(heap, bench_root_scanner, NULL);
+
+    Object* head = NULL;
+    for (size_t i = 0; i < live_objects; i++) {
+        Object* object = object_create(heap, node);
+        node_set(heap, object, NODE_NEXT, head);
+        head = object;
+    }
+    bench_roots[0] = head;
+    bench_root_count = 1;
+
+    printf("Incremental collection (%zu live objects, %zu garbage per cycle):\n",
+           live_objects, live_objects / 2);
+    printf("  target      slices   avg slice    max slice    total\n");
+    for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+        double total = 0, max = 0;
+        size_t slices = 0;
+
+        heap->gc->incremental_mode = targets[t] > 0;
+        if (targets[t] > 0) {
+            gc_set_pause_target(heap, targets[t]);
+        }
+        for (int c = 0; c < cycles; c++) {
+            for (size_t i = 0; i < live_objects / 2; i++) {
+                object_create(heap, node);
+            }
+
+            // Run the slices back to back; a mutator would run in between
+            do {
+                double start = now_us();
+                if (targets[t] > 0) {
+                    gc_collect_incremental(heap);
+                } else {
+                    gc_collect_full(heap);
+                }
+                double pause = now_us() - start;
+                total += pause;
+                if (pause > max) max = pause;
+                slices++;
+            } while (heap->gc->incremental_phase != GC_PHASE_IDLE);
+        }
+
+        if (targets[t] > 0) {
+            printf("  %6u us", targets[t]);
+        } else {
+            printf("  full STW ");
+        }
+        printf(" %8zu %9.1f us %9.1f us %9.1f us\n", slices / cycles,
+               total / slices, max, total / cycles);
+    }
+
+    bench_root_count = 0;
+    heap_destroy(heap);
+    class_destroy(node);
+}
+
+// Small-object footprint and allocation throughput: two-field points,
+// allocated in batches that die young
+static void bench_allocation(size_t batch, int batches) {
+    Heap* heap = heap_create(32 * 1024 * 1024);
+    Class* point = class_create("Bench.Point", 1, 2 * sizeof(int64_t));
+    if (!heap || !point) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    gc_set_root_scanner(heap, bench_root_scanner, NULL);
+    bench_root_count = 0;
+
+    double total = 0;
+    size_t allocated = 0, footprint = 0;
+    for (int b = 0; b < batches; b++) {
+        size_t used = heap->used_size;
+        double start = now_us();
+        for (size_t i = 0; i < batch; i++) {
+            Object* object = object_create(heap, point);
+            if (!object) break;
+            *(int64_t*)object->data = (int64_t)i;
+            allocated++;
+        }
+        total += now_us() - start;
+        footprint = heap->used_size - used;
+        gc_collect_young(heap);
+    }
+
+    printf("Small objects (%zu-byte header, %u-byte payload):\n",
+           sizeof(ObjectHeader), point->size);
+    printf("  footprint:  %.1f heap bytes per object\n", (double)footprint / batch);
+    printf("  allocation: %.2f M objects/s, %.0f ns per object (%zu objects)\n",
+           total > 0 ? allocated / total : 0.0,
+           allocated > 0 ? total * 1000 / allocated : 0.0, allocated);
+
+    heap_destroy(heap);
+    class_destroy(point);
+}
+
+// Roots of the string loop: the source string and the latest result
+static Object* string_roots[2];
+
+static void string_root_scanner(Heap* heap, void* context) {
+    (void)context;
+    for (size_t i = 0; i < 2; i++) {
+        if (string_roots[i]) gc_mark_object(heap, string_roots[i]);
+    }
+}
+
+// Substring and concatenation in a loop, as string-heavy bytecode does.
+// Each iteration allocates a few small strings that die young; the cost
+// per iteration should not grow with the iteration count. Every run is
+// long enough to collect several times, so the pauses are amortized in
+// all of them rather than only in the largest.
+static void bench_string_churn(void) {
+    static const int counts[] = { 160000, 640000, 2560000 };
+
+    Class* string_class = class_create("Bench.String", 1, 0);
+    Class* rope_class = class_create("Bench.Rope", 2, 0);
+    Class* slice_class = class_create("Bench.Slice", 3, 0);
+    if (!string_class || !rope_class || !slice_class) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    class_add_field(rope_class, field_create("left", FIELD_TYPE_STRING, offsetof(RopeObject, left) - sizeof(ObjectHeader), sizeof(StringObject*)));
+    class_add_field(rope_class, field_create("right", FIELD_TYPE_STRING, offsetof(RopeObject, right) - sizeof(ObjectHeader), sizeof(StringObject*)));
+    class_add_field(slice_class, field_create("parent", FIELD_TYPE_STRING, offsetof(SliceObject, parent) - sizeof(ObjectHeader), sizeof(StringObject*)));
+    class_set_superclass(rope_class, string_class);
+    class_set_superclass(slice_class, string_class);
+
+    printf("String churn (substring + concat per iteration):\n");
+    double first = 0;
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        Heap* heap = heap_create(64 * 1024 * 1024);
+        if (!heap) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+        gc_set_root_scanner(heap, string_root_scanner, NULL);
+        string_roots[0] = (Object*)string_create(heap, string_class, "the quick brown fox jumps", 25);
+
+        double start = now_us();
+        for (int i = 0; i < counts[c]; i++) {
+            StringObject* part = string_substring(heap, slice_class, (StringObject*)string_roots[0], i % 10, 5);
+            string_roots[1] = (Object*)part;
+            string_roots[1] = (Object*)string_concat(heap, rope_class, part, (StringObject*)string_roots[0]);
+        }
+        double per_iteration = (now_us() - start) * 1000 / counts[c];
+        if (c == 0) first = per_iteration;
+        printf("  %7d iterations: %.0f ns per iteration (%.2fx the smallest run, %zu collections)\n",
+               counts[c], per_iteration, per_iteration / first, heap->gc->stats.collections_performed);
+
+        string_roots[0] = string_roots[1] = NULL;
+        heap_destroy(heap);
+    }
+
+    class_destroy(string_class);
+    class_destroy(rope_class);
+    class_destroy(slice_class);
+}
+
+int main(int argc, char* argv[]) {
+    size_t old_objects = argc > 1 ? (size_t)atol(argv[1]) : DEFAULT_OLD_OBJECTS;
+    size_t young_objects = argc > 2 ? (size_t)atol(argv[2]) : DEFAULT_YOUNG_OBJECTS;
+    int rounds = argc > 3 ? atoi(argv[3]) : DEFAULT_ROUNDS;
+
+    printf("He³ GC Benchmark\n");
+    printf("================\n");
+    printf("Old objects: %zu, young objects/round: %zu, rounds: %d\n\n",
+           old_objects, young_objects, rounds);
+
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    if (!heap || !heap->gc->card_table) {
+        fprintf(stderr, "Failed to create generational heap\n");
+        return 1;
+    }
+    gc_set_root_scanner(heap, bench_root_scanner, NULL);
+
+    Class* node = class_create("Bench.Node", 1, NODE_VALUE + sizeof(int64_t));
+    class_add_field(node, field_create("next", FIELD_TYPE_OBJECT, NODE_NEXT, sizeof(Object*)));
+    class_add_field(node, field_create("child", FIELD_TYPE_OBJECT, NODE_CHILD, sizeof(Object*)));
+    class_add_field(node, field_create("value", FIELD_TYPE_I64, NODE_VALUE, sizeof(int64_t)));
+
+    bench_roots = calloc(young_objects + 1, sizeof(Object*));
+    Object** old_nodes = malloc(sizeof(Object*) * old_objects);
+    if (!bench_roots || !old_nodes) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    // Build an old linked list and tenure it
+    Object* head = NULL;
+    for (size_t i = 0; i < old_objects; i++) {
+        Object* object = object_create(heap, node);
+        if (!object) {
+            fprintf(stderr, "Heap exhausted after %zu old objects\n", i);
+            return 1;
+        }
+        node_set(heap, object, NODE_NEXT, head);
+        old_nodes[i] = object;
+        head = object;
+    }
+    bench_roots[0] = head;
+    bench_root_count = 1;
+    for (uint32_t i = 0; i < heap->gc->tenure_threshold; i++) {
+        gc_collect_young(heap);
+    }
+    printf("Old generation: %zu objects, %zu bytes\n\n",
+           heap->gc->old_gen->object_count, heap->gc->old_gen->used);
+
+    double minor_total = 0, minor_max = 0;
+    double full_total = 0, full_max = 0;
+    size_t cards_before = heap->gc->stats.dirty_cards_scanned;
+
+    for (int round = 0; round < rounds; round++) {
+        // Allocate young objects; every 10th is linked from an old node
+        // (old-to-young via the barrier), every 10th+5 is rooted directly,
+        // the rest are garbage
+        bench_root_count = 1;
+        for (size_t i = 0; i < young_objects; i++) {
+            Object* object = object_create(heap, node);
+            if (!object) break;
+            if (i % 10 == 0) {
+                node_set(heap, old_nodes[(round * young_objects + i) % old_objects], NODE_CHILD, object);
+            } else if (i % 10 == 5) {
+                bench_roots[bench_root_count++] = object;
+            }
+        }
+
+        double start = now_us();
+        if (round % 2 == 0) {
+            gc_collect_young(heap);
+            double pause = now_us() - start;
+            minor_total += pause;
+            if (pause > minor_max) minor_max = pause;
+        } else {
+            gc_collect_full(heap);
+            double pause = now_us() - start;
+            full_total += pause;
+            if (pause > full_max) full_max = pause;
+        }
+    }
+
+    int minor_rounds = (rounds + 1) / 2;
+    int full_rounds = rounds / 2;
+    printf("Collection pauses:\n");
+    if (minor_rounds > 0) {
+        printf("  minor: avg %.1f us, max %.1f us (%zu dirty cards scanned per collection)\n",
+               minor_total / minor_rounds, minor_max,
+               (heap->gc->stats.dirty_cards_scanned - cards_before) / minor_rounds);
+    }
+    if (full_rounds > 0) {
+        printf("  full:  avg %.1f us, max %.1f us\n", full_total / full_rounds, full_max);
+    }
+    printf("\n");
+
+    bench_concurrent(heap, old_nodes, old_objects, node, 5);
+    printf("\n");
+
+    bench_barrier(heap, old_nodes, old_objects, head);
+    printf("\n");
+
+    gc_print_stats(heap);
+    printf("\n");
+
+    free(old_nodes);
+    heap_destroy(heap);
+    class_destroy(node);
+
+    bench_parallel(2 * old_objects, 5);
+    printf("\n");
+
+    bench_incremental(old_objects, 5);
+    printf("\n");
+
+    bench_allocation(5000, 20);
+    printf("\n");
+
+    bench_string_churn();
+
+    free(bench_roots);
+    return 0;
+}
@@ -1,9 +1,23 @@
+// clock_gettime, MAP_ANONYMOUS and madvise are hidden under -std=c99
+#define _DEFAULT_SOURCE
+
 #include "heap.h"
+#include "../objects/object.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
 
 // Default heap configuration
 #define DEFAULT_HEAP_SIZE (16 * 1024 * 1024)  // 16MB
@@ -12,12 +26,99 @@
 #define OLD_GEN_SIZE (8 * 1024 * 1024)        // 8MB
 #define PERM_GEN_SIZE (4 * 1024 * 1024)       // 4MB
 
+// Card table start bitmap: one bit per 8-byte slot, 64 slots per card
+#define GC_CARD_SLOT_SHIFT 3
+#define GC_INITIAL_MARK_STACK 256
+
+static double gc_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Virtual memory. The heap reserves its whole address range without
+// access rights and commits it on demand; committed pages only take
+// physical memory once touched.
+static size_t heap_page_size(void) {
+    long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? (size_t)page : 4096;
+}
+
+static size_t heap_round_up(size_t size, size_t granule) {
+    return (size + granule - 1) / granule * granule;
+}
+
+static void* heap_os_reserve(size_t size, size_t alignment) {
+    size_t padded = size + alignment;
+    char* base = mmap(NULL, padded, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) return NULL;
+
+    // Trim the padding so the reservation starts on an alignment boundary
+    char* aligned = (char*)(((uintptr_t)base + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    if (aligned > base) {
+        munmap(base, aligned - base);
+    }
+    size_t tail = (size_t)((base + padded) - (aligned + size));
+    if (tail > 0) {
+        munmap(aligned + size, tail);
+    }
+
+    return aligned;
+}
+
+static bool heap_os_commit(void* start, size_t size) {
+    return size == 0 || mprotect(start, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+static void heap_os_decommit(void* start, size_t size) {
+    if (size == 0) return;
+
+    madvise(start, size, MADV_DONTNEED);
+    mprotect(start, size, PROT_NONE);
+}
+
+// Zero-filled memory that only takes physical pages once written
+static void* heap_os_map(size_t size) {
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return memory == MAP_FAILED ? NULL : memory;
+}
+
+static size_t heap_commit_granule(Heap* heap) {
+    return heap->huge_pages ? HEAP_HUGE_PAGE_SIZE : HEAP_COMMIT_GRANULE;
+}
+
+// Size class free lists and the allocation index
+static void heap_free_list_insert(Heap* heap, MemoryRegion* region);
+static void heap_free_list_remove(Heap* heap, MemoryRegion* region);
+static void heap_free_lists_rebuild(Heap* heap);
+static void allocation_index_add(Heap* heap, Allocation* alloc);
+static void allocation_unlink(Heap* heap, Allocation* alloc);
+
 // Heap creation and destruction
 Heap* heap_create(size_t initial_size) {
     if (initial_size == 0) {
         initial_size = DEFAULT_HEAP_SIZE;
     }
     
+    // A fixed-size heap
+    return heap_create_growable(initial_size, initial_size, initial_size);
+}
+
+Heap* heap_create_growable(size_t initial_size, size_t soft_limit, size_t hard_limit) {
+    if (initial_size == 0) {
+        initial_size = DEFAULT_HEAP_SIZE;
+    }
+    if (hard_limit < initial_size) {
+        hard_limit = initial_size;
+    }
+    if (soft_limit < initial_size) {
+        soft_limit = initial_size;
+    }
+    if (soft_limit > hard_limit) {
+        soft_limit = hard_limit;
+    }
+    
     Heap* heap = malloc(sizeof(Heap));
     if (!heap) {
         return NULL;
@@ -25,33 +126,49 @@ Heap* heap_create(size_t initial_size) {
     
     // Initialize heap
     memset(heap, 0, sizeof(Heap));
-    
-    // Allocate raw memory
-    heap->memory = malloc(initial_size);
+    slab_pool_init(&heap->allocation_pool, sizeof(Allocation), 0);
+    
+    // Reserve address space up to the hard limit and commit the initial size.
+    // Reservations of huge page size or more are aligned for huge pages.
+    size_t page = heap_page_size();
+    heap->reserved_size = heap_round_up(hard_limit, page);
+    heap->memory = heap_os_reserve(heap->reserved_size,
+                                   heap->reserved_size >= HEAP_HUGE_PAGE_SIZE ? HEAP_HUGE_PAGE_SIZE : page);
     if (!heap->memory) {
         free(heap);
         return NULL;
     }
+    heap->committed_size = heap_round_up(initial_size, page);
+    if (!heap_os_commit(heap->memory, heap->committed_size)) {
+        munmap(heap->memory, heap->reserved_size);
+        free(heap);
+        return NULL;
+    }
     
     heap->total_size = initial_size;
     heap->free_size = initial_size;
+    heap->min_size = initial_size;
+    heap->soft_limit = soft_limit;
+    heap->hard_limit = hard_limit;
+    heap->release_free_mark = initial_size;
     heap->alignment = DEFAULT_ALIGNMENT;
     
     // Create initial free region
     heap->regions = memory_region_create(heap->memory, initial_size);
     if (!heap->regions) {
-        free(heap->memory);
+        munmap(heap->memory, heap->reserved_size);
         free(heap);
         return NULL;
     }
     
     heap->region_count = 1;
+    heap_free_list_insert(heap, heap->regions);
     
     // Initialize garbage collector
     heap->gc = malloc(sizeof(GC));
     if (!heap->gc) {
         memory_region_destroy(heap->regions);
-        free(heap->memory);
+        munmap(heap->memory, heap->reserved_size);
         free(heap);
         return NULL;
     }
@@ -59,9 +176,15 @@ Heap* heap_create(size_t initial_size) {
     memset(heap->gc, 0, sizeof(GC));
     heap->gc->young_threshold = YOUNG_GEN_SIZE;
     heap->gc->old_threshold = OLD_GEN_SIZE;
-    
-    // Create generations (only if heap is large enough)
-    if (initial_size >= YOUNG_GEN_SIZE + OLD_GEN_SIZE + PERM_GEN_SIZE) {
+    heap->gc->tenure_threshold = GC_DEFAULT_TENURE_THRESHOLD;
+    heap->gc->worker_count = 1;
+    heap->gc->pause_target_us = GC_DEFAULT_PAUSE_TARGET_US;
+    heap->gc->incremental_pace = GC_DEFAULT_INCREMENTAL_PACE;
+    heap->gc->start_time_us = gc_now_us();
+    heap->gc->last_cycle_start_us = heap->gc->start_time_us;
+    
+    // Create generations (only if heap can grow large enough)
+    if (hard_limit >= YOUNG_GEN_SIZE + OLD_GEN_SIZE + PERM_GEN_SIZE) {
         void* young_start = heap->memory;
         void* old_start = (char*)young_start + YOUNG_GEN_SIZE;
         void* perm_start = (char*)old_start + OLD_GEN_SIZE;
@@ -69,6 +192,14 @@ Heap* heap_create(size_t initial_size) {
         heap->gc->young_gen = generation_create(young_start, YOUNG_GEN_SIZE);
         heap->gc->old_gen = generation_create(old_start, OLD_GEN_SIZE);
         heap->gc->perm_gen = generation_create(perm_start, PERM_GEN_SIZE);
+        
+        // Objects are placed first-fit anywhere in the heap, so the card
+        // table covers the whole block rather than the old generation range
+        heap->gc->card_table = card_table_create(heap->memory, initial_size, heap->reserved_size);
+        if (!heap->gc->card_table) {
+            heap_destroy(heap);
+            return NULL;
+        }
     } else {
         // For small heaps, just create a single generation
         heap->gc->young_gen = generation_create(heap->memory, initial_size);
@@ -92,9 +223,20 @@ void heap_destroy(Heap* heap) {
         if (heap->gc->young_gen) generation_destroy(heap->gc->young_gen);
         if (heap->gc->old_gen) generation_destroy(heap->gc->old_gen);
         if (heap->gc->perm_gen) generation_destroy(heap->gc->perm_gen);
+        // Stop a concurrent marker before its heap goes away
+        if (heap->gc->marker_running) {
+            pthread_join(heap->gc->marker_thread, NULL);
+        }
+        card_table_destroy(heap->gc->card_table);
+        free(heap->gc->mark_stack);
+        free(heap->gc->satb_buffer);
+        free(heap->gc->sweep_pending);
+        free(heap->gc->captured_roots);
         free(heap->gc);
     }
     
+    heap_profiler_disable(heap);
+    
     // Destroy regions
     MemoryRegion* region = heap->regions;
     while (region) {
@@ -103,22 +245,197 @@ void heap_destroy(Heap* heap) {
         region = next;
     }
     
-    // Destroy allocations
-    Allocation* alloc = heap->allocations;
-    while (alloc) {
-        Allocation* next = alloc->next;
-        allocation_destroy(alloc);
-        alloc = next;
-    }
+    // Destroy allocation records
+    slab_pool_destroy(&heap->allocation_pool);
+    free(heap->allocation_index);
     
-    // Free raw memory
+    // Release the reservation
     if (heap->memory) {
-        free(heap->memory);
+        munmap(heap->memory, heap->reserved_size);
     }
     
     free(heap);
 }
 
+// Heap sizing
+// The free region ending at the top of the heap, if any
+static MemoryRegion* heap_tail_region(Heap* heap) {
+    char* top = (char*)heap->memory + heap->total_size;
+    for (MemoryRegion* region = heap->regions; region; region = region->next) {
+        if ((char*)region->start + region->size == top) {
+            return region->is_free ? region : NULL;
+        }
+    }
+    return NULL;
+}
+
+// Commit more of the reservation so that a size-byte allocation fits,
+// without growing past limit. Grows by at least half the current size.
+// Returns the free region at the top of the heap, or NULL.
+static MemoryRegion* heap_grow(Heap* heap, size_t size, size_t limit) {
+    MemoryRegion* tail = heap_tail_region(heap);
+    size_t available = tail ? tail->size : 0;
+    size_t needed = size > available ? size - available : 0;
+    if (needed == 0 || heap->total_size + needed > limit) {
+        return NULL;
+    }
+
+    size_t step = needed > heap->total_size / 2 ? needed : heap->total_size / 2;
+    size_t new_total = heap_round_up(heap->total_size + step, heap_commit_granule(heap));
+    if (new_total > limit) {
+        new_total = limit;
+    }
+
+    size_t new_committed = heap_round_up(new_total, heap_page_size());
+    if (new_committed > heap->committed_size) {
+        if (!heap_os_commit((char*)heap->memory + heap->committed_size,
+                            new_committed - heap->committed_size)) {
+            return NULL;
+        }
+        heap->committed_size = new_committed;
+    }
+
+    // Extend the free region at the top, or add one
+    size_t growth = new_total - heap->total_size;
+    if (tail) {
+        heap_free_list_remove(heap, tail);
+        tail->size += growth;
+        heap_free_list_insert(heap, tail);
+    } else {
+        tail = memory_region_create((char*)heap->memory + heap->total_size, growth);
+        if (!tail) return NULL;
+
+        MemoryRegion* last = heap->regions;
+        while (last && last->next) {
+            last = last->next;
+        }
+        tail->prev = last;
+        if (last) {
+            last->next = tail;
+        } else {
+            heap->regions = tail;
+        }
+        heap->region_count++;
+        heap_free_list_insert(heap, tail);
+    }
+
+    heap->total_size = new_total;
+    heap->free_size += growth;
+    heap->grow_count++;
+    if (heap->gc && heap->gc->card_table) {
+        card_table_resize(heap->gc->card_table, new_total);
+    }
+
+    return tail;
+}
+
+// Give free memory back to the OS: decommit the free top of the heap down
+// to 1.5x the live size (not below min_size), and drop the pages of large
+// interior free regions with MADV_DONTNEED. Returns the bytes released.
+size_t heap_release_memory(Heap* heap) {
+    if (!heap) return 0;
+
+    size_t page = heap_page_size();
+    size_t released = 0;
+
+    // Shrink
+    MemoryRegion* tail = heap_tail_region(heap);
+    size_t keep = heap_round_up(heap->used_size + heap->used_size / 2, heap_commit_granule(heap));
+    if (keep < heap->min_size) {
+        keep = heap->min_size;
+    }
+    if (tail && keep < heap->total_size) {
+        size_t cut = heap->total_size - keep;
+        if (cut > tail->size) {
+            cut = tail->size;
+        }
+
+        size_t new_total = heap->total_size - cut;
+        size_t new_committed = heap_round_up(new_total, page);
+        if (cut >= HEAP_RELEASE_MIN && new_committed < heap->committed_size) {
+            heap_os_decommit((char*)heap->memory + new_committed, heap->committed_size - new_committed);
+            released += heap->committed_size - new_committed;
+            heap->committed_size = new_committed;
+
+            heap_free_list_remove(heap, tail);
+            tail->size -= cut;
+            if (tail->size == 0) {
+                if (tail->prev) {
+                    tail->prev->next = tail->next;
+                } else {
+                    heap->regions = tail->next;
+                }
+                if (tail->next) {
+                    tail->next->prev = tail->prev;
+                }
+                memory_region_destroy(tail);
+                heap->region_count--;
+            } else {
+                heap_free_list_insert(heap, tail);
+            }
+
+            heap->total_size = new_total;
+            heap->free_size -= cut;
+            heap->shrink_count++;
+            if (heap->gc && heap->gc->card_table) {
+                card_table_resize(heap->gc->card_table, new_total);
+            }
+        }
+    }
+
+    // Drop the pages of large free regions once enough has been freed
+    if (heap->free_size < heap->release_free_mark) {
+        heap->release_free_mark = heap->free_size;
+    }
+    if (heap->free_size >= heap->release_free_mark + HEAP_RELEASE_MIN) {
+        for (MemoryRegion* region = heap->regions; region; region = region->next) {
+            if (!region->is_free || region->size < HEAP_RELEASE_MIN) continue;
+
+            uintptr_t start = heap_round_up((uintptr_t)region->start, page);
+            uintptr_t end = ((uintptr_t)region->start + region->size) / page * page;
+            if (end > start) {
+                madvise((void*)start, end - start, MADV_DONTNEED);
+                released += end - start;
+            }
+        }
+        heap->release_free_mark = heap->free_size;
+    }
+
+    heap->released_bytes += released;
+    return released;
+}
+
+bool heap_set_limits(Heap* heap, size_t soft_limit, size_t hard_limit) {
+    if (!heap) return false;
+
+    // The hard limit cannot pass the reservation or fall below the heap
+    if (hard_limit > heap->reserved_size || hard_limit < heap->total_size) {
+        return false;
+    }
+    if (soft_limit > hard_limit) {
+        soft_limit = hard_limit;
+    }
+
+    heap->soft_limit = soft_limit;
+    heap->hard_limit = hard_limit;
+    return true;
+}
+
+bool heap_set_huge_pages(Heap* heap, bool enabled) {
+    if (!heap) return false;
+
+#ifdef MADV_HUGEPAGE
+    if (madvise(heap->memory, heap->reserved_size, enabled ? MADV_HUGEPAGE : MADV_NOHUGEPAGE) != 0) {
+        return false;
+    }
+    heap->huge_pages = enabled;
+    return true;
+#else
+    // Transparent huge pages are Linux-only
+    return !enabled;
+#endif
+}
+
 // Memory allocation
 void* heap_allocate(Heap* heap, size_t size) {
     if (!heap || size == 0) {
@@ -131,16 +448,39 @@ void* heap_allocate(Heap* heap, size_t size) {
     
     // Find free region
     MemoryRegion* region = memory_region_find_free(heap, size);
+    if (!region && heap->gc && heap->gc->sweep_pending_count > 0) {
+        // Finish a lazy sweep first
+        gc_lazy_sweep(heap, heap->gc->sweep_pending_count);
+        region = memory_region_find_free(heap, size);
+    }
+    if (!region) {
+        // Below the soft limit the heap grows instead of collecting
+        region = heap_grow(heap, size, heap->soft_limit);
+    }
     if (!region) {
         // Try garbage collection
         gc_collect(heap);
         region = memory_region_find_free(heap, size);
+        if (!region && heap->gc &&
+            (heap->gc->marking_active || heap->gc->incremental_phase != GC_PHASE_IDLE)) {
+            // Finish the running concurrent or incremental cycle instead of failing
+            gc_collect_full(heap);
+            region = memory_region_find_free(heap, size);
+        }
         if (!region) {
+            // Past the soft limit only after collecting
+            region = heap_grow(heap, size, heap->hard_limit);
+        }
+        if (!region) {
+            if (heap->oom_handler) {
+                heap->oom_handler(heap, size, heap->oom_context);
+            }
             return NULL; // Out of memory
         }
     }
     
     // Split region if necessary
+    heap_free_list_remove(heap, region);
     if (region->size > size) {
         MemoryRegion* remaining = memory_region_split(region, size);
         if (remaining) {
@@ -152,6 +492,7 @@ void* heap_allocate(Heap* heap, size_t size) {
             }
             region->next = remaining;
             heap->region_count++;
+            heap_free_list_insert(heap, remaining);
         }
     }
     
@@ -168,11 +509,16 @@ void* heap_allocate(Heap* heap, size_t size) {
     }
     
     // Create allocation record
-    Allocation* alloc = allocation_create(region->start, original_size, 0);
+    Allocation* alloc = allocation_create(heap, region->start, original_size, 0);
     if (alloc) {
+        alloc->region = region;
         alloc->next = heap->allocations;
+        if (heap->allocations) {
+            heap->allocations->prev = alloc;
+        }
         heap->allocations = alloc;
         heap->allocation_count++;
+        allocation_index_add(heap, alloc);
     }
     
     return region->start;
@@ -233,68 +579,65 @@ void* heap_reallocate(Heap* heap, void* ptr, size_t new_size) {
 void heap_deallocate(Heap* heap, void* ptr) {
     if (!heap || !ptr) return;
     
+    if (heap->profiler && heap->profiler->live_count > 0) {
+        heap_profile_free(heap, ptr);
+    }
+    
     // Find allocation
     Allocation* alloc = allocation_find(heap, ptr);
     if (!alloc) {
         return; // Invalid pointer
     }
     
-    // Find corresponding region
-    MemoryRegion* region = heap->regions;
-    while (region) {
-        if (region->start == ptr) {
-            break;
+    // Find corresponding region (the allocation record remembers it unless
+    // the heap has been compacted since)
+    MemoryRegion* region = alloc->region;
+    if (!region || region->start != ptr) {
+        region = heap->regions;
+        while (region) {
+            if (region->start == ptr) {
+                break;
+            }
+            region = region->next;
         }
-        region = region->next;
     }
     
     if (region) {
         // Mark region as free
         region->is_free = true;
         
-        // Update heap statistics
-        heap->used_size -= alloc->size;
-        heap->free_size += alloc->size;
+        // Update heap statistics (regions hold the aligned size)
+        heap->used_size -= region->size;
+        heap->free_size += region->size;
         heap->total_deallocations++;
         
-        // Try to merge with adjacent free regions
+        // Try to merge with adjacent free regions (memory_region_merge
+        // relinks the list and destroys the absorbed region)
         if (region->prev && region->prev->is_free) {
-            MemoryRegion* merged = memory_region_merge(region->prev, region);
-            if (merged) {
-                // Remove old regions
-                if (region->prev->prev) {
-                    region->prev->prev->next = merged;
-                } else {
-                    heap->regions = merged;
-                }
-                memory_region_destroy(region->prev);
-                memory_region_destroy(region);
+            MemoryRegion* prev = region->prev;
+            heap_free_list_remove(heap, prev);
+            if (memory_region_merge(prev, region)) {
                 heap->region_count--;
-                region = merged;
+                region = prev;
+            } else {
+                heap_free_list_insert(heap, prev);
             }
         }
         
         if (region->next && region->next->is_free) {
-            MemoryRegion* merged = memory_region_merge(region, region->next);
-            if (merged) {
-                // Remove old regions
-                if (region->prev) {
-                    region->prev->next = merged;
-                } else {
-                    heap->regions = merged;
-                }
-                if (region->next->next) {
-                    region->next->next->prev = merged;
-                }
-                memory_region_destroy(region);
-                memory_region_destroy(region->next);
+            MemoryRegion* next = region->next;
+            heap_free_list_remove(heap, next);
+            if (memory_region_merge(region, next)) {
                 heap->region_count--;
+            } else {
+                heap_free_list_insert(heap, next);
             }
         }
+        heap_free_list_insert(heap, region);
     }
     
     // Remove allocation record
-    allocation_remove(heap, ptr);
+    allocation_unlink(heap, alloc);
 }
 
 // Memory management utilities
@@ -368,202 +711,1545 @@ void heap_compact(Heap* heap) {
             heap->region_count++;
         }
     }
+    heap_free_lists_rebuild(heap);
 }
 
 void heap_defragment(Heap* heap) {
     heap_compact(heap);
 }
 
-// Garbage collection
-void gc_collect(Heap* heap) {
-    if (!heap || !heap->gc) return;
-    
-    clock_t start = clock();
-    
-    // Check if we need collection
-    if (heap->used_size < heap->gc->young_threshold) {
-        return;
-    }
-    
-    // Mark all reachable objects
-    gc_mark_all_roots(heap);
-    
-    // Sweep generations
-    gc_sweep_generation(heap->gc->young_gen);
-    gc_sweep_generation(heap->gc->old_gen);
-    
-    // Update statistics
-    heap->gc->stats.collections_performed++;
-    clock_t end = clock();
-    double collection_time = ((double)(end - start)) / CLOCKS_PER_SEC;
-    heap->gc->stats.avg_collection_time = 
-        (heap->gc->stats.avg_collection_time * (heap->gc->stats.collections_performed - 1) + collection_time) 
-        / heap->gc->stats.collections_performed;
-}
+// Garbage collection telemetry. A cycle begins at its first stop-the-world
+// pause and ends after its sweep; concurrent and incremental cycles have
+// several pauses in between.
+static const char* gc_cycle_names[] = { "minor", "full", "concurrent", "incremental" };
 
-void gc_collect_young(Heap* heap) {
-    if (!heap || !heap->gc || !heap->gc->young_gen) return;
-    
-    // Mark young generation objects
-    gc_mark_all_roots(heap);
-    
-    // Sweep young generation
-    gc_sweep_generation(heap->gc->young_gen);
-}
+static void gc_cycle_begin(Heap* heap, uint32_t type) {
+    GC* gc = heap->gc;
+    GCCycle* cycle = &gc->cycle;
 
-void gc_collect_full(Heap* heap) {
-    if (!heap || !heap->gc) return;
-    
-    // Mark all objects
-    gc_mark_all_roots(heap);
-    
-    // Sweep all generations
-    gc_sweep_generation(heap->gc->young_gen);
-    gc_sweep_generation(heap->gc->old_gen);
-    gc_sweep_generation(heap->gc->perm_gen);
-}
+    memset(cycle, 0, sizeof(GCCycle));
+    cycle->type = type;
+    cycle->active = true;
+    cycle->start_us = gc_now_us();
+    cycle->used_before = heap->used_size;
+    cycle->young_before = gc->young_gen ? gc->young_gen->used : 0;
+    cycle->old_before = gc->old_gen ? gc->old_gen->used : 0;
+    cycle->allocated_before = gc->stats.total_allocated;
+    cycle->freed_before = gc->stats.bytes_freed;
+    cycle->promoted_before = gc->stats.bytes_promoted;
+    cycle->young_swept_before = gc->stats.young_bytes_swept;
+    cycle->young_survived_before = gc->stats.young_bytes_survived;
+    cycle->old_swept_before = gc->stats.old_bytes_swept;
+    cycle->old_survived_before = gc->stats.old_bytes_survived;
 
-void gc_collect_incremental(Heap* heap) {
-    if (!heap || !heap->gc) return;
-    
-    // Incremental collection - process one generation at a time
-    switch (heap->gc->collection_step % 3) {
-        case 0:
-            gc_collect_young(heap);
-            break;
-        case 1:
-            gc_sweep_generation(heap->gc->old_gen);
-            break;
-        case 2:
-            gc_sweep_generation(heap->gc->perm_gen);
-            break;
+    if (heap->used_size > gc->stats.peak_memory) {
+        gc->stats.peak_memory = heap->used_size;
     }
-    
-    heap->gc->collection_step++;
 }
 
-// GC utilities
-void gc_mark_object(struct Object* object) {
-    // TODO: Implement object marking
-    // This will be implemented when we have the object system
-    (void)object;
-}
+// Record a stop-the-world pause that started at start_us
+static void gc_record_pause(GC* gc, double start_us) {
+    double pause = gc_now_us() - start_us;
+    if (pause < 0) pause = 0;
 
-void gc_mark_all_roots(Heap* heap) {
-    // TODO: Mark all root objects
-    // This includes:
-    // - Stack variables
-    // - Global variables
-    // - Static variables
-    // - Method parameters
-    (void)heap;
+    gc_histogram_record(&gc->stats.pause_histogram, (uint64_t)(pause + 0.5));
+    gc->stats.total_pause_time += pause / 1e6;
+    gc->cycle.pause_us += pause;
+    gc->cycle.pauses++;
+    if (pause > gc->cycle.max_pause_us) {
+        gc->cycle.max_pause_us = pause;
+    }
 }
 
-void gc_sweep_generation(struct Generation* gen) {
-    if (!gen) return;
-    
-    // TODO: Implement generation sweeping
-    // This will be implemented when we have the object system
+static void gc_log_survival(FILE* file, const char* name, size_t swept, size_t survived) {
+    if (swept > 0) {
+        fprintf(file, ",\"%s\":%.4f", name, (double)survived / swept);
+    } else {
+        fprintf(file, ",\"%s\":null", name);
+    }
 }
 
-void gc_move_object(struct Object* object, struct Generation* target_gen) {
-    // TODO: Implement object movement between generations
-    (void)object;
-    (void)target_gen;
-}
+static void gc_cycle_end(Heap* heap) {
+    GC* gc = heap->gc;
+    GCCycle* cycle = &gc->cycle;
+    if (!cycle->active) return;
+    cycle->active = false;
 
-// Memory region management
-MemoryRegion* memory_region_create(void* start, size_t size) {
-    MemoryRegion* region = malloc(sizeof(MemoryRegion));
-    if (!region) return NULL;
-    
-    region->start = start;
-    region->size = size;
-    region->is_free = true;
-    region->next = NULL;
-    region->prev = NULL;
-    
-    return region;
-}
+    // A whole-heap cycle may have left memory to give back
+    if (cycle->type != GC_CYCLE_MINOR) {
+        heap_release_memory(heap);
+    }
 
-void memory_region_destroy(MemoryRegion* region) {
-    if (region) {
-        free(region);
+    gc->stats.collections_performed++;
+    gc->stats.avg_collection_time =
+        (gc->stats.avg_collection_time * (gc->stats.collections_performed - 1) + cycle->pause_us / 1e6)
+        / gc->stats.collections_performed;
+    gc->stats.occupancy_before = cycle->used_before;
+    gc->stats.occupancy_after = heap->used_size;
+
+    // Allocation rate over the interval since the previous cycle began
+    double interval = cycle->start_us - gc->last_cycle_start_us;
+    if (interval > 0) {
+        gc->stats.last_alloc_rate =
+            (cycle->allocated_before - gc->last_cycle_allocated) / (interval / 1e6);
     }
+    gc->last_cycle_start_us = cycle->start_us;
+    gc->last_cycle_allocated = cycle->allocated_before;
+
+    if (!gc->log_file) return;
+
+    FILE* file = gc->log_file;
+    fprintf(file, "{\"cycle\":%zu,\"type\":\"%s\",\"time_ms\":%.3f,\"duration_ms\":%.3f",
+            gc->stats.collections_performed, gc_cycle_names[cycle->type],
+            (cycle->start_us - gc->start_time_us) / 1e3, (gc_now_us() - cycle->start_us) / 1e3);
+    fprintf(file, ",\"pauses\":%u,\"pause_us\":%.1f,\"max_pause_us\":%.1f",
+            cycle->pauses, cycle->pause_us, cycle->max_pause_us);
+    fprintf(file, ",\"heap_before\":%zu,\"heap_after\":%zu", cycle->used_before, heap->used_size);
+    fprintf(file, ",\"young_before\":%zu,\"young_after\":%zu", cycle->young_before,
+            gc->young_gen ? gc->young_gen->used : 0);
+    fprintf(file, ",\"old_before\":%zu,\"old_after\":%zu", cycle->old_before,
+            gc->old_gen ? gc->old_gen->used : 0);
+    fprintf(file, ",\"freed_bytes\":%zu,\"promoted_bytes\":%zu",
+            gc->stats.bytes_freed - cycle->freed_before,
+            gc->stats.bytes_promoted - cycle->promoted_before);
+    gc_log_survival(file, "young_survival",
+                    gc->stats.young_bytes_swept - cycle->young_swept_before,
+                    gc->stats.young_bytes_survived - cycle->young_survived_before);
+    gc_log_survival(file, "old_survival",
+                    gc->stats.old_bytes_swept - cycle->old_swept_before,
+                    gc->stats.old_bytes_survived - cycle->old_survived_before);
+    fprintf(file, ",\"alloc_rate_mb_s\":%.3f}\n", gc->stats.last_alloc_rate / (1024.0 * 1024.0));
+    fflush(file);
 }
 
-MemoryRegion* memory_region_split(MemoryRegion* region, size_t size) {
-    if (!region || region->size <= size) return NULL;
-    
-    // Create new region for remaining space
-    void* new_start = (char*)region->start + size;
-    size_t new_size = region->size - size;
-    
-    MemoryRegion* new_region = memory_region_create(new_start, new_size);
-    if (!new_region) return NULL;
-    
-    // Update original region size
-    region->size = size;
-    
-    return new_region;
+void gc_set_log_file(Heap* heap, FILE* file) {
+    if (heap && heap->gc) {
+        heap->gc->log_file = file;
+    }
 }
 
-MemoryRegion* memory_region_merge(MemoryRegion* region1, MemoryRegion* region2) {
-    if (!region1 || !region2) return NULL;
-    if (!region1->is_free || !region2->is_free) return NULL;
-    
-    // Check if regions are adjacent
-    if ((char*)region1->start + region1->size != region2->start) {
-        return NULL;
+// Histogram buckets: values below 2 * GC_HISTOGRAM_SUB_BUCKETS map to
+// themselves; above that, the top five significant bits select the
+// sub-bucket and the shift selects the magnitude
+static size_t gc_histogram_index(uint64_t value) {
+    if (value < 2 * GC_HISTOGRAM_SUB_BUCKETS) {
+        return (size_t)value;
     }
-    
-    // Merge region2 into region1
-    region1->size += region2->size;
-    region1->next = region2->next;
-    if (region2->next) {
-        region2->next->prev = region1;
+
+    unsigned shift = (63 - (unsigned)__builtin_clzll(value)) - 4;
+    if (shift >= GC_HISTOGRAM_MAGNITUDES) {
+        return GC_HISTOGRAM_BUCKETS - 1;
     }
-    
-    // Destroy region2
-    memory_region_destroy(region2);
-    
-    return region1;
+    return (size_t)shift * GC_HISTOGRAM_SUB_BUCKETS + (size_t)(value >> shift);
 }
 
-MemoryRegion* memory_region_find_free(Heap* heap, size_t size) {
-    MemoryRegion* region = heap->regions;
-    
-    while (region) {
-        if (region->is_free && region->size >= size) {
-            return region;
-        }
-        region = region->next;
+// Highest value that maps to a bucket
+static uint64_t gc_histogram_value(size_t index) {
+    if (index < 2 * GC_HISTOGRAM_SUB_BUCKETS) {
+        return index;
     }
-    
-    return NULL;
+
+    unsigned shift = (unsigned)(index / GC_HISTOGRAM_SUB_BUCKETS) - 1;
+    uint64_t sub = index - (size_t)shift * GC_HISTOGRAM_SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
 }
 
-// Allocation tracking
-Allocation* allocation_create(void* ptr, size_t size, uint32_t type_id) {
-    Allocation* alloc = malloc(sizeof(Allocation));
-    if (!alloc) return NULL;
-    
-    alloc->ptr = ptr;
-    alloc->size = size;
-    alloc->type_id = type_id;
-    alloc->object = NULL;
-    alloc->next = NULL;
-    
-    return alloc;
+void gc_histogram_record(GCHistogram* histogram, uint64_t value) {
+    if (!histogram) return;
+
+    histogram->counts[gc_histogram_index(value)]++;
+    histogram->total_count++;
+    histogram->total_value += value;
+    if (value > histogram->max_value) {
+        histogram->max_value = value;
+    }
 }
 
-void allocation_destroy(Allocation* allocation) {
-    if (allocation) {
-        free(allocation);
+uint64_t gc_histogram_percentile(const GCHistogram* histogram, double percentile) {
+    if (!histogram || histogram->total_count == 0) return 0;
+
+    if (percentile > 100.0) percentile = 100.0;
+    size_t target = (size_t)(percentile / 100.0 * histogram->total_count + 0.999999);
+    if (target == 0) target = 1;
+
+    size_t seen = 0;
+    for (size_t i = 0; i < GC_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen >= target) {
+            uint64_t value = gc_histogram_value(i);
+            return value < histogram->max_value ? value : histogram->max_value;
+        }
     }
+
+    return histogram->max_value;
+}
+
+static void gc_drain_mark_stack(Heap* heap);
+static void gc_mark_parallel(Heap* heap);
+static void gc_scan_dirty_cards(Heap* heap);
+static void gc_rebuild_cards(Heap* heap);
+static void gc_sweep_generation_parallel(Heap* heap, Generation* gen);
+static bool gc_sweep_object(Heap* heap, Generation* gen, Object* object);
+static void gc_incremental_finish(Heap* heap);
+
+// Trace everything reachable from the grey objects on the mark stack
+static void gc_trace_heap(Heap* heap) {
+    if (heap->gc->worker_count > 1) {
+        gc_mark_parallel(heap);
+    } else {
+        gc_drain_mark_stack(heap);
+    }
+}
+
+static void gc_sweep_after_full_mark(Heap* heap) {
+    GC* gc = heap->gc;
+
+    // Sweep the old generation before the young one so objects promoted by
+    // the young sweep are not mistaken for unmarked old objects. The
+    // permanent generation holds class metadata and is never swept.
+    if (gc->worker_count > 1) {
+        gc_sweep_generation_parallel(heap, gc->old_gen);
+        gc_sweep_generation_parallel(heap, gc->young_gen);
+    } else {
+        gc_sweep_generation(heap, gc->old_gen);
+        gc_sweep_generation(heap, gc->young_gen);
+    }
+
+    // Every old-to-young reference is known after a full mark
+    gc_rebuild_cards(heap);
+}
+
+void gc_collect(Heap* heap) {
+    if (!heap || !heap->gc) return;
+
+    // An incremental cycle advances by one more slice
+    if (heap->gc->incremental_phase != GC_PHASE_IDLE) {
+        gc_collect_incremental(heap);
+        return;
+    }
+
+    // A concurrent cycle owns the heap until its remark; minor collections
+    // are deferred until then
+    if (heap->gc->marking_active) {
+        if (__atomic_load_n(&heap->gc->safepoint_requested, __ATOMIC_ACQUIRE)) {
+            gc_concurrent_finish(heap);
+        }
+        return;
+    }
+
+    // Collect the whole heap once the old generation passes its threshold,
+    // otherwise a minor collection is enough
+    if (heap->gc->old_gen && heap->gc->old_gen->used >= heap->gc->old_threshold) {
+        if (heap->gc->concurrent_mode) {
+            gc_collect_concurrent(heap);
+        } else if (heap->gc->incremental_mode) {
+            gc_collect_incremental(heap);
+        } else {
+            gc_collect_full(heap);
+        }
+    } else {
+        gc_collect_young(heap);
+    }
+}
+
+void gc_collect_young(Heap* heap) {
+    if (!heap || !heap->gc || !heap->gc->young_gen) return;
+
+    GC* gc = heap->gc;
+
+    // Without a root scanner every object has to be assumed live
+    if (!gc->root_scanner || gc->is_collecting || gc->marking_active ||
+        gc->incremental_phase != GC_PHASE_IDLE) return;
+
+    // Small heaps have a single generation - collect all of it
+    if (!gc->old_gen || !gc->card_table) {
+        gc_collect_full(heap);
+        return;
+    }
+
+    double start = gc_now_us();
+    gc_cycle_begin(heap, GC_CYCLE_MINOR);
+    gc->is_collecting = true;
+    gc->young_only = true;
+
+    // Mark young objects reachable from the roots and from dirty old cards
+    gc_mark_all_roots(heap);
+    gc_scan_dirty_cards(heap);
+    gc_drain_mark_stack(heap);
+
+    // Free dead young objects, age and promote the survivors
+    gc_sweep_generation(heap, gc->young_gen);
+
+    gc->young_only = false;
+    gc->is_collecting = false;
+    gc->stats.minor_collections++;
+    gc_record_pause(gc, start);
+    gc_cycle_end(heap);
+}
+
+void gc_collect_full(Heap* heap) {
+    if (!heap || !heap->gc) return;
+
+    GC* gc = heap->gc;
+    if (!gc->root_scanner || gc->is_collecting) return;
+
+    // Finishing a running incremental or concurrent cycle is a full collection
+    if (gc->incremental_phase != GC_PHASE_IDLE) {
+        gc_incremental_finish(heap);
+        return;
+    }
+    if (gc->marking_active) {
+        gc_concurrent_finish(heap);
+        return;
+    }
+
+    double start = gc_now_us();
+    gc_cycle_begin(heap, GC_CYCLE_FULL);
+    gc->is_collecting = true;
+    gc->young_only = false;
+
+    // Mark all objects
+    gc_mark_all_roots(heap);
+    gc_trace_heap(heap);
+
+    gc_sweep_after_full_mark(heap);
+
+    gc->is_collecting = false;
+    gc->stats.full_collections++;
+    gc_record_pause(gc, start);
+    gc_cycle_end(heap);
+}
+
+// Concurrent collection: a short stop-the-world initial mark greys the
+// roots, a background thread traces the heap while the interpreter keeps
+// running, and a stop-the-world remark at the next safepoint drains the
+// SATB log before sweeping. Objects allocated during the cycle are
+// allocated black and minor collections are deferred until remark.
+static void* gc_marker_main(void* arg) {
+    Heap* heap = (Heap*)arg;
+
+    gc_drain_mark_stack(heap);
+
+    __atomic_store_n(&heap->gc->safepoint_requested, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+void gc_collect_concurrent(Heap* heap) {
+    if (!heap || !heap->gc) return;
+
+    GC* gc = heap->gc;
+    if (!gc->root_scanner || gc->is_collecting || gc->marking_active) return;
+
+    // Initial mark (stop-the-world): grey the roots
+    double start = gc_now_us();
+    gc_cycle_begin(heap, GC_CYCLE_CONCURRENT);
+    gc->young_only = false;
+    gc_mark_all_roots(heap);
+
+    gc->marking_active = true;
+    __atomic_store_n(&gc->safepoint_requested, 0, __ATOMIC_RELAXED);
+    gc_record_pause(gc, start);
+
+    gc->marker_running = pthread_create(&gc->marker_thread, NULL, gc_marker_main, heap) == 0;
+    if (!gc->marker_running) {
+        // No thread available - finish the cycle on the mutator
+        gc_marker_main(heap);
+        gc_concurrent_finish(heap);
+    }
+}
+
+void gc_concurrent_finish(Heap* heap) {
+    if (!heap || !heap->gc || !heap->gc->marking_active) return;
+
+    GC* gc = heap->gc;
+    double start = gc_now_us();
+
+    if (gc->marker_running) {
+        pthread_join(gc->marker_thread, NULL);
+        gc->marker_running = false;
+    }
+
+    // Remark (stop-the-world): rescan roots, mark the SATB log and finish
+    // tracing on the mutator thread
+    gc->is_collecting = true;
+    gc_mark_all_roots(heap);
+    for (size_t i = 0; i < gc->satb_count; i++) {
+        gc_mark_object(heap, gc->satb_buffer[i]);
+    }
+    gc->satb_count = 0;
+    gc->marking_active = false;
+    __atomic_store_n(&gc->safepoint_requested, 0, __ATOMIC_RELAXED);
+    gc_trace_heap(heap);
+
+    gc_sweep_after_full_mark(heap);
+
+    gc->is_collecting = false;
+    gc->stats.concurrent_cycles++;
+    gc_record_pause(gc, start);
+    gc_cycle_end(heap);
+}
+
+void gc_satb_enqueue(Heap* heap, struct Object* object) {
+    if (!heap || !heap->gc || !object) return;
+
+    GC* gc = heap->gc;
+    if (gc->satb_count >= gc->satb_capacity) {
+        size_t new_capacity = gc->satb_capacity ? gc->satb_capacity * 2 : GC_INITIAL_MARK_STACK;
+        Object** new_buffer = realloc(gc->satb_buffer, sizeof(Object*) * new_capacity);
+        if (!new_buffer) {
+            // Cannot log the reference - finish the marking cycle now
+            gc_collect_full(heap);
+            return;
+        }
+        gc->satb_buffer = new_buffer;
+        gc->satb_capacity = new_capacity;
+    }
+
+    gc->satb_buffer[gc->satb_count++] = object;
+    gc->stats.satb_enqueued++;
+}
+
+void gc_safepoint_slow(Heap* heap) {
+    if (!heap || !heap->gc) return;
+
+    if (heap->gc->incremental_phase != GC_PHASE_IDLE) {
+        gc_collect_incremental(heap);
+    } else if (heap->gc->marking_active) {
+        gc_concurrent_finish(heap);
+    }
+}
+
+void gc_allocation_check(Heap* heap, size_t size) {
+    if (!heap || !heap->gc) return;
+
+    GC* gc = heap->gc;
+
+    // Pay off a pending lazy sweep a batch at a time
+    if (gc->sweep_pending_count > 0) {
+        gc_lazy_sweep(heap, GC_LAZY_SWEEP_BATCH);
+    }
+
+    // During an incremental cycle allocation is a safepoint as well: run a
+    // requested slice, and request the next one once enough has been
+    // allocated since the last
+    if (gc->incremental_phase != GC_PHASE_IDLE &&
+        __atomic_load_n(&gc->safepoint_requested, __ATOMIC_ACQUIRE)) {
+        gc_collect_incremental(heap);
+    }
+    if (gc->incremental_phase != GC_PHASE_IDLE) {
+        gc->incremental_debt += size;
+        if (gc->incremental_debt >= gc->incremental_pace) {
+            __atomic_store_n(&gc->safepoint_requested, 1, __ATOMIC_RELEASE);
+        }
+        return;
+    }
+
+    if (gc->root_scanner && gc->young_gen &&
+        gc->young_gen->used + size > gc->young_threshold) {
+        gc_collect(heap);
+    }
+}
+
+// GC utilities
+void gc_set_root_scanner(Heap* heap, GCRootScanner scanner, void* context) {
+    if (!heap || !heap->gc) return;
+
+    heap->gc->root_scanner = scanner;
+    heap->gc->root_context = context;
+}
+
+// Parallel GC worker - owns a work-stealing deque of grey objects. The
+// owner pushes and pops at the tail, idle workers steal from the head.
+typedef struct GCWorker {
+    Heap* heap;
+    struct GCParallelMark* shared;  // Workers and termination state
+    uint32_t id;                    // Worker index (0 runs on the caller)
+    pthread_t thread;               // Worker thread
+    pthread_mutex_t lock;           // Protects the deque
+    Object** items;                 // Deque storage
+    size_t head;                    // Steal end
+    size_t tail;                    // Owner end
+    size_t capacity;                // Deque capacity
+    size_t traced;                  // Objects traced by this worker
+    size_t stolen;                  // Objects stolen from other workers
+} GCWorker;
+
+typedef struct GCParallelMark {
+    GCWorker* workers;              // Worker array
+    uint32_t count;                 // Number of workers
+    uint32_t idle;                  // Workers out of work (atomic)
+} GCParallelMark;
+
+static bool gc_worker_push(GCWorker* worker, Object* object) {
+    pthread_mutex_lock(&worker->lock);
+
+    if (worker->tail == worker->capacity) {
+        if (worker->head > 0) {
+            // Reclaim space freed by thieves
+            memmove(worker->items, worker->items + worker->head,
+                    sizeof(Object*) * (worker->tail - worker->head));
+            worker->tail -= worker->head;
+            worker->head = 0;
+        } else {
+            size_t new_capacity = worker->capacity ? worker->capacity * 2 : GC_INITIAL_MARK_STACK;
+            Object** new_items = realloc(worker->items, sizeof(Object*) * new_capacity);
+            if (!new_items) {
+                pthread_mutex_unlock(&worker->lock);
+                return false;
+            }
+            worker->items = new_items;
+            worker->capacity = new_capacity;
+        }
+    }
+    worker->items[worker->tail++] = object;
+
+    pthread_mutex_unlock(&worker->lock);
+    return true;
+}
+
+static Object* gc_worker_pop(GCWorker* worker) {
+    Object* object = NULL;
+
+    pthread_mutex_lock(&worker->lock);
+    if (worker->tail > worker->head) {
+        object = worker->items[--worker->tail];
+    }
+    pthread_mutex_unlock(&worker->lock);
+
+    return object;
+}
+
+static Object* gc_worker_steal(GCWorker* victim) {
+    Object* object = NULL;
+
+    pthread_mutex_lock(&victim->lock);
+    if (victim->tail > victim->head) {
+        object = victim->items[victim->head++];
+    }
+    pthread_mutex_unlock(&victim->lock);
+
+    return object;
+}
+
+static bool gc_worker_has_work(GCWorker* worker) {
+    pthread_mutex_lock(&worker->lock);
+    bool has_work = worker->tail > worker->head;
+    pthread_mutex_unlock(&worker->lock);
+
+    return has_work;
+}
+
+static void gc_mark_grey(Heap* heap, GCWorker* worker, Object* object);
+
+// Visit the reference fields of an object, optionally marking the referents
+// onto the worker's deque (or the shared mark stack when worker is NULL).
+// Returns true if any referent lives in the young generation.
+static bool gc_visit_references(Heap* heap, GCWorker* worker, Object* object, bool mark) {
+    bool has_young = false;
+    Class* class_info = object_class(object);
+    if (!class_info) return false;
+
+    size_t data_size = object_size(object) - sizeof(ObjectHeader);
+    for (Field* field = class_info->fields; field; field = field->next) {
+        if (!field_is_reference(field)) continue;
+        if (field->offset + sizeof(Object*) > data_size) continue;
+
+        // The mutator may store concurrently with a background marker
+        Object* child = __atomic_load_n((Object**)(object->data + field->offset), __ATOMIC_RELAXED);
+        if (!child) continue;
+
+        if (!(child->header.flags & OBJECT_FLAG_OLD)) {
+            has_young = true;
+        }
+        if (mark) {
+            gc_mark_grey(heap, worker, child);
+        }
+    }
+
+    return has_young;
+}
+
+static void gc_mark_grey(Heap* heap, GCWorker* worker, Object* object) {
+    if (!object) return;
+
+    GC* gc = heap->gc;
+    uint32_t flags = __atomic_load_n(&object->header.flags, __ATOMIC_RELAXED);
+    if (flags & OBJECT_FLAG_MARKED) return;
+
+    // Minor collections treat the whole old generation as live
+    if (gc->young_only && (flags & OBJECT_FLAG_OLD)) return;
+
+    // Several markers (or an allocating mutator) may race for the bit
+    if (__atomic_fetch_or(&object->header.flags, OBJECT_FLAG_MARKED, __ATOMIC_RELAXED) & OBJECT_FLAG_MARKED) {
+        return;
+    }
+
+    if (worker) {
+        if (!gc_worker_push(worker, object)) {
+            gc_visit_references(heap, worker, object, true);
+        }
+        return;
+    }
+
+    // Push onto the mark stack (trace recursively if it cannot grow)
+    if (gc->mark_stack_count >= gc->mark_stack_capacity) {
+        size_t new_capacity = gc->mark_stack_capacity ? gc->mark_stack_capacity * 2 : GC_INITIAL_MARK_STACK;
+        Object** new_stack = realloc(gc->mark_stack, sizeof(Object*) * new_capacity);
+        if (!new_stack) {
+            gc_visit_references(heap, NULL, object, true);
+            return;
+        }
+        gc->mark_stack = new_stack;
+        gc->mark_stack_capacity = new_capacity;
+    }
+    gc->mark_stack[gc->mark_stack_count++] = object;
+}
+
+void gc_mark_object(Heap* heap, struct Object* object) {
+    if (!heap || !heap->gc || !object) return;
+
+    if (heap->gc->capturing_roots) {
+        GC* gc = heap->gc;
+        if (gc->captured_root_count == gc->captured_root_capacity) {
+            size_t capacity = gc->captured_root_capacity ? gc->captured_root_capacity * 2 : 256;
+            Object** roots = realloc(gc->captured_roots, capacity * sizeof(Object*));
+            if (!roots) return;
+            gc->captured_roots = roots;
+            gc->captured_root_capacity = capacity;
+        }
+        gc->captured_roots[gc->captured_root_count++] = object;
+        return;
+    }
+
+    gc_mark_grey(heap, NULL, object);
+}
+
+static void gc_drain_mark_stack(Heap* heap) {
+    GC* gc = heap->gc;
+
+    while (gc->mark_stack_count > 0) {
+        Object* object = gc->mark_stack[--gc->mark_stack_count];
+        gc_visit_references(heap, NULL, object, true);
+    }
+}
+
+// Worker loop: drain the local deque, then steal. Marking is complete once
+// every worker is idle - idle workers never push, so no work can reappear.
+static void* gc_mark_worker_main(void* arg) {
+    GCWorker* worker = (GCWorker*)arg;
+    GCParallelMark* shared = worker->shared;
+
+    for (;;) {
+        Object* object = gc_worker_pop(worker);
+
+        for (uint32_t i = 1; !object && i < shared->count; i++) {
+            object = gc_worker_steal(&shared->workers[(worker->id + i) % shared->count]);
+            if (object) {
+                worker->stolen++;
+            }
+        }
+
+        if (object) {
+            gc_visit_references(worker->heap, worker, object, true);
+            worker->traced++;
+            continue;
+        }
+
+        __atomic_add_fetch(&shared->idle, 1, __ATOMIC_ACQ_REL);
+        for (;;) {
+            if (__atomic_load_n(&shared->idle, __ATOMIC_ACQUIRE) == shared->count) {
+                return NULL;
+            }
+
+            bool found = false;
+            for (uint32_t i = 0; i < shared->count && !found; i++) {
+                found = gc_worker_has_work(&shared->workers[i]);
+            }
+            if (found) {
+                __atomic_sub_fetch(&shared->idle, 1, __ATOMIC_ACQ_REL);
+                break;
+            }
+            sched_yield();
+        }
+    }
+}
+
+// Trace the grey roots on the shared mark stack with worker_count threads.
+// Roots are dealt round-robin across the worker deques; the calling thread
+// acts as worker 0.
+static void gc_mark_parallel(Heap* heap) {
+    GC* gc = heap->gc;
+    uint32_t count = gc->worker_count;
+
+    GCWorker* workers = calloc(count, sizeof(GCWorker));
+    if (!workers) {
+        gc_drain_mark_stack(heap);
+        return;
+    }
+
+    GCParallelMark shared = { workers, count, 0 };
+    for (uint32_t i = 0; i < count; i++) {
+        workers[i].heap = heap;
+        workers[i].shared = &shared;
+        workers[i].id = i;
+        pthread_mutex_init(&workers[i].lock, NULL);
+    }
+
+    // Partition the roots
+    for (size_t i = 0; i < gc->mark_stack_count; i++) {
+        Object* root = gc->mark_stack[i];
+        if (!gc_worker_push(&workers[i % count], root)) {
+            gc_visit_references(heap, &workers[0], root, true);
+        }
+    }
+    gc->mark_stack_count = 0;
+
+    // Start helpers; a worker that fails to start simply has its roots stolen
+    bool* started = calloc(count, sizeof(bool));
+    for (uint32_t i = 1; i < count && started; i++) {
+        started[i] = pthread_create(&workers[i].thread, NULL, gc_mark_worker_main, &workers[i]) == 0;
+        if (!started[i]) {
+            __atomic_add_fetch(&shared.idle, 1, __ATOMIC_ACQ_REL);
+        }
+    }
+    if (!started) {
+        shared.idle = count - 1;
+    }
+
+    gc_mark_worker_main(&workers[0]);
+
+    for (uint32_t i = 1; i < count; i++) {
+        if (started && started[i]) {
+            pthread_join(workers[i].thread, NULL);
+        }
+    }
+
+    // A helper that never started may still hold grey roots
+    for (uint32_t i = 1; i < count; i++) {
+        Object* object;
+        while ((object = gc_worker_pop(&workers[i])) != NULL) {
+            gc_visit_references(heap, NULL, object, true);
+        }
+    }
+    gc_drain_mark_stack(heap);
+
+    for (uint32_t i = 0; i < count; i++) {
+        gc->stats.objects_stolen += workers[i].stolen;
+        pthread_mutex_destroy(&workers[i].lock);
+        free(workers[i].items);
+    }
+    free(started);
+    free(workers);
+}
+
+void gc_mark_all_roots(Heap* heap) {
+    if (!heap || !heap->gc || !heap->gc->root_scanner) return;
+
+    // Roots (operand stack, frame locals, this pointers) are owned by the VM
+    heap->gc->root_scanner(heap, heap->gc->root_context);
+}
+
+static void card_table_set_start(CardTable* table, Object* object, bool is_start) {
+    size_t slot = ((uintptr_t)object - table->covered_start) >> GC_CARD_SLOT_SHIFT;
+    uint64_t bit = (uint64_t)1 << (slot & 63);
+
+    if (is_start) {
+        table->start_bits[slot >> 6] |= bit;
+    } else {
+        table->start_bits[slot >> 6] &= ~bit;
+    }
+}
+
+// Trace old objects starting on dirty cards; cards that no longer hold any
+// old-to-young reference are cleaned
+static void gc_scan_dirty_cards(Heap* heap) {
+    GC* gc = heap->gc;
+    CardTable* table = gc->card_table;
+
+    for (size_t card = 0; card < table->card_count; card++) {
+        if (table->cards[card] != GC_CARD_DIRTY) continue;
+
+        gc->stats.dirty_cards_scanned++;
+        bool has_young = false;
+        uint64_t bits = table->start_bits[card];
+
+        while (bits) {
+            unsigned slot = (unsigned)__builtin_ctzll(bits);
+            bits &= bits - 1;
+
+            uintptr_t address = table->covered_start + (card << GC_CARD_SHIFT) +
+                                ((uintptr_t)slot << GC_CARD_SLOT_SHIFT);
+            if (gc_visit_references(heap, NULL, (Object*)address, true)) {
+                has_young = true;
+            }
+        }
+
+        if (!has_young) {
+            table->cards[card] = GC_CARD_CLEAN;
+        }
+    }
+}
+
+static void gc_rebuild_cards(Heap* heap) {
+    GC* gc = heap->gc;
+    CardTable* table = gc->card_table;
+    if (!table || !gc->old_gen) return;
+
+    card_table_clear(table);
+
+    for (size_t i = 0; i < gc->old_gen->object_count; i++) {
+        Object* object = gc->old_gen->objects[i];
+        if (gc_visit_references(heap, NULL, object, false)) {
+            gc_write_barrier(heap, object);
+        }
+    }
+}
+
+// Per-generation survival accounting
+static void gc_count_swept(GC* gc, bool is_young, size_t size, bool survived) {
+    if (is_young) {
+        gc->stats.young_bytes_swept += size;
+        if (survived) gc->stats.young_bytes_survived += size;
+    } else {
+        gc->stats.old_bytes_swept += size;
+        if (survived) gc->stats.old_bytes_survived += size;
+    }
+}
+
+// Sweep one object of gen: free it if unmarked, otherwise clear the mark
+// and age or promote young survivors. Returns true if it stays in gen.
+static bool gc_sweep_object(Heap* heap, Generation* gen, Object* object) {
+    GC* gc = heap->gc;
+    uint32_t size = object_size(object);
+    bool is_young = gen == gc->young_gen;
+
+    gc_count_swept(gc, is_young, size, object->header.flags & OBJECT_FLAG_MARKED);
+    if (!(object->header.flags & OBJECT_FLAG_MARKED)) {
+        // Unreachable - release the memory
+        if ((object->header.flags & OBJECT_FLAG_OLD) && gc->card_table) {
+            card_table_set_start(gc->card_table, object, false);
+        }
+        gen->used -= size;
+        gc->stats.objects_collected++;
+        gc->stats.bytes_freed += size;
+        heap_deallocate(heap, object);
+        return false;
+    }
+
+    object->header.flags &= ~OBJECT_FLAG_MARKED;
+
+    // Age young survivors and promote them at the tenure threshold
+    if (is_young && gc->old_gen) {
+        uint32_t age = ((object->header.flags & OBJECT_AGE_MASK) >> OBJECT_AGE_SHIFT) + 1;
+        if (age >= gc->tenure_threshold && gc_move_object(heap, object, gc->old_gen)) {
+            gen->used -= size;
+            return false;
+        }
+        if (age <= (OBJECT_AGE_MASK >> OBJECT_AGE_SHIFT)) {
+            object->header.flags = (object->header.flags & ~OBJECT_AGE_MASK) | (age << OBJECT_AGE_SHIFT);
+        }
+    }
+
+    return true;
+}
+
+void gc_sweep_generation(Heap* heap, struct Generation* gen) {
+    if (!heap || !heap->gc || !gen) return;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < gen->object_count; i++) {
+        Object* object = gen->objects[i];
+        if (gc_sweep_object(heap, gen, object)) {
+            gen->objects[kept++] = object;
+        }
+    }
+
+    gen->object_count = kept;
+}
+
+// Parallel sweeping: worker threads classify slices of a generation's
+// object array (clearing mark bits and ageing survivors), then the caller
+// compacts the array, promotes tenured objects and queues the dead for
+// lazy release - the free-region list itself is not thread-safe.
+#define GC_SWEEP_KEEP 0
+#define GC_SWEEP_FREE 1
+#define GC_SWEEP_PROMOTE 2
+
+typedef struct GCSweepSlice {
+    Heap* heap;
+    Generation* gen;
+    uint8_t* verdicts;              // Per-object outcome, indexed like gen->objects
+    size_t begin;                   // First object index
+    size_t end;                     // One past the last object index
+    pthread_t thread;               // Slice thread
+} GCSweepSlice;
+
+static void* gc_sweep_slice_main(void* arg) {
+    GCSweepSlice* slice = (GCSweepSlice*)arg;
+    GC* gc = slice->heap->gc;
+    bool age_survivors = slice->gen == gc->young_gen && gc->old_gen;
+
+    for (size_t i = slice->begin; i < slice->end; i++) {
+        Object* object = slice->gen->objects[i];
+        uint32_t flags = object->header.flags;
+
+        if (!(flags & OBJECT_FLAG_MARKED)) {
+            slice->verdicts[i] = GC_SWEEP_FREE;
+            continue;
+        }
+
+        flags &= ~OBJECT_FLAG_MARKED;
+        uint8_t verdict = GC_SWEEP_KEEP;
+        if (age_survivors) {
+            uint32_t age = ((flags & OBJECT_AGE_MASK) >> OBJECT_AGE_SHIFT) + 1;
+            if (age >= gc->tenure_threshold) {
+                verdict = GC_SWEEP_PROMOTE;
+            } else if (age <= (OBJECT_AGE_MASK >> OBJECT_AGE_SHIFT)) {
+                flags = (flags & ~OBJECT_AGE_MASK) | (age << OBJECT_AGE_SHIFT);
+            }
+        }
+        object->header.flags = flags;
+        slice->verdicts[i] = verdict;
+    }
+
+    return NULL;
+}
+
+static void gc_queue_free(Heap* heap, Object* object) {
+    GC* gc = heap->gc;
+
+    if (gc->sweep_pending_count >= gc->sweep_pending_capacity) {
+        size_t new_capacity = gc->sweep_pending_capacity ? gc->sweep_pending_capacity * 2 : GC_INITIAL_MARK_STACK;
+        Object** new_pending = realloc(gc->sweep_pending, sizeof(Object*) * new_capacity);
+        if (!new_pending) {
+            heap_deallocate(heap, object);
+            return;
+        }
+        gc->sweep_pending = new_pending;
+        gc->sweep_pending_capacity = new_capacity;
+    }
+    gc->sweep_pending[gc->sweep_pending_count++] = object;
+}
+
+static void gc_sweep_generation_parallel(Heap* heap, Generation* gen) {
+    if (!gen || gen->object_count == 0) return;
+
+    GC* gc = heap->gc;
+    size_t count = gen->object_count;
+    uint32_t workers = gc->worker_count;
+    if (workers > count) workers = (uint32_t)count;
+
+    uint8_t* verdicts = malloc(count);
+    GCSweepSlice* slices = calloc(workers, sizeof(GCSweepSlice));
+    if (!verdicts || !slices) {
+        free(verdicts);
+        free(slices);
+        gc_sweep_generation(heap, gen);
+        return;
+    }
+
+    // Classify slices in parallel; slice 0 runs on the caller
+    size_t per_slice = (count + workers - 1) / workers;
+    for (uint32_t i = 0; i < workers; i++) {
+        slices[i].heap = heap;
+        slices[i].gen = gen;
+        slices[i].verdicts = verdicts;
+        slices[i].begin = i * per_slice < count ? i * per_slice : count;
+        slices[i].end = slices[i].begin + per_slice < count ? slices[i].begin + per_slice : count;
+    }
+    bool* started = calloc(workers, sizeof(bool));
+    for (uint32_t i = 1; i < workers; i++) {
+        if (started) {
+            started[i] = pthread_create(&slices[i].thread, NULL, gc_sweep_slice_main, &slices[i]) == 0;
+        }
+        if (!started || !started[i]) {
+            gc_sweep_slice_main(&slices[i]);
+        }
+    }
+    gc_sweep_slice_main(&slices[0]);
+    for (uint32_t i = 1; i < workers; i++) {
+        if (started && started[i]) {
+            pthread_join(slices[i].thread, NULL);
+        }
+    }
+
+    // Merge: compact survivors, promote and queue the dead
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        Object* object = gen->objects[i];
+        uint32_t size = object_size(object);
+
+        gc_count_swept(gc, gen == gc->young_gen, size, verdicts[i] != GC_SWEEP_FREE);
+        switch (verdicts[i]) {
+            case GC_SWEEP_FREE:
+                if ((object->header.flags & OBJECT_FLAG_OLD) && gc->card_table) {
+                    card_table_set_start(gc->card_table, object, false);
+                }
+                gen->used -= size;
+                gc->stats.objects_collected++;
+                gc->stats.bytes_freed += size;
+                gc_queue_free(heap, object);
+                continue;
+            case GC_SWEEP_PROMOTE:
+                if (gc_move_object(heap, object, gc->old_gen)) {
+                    gen->used -= size;
+                    continue;
+                }
+                break;
+            default:
+                break;
+        }
+
+        gen->objects[kept++] = object;
+    }
+    gen->object_count = kept;
+
+    free(started);
+    free(slices);
+    free(verdicts);
+}
+
+size_t gc_lazy_sweep(Heap* heap, size_t budget) {
+    if (!heap || !heap->gc) return 0;
+
+    GC* gc = heap->gc;
+    size_t freed = 0;
+    while (gc->sweep_pending_count > 0 && freed < budget) {
+        heap_deallocate(heap, gc->sweep_pending[--gc->sweep_pending_count]);
+        freed++;
+    }
+    gc->stats.lazily_swept += freed;
+
+    return freed;
+}
+
+void gc_set_worker_count(Heap* heap, uint32_t workers) {
+    if (!heap || !heap->gc) return;
+
+    if (workers < 1) workers = 1;
+    if (workers > GC_MAX_WORKERS) workers = GC_MAX_WORKERS;
+    heap->gc->worker_count = workers;
+}
+
+// Incremental collection: the whole heap is marked and swept in slices of
+// at most pause_target_us of work. Marking reuses the SATB barrier and
+// allocate-black of concurrent marking; the mutator runs between slices.
+// Allocation requests a slice every incremental_pace bytes and the slice
+// runs at the next safepoint. Minor collections are deferred for the whole
+// cycle, so the card table stays a valid superset and needs no rebuild.
+// Objects traced between deadline checks
+#define GC_INCREMENTAL_CHECK_INTERVAL 32
+
+// Trace grey objects until the deadline (0 = none). Returns true once
+// marking is complete.
+static bool gc_incremental_mark(Heap* heap, double deadline) {
+    GC* gc = heap->gc;
+    size_t work = 0;
+
+    for (;;) {
+        while (gc->mark_stack_count > 0) {
+            Object* object = gc->mark_stack[--gc->mark_stack_count];
+            gc_visit_references(heap, NULL, object, true);
+
+            if (deadline > 0 && ++work % GC_INCREMENTAL_CHECK_INTERVAL == 0 &&
+                gc_now_us() >= deadline) {
+                return false;
+            }
+        }
+
+        // Grey the references logged by the SATB barrier since the last slice
+        if (gc->satb_count > 0) {
+            for (size_t i = 0; i < gc->satb_count; i++) {
+                gc_mark_object(heap, gc->satb_buffer[i]);
+            }
+            gc->satb_count = 0;
+            continue;
+        }
+
+        // Remark: rescan the roots once nothing else is grey
+        gc_mark_all_roots(heap);
+        if (gc->mark_stack_count == 0) {
+            return true;
+        }
+    }
+}
+
+// Sweep old then young objects until the deadline (0 = none). Returns true
+// once both generations are swept.
+static bool gc_incremental_sweep(Heap* heap, double deadline) {
+    GC* gc = heap->gc;
+
+    while (gc->sweep_gen) {
+        Generation* gen = gc->sweep_gen;
+
+        // Removed objects are replaced by the last one, so objects
+        // allocated (black) during the sweep are swept as well
+        while (gc->sweep_index < gen->object_count) {
+            Object* object = gen->objects[gc->sweep_index];
+            if (gc_sweep_object(heap, gen, object)) {
+                gc->sweep_index++;
+            } else {
+                gen->objects[gc->sweep_index] = gen->objects[--gen->object_count];
+            }
+
+            // Freeing dominates the cost of a sweep step, so the clock is
+            // read after every object
+            if (deadline > 0 && gc_now_us() >= deadline) {
+                return false;
+            }
+        }
+
+        gc->sweep_gen = (gen == gc->old_gen) ? gc->young_gen : NULL;
+        gc->sweep_index = 0;
+    }
+
+    return true;
+}
+
+// Run one slice of the current cycle (deadline 0 finishes it)
+static void gc_incremental_slice(Heap* heap, double deadline) {
+    GC* gc = heap->gc;
+
+    if (gc->incremental_phase == GC_PHASE_MARK && gc_incremental_mark(heap, deadline)) {
+        // Marking done - stop logging and start sweeping. New objects stay
+        // black until the sweep has passed them.
+        gc->marking_active = false;
+        gc->incremental_phase = GC_PHASE_SWEEP;
+        gc->sweep_gen = gc->old_gen ? gc->old_gen : gc->young_gen;
+        gc->sweep_index = 0;
+    }
+
+    if (gc->incremental_phase == GC_PHASE_SWEEP && gc_incremental_sweep(heap, deadline)) {
+        gc->incremental_phase = GC_PHASE_IDLE;
+        gc->stats.incremental_cycles++;
+        gc->stats.full_collections++;
+        gc->collection_step = 0;
+    }
+}
+
+void gc_collect_incremental(Heap* heap) {
+    if (!heap || !heap->gc) return;
+
+    GC* gc = heap->gc;
+    if (!gc->root_scanner || gc->is_collecting) return;
+
+    // A concurrent cycle in progress cannot be sliced
+    if (gc->marking_active && gc->incremental_phase == GC_PHASE_IDLE) return;
+
+    double start = gc_now_us();
+    gc->is_collecting = true;
+    __atomic_store_n(&gc->safepoint_requested, 0, __ATOMIC_RELAXED);
+    gc->incremental_debt = 0;
+
+    if (gc->incremental_phase == GC_PHASE_IDLE) {
+        // Initial mark: grey the roots, then trace with the rest of the slice
+        gc->young_only = false;
+        gc->marking_active = true;
+        gc->incremental_phase = GC_PHASE_MARK;
+        gc->collection_step = 0;
+        gc_cycle_begin(heap, GC_CYCLE_INCREMENTAL);
+        gc_mark_all_roots(heap);
+    }
+
+    gc_incremental_slice(heap, start + gc->pause_target_us);
+
+    gc->is_collecting = false;
+    gc->collection_step++;
+    gc->stats.incremental_slices++;
+
+    double elapsed = (gc_now_us() - start) / 1e6;
+    if (elapsed > gc->stats.max_slice_time) {
+        gc->stats.max_slice_time = elapsed;
+    }
+    if (elapsed * 1e6 > gc->pause_target_us) {
+        gc->stats.slices_over_target++;
+    }
+    gc_record_pause(gc, start);
+    if (gc->incremental_phase == GC_PHASE_IDLE) {
+        gc_cycle_end(heap);
+    }
+}
+
+// Complete the current cycle in one pause (the heap ran out before the
+// slices caught up). Slices are requested twice as often from then on.
+static void gc_incremental_finish(Heap* heap) {
+    GC* gc = heap->gc;
+    double start = gc_now_us();
+
+    gc->is_collecting = true;
+    __atomic_store_n(&gc->safepoint_requested, 0, __ATOMIC_RELAXED);
+    gc->incremental_debt = 0;
+    gc_incremental_slice(heap, 0);
+    gc->is_collecting = false;
+
+    gc->stats.incremental_fallbacks++;
+    if (gc->incremental_pace / 2 >= GC_MIN_INCREMENTAL_PACE) {
+        gc->incremental_pace /= 2;
+    }
+    gc_record_pause(gc, start);
+    gc_cycle_end(heap);
+}
+
+void gc_set_pause_target(Heap* heap, uint32_t target_us) {
+    if (!heap || !heap->gc) return;
+
+    if (target_us < GC_MIN_PAUSE_TARGET_US) target_us = GC_MIN_PAUSE_TARGET_US;
+    heap->gc->pause_target_us = target_us;
+}
+
+bool gc_move_object(Heap* heap, struct Object* object, struct Generation* target_gen) {
+    if (!heap || !heap->gc || !object || !target_gen) return false;
+
+    GC* gc = heap->gc;
+    if (!generation_add_object(target_gen, object)) return false;
+    target_gen->used += object_size(object);
+
+    // Objects are not relocated; tenuring only changes ownership
+    if (target_gen == gc->old_gen) {
+        object->header.flags |= OBJECT_FLAG_OLD;
+        object->header.flags &= ~OBJECT_AGE_MASK;
+        gc->stats.objects_promoted++;
+        gc->stats.bytes_promoted += object_size(object);
+
+        if (gc->card_table) {
+            card_table_set_start(gc->card_table, object, true);
+
+            // The promoted object may still reference young survivors
+            if (gc_visit_references(heap, NULL, object, false)) {
+                gc_write_barrier(heap, object);
+            }
+        }
+    }
+
+    return true;
+}
+
+void gc_register_object(Heap* heap, struct Object* object) {
+    if (!heap || !heap->gc || !heap->gc->young_gen || !object) return;
+
+    // Objects created during a concurrent mark or an incremental cycle are
+    // allocated black
+    if (heap->gc->marking_active || heap->gc->incremental_phase != GC_PHASE_IDLE) {
+        object->header.flags |= OBJECT_FLAG_MARKED;
+    }
+
+    // Label the allocation record (heap_allocate just pushed it)
+    Allocation* alloc = heap->allocations;
+    if (alloc && alloc->ptr == object) {
+        alloc->object = object;
+        alloc->type_id = object_class(object)->type_id;
+    }
+
+    // New objects start in the young generation
+    if (generation_add_object(heap->gc->young_gen, object)) {
+        heap->gc->young_gen->used += object_size(object);
+        heap->gc->stats.total_allocated += object_size(object);
+    }
+}
+
+// Permanent objects are created marked and old in the permanent generation,
+// which is never swept, so no collection traces or frees them
+bool gc_register_permanent(Heap* heap, struct Object* object) {
+    if (!heap || !heap->gc || !heap->gc->perm_gen || !object) return false;
+
+    Allocation* alloc = heap->allocations;
+    if (alloc && alloc->ptr == object) {
+        alloc->object = object;
+        alloc->type_id = object_class(object)->type_id;
+    }
+
+    object->header.flags |= OBJECT_FLAG_MARKED | OBJECT_FLAG_OLD;
+    if (!generation_add_object(heap->gc->perm_gen, object)) return false;
+    heap->gc->perm_gen->used += object_size(object);
+    heap->gc->stats.total_allocated += object_size(object);
+    return true;
+}
+
+// Card table management. The arrays are mapped for the whole reservation
+// up front; only the cards of committed memory are ever touched.
+CardTable* card_table_create(void* start, size_t size, size_t capacity) {
+    CardTable* table = calloc(1, sizeof(CardTable));
+    if (!table) return NULL;
+
+    if (capacity < size) {
+        capacity = size;
+    }
+    table->covered_start = (uintptr_t)start;
+    table->card_capacity = (capacity + GC_CARD_SIZE - 1) >> GC_CARD_SHIFT;
+    table->cards = heap_os_map(table->card_capacity * sizeof(uint8_t));
+    table->start_bits = heap_os_map(table->card_capacity * sizeof(uint64_t));
+
+    if (!table->cards || !table->start_bits) {
+        card_table_destroy(table);
+        return NULL;
+    }
+
+    card_table_resize(table, size);
+    return table;
+}
+
+void card_table_destroy(CardTable* table) {
+    if (table) {
+        if (table->cards) {
+            munmap(table->cards, table->card_capacity * sizeof(uint8_t));
+        }
+        if (table->start_bits) {
+            munmap(table->start_bits, table->card_capacity * sizeof(uint64_t));
+        }
+        free(table);
+    }
+}
+
+// Follow the heap as it grows or shrinks; cards dropped by a shrink are
+// cleared so they start clean if the heap grows again
+void card_table_resize(CardTable* table, size_t size) {
+    if (!table) return;
+
+    size_t card_count = (size + GC_CARD_SIZE - 1) >> GC_CARD_SHIFT;
+    if (card_count > table->card_capacity) {
+        card_count = table->card_capacity;
+        size = card_count << GC_CARD_SHIFT;
+    }
+    if (card_count < table->card_count) {
+        memset(table->cards + card_count, GC_CARD_CLEAN, table->card_count - card_count);
+        memset(table->start_bits + card_count, 0, (table->card_count - card_count) * sizeof(uint64_t));
+    }
+
+    table->card_count = card_count;
+    table->covered_size = size;
+}
+
+void card_table_clear(CardTable* table) {
+    if (table) {
+        memset(table->cards, GC_CARD_CLEAN, table->card_count);
+    }
+}
+
+size_t card_table_dirty_count(CardTable* table) {
+    if (!table) return 0;
+
+    size_t dirty = 0;
+    for (size_t i = 0; i < table->card_count; i++) {
+        if (table->cards[i] == GC_CARD_DIRTY) {
+            dirty++;
+        }
+    }
+
+    return dirty;
+}
+
+// Memory region management
+MemoryRegion* memory_region_create(void* start, size_t size) {
+    MemoryRegion* region = malloc(sizeof(MemoryRegion));
+    if (!region) return NULL;
+    
+    region->start = start;
+    region->size = size;
+    region->is_free = true;
+    region->next = NULL;
+    region->prev = NULL;
+    
+    return region;
+}
+
+void memory_region_destroy(MemoryRegion* region) {
+    if (region) {
+        free(region);
+    }
+}
+
+MemoryRegion* memory_region_split(MemoryRegion* region, size_t size) {
+    if (!region || region->size <= size) return NULL;
+    
+    // Create new region for remaining space
+    void* new_start = (char*)region->start + size;
+    size_t new_size = region->size - size;
+    
+    MemoryRegion* new_region = memory_region_create(new_start, new_size);
+    if (!new_region) return NULL;
+    
+    // Update original region size
+    region->size = size;
+    
+    return new_region;
+}
+
+MemoryRegion* memory_region_merge(MemoryRegion* region1, MemoryRegion* region2) {
+    if (!region1 || !region2) return NULL;
+    if (!region1->is_free || !region2->is_free) return NULL;
+    
+    // Check if regions are adjacent
+    if ((char*)region1->start + region1->size != region2->start) {
+        return NULL;
+    }
+    
+    // Merge region2 into region1
+    region1->size += region2->size;
+    region1->next = region2->next;
+    if (region2->next) {
+        region2->next->prev = region1;
+    }
+    
+    // Destroy region2
+    memory_region_destroy(region2);
+    
+    return region1;
+}
+
+// Size class of a region: floor(log2(size))
+static size_t heap_size_class(size_t size) {
+    return size ? 63 - (size_t)__builtin_clzll((unsigned long long)size) : 0;
+}
+
+static void heap_free_list_insert(Heap* heap, MemoryRegion* region) {
+    size_t size_class = heap_size_class(region->size);
+    region->free_prev = NULL;
+    region->free_next = heap->free_lists[size_class];
+    if (region->free_next) {
+        region->free_next->free_prev = region;
+    }
+    heap->free_lists[size_class] = region;
+    heap->free_classes |= 1ULL << size_class;
+}
+
+static void heap_free_list_remove(Heap* heap, MemoryRegion* region) {
+    size_t size_class = heap_size_class(region->size);
+    if (region->free_prev) {
+        region->free_prev->free_next = region->free_next;
+    } else {
+        heap->free_lists[size_class] = region->free_next;
+    }
+    if (region->free_next) {
+        region->free_next->free_prev = region->free_prev;
+    }
+    if (!heap->free_lists[size_class]) {
+        heap->free_classes &= ~(1ULL << size_class);
+    }
+    region->free_next = NULL;
+    region->free_prev = NULL;
+}
+
+static void heap_free_lists_rebuild(Heap* heap) {
+    memset(heap->free_lists, 0, sizeof(heap->free_lists));
+    heap->free_classes = 0;
+    for (MemoryRegion* region = heap->regions; region; region = region->next) {
+        if (region->is_free) {
+            heap_free_list_insert(heap, region);
+        }
+    }
+}
+
+// Free region for a size-byte allocation. Regions in the size's own class
+// may be too small and are checked first-fit; any region of a larger class
+// fits, so the smallest non-empty one is taken without a search.
+MemoryRegion* memory_region_find_free(Heap* heap, size_t size) {
+    size_t size_class = heap_size_class(size);
+    
+    for (MemoryRegion* region = heap->free_lists[size_class]; region; region = region->free_next) {
+        if (region->size >= size) {
+            return region;
+        }
+    }
+    
+    uint64_t larger = size_class + 1 < HEAP_SIZE_CLASSES ? heap->free_classes >> (size_class + 1) : 0;
+    if (!larger) {
+        return NULL;
+    }
+    return heap->free_lists[size_class + 1 + (size_t)__builtin_ctzll(larger)];
+}
+
+// Allocation tracking
+Allocation* allocation_create(Heap* heap, void* ptr, size_t size, uint32_t type_id) {
+    Allocation* alloc = slab_pool_alloc(&heap->allocation_pool);
+    if (!alloc) return NULL;
+    
+    alloc->ptr = ptr;
+    alloc->size = size;
+    alloc->type_id = type_id;
+    alloc->object = NULL;
+    alloc->region = NULL;
+    alloc->next = NULL;
+    alloc->prev = NULL;
+    alloc->hash_next = NULL;
+    
+    return alloc;
+}
+
+void allocation_destroy(Heap* heap, Allocation* allocation) {
+    slab_pool_free(&heap->allocation_pool, allocation);
+}
+
+static size_t allocation_hash(const void* ptr) {
+    uintptr_t key = (uintptr_t)ptr;
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)key;
+}
+
+// Rehash every record on the allocation list into `size` buckets
+static bool allocation_index_rebuild(Heap* heap, size_t size) {
+    Allocation** index = calloc(size, sizeof(Allocation*));
+    if (!index) return false;
+    
+    for (Allocation* alloc = heap->allocations; alloc; alloc = alloc->next) {
+        size_t bucket = allocation_hash(alloc->ptr) & (size - 1);
+        alloc->hash_next = index[bucket];
+        index[bucket] = alloc;
+    }
+    free(heap->allocation_index);
+    heap->allocation_index = index;
+    heap->allocation_index_size = size;
+    return true;
+}
+
+// Index a record already pushed onto the allocation list
+static void allocation_index_add(Heap* heap, Allocation* alloc) {
+    if (heap->allocation_count > heap->allocation_index_size) {
+        size_t size = heap->allocation_index_size ? heap->allocation_index_size * 2 : HEAP_ALLOCATION_INDEX_MIN;
+        if (allocation_index_rebuild(heap, size)) {
+            return;
+        }
+    }
+    if (!heap->allocation_index) return;
+    
+    size_t bucket = allocation_hash(alloc->ptr) & (heap->allocation_index_size - 1);
+    alloc->hash_next = heap->allocation_index[bucket];
+    heap->allocation_index[bucket] = alloc;
+}
+
+// Unlink a record from the list and the index, and free it
+static void allocation_unlink(Heap* heap, Allocation* alloc) {
+    if (heap->allocation_index) {
+        Allocation** link = &heap->allocation_index[allocation_hash(alloc->ptr) & (heap->allocation_index_size - 1)];
+        while (*link && *link != alloc) {
+            link = &(*link)->hash_next;
+        }
+        if (*link) {
+            *link = alloc->hash_next;
+        }
+    }
+    if (alloc->prev) {
+        alloc->prev->next = alloc->next;
+    } else {
+        heap->allocations = alloc->next;
+    }
+    if (alloc->next) {
+        alloc->next->prev = alloc->prev;
+    }
+    allocation_destroy(heap, alloc);
+    heap->allocation_count--;
 }
 
 Allocation* allocation_find(Heap* heap, void* ptr) {
+    if (heap->allocation_index) {
+        Allocation* alloc = heap->allocation_index[allocation_hash(ptr) & (heap->allocation_index_size - 1)];
+        while (alloc && alloc->ptr != ptr) {
+            alloc = alloc->hash_next;
+        }
+        return alloc;
+    }
+    
     Allocation* alloc = heap->allocations;
     
     while (alloc) {
@@ -577,22 +2263,9 @@ Allocation* allocation_find(Heap* heap, void* ptr) {
 }
 
 void allocation_remove(Heap* heap, void* ptr) {
-    Allocation* alloc = heap->allocations;
-    Allocation* prev = NULL;
-    
-    while (alloc) {
-        if (alloc->ptr == ptr) {
-            if (prev) {
-                prev->next = alloc->next;
-            } else {
-                heap->allocations = alloc->next;
-            }
-            allocation_destroy(alloc);
-            heap->allocation_count--;
-            return;
-        }
-        prev = alloc;
-        alloc = alloc->next;
+    Allocation* alloc = allocation_find(heap, ptr);
+    if (alloc) {
+        allocation_unlink(heap, alloc);
     }
 }
 
@@ -676,6 +2349,403 @@ void generation_compact(Generation* gen) {
     // This will be implemented when we have the object system
 }
 
+// Allocation profiler. Sampling intervals are drawn uniformly from
+// [1, 2 * rate - 1] so that loops allocating with a fixed stride cannot
+// alias with the sampler; each sample stands for `rate` allocations.
+static uint32_t heap_profile_interval(AllocProfiler* profiler) {
+    uint64_t x = profiler->random;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    profiler->random = x;
+    if (profiler->rate <= 1) return 1;
+    return 1 + (uint32_t)(x % (2 * (uint64_t)profiler->rate - 1));
+}
+
+static size_t heap_profile_hash(uintptr_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)key;
+}
+
+static size_t heap_profile_site_hash(const char* method, uint32_t offset, uint32_t type_id) {
+    return heap_profile_hash((uintptr_t)method ^ ((uintptr_t)offset << 20) ^ ((uintptr_t)type_id << 40));
+}
+
+bool heap_profiler_enable(Heap* heap, uint32_t rate) {
+    if (!heap) return false;
+    if (rate == 0) {
+        rate = ALLOC_PROFILE_DEFAULT_RATE;
+    }
+    
+    heap_profiler_disable(heap);
+    AllocProfiler* profiler = calloc(1, sizeof(AllocProfiler));
+    if (!profiler) return false;
+    
+    profiler->rate = rate;
+    profiler->random = 0x9E3779B97F4A7C15ULL ^ (uint64_t)(uintptr_t)heap;
+    profiler->countdown = heap_profile_interval(profiler);
+    profiler->site_slot_count = 256;
+    profiler->site_slots = calloc(profiler->site_slot_count, sizeof(uint32_t));
+    profiler->live_capacity = 1024;
+    profiler->live = calloc(profiler->live_capacity, sizeof(AllocSample));
+    if (!profiler->site_slots || !profiler->live) {
+        free(profiler->site_slots);
+        free(profiler->live);
+        free(profiler);
+        return false;
+    }
+    
+    heap->profiler = profiler;
+    return true;
+}
+
+void heap_profiler_disable(Heap* heap) {
+    if (!heap || !heap->profiler) return;
+    
+    free(heap->profiler->sites);
+    free(heap->profiler->site_slots);
+    free(heap->profiler->live);
+    free(heap->profiler);
+    heap->profiler = NULL;
+}
+
+// Find or add the site of the current instruction for the given type
+static AllocSite* heap_profile_site(AllocProfiler* profiler, uint32_t type_id, const char* type_name) {
+    // Keep the slot table at most half full
+    if ((profiler->site_count + 1) * 2 > profiler->site_slot_count) {
+        size_t slot_count = profiler->site_slot_count * 2;
+        uint32_t* slots = calloc(slot_count, sizeof(uint32_t));
+        if (!slots) return NULL;
+        for (size_t i = 0; i < profiler->site_count; i++) {
+            AllocSite* site = &profiler->sites[i];
+            size_t slot = heap_profile_site_hash(site->method, site->offset, site->type_id) & (slot_count - 1);
+            while (slots[slot]) slot = (slot + 1) & (slot_count - 1);
+            slots[slot] = (uint32_t)i + 1;
+        }
+        free(profiler->site_slots);
+        profiler->site_slots = slots;
+        profiler->site_slot_count = slot_count;
+    }
+    
+    const char* method = profiler->site_method;
+    uint32_t offset = method ? profiler->site_offset : 0;
+    size_t mask = profiler->site_slot_count - 1;
+    size_t slot = heap_profile_site_hash(method, offset, type_id) & mask;
+    while (profiler->site_slots[slot]) {
+        AllocSite* site = &profiler->sites[profiler->site_slots[slot] - 1];
+        if (site->method == method && site->offset == offset && site->type_id == type_id &&
+            site->type_name == type_name) {
+            return site;
+        }
+        slot = (slot + 1) & mask;
+    }
+    
+    if (profiler->site_count == profiler->site_capacity) {
+        size_t capacity = profiler->site_capacity ? profiler->site_capacity * 2 : 64;
+        AllocSite* sites = realloc(profiler->sites, capacity * sizeof(AllocSite));
+        if (!sites) return NULL;
+        profiler->sites = sites;
+        profiler->site_capacity = capacity;
+    }
+    
+    AllocSite* site = &profiler->sites[profiler->site_count];
+    memset(site, 0, sizeof(AllocSite));
+    site->method = method;
+    site->offset = offset;
+    site->type_id = type_id;
+    site->type_name = type_name;
+    profiler->site_slots[slot] = (uint32_t)++profiler->site_count;
+    return site;
+}
+
+static bool heap_profile_live_insert(AllocProfiler* profiler, const void* ptr, uint32_t site, uint32_t size) {
+    if ((profiler->live_count + 1) * 2 > profiler->live_capacity) {
+        size_t capacity = profiler->live_capacity * 2;
+        AllocSample* live = calloc(capacity, sizeof(AllocSample));
+        if (!live) return false;
+        for (size_t i = 0; i < profiler->live_capacity; i++) {
+            if (!profiler->live[i].ptr) continue;
+            size_t slot = heap_profile_hash((uintptr_t)profiler->live[i].ptr) & (capacity - 1);
+            while (live[slot].ptr) slot = (slot + 1) & (capacity - 1);
+            live[slot] = profiler->live[i];
+        }
+        free(profiler->live);
+        profiler->live = live;
+        profiler->live_capacity = capacity;
+    }
+    
+    size_t mask = profiler->live_capacity - 1;
+    size_t slot = heap_profile_hash((uintptr_t)ptr) & mask;
+    while (profiler->live[slot].ptr) {
+        if (profiler->live[slot].ptr == ptr) break;
+        slot = (slot + 1) & mask;
+    }
+    if (!profiler->live[slot].ptr) {
+        profiler->live_count++;
+    }
+    profiler->live[slot].ptr = ptr;
+    profiler->live[slot].site = site;
+    profiler->live[slot].size = size;
+    return true;
+}
+
+void heap_profile_allocation(Heap* heap, const void* ptr, size_t size, uint32_t type_id, const char* type_name) {
+    if (!heap || !heap->profiler || !ptr) return;
+    
+    AllocProfiler* profiler = heap->profiler;
+    profiler->countdown = heap_profile_interval(profiler);
+    
+    AllocSite* site = heap_profile_site(profiler, type_id, type_name);
+    if (!site) return;
+    site->samples++;
+    site->bytes += size;
+    if (heap_profile_live_insert(profiler, ptr, (uint32_t)(site - profiler->sites), (uint32_t)size)) {
+        site->live_samples++;
+        site->live_bytes += size;
+    }
+}
+
+// Forget a sampled allocation; ptr need not have been sampled
+void heap_profile_free(Heap* heap, const void* ptr) {
+    if (!heap || !heap->profiler || !ptr) return;
+    
+    AllocProfiler* profiler = heap->profiler;
+    size_t mask = profiler->live_capacity - 1;
+    size_t slot = heap_profile_hash((uintptr_t)ptr) & mask;
+    while (profiler->live[slot].ptr != ptr) {
+        if (!profiler->live[slot].ptr) return;
+        slot = (slot + 1) & mask;
+    }
+    
+    AllocSite* site = &profiler->sites[profiler->live[slot].site];
+    site->live_samples--;
+    site->live_bytes -= profiler->live[slot].size;
+    profiler->live_count--;
+    
+    // Backward-shift deletion keeps every probe chain unbroken
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & mask; profiler->live[next].ptr; next = (next + 1) & mask) {
+        size_t home = heap_profile_hash((uintptr_t)profiler->live[next].ptr) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            profiler->live[hole] = profiler->live[next];
+            hole = next;
+        }
+    }
+    profiler->live[hole].ptr = NULL;
+}
+
+// Report rows: sites, or sites merged per class
+typedef struct AllocProfileRow {
+    const AllocSite* site;          // First site of the row
+    size_t samples;
+    size_t bytes;
+    size_t live_bytes;
+} AllocProfileRow;
+
+static int heap_profile_row_compare(const void* a, const void* b) {
+    const AllocProfileRow* left = a;
+    const AllocProfileRow* right = b;
+    if (left->live_bytes != right->live_bytes) return left->live_bytes < right->live_bytes ? 1 : -1;
+    if (left->bytes != right->bytes) return left->bytes < right->bytes ? 1 : -1;
+    return 0;
+}
+
+// Print the sampled sites (by_class merges them per class), largest live
+// footprint first. Counts are scaled up by the sampling rate.
+static void heap_profile_print_rows(AllocProfiler* profiler, FILE* out, bool by_class) {
+    AllocProfileRow* rows = calloc(profiler->site_count ? profiler->site_count : 1, sizeof(AllocProfileRow));
+    if (!rows) return;
+    
+    size_t row_count = 0;
+    for (size_t i = 0; i < profiler->site_count; i++) {
+        const AllocSite* site = &profiler->sites[i];
+        AllocProfileRow* row = NULL;
+        if (by_class) {
+            for (size_t r = 0; r < row_count; r++) {
+                if (rows[r].site->type_id == site->type_id && rows[r].site->type_name == site->type_name) {
+                    row = &rows[r];
+                    break;
+                }
+            }
+        }
+        if (!row) {
+            row = &rows[row_count++];
+            row->site = site;
+        }
+        row->samples += site->samples;
+        row->bytes += site->bytes;
+        row->live_bytes += site->live_bytes;
+    }
+    qsort(rows, row_count, sizeof(AllocProfileRow), heap_profile_row_compare);
+    
+    size_t rate = profiler->rate;
+    fprintf(out, "%14s %14s %12s  %s\n", "Live bytes", "Total bytes", "Allocations", by_class ? "Class" : "Site");
+    for (size_t r = 0; r < row_count; r++) {
+        const AllocSite* site = rows[r].site;
+        fprintf(out, "%14zu %14zu %12zu  ", rows[r].live_bytes * rate, rows[r].bytes * rate, rows[r].samples * rate);
+        if (by_class) {
+            fprintf(out, "%s (type %u)\n", site->type_name ? site->type_name : "?", site->type_id);
+        } else if (site->method) {
+            fprintf(out, "%s+%u %s\n", site->method, site->offset, site->type_name ? site->type_name : "?");
+        } else {
+            fprintf(out, "(native) %s\n", site->type_name ? site->type_name : "?");
+        }
+    }
+    free(rows);
+}
+
+void heap_profile_report(Heap* heap, FILE* out) {
+    if (!heap || !out) return;
+    
+    AllocProfiler* profiler = heap->profiler;
+    if (!profiler) {
+        fprintf(out, "Allocation profiler is off\n");
+        return;
+    }
+    
+    size_t samples = 0, live_bytes = 0, bytes = 0;
+    for (size_t i = 0; i < profiler->site_count; i++) {
+        samples += profiler->sites[i].samples;
+        bytes += profiler->sites[i].bytes;
+        live_bytes += profiler->sites[i].live_bytes;
+    }
+    
+    fprintf(out, "=== Allocation Profile ===\n");
+    fprintf(out, "Sampling: 1 in %u allocations (%zu of %zu sampled)\n",
+            profiler->rate, samples, profiler->allocations);
+    fprintf(out, "Estimated: %zu bytes live, %zu bytes allocated\n",
+            live_bytes * profiler->rate, bytes * profiler->rate);
+    fprintf(out, "\nBy class:\n");
+    heap_profile_print_rows(profiler, out, true);
+    fprintf(out, "\nBy site:\n");
+    heap_profile_print_rows(profiler, out, false);
+}
+
+// Heap snapshots. The snapshot is taken between cycles: a running
+// concurrent or incremental cycle is finished first, and objects awaiting a
+// lazy sweep are released, so every object written is in a generation.
+void heap_set_oom_handler(Heap* heap, HeapOOMHandler handler, void* context) {
+    if (!heap) return;
+    heap->oom_handler = handler;
+    heap->oom_context = context;
+}
+
+static void snapshot_write_u32(FILE* out, uint32_t value) {
+    uint8_t bytes[4];
+    for (int i = 0; i < 4; i++) bytes[i] = (uint8_t)(value >> (8 * i));
+    fwrite(bytes, 1, sizeof(bytes), out);
+}
+
+static void snapshot_write_u64(FILE* out, uint64_t value) {
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; i++) bytes[i] = (uint8_t)(value >> (8 * i));
+    fwrite(bytes, 1, sizeof(bytes), out);
+}
+
+// Reference fields of an object, as gc_visit_references sees them
+static uint32_t snapshot_references(Object* object, FILE* out) {
+    Class* class_info = object_class(object);
+    if (!class_info) return 0;
+
+    uint32_t count = 0;
+    size_t data_size = object_size(object) - sizeof(ObjectHeader);
+    for (Field* field = class_info->fields; field; field = field->next) {
+        if (!field_is_reference(field)) continue;
+        if (field->offset + sizeof(Object*) > data_size) continue;
+
+        Object* child = *(Object**)(object->data + field->offset);
+        if (!child) continue;
+        if (out) snapshot_write_u64(out, (uint64_t)(uintptr_t)child);
+        count++;
+    }
+    return count;
+}
+
+bool heap_write_snapshot(Heap* heap, FILE* out) {
+    if (!heap || !heap->gc || !out) return false;
+
+    GC* gc = heap->gc;
+    if (gc->marking_active || gc->incremental_phase != GC_PHASE_IDLE) {
+        gc_collect_full(heap);
+    }
+    if (gc->sweep_pending_count > 0) {
+        gc_lazy_sweep(heap, gc->sweep_pending_count);
+    }
+
+    Generation* gens[] = { gc->young_gen, gc->old_gen, gc->perm_gen };
+    size_t gen_count = sizeof(gens) / sizeof(gens[0]);
+
+    // Classes in use
+    uint32_t max_index = 0;
+    uint64_t object_count = 0;
+    for (size_t g = 0; g < gen_count; g++) {
+        if (!gens[g]) continue;
+        object_count += gens[g]->object_count;
+        for (size_t i = 0; i < gens[g]->object_count; i++) {
+            uint32_t index = gens[g]->objects[i]->header.class_index;
+            if (index > max_index) max_index = index;
+        }
+    }
+    bool* used = calloc((size_t)max_index + 1, sizeof(bool));
+    if (!used) return false;
+    uint32_t class_count = 0;
+    for (size_t g = 0; g < gen_count; g++) {
+        if (!gens[g]) continue;
+        for (size_t i = 0; i < gens[g]->object_count; i++) {
+            uint32_t index = gens[g]->objects[i]->header.class_index;
+            if (!used[index] && object_class_table[index]) {
+                used[index] = true;
+                class_count++;
+            }
+        }
+    }
+
+    fwrite(HEAP_SNAPSHOT_MAGIC, 1, sizeof(HEAP_SNAPSHOT_MAGIC), out);
+    snapshot_write_u32(out, HEAP_SNAPSHOT_VERSION);
+    snapshot_write_u32(out, 0);
+
+    snapshot_write_u32(out, class_count);
+    for (uint32_t index = 0; index <= max_index; index++) {
+        if (!used[index]) continue;
+        Class* class_info = object_class_table[index];
+        const char* name = class_info->name ? class_info->name : "";
+        snapshot_write_u32(out, index);
+        snapshot_write_u32(out, class_info->type_id);
+        snapshot_write_u32(out, (uint32_t)strlen(name));
+        fwrite(name, 1, strlen(name), out);
+    }
+    free(used);
+
+    snapshot_write_u64(out, object_count);
+    for (size_t g = 0; g < gen_count; g++) {
+        if (!gens[g]) continue;
+        for (size_t i = 0; i < gens[g]->object_count; i++) {
+            Object* object = gens[g]->objects[i];
+            bool has_class = object_class(object) != NULL;
+            snapshot_write_u64(out, (uint64_t)(uintptr_t)object);
+            snapshot_write_u32(out, object->header.class_index);
+            snapshot_write_u32(out, has_class ? (uint32_t)object_size(object) : 0);
+            snapshot_write_u32(out, snapshot_references(object, NULL));
+            snapshot_references(object, out);
+        }
+    }
+
+    // Roots, as the VM's root scanner reports them
+    gc->captured_root_count = 0;
+    gc->capturing_roots = true;
+    gc_mark_all_roots(heap);
+    gc->capturing_roots = false;
+    snapshot_write_u64(out, gc->captured_root_count);
+    for (size_t i = 0; i < gc->captured_root_count; i++) {
+        snapshot_write_u64(out, (uint64_t)(uintptr_t)gc->captured_roots[i]);
+    }
+
+    fflush(out);
+    return !ferror(out);
+}
+
 // Statistics and debugging
 void heap_print_stats(Heap* heap) {
     if (!heap) return;
@@ -695,13 +2765,15 @@ void heap_print_stats(Heap* heap) {
     printf("Memory Regions: %zu\n", heap->region_count);
     printf("Utilization: %.2f%%\n", 
            (double)heap->used_size / heap->total_size * 100.0);
+    printf("Committed: %zu of %zu bytes reserved (soft limit %zu, hard limit %zu)\n",
+           heap->committed_size, heap->reserved_size, heap->soft_limit, heap->hard_limit);
+    printf("Resizes: %zu grown, %zu shrunk, %zu bytes released%s\n",
+           heap->grow_count, heap->shrink_count, heap->released_bytes,
+           heap->huge_pages ? " (huge pages)" : "");
     
     if (heap->gc) {
-        printf("\n=== GC Statistics ===\n");
-        printf("Collections: %zu\n", heap->gc->stats.collections_performed);
-        printf("Objects Collected: %zu\n", heap->gc->stats.objects_collected);
-        printf("Bytes Freed: %zu\n", heap->gc->stats.bytes_freed);
-        printf("Avg Collection Time: %.6f seconds\n", heap->gc->stats.avg_collection_time);
+        printf("\n");
+        gc_print_stats(heap);
     }
 }
 
@@ -723,9 +2795,57 @@ void heap_print_regions(Heap* heap) {
     }
 }
 
-void heap_print_allocations(Heap* heap) {
+void heap_print_allocations(Heap* heap, int grouping) {
     if (!heap) return;
     
+    if (grouping == HEAP_GROUP_SITE) {
+        printf("=== Allocations by Site (sampled) ===\n");
+        if (heap->profiler) {
+            heap_profile_print_rows(heap->profiler, stdout, false);
+        } else {
+            printf("Allocation profiler is off\n");
+        }
+        return;
+    }
+    
+    if (grouping == HEAP_GROUP_CLASS) {
+        // Allocations that are not objects are grouped under type 0
+        typedef struct { uint32_t type_id; const char* name; size_t count; size_t bytes; } ClassTotal;
+        ClassTotal* totals = NULL;
+        size_t total_count = 0, total_capacity = 0;
+        
+        for (Allocation* alloc = heap->allocations; alloc; alloc = alloc->next) {
+            Class* class_info = alloc->object ? object_class(alloc->object) : NULL;
+            const char* name = class_info ? class_info->name : "(raw)";
+            size_t t = 0;
+            while (t < total_count && (totals[t].type_id != alloc->type_id || totals[t].name != name)) t++;
+            if (t == total_count) {
+                if (total_count == total_capacity) {
+                    size_t capacity = total_capacity ? total_capacity * 2 : 16;
+                    ClassTotal* grown = realloc(totals, capacity * sizeof(ClassTotal));
+                    if (!grown) break;
+                    totals = grown;
+                    total_capacity = capacity;
+                }
+                totals[t].type_id = alloc->type_id;
+                totals[t].name = name;
+                totals[t].count = 0;
+                totals[t].bytes = 0;
+                total_count++;
+            }
+            totals[t].count++;
+            totals[t].bytes += alloc->size;
+        }
+        
+        printf("=== Active Allocations by Class ===\n");
+        printf("%12s %12s  %s\n", "Bytes", "Count", "Class");
+        for (size_t t = 0; t < total_count; t++) {
+            printf("%12zu %12zu  %s (type %u)\n", totals[t].bytes, totals[t].count, totals[t].name, totals[t].type_id);
+        }
+        free(totals);
+        return;
+    }
+    
     printf("=== Active Allocations ===\n");
     Allocation* alloc = heap->allocations;
     size_t index = 0;
@@ -751,6 +2871,33 @@ void gc_print_stats(Heap* heap) {
     printf("Peak Memory: %zu\n", heap->gc->stats.peak_memory);
     printf("Average Collection Time: %.6f seconds\n", heap->gc->stats.avg_collection_time);
     
+    // Wall-clock pauses and throughput
+    GCStats* stats = &heap->gc->stats;
+    if (stats->pause_histogram.total_count > 0) {
+        printf("Pauses: %zu (p50 %llu us, p99 %llu us, max %llu us, total %.3f ms)\n",
+               stats->pause_histogram.total_count,
+               (unsigned long long)gc_histogram_percentile(&stats->pause_histogram, 50.0),
+               (unsigned long long)gc_histogram_percentile(&stats->pause_histogram, 99.0),
+               (unsigned long long)stats->pause_histogram.max_value,
+               stats->total_pause_time * 1e3);
+        printf("Heap Occupancy: %zu -> %zu bytes (last cycle)\n",
+               stats->occupancy_before, stats->occupancy_after);
+    }
+    double uptime = (gc_now_us() - heap->gc->start_time_us) / 1e6;
+    if (uptime > 0) {
+        printf("Allocation Rate: %.2f MB/s (%.2f MB/s before the last cycle)\n",
+               stats->total_allocated / (1024.0 * 1024.0) / uptime,
+               stats->last_alloc_rate / (1024.0 * 1024.0));
+    }
+    if (stats->young_bytes_swept > 0) {
+        printf("Young Survival: %.1f%% of %zu bytes swept\n",
+               100.0 * stats->young_bytes_survived / stats->young_bytes_swept, stats->young_bytes_swept);
+    }
+    if (stats->old_bytes_swept > 0) {
+        printf("Old Survival: %.1f%% of %zu bytes swept\n",
+               100.0 * stats->old_bytes_survived / stats->old_bytes_swept, stats->old_bytes_swept);
+    }
+    
     if (heap->gc->young_gen) {
         printf("Young Generation: %zu objects\n", heap->gc->young_gen->object_count);
     }
@@ -760,6 +2907,34 @@ void gc_print_stats(Heap* heap) {
     if (heap->gc->perm_gen) {
         printf("Permanent Generation: %zu objects\n", heap->gc->perm_gen->object_count);
     }
+    
+    printf("Minor Collections: %zu\n", heap->gc->stats.minor_collections);
+    printf("Full Collections: %zu\n", heap->gc->stats.full_collections);
+    printf("Objects Promoted: %zu (%zu bytes)\n", heap->gc->stats.objects_promoted,
+           heap->gc->stats.bytes_promoted);
+    if (heap->gc->worker_count > 1) {
+        printf("GC Workers: %u (%zu objects stolen, %zu lazily swept, %zu pending)\n",
+               heap->gc->worker_count, heap->gc->stats.objects_stolen,
+               heap->gc->stats.lazily_swept, heap->gc->sweep_pending_count);
+    }
+    if (heap->gc->incremental_mode) {
+        printf("Incremental Cycles: %zu (%zu slices, %zu finished in one pause)\n",
+               heap->gc->stats.incremental_cycles, heap->gc->stats.incremental_slices,
+               heap->gc->stats.incremental_fallbacks);
+        printf("Pause Target: %u us (max slice %.1f us, %zu slices over target)\n",
+               heap->gc->pause_target_us, heap->gc->stats.max_slice_time * 1e6,
+               heap->gc->stats.slices_over_target);
+    }
+    if (heap->gc->concurrent_mode) {
+        printf("Concurrent Cycles: %zu (%zu SATB references logged)\n",
+               heap->gc->stats.concurrent_cycles, heap->gc->stats.satb_enqueued);
+    }
+    if (heap->gc->card_table) {
+        printf("Dirty Cards: %zu of %zu (%zu scanned by minor collections)\n",
+               card_table_dirty_count(heap->gc->card_table),
+               heap->gc->card_table->card_count,
+               heap->gc->stats.dirty_cards_scanned);
+    }
 }
 
 void heap_validate(Heap* heap) {
@@ -819,7 +2994,33 @@ bool heap_check_integrity(Heap* heap) {
         return false;
     }
     
-    return true;
+    // Every free region is on the list of its size class, and only those
+    size_t free_regions = 0;
+    for (MemoryRegion* region = heap->regions; region; region = region->next) {
+        if (region->is_free) free_regions++;
+    }
+    for (size_t size_class = 0; size_class < HEAP_SIZE_CLASSES; size_class++) {
+        for (MemoryRegion* region = heap->free_lists[size_class]; region; region = region->free_next) {
+            if (!region->is_free || heap_size_class(region->size) != size_class || free_regions == 0) {
+                return false;
+            }
+            free_regions--;
+        }
+    }
+    if (free_regions != 0) {
+        return false;
+    }
+    
+    // Every record is reachable through the allocation index
+    size_t records = 0;
+    for (Allocation* alloc = heap->allocations; alloc; alloc = alloc->next) {
+        if (allocation_find(heap, alloc->ptr) != alloc) {
+            return false;
+        }
+        records++;
+    }
+    
+    return records == heap->allocation_count;
 }
 
 void heap_detect_leaks(Heap* heap) {
@@ -829,7 +3030,7 @@ void heap_detect_leaks(Heap* heap) {
     
     if (heap->allocation_count > 0) {
         printf("WARNING: %zu potential memory leaks detected!\n", heap->allocation_count);
-        heap_print_allocations(heap);
+        heap_print_allocations(heap, HEAP_GROUP_NONE);
     } else {
         printf("No memory leaks detected.\n");
     }
@@ -3,6 +3,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
+#include <pthread.h>
+#include "pool.h"
 
 // Forward declarations
 struct Heap;
@@ -21,6 +24,8 @@ typedef struct MemoryRegion {
     bool is_free;                   // Free/allocated status
     struct MemoryRegion* next;      // Linked list
     struct MemoryRegion* prev;      // Doubly linked list
+    struct MemoryRegion* free_next; // Free list of the region's size class
+    struct MemoryRegion* free_prev;
 } MemoryRegion;
 
 // Allocation tracking structure
@@ -29,7 +34,10 @@ typedef struct Allocation {
     size_t size;                    // Allocation size
     uint32_t type_id;               // Type identifier
     Object* object;                 // Associated object
-    struct Allocation* next;        // Linked list
+    struct MemoryRegion* region;    // Backing memory region
+    struct Allocation* next;        // Linked list (newest first)
+    struct Allocation* prev;        // Doubly linked list
+    struct Allocation* hash_next;   // Chain of the allocation index bucket
 } Allocation;
 
 // Generation structure for generational GC
@@ -43,6 +51,98 @@ typedef struct Generation {
     struct Generation* next;        // Next generation
 } Generation;
 
+// Card table configuration
+#define GC_CARD_SHIFT 9                             // 512-byte cards
+#define GC_CARD_SIZE ((size_t)1 << GC_CARD_SHIFT)
+#define GC_CARD_CLEAN 0
+#define GC_CARD_DIRTY 1
+
+// Objects surviving this many minor collections are promoted
+#define GC_DEFAULT_TENURE_THRESHOLD 2
+
+// Parallel full collection workers
+#define GC_MAX_WORKERS 64
+
+// Objects freed per allocation while a lazy sweep is pending
+#define GC_LAZY_SWEEP_BATCH 64
+
+// Incremental collection: each slice stops once the pause target is spent,
+// and a slice is requested after every `incremental_pace` bytes allocated
+#define GC_DEFAULT_PAUSE_TARGET_US 1000
+#define GC_MIN_PAUSE_TARGET_US 50
+#define GC_DEFAULT_INCREMENTAL_PACE (64 * 1024)
+#define GC_MIN_INCREMENTAL_PACE (4 * 1024)
+
+// Incremental cycle phases
+#define GC_PHASE_IDLE 0
+#define GC_PHASE_MARK 1
+#define GC_PHASE_SWEEP 2
+
+// Card table - one byte per card of heap memory. The write barrier dirties
+// the card holding an object whose reference field was updated, so a minor
+// collection only has to scan dirty cards of the old generation instead of
+// the whole old generation to find old-to-young references.
+typedef struct CardTable {
+    uint8_t* cards;                 // Card state (GC_CARD_CLEAN / GC_CARD_DIRTY)
+    size_t card_count;              // Number of cards
+    size_t card_capacity;           // Cards reserved for heap growth
+    uintptr_t covered_start;        // First address covered by the table
+    size_t covered_size;            // Bytes covered by the table
+    
+    // Old object start bitmap: one bit per alignment slot, one word per card
+    // (512-byte cards / 8-byte alignment = 64 slots). Lets a minor collection
+    // find the old objects that start on a dirty card.
+    uint64_t* start_bits;
+} CardTable;
+
+// Root scanner callback - invoked at the start of every collection and
+// expected to call gc_mark_object() for each object referenced from outside
+// the heap (operand stack, call frame locals, this pointers, ...)
+typedef void (*GCRootScanner)(struct Heap* heap, void* context);
+
+// Called when an allocation fails even after collecting and growing
+typedef void (*HeapOOMHandler)(struct Heap* heap, size_t size, void* context);
+
+// Pause histogram: log-linear buckets of microseconds in the style of
+// HdrHistogram - 16 sub-buckets per power of two (~6% precision) up to
+// 2^44 us. Values below 32 us are recorded exactly.
+#define GC_HISTOGRAM_SUB_BUCKETS 16
+#define GC_HISTOGRAM_MAGNITUDES 40
+#define GC_HISTOGRAM_BUCKETS ((GC_HISTOGRAM_MAGNITUDES + 1) * GC_HISTOGRAM_SUB_BUCKETS)
+
+typedef struct GCHistogram {
+    uint32_t counts[GC_HISTOGRAM_BUCKETS];
+    size_t total_count;             // Recorded values
+    uint64_t total_value;           // Sum of recorded values
+    uint64_t max_value;             // Largest recorded value (exact)
+} GCHistogram;
+
+// Collection cycle kinds (telemetry and GC log)
+#define GC_CYCLE_MINOR 0
+#define GC_CYCLE_FULL 1
+#define GC_CYCLE_CONCURRENT 2
+#define GC_CYCLE_INCREMENTAL 3
+
+// Telemetry of the cycle in progress - snapshots taken at its first pause
+typedef struct GCCycle {
+    uint32_t type;                  // GC_CYCLE_*
+    bool active;                    // A cycle has begun and not yet ended
+    double start_us;                // Monotonic time of the first pause
+    double pause_us;                // Stop-the-world time so far
+    double max_pause_us;            // Longest pause so far
+    uint32_t pauses;                // Pauses so far
+    size_t used_before;             // Heap bytes in use
+    size_t young_before;            // Young generation bytes
+    size_t old_before;              // Old generation bytes
+    size_t allocated_before;        // stats.total_allocated
+    size_t freed_before;            // stats.bytes_freed
+    size_t promoted_before;         // stats.bytes_promoted
+    size_t young_swept_before;      // stats.young_bytes_swept
+    size_t young_survived_before;   // stats.young_bytes_survived
+    size_t old_swept_before;        // stats.old_bytes_swept
+    size_t old_survived_before;     // stats.old_bytes_survived
+} GCCycle;
+
 // Garbage collection statistics
 typedef struct GCStats {
     size_t collections_performed;   // Number of GC cycles
@@ -51,6 +151,31 @@ typedef struct GCStats {
     size_t total_allocated;         // Total bytes allocated
     size_t peak_memory;             // Peak memory usage
     double avg_collection_time;     // Average collection time
+    size_t minor_collections;       // Young generation collections
+    size_t full_collections;        // Whole heap collections
+    size_t objects_promoted;        // Objects tenured into the old generation
+    size_t dirty_cards_scanned;     // Dirty cards scanned by minor collections
+    size_t concurrent_cycles;       // Completed concurrent mark cycles
+    size_t satb_enqueued;           // References logged by the SATB barrier
+    size_t objects_stolen;          // Grey objects stolen between mark workers
+    size_t lazily_swept;            // Dead objects freed at allocation time
+    size_t incremental_cycles;      // Completed incremental cycles
+    size_t incremental_slices;      // Incremental work slices run
+    size_t incremental_fallbacks;   // Cycles finished in one pause (heap exhausted)
+    size_t slices_over_target;      // Slices that overran the pause target
+    double max_slice_time;          // Longest incremental slice (seconds)
+    
+    // Telemetry (wall-clock, monotonic)
+    double total_pause_time;        // Stop-the-world time (seconds)
+    GCHistogram pause_histogram;    // Every stop-the-world pause (us)
+    size_t bytes_promoted;          // Bytes tenured into the old generation
+    size_t young_bytes_swept;       // Young bytes examined by sweeps
+    size_t young_bytes_survived;    // ... of which survived (kept or promoted)
+    size_t old_bytes_swept;         // Old bytes examined by sweeps
+    size_t old_bytes_survived;      // ... of which survived
+    size_t occupancy_before;        // Heap bytes in use when the last cycle began
+    size_t occupancy_after;         // Heap bytes in use when it ended
+    double last_alloc_rate;         // Bytes/second between the last two cycles
 } GCStats;
 
 // Garbage collector structure
@@ -69,28 +194,178 @@ typedef struct GC {
     
     // Collection flags
     bool is_collecting;             // Currently collecting
-    bool incremental_mode;          // Incremental collection
-    size_t collection_step;         // Current collection step
+    bool incremental_mode;          // Collect the whole heap in time-bounded slices
+    bool concurrent_mode;           // Mark the whole heap on a background thread
+    size_t collection_step;         // Slices run in the current incremental cycle
+    uint32_t worker_count;          // Threads marking and sweeping full collections
+    
+    // Generational collection
+    struct CardTable* card_table;   // Old-to-young reference tracking
+    uint32_t tenure_threshold;      // Minor collections survived before promotion
+    bool young_only;                // Current mark phase traces young objects only
+    
+    // Root scanning (installed by the VM)
+    GCRootScanner root_scanner;     // Root enumeration callback
+    void* root_context;             // Callback context
+    
+    // Root capture for heap snapshots (gc_mark_object records instead of marking)
+    bool capturing_roots;
+    struct Object** captured_roots;
+    size_t captured_root_count;
+    size_t captured_root_capacity;
+    
+    // Mark stack
+    struct Object** mark_stack;     // Grey objects awaiting tracing
+    size_t mark_stack_count;        // Number of grey objects
+    size_t mark_stack_capacity;     // Mark stack capacity
+    
+    // Concurrent marking (snapshot-at-the-beginning)
+    bool marking_active;            // Concurrent cycle between initial mark and remark
+    int safepoint_requested;        // Set by the marker thread when remark can run
+    pthread_t marker_thread;        // Background marker
+    bool marker_running;            // marker_thread needs joining
+    struct Object** satb_buffer;    // Overwritten references logged by the mutator
+    size_t satb_count;              // Logged references
+    size_t satb_capacity;           // SATB buffer capacity
+    
+    // Incremental collection (marking shares the SATB state above)
+    uint32_t incremental_phase;     // GC_PHASE_IDLE / GC_PHASE_MARK / GC_PHASE_SWEEP
+    uint32_t pause_target_us;       // Work budget of one slice
+    size_t incremental_pace;        // Bytes allocated between slices
+    size_t incremental_debt;        // Bytes allocated since the last slice
+    struct Generation* sweep_gen;   // Generation being swept
+    size_t sweep_index;             // Next object of sweep_gen to sweep
+    
+    // Telemetry
+    double start_time_us;           // Monotonic time the heap was created
+    struct GCCycle cycle;           // Cycle in progress
+    double last_cycle_start_us;     // Start of the previous cycle
+    size_t last_cycle_allocated;    // stats.total_allocated at that point
+    FILE* log_file;                 // GC log, one JSON object per cycle (NULL = off)
+    
+    // Lazy sweeping (dead objects found by a parallel sweep, freed on demand)
+    struct Object** sweep_pending;  // Dead objects awaiting release
+    size_t sweep_pending_count;     // Pending objects
+    size_t sweep_pending_capacity;  // Pending buffer capacity
 } GC;
 
+// Allocation profiler - samples about one allocation in `rate` and charges
+// it to the bytecode site and class that made it. Sampled allocations are
+// remembered until freed, so live bytes can be reported as well as totals.
+#define ALLOC_PROFILE_DEFAULT_RATE 64
+
+typedef struct AllocSite {
+    const char* method;             // Allocating method (NULL outside bytecode)
+    uint32_t offset;                // Bytecode offset of the allocating instruction
+    uint32_t type_id;               // Class type id (0 if there is no class)
+    const char* type_name;          // Class or value kind name
+    size_t samples;                 // Sampled allocations
+    size_t bytes;                   // Sampled bytes
+    size_t live_samples;            // Sampled allocations not yet freed
+    size_t live_bytes;              // Sampled bytes not yet freed
+} AllocSite;
+
+typedef struct AllocSample {
+    const void* ptr;                // Sampled allocation (NULL = empty slot)
+    uint32_t site;                  // Index into AllocProfiler.sites
+    uint32_t size;                  // Bytes charged to the site
+} AllocSample;
+
+typedef struct AllocProfiler {
+    uint32_t rate;                  // Mean allocations per sample
+    uint32_t countdown;             // Allocations until the next sample
+    uint64_t random;                // Sampling interval generator state
+    size_t allocations;             // Allocations seen
+    
+    // Current site, kept up to date by the interpreter
+    const char* site_method;
+    uint32_t site_offset;
+    
+    // Sites, hashed on (method, offset, type)
+    AllocSite* sites;
+    size_t site_count;
+    size_t site_capacity;
+    uint32_t* site_slots;           // Open-addressed index into sites (+1)
+    size_t site_slot_count;         // Power of two
+    
+    // Sampled allocations still live, open-addressed on the pointer
+    AllocSample* live;
+    size_t live_count;
+    size_t live_capacity;           // Power of two
+} AllocProfiler;
+
+// Heap snapshot file (all integers little-endian):
+//   "HE3HEAP\0", u32 version, u32 reserved
+//   u32 class count, then per class: u32 class index, u32 type id,
+//       u32 name length, name bytes
+//   u64 object count, then per object: u64 id (address), u32 class index,
+//       u32 size, u32 reference count, u64 referenced ids
+//   u64 root count, then u64 root ids
+#define HEAP_SNAPSHOT_MAGIC "HE3HEAP"
+#define HEAP_SNAPSHOT_VERSION 1
+
+// heap_print_allocations groupings
+#define HEAP_GROUP_NONE 0               // Every allocation
+#define HEAP_GROUP_CLASS 1              // Live allocations per class (exact)
+#define HEAP_GROUP_SITE 2               // Per allocation site (sampled)
+
+// Heap growth: the address range up to the hard limit is reserved when
+// the heap is created and committed in granules as the heap grows
+#define HEAP_COMMIT_GRANULE (256 * 1024)
+#define HEAP_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Free regions at least this large are returned to the OS after a full
+// collection, once free memory has grown by as much since the last release
+#define HEAP_RELEASE_MIN (64 * 1024)
+
+// Free regions are kept on one list per power-of-two size class and
+// allocation records are hashed on their pointer, so allocating and freeing
+// do not walk every region and record of the heap
+#define HEAP_SIZE_CLASSES 64
+#define HEAP_ALLOCATION_INDEX_MIN 1024
+
 // Heap structure
 typedef struct Heap {
-    void* memory;                   // Raw heap memory
-    size_t total_size;              // Total heap size
+    void* memory;                   // Raw heap memory (start of the reservation)
+    size_t total_size;              // Usable heap size (grows up to hard_limit)
     size_t used_size;               // Currently used memory
     size_t free_size;               // Available memory
     
+    // Virtual memory
+    size_t reserved_size;           // Reserved address space
+    size_t committed_size;          // Committed (accessible) bytes, page-rounded
+    size_t min_size;                // The heap never shrinks below this
+    size_t soft_limit;              // Grow without collecting up to here
+    size_t hard_limit;              // Allocation fails beyond this
+    bool huge_pages;                // Transparent huge pages requested
+    size_t grow_count;              // Times the heap grew
+    size_t shrink_count;            // Times the heap shrank
+    size_t released_bytes;          // Bytes returned to the OS
+    size_t release_free_mark;       // free_size after the last release
+    
     // Memory regions
     struct MemoryRegion* regions;   // Contiguous memory regions
     size_t region_count;            // Number of regions
+    struct MemoryRegion* free_lists[HEAP_SIZE_CLASSES]; // Free regions by size class
+    uint64_t free_classes;          // Bit per size class with a free region
     
     // Allocation tracking
     struct Allocation* allocations; // Allocation table
     size_t allocation_count;        // Number of active allocations
+    struct Allocation** allocation_index; // Records hashed on the pointer (NULL = list only)
+    size_t allocation_index_size;   // Buckets, a power of two
+    SlabPool allocation_pool;       // Storage for Allocation records
     
     // Garbage collection
     struct GC* gc;                  // GC state and statistics
     
+    // Allocation profiling (NULL = off)
+    AllocProfiler* profiler;
+    
+    // Out-of-memory notification (NULL = none)
+    HeapOOMHandler oom_handler;
+    void* oom_context;
+    
     // Memory alignment
     size_t alignment;               // Memory alignment requirement
     
@@ -102,8 +377,14 @@ typedef struct Heap {
 
 // Heap creation and destruction
 Heap* heap_create(size_t initial_size);
+Heap* heap_create_growable(size_t initial_size, size_t soft_limit, size_t hard_limit);
 void heap_destroy(Heap* heap);
 
+// Heap sizing
+bool heap_set_limits(Heap* heap, size_t soft_limit, size_t hard_limit);
+bool heap_set_huge_pages(Heap* heap, bool enabled);
+size_t heap_release_memory(Heap* heap);
+
 // Memory allocation
 void* heap_allocate(Heap* heap, size_t size);
 void* heap_allocate_aligned(Heap* heap, size_t size, size_t alignment);
@@ -121,12 +402,87 @@ void gc_collect(Heap* heap);
 void gc_collect_young(Heap* heap);
 void gc_collect_full(Heap* heap);
 void gc_collect_incremental(Heap* heap);
+void gc_collect_concurrent(Heap* heap);
+void gc_concurrent_finish(Heap* heap);
 
 // GC utilities
-void gc_mark_object(struct Object* object);
+void gc_set_root_scanner(Heap* heap, GCRootScanner scanner, void* context);
+void gc_mark_object(Heap* heap, struct Object* object);
 void gc_mark_all_roots(Heap* heap);
-void gc_sweep_generation(struct Generation* gen);
-void gc_move_object(struct Object* object, struct Generation* target_gen);
+void gc_sweep_generation(Heap* heap, struct Generation* gen);
+bool gc_move_object(Heap* heap, struct Object* object, struct Generation* target_gen);
+void gc_register_object(Heap* heap, struct Object* object);
+bool gc_register_permanent(Heap* heap, struct Object* object);
+void gc_set_worker_count(Heap* heap, uint32_t workers);
+void gc_set_pause_target(Heap* heap, uint32_t target_us);
+void gc_set_log_file(Heap* heap, FILE* file);
+size_t gc_lazy_sweep(Heap* heap, size_t budget);
+void gc_allocation_check(Heap* heap, size_t size);
+void gc_satb_enqueue(Heap* heap, struct Object* object);
+void gc_safepoint_slow(Heap* heap);
+
+// Pause histogram
+void gc_histogram_record(GCHistogram* histogram, uint64_t value);
+uint64_t gc_histogram_percentile(const GCHistogram* histogram, double percentile);
+
+// Card table management
+CardTable* card_table_create(void* start, size_t size, size_t capacity);
+void card_table_destroy(CardTable* table);
+void card_table_resize(CardTable* table, size_t size);
+void card_table_clear(CardTable* table);
+size_t card_table_dirty_count(CardTable* table);
+
+// Write barrier - call after storing a reference into a field of `holder`.
+// The card is dirtied unconditionally (no old/young check on the fast path);
+// minor collections skip cards that hold no old objects.
+static inline void gc_write_barrier(Heap* heap, struct Object* holder) {
+    CardTable* table = heap->gc->card_table;
+    if (table) {
+        uintptr_t offset = (uintptr_t)holder - table->covered_start;
+        if (offset < table->covered_size) {
+            table->cards[offset >> GC_CARD_SHIFT] = GC_CARD_DIRTY;
+        }
+    }
+}
+
+// Snapshot-at-the-beginning barrier - call with the old value of a
+// reference field before overwriting it. While a concurrent mark is running
+// the old referent is logged so everything reachable when marking started
+// stays marked.
+static inline void gc_satb_barrier(Heap* heap, struct Object* old_value) {
+    if (heap->gc->marking_active && old_value) {
+        gc_satb_enqueue(heap, old_value);
+    }
+}
+
+// Safepoint poll - the interpreter calls this between instructions so a
+// finished concurrent mark can run its stop-the-world remark promptly and
+// a pending incremental slice runs with the VM roots in a consistent state
+static inline void gc_safepoint(Heap* heap) {
+    if (__atomic_load_n(&heap->gc->safepoint_requested, __ATOMIC_ACQUIRE)) {
+        gc_safepoint_slow(heap);
+    }
+}
+
+// Heap snapshots
+void heap_set_oom_handler(Heap* heap, HeapOOMHandler handler, void* context);
+bool heap_write_snapshot(Heap* heap, FILE* out);
+
+// Allocation profiler
+bool heap_profiler_enable(Heap* heap, uint32_t rate);
+void heap_profiler_disable(Heap* heap);
+void heap_profile_allocation(Heap* heap, const void* ptr, size_t size, uint32_t type_id, const char* type_name);
+void heap_profile_free(Heap* heap, const void* ptr);
+void heap_profile_report(Heap* heap, FILE* out);
+
+// Sampling decision - call once per profiled allocation and record it with
+// heap_profile_allocation when this returns true
+static inline bool heap_profile_sample(Heap* heap) {
+    AllocProfiler* profiler = heap->profiler;
+    if (!profiler) return false;
+    profiler->allocations++;
+    return --profiler->countdown == 0;
+}
 
 // Memory region management
 MemoryRegion* memory_region_create(void* start, size_t size);
@@ -136,8 +492,8 @@ MemoryRegion* memory_region_merge(MemoryRegion* region1, MemoryRegion* region2);
 MemoryRegion* memory_region_find_free(Heap* heap, size_t size);
 
 // Allocation tracking
-Allocation* allocation_create(void* ptr, size_t size, uint32_t type_id);
-void allocation_destroy(Allocation* allocation);
+Allocation* allocation_create(Heap* heap, void* ptr, size_t size, uint32_t type_id);
+void allocation_destroy(Heap* heap, Allocation* allocation);
 Allocation* allocation_find(Heap* heap, void* ptr);
 void allocation_remove(Heap* heap, void* ptr);
 
@@ -151,7 +507,7 @@ void generation_compact(Generation* gen);
 // Statistics and debugging
 void heap_print_stats(Heap* heap);
 void heap_print_regions(Heap* heap);
-void heap_print_allocations(Heap* heap);
+void heap_print_allocations(Heap* heap, int grouping);
 void gc_print_stats(Heap* heap);
 void heap_validate(Heap* heap);
 
@@ -0,0 +1,434 @@
+#include "heap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Heap snapshot analyzer - reads a snapshot written by heap_write_snapshot
+// (he3vm --heap-snapshot=FILE), builds the dominator tree of the object
+// graph and reports retained sizes per class and the objects that retain
+// the most memory. An object's retained size is what a collection would
+// free if that object became unreachable.
+//
+// Usage: heap_analyzer <snapshot> [top_objects]
+
+#define DEFAULT_TOP_OBJECTS 10
+#define UNDEFINED UINT32_MAX
+
+typedef struct Reader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    bool failed;
+} Reader;
+
+static uint64_t read_uint(Reader* reader, int bytes) {
+    if (reader->pos + bytes > reader->size) {
+        reader->failed = true;
+        return 0;
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (uint64_t)reader->data[reader->pos + i] << (8 * i);
+    }
+    reader->pos += bytes;
+    return value;
+}
+
+typedef struct SnapshotClass {
+    uint32_t index;
+    uint32_t type_id;
+    char* name;
+    size_t count;
+    size_t shallow;
+    size_t retained;
+    uint32_t on_path;               // Instances on the current dominator tree path
+} SnapshotClass;
+
+// Object graph. Node 0 is a synthetic root pointing at every GC root;
+// objects are nodes 1..node_count-1.
+typedef struct Graph {
+    uint32_t node_count;
+    uint64_t* ids;
+    uint32_t* classes;              // Index into the class array (UNDEFINED if unknown)
+    uint32_t* sizes;
+    uint32_t* edge_start;           // CSR successors, node_count + 1 entries
+    uint32_t* edges;
+    uint32_t* pred_start;           // CSR predecessors
+    uint32_t* preds;
+} Graph;
+
+typedef struct IdEntry {
+    uint64_t id;
+    uint32_t node;
+} IdEntry;
+
+static int id_compare(const void* a, const void* b) {
+    uint64_t left = ((const IdEntry*)a)->id;
+    uint64_t right = ((const IdEntry*)b)->id;
+    return left < right ? -1 : left > right ? 1 : 0;
+}
+
+static uint32_t id_lookup(const IdEntry* ids, uint32_t count, uint64_t id) {
+    uint32_t low = 0, high = count;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (ids[mid].id < id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < count && ids[low].id == id ? ids[low].node : UNDEFINED;
+}
+
+static void* checked_calloc(size_t count, size_t size) {
+    void* memory = calloc(count ? count : 1, size);
+    if (!memory) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return memory;
+}
+
+// Cooper, Harvey and Kennedy's iterative dominator algorithm over reverse
+// postorder. Returns idom per node (UNDEFINED for unreachable nodes) and
+// fills order with the reachable nodes in reverse postorder.
+static uint32_t* compute_dominators(const Graph* graph, uint32_t* order, uint32_t* order_count) {
+    uint32_t n = graph->node_count;
+    uint32_t* postorder = checked_calloc(n, sizeof(uint32_t));
+    uint32_t* stack = checked_calloc(n, sizeof(uint32_t));
+    uint32_t* next_edge = checked_calloc(n, sizeof(uint32_t));
+    bool* visited = checked_calloc(n, sizeof(bool));
+
+    // Iterative depth-first search from the synthetic root
+    uint32_t post_count = 0, depth = 0;
+    stack[depth++] = 0;
+    visited[0] = true;
+    next_edge[0] = graph->edge_start[0];
+    while (depth > 0) {
+        uint32_t node = stack[depth - 1];
+        if (next_edge[node] < graph->edge_start[node + 1]) {
+            uint32_t child = graph->edges[next_edge[node]++];
+            if (!visited[child]) {
+                visited[child] = true;
+                next_edge[child] = graph->edge_start[child];
+                stack[depth++] = child;
+            }
+        } else {
+            postorder[node] = post_count;
+            order[n - 1 - post_count] = node;
+            post_count++;
+            depth--;
+        }
+    }
+
+    // Compact the reverse postorder to the reachable nodes
+    *order_count = post_count;
+    memmove(order, order + (n - post_count), post_count * sizeof(uint32_t));
+
+    uint32_t* idom = checked_calloc(n, sizeof(uint32_t));
+    for (uint32_t i = 0; i < n; i++) idom[i] = UNDEFINED;
+    idom[0] = 0;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint32_t i = 1; i < post_count; i++) {
+            uint32_t node = order[i];
+            uint32_t new_idom = UNDEFINED;
+            for (uint32_t e = graph->pred_start[node]; e < graph->pred_start[node + 1]; e++) {
+                uint32_t pred = graph->preds[e];
+                if (idom[pred] == UNDEFINED) continue;
+                if (new_idom == UNDEFINED) {
+                    new_idom = pred;
+                    continue;
+                }
+                // Walk both fingers up the tree to their common ancestor
+                uint32_t a = pred, b = new_idom;
+                while (a != b) {
+                    while (postorder[a] < postorder[b]) a = idom[a];
+                    while (postorder[b] < postorder[a]) b = idom[b];
+                }
+                new_idom = a;
+            }
+            if (idom[node] != new_idom) {
+                idom[node] = new_idom;
+                changed = true;
+            }
+        }
+    }
+
+    free(postorder);
+    free(stack);
+    free(next_edge);
+    free(visited);
+    return idom;
+}
+
+static const SnapshotClass* sort_classes;
+
+static int class_retained_compare(const void* a, const void* b) {
+    const SnapshotClass* left = &sort_classes[*(const uint32_t*)a];
+    const SnapshotClass* right = &sort_classes[*(const uint32_t*)b];
+    if (left->retained != right->retained) return left->retained < right->retained ? 1 : -1;
+    return left->shallow < right->shallow ? 1 : left->shallow > right->shallow ? -1 : 0;
+}
+
+static const size_t* sort_retained;
+
+static int node_retained_compare(const void* a, const void* b) {
+    size_t left = sort_retained[*(const uint32_t*)a];
+    size_t right = sort_retained[*(const uint32_t*)b];
+    return left < right ? 1 : left > right ? -1 : 0;
+}
+
+static uint8_t* read_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* data = length > 0 ? malloc((size_t)length) : NULL;
+    if (!data || fread(data, 1, (size_t)length, file) != (size_t)length) {
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    *size = (size_t)length;
+    return data;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <snapshot> [top_objects]\n", argv[0]);
+        return 1;
+    }
+    size_t top = argc > 2 ? (size_t)atol(argv[2]) : DEFAULT_TOP_OBJECTS;
+
+    size_t file_size = 0;
+    uint8_t* data = read_file(argv[1], &file_size);
+    if (!data) {
+        fprintf(stderr, "Cannot read snapshot '%s'\n", argv[1]);
+        return 1;
+    }
+
+    Reader reader = { data, file_size, 0, false };
+    if (file_size < sizeof(HEAP_SNAPSHOT_MAGIC) ||
+        memcmp(data, HEAP_SNAPSHOT_MAGIC, sizeof(HEAP_SNAPSHOT_MAGIC)) != 0) {
+        fprintf(stderr, "'%s' is not a heap snapshot\n", argv[1]);
+        return 1;
+    }
+    reader.pos = sizeof(HEAP_SNAPSHOT_MAGIC);
+    uint32_t version = (uint32_t)read_uint(&reader, 4);
+    read_uint(&reader, 4);
+    if (version != HEAP_SNAPSHOT_VERSION) {
+        fprintf(stderr, "Unsupported snapshot version %u\n", version);
+        return 1;
+    }
+
+    // Classes
+    uint32_t class_count = (uint32_t)read_uint(&reader, 4);
+    if (reader.failed || class_count > file_size) {
+        fprintf(stderr, "Truncated snapshot\n");
+        return 1;
+    }
+    SnapshotClass* classes = checked_calloc(class_count, sizeof(SnapshotClass));
+    for (uint32_t c = 0; c < class_count && !reader.failed; c++) {
+        classes[c].index = (uint32_t)read_uint(&reader, 4);
+        classes[c].type_id = (uint32_t)read_uint(&reader, 4);
+        uint32_t length = (uint32_t)read_uint(&reader, 4);
+        if (reader.failed || reader.pos + length > file_size) {
+            reader.failed = true;
+            break;
+        }
+        classes[c].name = checked_calloc(length + 1, 1);
+        memcpy(classes[c].name, data + reader.pos, length);
+        reader.pos += length;
+    }
+
+    // Objects: first pass sizes the graph, second pass resolves references
+    uint64_t object_count = read_uint(&reader, 8);
+    if (reader.failed || object_count >= UNDEFINED || object_count > file_size) {
+        fprintf(stderr, "Truncated snapshot\n");
+        return 1;
+    }
+    Graph graph;
+    graph.node_count = (uint32_t)object_count + 1;
+    graph.ids = checked_calloc(graph.node_count, sizeof(uint64_t));
+    graph.classes = checked_calloc(graph.node_count, sizeof(uint32_t));
+    graph.sizes = checked_calloc(graph.node_count, sizeof(uint32_t));
+    graph.edge_start = checked_calloc(graph.node_count + 1, sizeof(uint32_t));
+    graph.classes[0] = UNDEFINED;
+
+    size_t objects_pos = reader.pos;
+    size_t reference_count = 0;
+    for (uint32_t node = 1; node < graph.node_count && !reader.failed; node++) {
+        graph.ids[node] = read_uint(&reader, 8);
+        uint32_t class_index = (uint32_t)read_uint(&reader, 4);
+        graph.sizes[node] = (uint32_t)read_uint(&reader, 4);
+        uint32_t refs = (uint32_t)read_uint(&reader, 4);
+        reader.pos += (size_t)refs * 8;
+        reference_count += refs;
+
+        graph.classes[node] = UNDEFINED;
+        for (uint32_t c = 0; c < class_count; c++) {
+            if (classes[c].index == class_index) {
+                graph.classes[node] = c;
+                break;
+            }
+        }
+    }
+    uint64_t root_count = read_uint(&reader, 8);
+    if (reader.failed || reader.pos + root_count * 8 > file_size) {
+        fprintf(stderr, "Truncated snapshot\n");
+        return 1;
+    }
+
+    IdEntry* ids = checked_calloc(object_count, sizeof(IdEntry));
+    for (uint32_t node = 1; node < graph.node_count; node++) {
+        ids[node - 1].id = graph.ids[node];
+        ids[node - 1].node = node;
+    }
+    qsort(ids, object_count, sizeof(IdEntry), id_compare);
+
+    // Successors: the synthetic root's edges are the GC roots
+    graph.edges = checked_calloc(reference_count + root_count, sizeof(uint32_t));
+    uint32_t edge_count = 0;
+    for (uint64_t r = 0; r < root_count; r++) {
+        uint32_t target = id_lookup(ids, (uint32_t)object_count, read_uint(&reader, 8));
+        if (target != UNDEFINED) graph.edges[edge_count++] = target;
+    }
+    reader.pos = objects_pos;
+    for (uint32_t node = 1; node < graph.node_count; node++) {
+        graph.edge_start[node] = edge_count;
+        reader.pos += 8 + 4 + 4;
+        uint32_t refs = (uint32_t)read_uint(&reader, 4);
+        for (uint32_t r = 0; r < refs; r++) {
+            uint32_t target = id_lookup(ids, (uint32_t)object_count, read_uint(&reader, 8));
+            if (target != UNDEFINED) graph.edges[edge_count++] = target;
+        }
+    }
+    graph.edge_start[graph.node_count] = edge_count;
+
+    // Predecessors
+    graph.pred_start = checked_calloc(graph.node_count + 1, sizeof(uint32_t));
+    graph.preds = checked_calloc(edge_count, sizeof(uint32_t));
+    for (uint32_t e = 0; e < edge_count; e++) graph.pred_start[graph.edges[e] + 1]++;
+    for (uint32_t node = 0; node < graph.node_count; node++) graph.pred_start[node + 1] += graph.pred_start[node];
+    uint32_t* fill = checked_calloc(graph.node_count, sizeof(uint32_t));
+    memcpy(fill, graph.pred_start, graph.node_count * sizeof(uint32_t));
+    for (uint32_t node = 0; node < graph.node_count; node++) {
+        for (uint32_t e = graph.edge_start[node]; e < graph.edge_start[node + 1]; e++) {
+            graph.preds[fill[graph.edges[e]]++] = node;
+        }
+    }
+    free(fill);
+
+    // Dominator tree and retained sizes (children follow parents in order)
+    uint32_t* order = checked_calloc(graph.node_count, sizeof(uint32_t));
+    uint32_t reachable = 0;
+    uint32_t* idom = compute_dominators(&graph, order, &reachable);
+    size_t* retained = checked_calloc(graph.node_count, sizeof(size_t));
+    for (uint32_t i = 0; i < reachable; i++) retained[order[i]] = graph.sizes[order[i]];
+    for (uint32_t i = reachable; i-- > 1;) retained[idom[order[i]]] += retained[order[i]];
+
+    size_t total_bytes = 0, unreachable_bytes = 0, unreachable_count = 0;
+    for (uint32_t node = 1; node < graph.node_count; node++) {
+        total_bytes += graph.sizes[node];
+        if (idom[node] == UNDEFINED) {
+            unreachable_count++;
+            unreachable_bytes += graph.sizes[node];
+        }
+        if (graph.classes[node] != UNDEFINED) {
+            classes[graph.classes[node]].count++;
+            classes[graph.classes[node]].shallow += graph.sizes[node];
+        }
+    }
+
+    // Retained size per class: the union of the dominator subtrees of its
+    // instances, i.e. instances with no instance of the same class above them
+    uint32_t* child_start = checked_calloc(graph.node_count + 1, sizeof(uint32_t));
+    uint32_t* children = checked_calloc(graph.node_count, sizeof(uint32_t));
+    for (uint32_t i = 1; i < reachable; i++) child_start[idom[order[i]] + 1]++;
+    for (uint32_t node = 0; node < graph.node_count; node++) child_start[node + 1] += child_start[node];
+    fill = checked_calloc(graph.node_count, sizeof(uint32_t));
+    memcpy(fill, child_start, graph.node_count * sizeof(uint32_t));
+    for (uint32_t i = 1; i < reachable; i++) children[fill[idom[order[i]]]++] = order[i];
+    free(fill);
+
+    uint32_t* stack = checked_calloc(graph.node_count, sizeof(uint32_t));
+    uint32_t* next_child = checked_calloc(graph.node_count, sizeof(uint32_t));
+    uint32_t depth = 0;
+    stack[depth++] = 0;
+    next_child[0] = child_start[0];
+    while (depth > 0) {
+        uint32_t node = stack[depth - 1];
+        if (next_child[node] < child_start[node + 1]) {
+            uint32_t child = children[next_child[node]++];
+            uint32_t c = graph.classes[child];
+            if (c != UNDEFINED) {
+                if (classes[c].on_path == 0) classes[c].retained += retained[child];
+                classes[c].on_path++;
+            }
+            next_child[child] = child_start[child];
+            stack[depth++] = child;
+        } else {
+            if (node != 0 && graph.classes[node] != UNDEFINED) classes[graph.classes[node]].on_path--;
+            depth--;
+        }
+    }
+
+    printf("He³ Heap Snapshot: %s\n", argv[1]);
+    printf("Objects: %llu (%zu bytes), %llu roots, %zu references\n",
+           (unsigned long long)object_count, total_bytes, (unsigned long long)root_count, reference_count);
+    printf("Unreachable: %zu objects (%zu bytes)\n\n", unreachable_count, unreachable_bytes);
+
+    uint32_t* class_order = checked_calloc(class_count, sizeof(uint32_t));
+    for (uint32_t c = 0; c < class_count; c++) class_order[c] = c;
+    sort_classes = classes;
+    qsort(class_order, class_count, sizeof(uint32_t), class_retained_compare);
+    printf("By class:\n");
+    printf("%10s %14s %14s  %s\n", "Count", "Shallow bytes", "Retained bytes", "Class");
+    for (uint32_t i = 0; i < class_count; i++) {
+        const SnapshotClass* c = &classes[class_order[i]];
+        printf("%10zu %14zu %14zu  %s (type %u)\n", c->count, c->shallow, c->retained, c->name, c->type_id);
+    }
+
+    uint32_t* node_order = checked_calloc(reachable, sizeof(uint32_t));
+    uint32_t ranked = 0;
+    for (uint32_t i = 1; i < reachable; i++) node_order[ranked++] = order[i];
+    sort_retained = retained;
+    qsort(node_order, ranked, sizeof(uint32_t), node_retained_compare);
+    printf("\nLargest retainers:\n");
+    printf("%14s %10s  %-18s  %s\n", "Retained bytes", "Size", "Object", "Class");
+    for (uint32_t i = 0; i < ranked && i < top; i++) {
+        uint32_t node = node_order[i];
+        uint32_t c = graph.classes[node];
+        printf("%14zu %10u  0x%-16llx  %s\n", retained[node], graph.sizes[node],
+               (unsigned long long)graph.ids[node], c != UNDEFINED ? classes[c].name : "?");
+    }
+
+    for (uint32_t c = 0; c < class_count; c++) free(classes[c].name);
+    free(classes);
+    free(class_order);
+    free(node_order);
+    free(stack);
+    free(next_child);
+    free(children);
+    free(child_start);
+    free(retained);
+    free(idom);
+    free(order);
+    free(ids);
+    free(graph.ids);
+    free(graph.classes);
+    free(graph.sizes);
+    free(graph.edge_start);
+    free(graph.edges);
+    free(graph.pred_start);
+    free(graph.preds);
+    free(data);
+    return 0;
+}
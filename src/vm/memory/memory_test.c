@@ -1,4 +1,8 @@
 #include "heap.h"
+#include "pool.h"
+#include "../objects/object.h"
+#include "../objects/string_object.h"
+#include "../objects/utf8.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -88,6 +92,15 @@ void test_fragmentation(void) {
     void* large_ptr = heap_allocate(heap, 5000);
     assert(large_ptr != NULL);
     
+    // The freed blocks are reused for blocks that fit
+    void* small_ptr = heap_allocate(heap, 100);
+    bool reused = false;
+    for (int i = 0; i < 100; i += 2) {
+        reused = reused || small_ptr == ptrs[i];
+    }
+    assert(reused);
+    assert(heap_check_integrity(heap));
+    
     // Compact heap
     heap_compact(heap);
     
@@ -137,9 +150,9 @@ void test_memory_regions(void) {
     assert(heap != NULL);
     
     // Allocate and free to create fragmentation
-    void* ptr1 = heap_allocate(heap, 1000);
+    heap_allocate(heap, 1000);
     void* ptr2 = heap_allocate(heap, 2000);
-    void* ptr3 = heap_allocate(heap, 3000);
+    heap_allocate(heap, 3000);
     
     heap_deallocate(heap, ptr2); // Free middle block
     
@@ -165,7 +178,7 @@ void test_allocation_tracking(void) {
     }
     
     // Print allocations
-    heap_print_allocations(heap);
+    heap_print_allocations(heap, HEAP_GROUP_NONE);
     
     // Verify allocation count
     assert(heap->allocation_count == 10);
@@ -189,8 +202,8 @@ void test_heap_validation(void) {
     assert(heap != NULL);
     
     // Allocate some memory
-    void* ptr1 = heap_allocate(heap, 1000);
-    void* ptr2 = heap_allocate(heap, 2000);
+    heap_allocate(heap, 1000);
+    heap_allocate(heap, 2000);
     
     // Validate heap
     assert(heap_check_integrity(heap));
@@ -254,15 +267,973 @@ void test_stress_allocation(void) {
         }
     }
     
+    assert(heap_check_integrity(heap));
+    
     // Clean up remaining allocations
     for (int i = 0; i < allocated; i++) {
         heap_deallocate(heap, ptrs[i]);
     }
+    assert(heap_check_integrity(heap));
+    assert(heap->allocation_count == 0 && heap->region_count == 1);
     
     heap_destroy(heap);
     printf("Stress allocation test passed!\n");
 }
 
+// Roots for the generational collection test
+static Object* test_roots[4];
+
+static void test_root_scanner(Heap* heap, void* context) {
+    (void)context;
+    for (size_t i = 0; i < sizeof(test_roots) / sizeof(test_roots[0]); i++) {
+        gc_mark_object(heap, test_roots[i]);
+    }
+}
+
+// Test card marking and generational collection
+void test_card_marking(void) {
+    printf("=== Testing Card Marking ===\n");
+    
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    assert(heap != NULL);
+    assert(heap->gc->card_table != NULL);
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    
+    Class* node = class_create("Test.Node", 100, sizeof(Object*));
+    class_add_field(node, field_create("next", FIELD_TYPE_OBJECT, 0, sizeof(Object*)));
+    
+    // Tenure a rooted holder object
+    Object* holder = object_create(heap, node);
+    test_roots[0] = holder;
+    for (uint32_t i = 0; i < heap->gc->tenure_threshold; i++) {
+        gc_collect_young(heap);
+    }
+    assert(holder->header.flags & OBJECT_FLAG_OLD);
+    assert(heap->gc->old_gen->object_count == 1);
+    assert(card_table_dirty_count(heap->gc->card_table) == 0);
+    
+    // Old-to-young store through the write barrier
+    Object* young = object_create(heap, node);
+    object_create(heap, node); // Unreachable
+    *(Object**)holder->data = young;
+    gc_write_barrier(heap, holder);
+    assert(card_table_dirty_count(heap->gc->card_table) == 1);
+    
+    // The young object is only reachable through the dirty card
+    size_t collected = heap->gc->stats.objects_collected;
+    gc_collect_young(heap);
+    assert(heap->gc->stats.objects_collected == collected + 1);
+    assert(heap->gc->young_gen->object_count == 1);
+    assert(heap->gc->young_gen->objects[0] == young);
+    assert(card_table_dirty_count(heap->gc->card_table) == 1);
+    
+    // Dropping the reference frees the young object and cleans the card
+    *(Object**)holder->data = NULL;
+    gc_write_barrier(heap, holder);
+    gc_collect_young(heap);
+    assert(heap->gc->young_gen->object_count == 0);
+    assert(card_table_dirty_count(heap->gc->card_table) == 0);
+    
+    // A full collection reclaims the old generation too
+    test_roots[0] = NULL;
+    gc_collect_full(heap);
+    assert(heap->gc->old_gen->object_count == 0);
+    assert(heap->allocation_count == 0);
+    
+    gc_print_stats(heap);
+    heap_destroy(heap);
+    class_destroy(node);
+    printf("Card marking test passed!\n");
+}
+
+// Test concurrent marking with the SATB barrier
+void test_concurrent_marking(void) {
+    printf("=== Testing Concurrent Marking ===\n");
+    
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    assert(heap != NULL);
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    heap->gc->concurrent_mode = true;
+    
+    Class* node = class_create("Test.Node", 100, sizeof(Object*));
+    class_add_field(node, field_create("next", FIELD_TYPE_OBJECT, 0, sizeof(Object*)));
+    
+    // Rooted holder -> child, plus unreachable garbage
+    Object* holder = object_create(heap, node);
+    Object* child = object_create(heap, node);
+    *(Object**)holder->data = child;
+    test_roots[0] = holder;
+    object_create(heap, node);
+    
+    gc_collect_concurrent(heap);
+    assert(heap->gc->marking_active);
+    
+    // Move the child from the heap into a root while marking runs; the
+    // SATB barrier keeps it alive even if the marker has not reached it
+    test_roots[1] = child;
+    gc_satb_barrier(heap, *(Object**)holder->data);
+    *(Object**)holder->data = NULL;
+    
+    // Objects allocated during marking are black
+    Object* fresh = object_create(heap, node);
+    assert(fresh->header.flags & OBJECT_FLAG_MARKED);
+    
+    gc_concurrent_finish(heap);
+    assert(!heap->gc->marking_active);
+    assert(heap->gc->stats.concurrent_cycles == 1);
+    assert(heap->gc->stats.objects_collected == 1);
+    assert(heap_is_valid_pointer(heap, child));
+    assert(heap_is_valid_pointer(heap, fresh));
+    
+    test_roots[0] = NULL;
+    test_roots[1] = NULL;
+    heap_destroy(heap);
+    class_destroy(node);
+    printf("Concurrent marking test passed!\n");
+}
+
+// Test parallel marking and lazy sweeping
+void test_parallel_collection(void) {
+    printf("=== Testing Parallel Collection ===\n");
+    
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    assert(heap != NULL);
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    gc_set_worker_count(heap, 4);
+    
+    Class* pair = class_create("Test.Pair", 101, 2 * sizeof(Object*));
+    class_add_field(pair, field_create("left", FIELD_TYPE_OBJECT, 0, sizeof(Object*)));
+    class_add_field(pair, field_create("right", FIELD_TYPE_OBJECT, sizeof(Object*), sizeof(Object*)));
+    
+    // A rooted binary tree of 1023 nodes interleaved with 1023 garbage nodes
+    Object* nodes[1023];
+    for (int i = 0; i < 1023; i++) {
+        nodes[i] = object_create(heap, pair);
+        object_create(heap, pair);
+    }
+    for (int i = 0; i < 511; i++) {
+        *(Object**)nodes[i]->data = nodes[2 * i + 1];
+        *(Object**)(nodes[i]->data + sizeof(Object*)) = nodes[2 * i + 2];
+    }
+    test_roots[0] = nodes[0];
+    
+    gc_collect_full(heap);
+    assert(heap->gc->stats.objects_collected == 1023);
+    assert(heap->gc->young_gen->object_count == 1023);
+    for (int i = 0; i < 1023; i++) {
+        assert(!(nodes[i]->header.flags & OBJECT_FLAG_MARKED));
+    }
+    
+    // Garbage is released lazily
+    assert(heap->gc->sweep_pending_count == 1023);
+    assert(gc_lazy_sweep(heap, 1023) == 1023);
+    assert(heap->allocation_count == 1023);
+    
+    // Dropping the root frees the whole tree
+    test_roots[0] = NULL;
+    gc_collect_full(heap);
+    gc_lazy_sweep(heap, heap->gc->sweep_pending_count);
+    assert(heap->allocation_count == 0);
+    
+    heap_destroy(heap);
+    class_destroy(pair);
+    printf("Parallel collection test passed!\n");
+}
+
+// Test time-budgeted incremental collection
+void test_incremental_collection(void) {
+    printf("=== Testing Incremental Collection ===\n");
+    
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    assert(heap != NULL);
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    heap->gc->incremental_mode = true;
+    gc_set_pause_target(heap, 1);
+    assert(heap->gc->pause_target_us == GC_MIN_PAUSE_TARGET_US);
+    
+    Class* node = class_create("Test.Node", 100, sizeof(Object*));
+    class_add_field(node, field_create("next", FIELD_TYPE_OBJECT, 0, sizeof(Object*)));
+    
+    // A rooted list of 2000 nodes interleaved with 2000 garbage nodes
+    Object* head = NULL;
+    Object* second = NULL;
+    for (int i = 0; i < 2000; i++) {
+        Object* object = object_create(heap, node);
+        *(Object**)object->data = head;
+        second = head;
+        head = object;
+        object_create(heap, node);
+    }
+    test_roots[0] = head;
+    
+    // Initial slice: the cycle starts marking and allocates black
+    gc_collect_incremental(heap);
+    assert(heap->gc->incremental_phase != GC_PHASE_IDLE);
+    Object* fresh = object_create(heap, node);
+    assert(fresh->header.flags & OBJECT_FLAG_MARKED);
+    
+    // Cut the list behind a root while the cycle runs; the SATB barrier
+    // keeps the tail alive for this cycle
+    test_roots[1] = second;
+    if (heap->gc->marking_active) {
+        gc_satb_barrier(heap, *(Object**)head->data);
+    }
+    *(Object**)head->data = NULL;
+    
+    // Allocation requests the next slice once the pace is used up
+    heap->gc->incremental_pace = GC_MIN_INCREMENTAL_PACE;
+    while (!heap->gc->safepoint_requested && heap->gc->incremental_phase != GC_PHASE_IDLE) {
+        assert(object_create(heap, node) != NULL);
+    }
+    
+    // Slices at safepoints until the cycle completes
+    size_t guard = 0;
+    while (heap->gc->incremental_phase != GC_PHASE_IDLE) {
+        __atomic_store_n(&heap->gc->safepoint_requested, 1, __ATOMIC_RELEASE);
+        gc_safepoint(heap);
+        assert(++guard < 1000000);
+    }
+    assert(heap->gc->stats.incremental_cycles == 1);
+    assert(heap->gc->stats.incremental_slices >= 2);
+    assert(heap->gc->stats.objects_collected == 2000);
+    assert(heap_is_valid_pointer(heap, head));
+    assert(heap_is_valid_pointer(heap, second));
+    assert(heap_is_valid_pointer(heap, fresh));
+    assert(!(head->header.flags & OBJECT_FLAG_MARKED));
+    
+    // A full collection in the middle of a cycle finishes it in one pause
+    test_roots[1] = NULL;
+    gc_collect_incremental(heap);
+    if (heap->gc->incremental_phase != GC_PHASE_IDLE) {
+        gc_collect_full(heap);
+        assert(heap->gc->stats.incremental_fallbacks == 1);
+    }
+    assert(heap->gc->incremental_phase == GC_PHASE_IDLE);
+    assert(heap->gc->stats.incremental_cycles == 2);
+    
+    // The cycle above snapshotted the list tail; the next one frees it
+    gc_collect_full(heap);
+    assert(heap->gc->young_gen->object_count + heap->gc->old_gen->object_count ==
+           heap->allocation_count);
+    assert(heap_is_valid_pointer(heap, head));
+    assert(!heap_is_valid_pointer(heap, second));
+    
+    gc_print_stats(heap);
+    test_roots[0] = NULL;
+    heap_destroy(heap);
+    class_destroy(node);
+    printf("Incremental collection test passed!\n");
+}
+
+// Test pause histogram and GC log
+void test_gc_telemetry(void) {
+    printf("=== Testing GC Telemetry ===\n");
+    
+    // Exact below 32 us, within one sub-bucket (~6%) above
+    GCHistogram histogram;
+    memset(&histogram, 0, sizeof(histogram));
+    for (uint64_t value = 1; value <= 1000; value++) {
+        gc_histogram_record(&histogram, value);
+    }
+    gc_histogram_record(&histogram, 250000);
+    assert(histogram.total_count == 1001);
+    assert(histogram.max_value == 250000);
+    assert(gc_histogram_percentile(&histogram, 1.0) == 11);
+    uint64_t p50 = gc_histogram_percentile(&histogram, 50.0);
+    assert(p50 >= 501 && p50 <= 501 + 501 / 16);
+    uint64_t p99 = gc_histogram_percentile(&histogram, 99.0);
+    assert(p99 >= 991 && p99 <= 991 + 991 / 16);
+    assert(gc_histogram_percentile(&histogram, 100.0) == 250000);
+    
+    // One JSON line per cycle
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    assert(heap != NULL);
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    FILE* log = tmpfile();
+    assert(log != NULL);
+    gc_set_log_file(heap, log);
+    
+    Class* node = class_create("Test.Node", 100, sizeof(Object*));
+    class_add_field(node, field_create("next", FIELD_TYPE_OBJECT, 0, sizeof(Object*)));
+    test_roots[0] = object_create(heap, node);
+    for (int i = 0; i < 99; i++) {
+        object_create(heap, node);
+    }
+    
+    gc_collect_young(heap);
+    gc_collect_young(heap);
+    gc_collect_full(heap);
+    assert(heap->gc->stats.pause_histogram.total_count == 3);
+    
+    // The root survives two minor collections (promoted by the second) and
+    // the full collection; the 99 others die in the first
+    size_t size = object_size(test_roots[0]);
+    assert(heap->gc->stats.bytes_promoted == size);
+    assert(heap->gc->stats.young_bytes_swept == 101 * size);
+    assert(heap->gc->stats.young_bytes_survived == 2 * size);
+    assert(heap->gc->stats.old_bytes_swept == size);
+    assert(heap->gc->stats.old_bytes_survived == size);
+    assert(heap->gc->stats.occupancy_after == heap->used_size);
+    
+    char line[1024];
+    int lines = 0;
+    rewind(log);
+    while (fgets(line, sizeof(line), log)) {
+        assert(line[0] == '{' && strstr(line, "}\n"));
+        assert(strstr(line, "\"pause_us\":") && strstr(line, "\"heap_before\":"));
+        lines++;
+    }
+    assert(lines == 3);
+    assert(strstr(line, "\"type\":\"full\"") && strstr(line, "\"old_survival\":1.0000"));
+    
+    gc_print_stats(heap);
+    fclose(log);
+    test_roots[0] = NULL;
+    heap_destroy(heap);
+    class_destroy(node);
+    printf("GC telemetry test passed!\n");
+}
+
+// Test the reserved, lazily committed heap
+void test_growable_heap(void) {
+    printf("=== Testing Growable Heap ===\n");
+    
+    size_t mb = 1024 * 1024;
+    Heap* heap = heap_create_growable(mb, 4 * mb, 64 * mb);
+    assert(heap != NULL);
+    assert(heap->reserved_size >= 64 * mb);
+    assert(heap->total_size == mb && heap->committed_size == mb);
+    assert(heap->gc->card_table->card_count == mb / GC_CARD_SIZE);
+    assert(!heap_set_limits(heap, 4 * mb, 128 * mb));
+    
+    // Grows without collecting up to the soft limit...
+    void* blocks[128];
+    int count = 0;
+    while (heap->total_size < 4 * mb) {
+        blocks[count] = heap_allocate(heap, 64 * 1024);
+        assert(blocks[count] != NULL);
+        memset(blocks[count], 0xAB, 64 * 1024);
+        count++;
+    }
+    assert(heap->grow_count > 0);
+    assert(heap->total_size == 4 * mb);
+    assert(heap->gc->card_table->card_count == 4 * mb / GC_CARD_SIZE);
+    assert(heap_check_integrity(heap));
+    
+    // ...then up to the hard limit, and no further
+    while (count < 128 && heap->total_size == 4 * mb) {
+        blocks[count] = heap_allocate(heap, 64 * 1024);
+        assert(blocks[count] != NULL);
+        count++;
+    }
+    assert(heap->total_size > 4 * mb && heap->total_size <= 64 * mb);
+    assert(heap_allocate(heap, 64 * mb) == NULL);
+    
+    // The write barrier covers grown memory
+    Class* node = class_create("Test.Node", 100, sizeof(Object*));
+    class_add_field(node, field_create("next", FIELD_TYPE_OBJECT, 0, sizeof(Object*)));
+    Object* high = object_create(heap, node);
+    assert(high != NULL && (char*)high >= (char*)heap->memory + mb);
+    card_table_clear(heap->gc->card_table);
+    gc_write_barrier(heap, high);
+    assert(card_table_dirty_count(heap->gc->card_table) == 1);
+    
+    // A full collection gives freed memory back to the OS and shrinks the
+    // heap to its minimum
+    for (int i = 0; i < count; i++) {
+        heap_deallocate(heap, blocks[i]);
+    }
+    size_t grown = heap->total_size;
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    gc_collect_full(heap);
+    assert(heap->allocation_count == 0);
+    assert(heap->released_bytes >= grown - mb);
+    assert(heap->total_size == mb && heap->committed_size == mb);
+    assert(heap->shrink_count == 1 && heap->region_count == 1);
+    assert(heap->gc->card_table->card_count == mb / GC_CARD_SIZE);
+    assert(heap_check_integrity(heap));
+    
+    // And can grow again
+    assert(heap_allocate(heap, 2 * mb) != NULL);
+    assert(heap->total_size >= 2 * mb);
+    
+    if (heap_set_huge_pages(heap, true)) {
+        assert(heap->huge_pages);
+    }
+    
+    heap_print_stats(heap);
+    heap_destroy(heap);
+    class_destroy(node);
+    printf("Growable heap test passed!\n");
+}
+
+// Test the compact object header
+void test_compact_header(void) {
+    printf("=== Testing Compact Object Header ===\n");
+    
+    assert(sizeof(ObjectHeader) == 8);
+    
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    assert(heap != NULL);
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    
+    Class* point = class_create("Test.Point", 102, 2 * sizeof(int64_t));
+    Class* text = class_create("Test.Text", 103, 0);
+    assert(point->class_index != 0 && text->class_index != point->class_index);
+    
+    // Class, type id and size come from the class table
+    Object* p = object_create(heap, point);
+    assert(p->header.class_index == point->class_index);
+    assert(object_get_class(p) == point);
+    assert(object_get_type_id(p) == 102);
+    assert(object_size(p) == sizeof(ObjectHeader) + 2 * sizeof(int64_t));
+    
+    // Variable-size objects carry their own size
+    Object* t = object_create_sized(heap, text, 100);
+    assert(t->header.flags & OBJECT_FLAG_SIZED);
+    assert(object_size(t) == sizeof(ObjectHeader) + sizeof(uint64_t) + 100);
+    assert(object_get_class(t) == text);
+    
+    // Both are swept by size without touching the class size
+    test_roots[0] = t;
+    gc_collect_full(heap);
+    assert(heap->gc->stats.objects_collected >= 1);
+    assert(object_size(t) == sizeof(ObjectHeader) + sizeof(uint64_t) + 100);
+    test_roots[0] = NULL;
+    gc_collect_full(heap);
+    assert(heap->allocation_count == 0);
+    
+    // Creating classes never moves the table the markers read
+    Class** table = object_class_table;
+    Class* extra[200];
+    for (int i = 0; i < 200; i++) {
+        extra[i] = class_create("Extra", 0, 8);
+        assert(extra[i] != NULL && extra[i]->class_index != 0);
+    }
+    assert(object_class_table == table);
+    assert(object_class(t) == text);
+    for (int i = 0; i < 200; i++) {
+        class_destroy(extra[i]);
+    }
+
+    // A destroyed class leaves its slot empty
+    uint32_t index = point->class_index;
+    class_destroy(point);
+    assert(object_class_table[index] == NULL);
+    
+    heap_destroy(heap);
+    class_destroy(text);
+    printf("Compact object header test passed!\n");
+}
+
+// Test the sampling allocation profiler
+void test_allocation_profiler(void) {
+    printf("=== Testing Allocation Profiler ===\n");
+    
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    assert(heap != NULL);
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    
+    Class* node = class_create("Test.Node", 100, sizeof(Object*));
+    Class* point = class_create("Test.Point", 102, 2 * sizeof(int64_t));
+    
+    // Every allocation sampled: objects are charged to the current site
+    assert(heap_profiler_enable(heap, 1));
+    AllocProfiler* profiler = heap->profiler;
+    profiler->site_method = "Test.main";
+    profiler->site_offset = 4;
+    for (int i = 0; i < 10; i++) {
+        object_create(heap, node);
+    }
+    profiler->site_offset = 9;
+    test_roots[0] = object_create(heap, point);
+    test_roots[1] = object_create(heap, point);
+    assert(profiler->site_count == 2);
+    assert(profiler->sites[0].samples == 10 && profiler->sites[0].type_id == 100);
+    assert(profiler->sites[1].live_samples == 2);
+    assert(profiler->live_count == 12);
+    
+    // Collected objects stop counting as live, survivors stay
+    gc_collect_full(heap);
+    assert(profiler->sites[0].live_samples == 0 && profiler->sites[0].live_bytes == 0);
+    assert(profiler->sites[0].bytes == 10 * (sizeof(ObjectHeader) + sizeof(Object*)));
+    assert(profiler->sites[1].live_samples == 2);
+    assert(profiler->live_count == 2);
+    
+    heap_profile_report(heap, stdout);
+    heap_print_allocations(heap, HEAP_GROUP_CLASS);
+    heap_print_allocations(heap, HEAP_GROUP_SITE);
+    
+    // Sampling 1 in 8 records about an eighth of the allocations
+    assert(heap_profiler_enable(heap, 8));
+    profiler = heap->profiler;
+    for (int i = 0; i < 8000; i++) {
+        Object* object = object_create(heap, point);
+        assert(object != NULL);
+        if (i % 1000 == 999) gc_collect_young(heap);
+    }
+    size_t samples = profiler->site_count ? profiler->sites[0].samples : 0;
+    assert(profiler->allocations == 8000);
+    assert(samples > 700 && samples < 1300);
+    
+    test_roots[0] = test_roots[1] = NULL;
+    gc_collect_full(heap);
+    assert(profiler->live_count == 0);
+    
+    heap_destroy(heap);
+    class_destroy(node);
+    class_destroy(point);
+    printf("Allocation profiler test passed!\n");
+}
+
+static size_t test_oom_size;
+
+static void test_oom_handler(Heap* heap, size_t size, void* context) {
+    (void)heap;
+    (void)context;
+    test_oom_size = size;
+}
+
+static uint64_t test_read_uint(FILE* file, int bytes) {
+    uint8_t buffer[8];
+    assert(fread(buffer, 1, bytes, file) == (size_t)bytes);
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) value |= (uint64_t)buffer[i] << (8 * i);
+    return value;
+}
+
+// Test heap snapshots and the out-of-memory hook
+void test_heap_snapshot(void) {
+    printf("=== Testing Heap Snapshot ===\n");
+    
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    assert(heap != NULL);
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    
+    Class* node = class_create("Test.Node", 100, sizeof(Object*));
+    class_add_field(node, field_create("next", FIELD_TYPE_OBJECT, 0, sizeof(Object*)));
+    
+    // root -> a -> b, plus an unreachable object
+    Object* root = object_create(heap, node);
+    Object* a = object_create(heap, node);
+    Object* b = object_create(heap, node);
+    object_create(heap, node);
+    *(Object**)root->data = a;
+    *(Object**)a->data = b;
+    test_roots[0] = root;
+    
+    FILE* file = tmpfile();
+    assert(file != NULL);
+    assert(heap_write_snapshot(heap, file));
+    rewind(file);
+    
+    char magic[sizeof(HEAP_SNAPSHOT_MAGIC)];
+    assert(fread(magic, 1, sizeof(magic), file) == sizeof(magic));
+    assert(memcmp(magic, HEAP_SNAPSHOT_MAGIC, sizeof(magic)) == 0);
+    assert(test_read_uint(file, 4) == HEAP_SNAPSHOT_VERSION);
+    test_read_uint(file, 4);
+    
+    assert(test_read_uint(file, 4) == 1);
+    assert(test_read_uint(file, 4) == node->class_index);
+    assert(test_read_uint(file, 4) == 100);
+    uint32_t name_length = (uint32_t)test_read_uint(file, 4);
+    assert(name_length == strlen("Test.Node"));
+    fseek(file, name_length, SEEK_CUR);
+    
+    // Every object with its size and references
+    assert(test_read_uint(file, 8) == 4);
+    size_t references = 0;
+    for (int i = 0; i < 4; i++) {
+        uint64_t id = test_read_uint(file, 8);
+        assert(test_read_uint(file, 4) == node->class_index);
+        assert(test_read_uint(file, 4) == sizeof(ObjectHeader) + sizeof(Object*));
+        uint32_t count = (uint32_t)test_read_uint(file, 4);
+        for (uint32_t r = 0; r < count; r++) {
+            uint64_t target = test_read_uint(file, 8);
+            assert(id == (uintptr_t)root ? target == (uintptr_t)a : target == (uintptr_t)b);
+        }
+        references += count;
+    }
+    assert(references == 2);
+    
+    // Roots as the scanner reports them
+    assert(test_read_uint(file, 8) == 1);
+    assert(test_read_uint(file, 8) == (uintptr_t)root);
+    assert(fgetc(file) == EOF);
+    fclose(file);
+    
+    test_roots[0] = NULL;
+    heap_destroy(heap);
+    class_destroy(node);
+    
+    // A failing allocation reports to the out-of-memory handler
+    heap = heap_create(1024);
+    assert(heap != NULL);
+    heap_set_oom_handler(heap, test_oom_handler, NULL);
+    assert(heap_allocate(heap, 4096) == NULL);
+    assert(test_oom_size == 4096);
+    heap_destroy(heap);
+    printf("Heap snapshot test passed!\n");
+}
+
+// Test immutable GC strings and permanent (interned) strings
+void test_string_objects(void) {
+    printf("=== Testing String Objects ===\n");
+    
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    assert(heap != NULL);
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    
+    Class* string_class = class_create("Test.String", 104, 0);
+    Class* holder_class = class_create("Test.Holder", 105, sizeof(StringObject*));
+    class_add_field(holder_class, field_create("name", FIELD_TYPE_STRING, 0, sizeof(StringObject*)));
+    
+    // Length, hash and bytes live in one variable-size object
+    StringObject* hello = string_create(heap, string_class, "hello", 5);
+    assert(hello && hello->length == 5 && strcmp(hello->chars, "hello") == 0);
+    assert(hello->hash == string_hash_bytes("hello", 5));
+    assert(object_size((Object*)hello) == sizeof(StringObject) + 6);
+    
+    // Equality compares contents unless both strings are interned
+    StringObject* copy = string_create(heap, string_class, "hello", 5);
+    StringObject* other = string_create(heap, string_class, "world", 5);
+    StringObject* interned = string_create_permanent(heap, string_class, "hello", 5);
+    StringObject* interned_other = string_create_permanent(heap, string_class, "world", 5);
+    assert(string_is_interned(interned) && !string_is_interned(hello));
+    assert(string_equals(hello, copy) && !string_equals(hello, other));
+    assert(string_equals(hello, interned) && !string_equals(interned, interned_other));
+    assert(heap->gc->perm_gen->object_count == 2);
+    
+    // A string field keeps its string alive
+    Object* holder = object_create(heap, holder_class);
+    *(StringObject**)holder->data = other;
+    test_roots[0] = holder;
+    gc_collect_full(heap);
+    assert(heap->gc->young_gen->object_count + heap->gc->old_gen->object_count == 2);
+    assert(strcmp(other->chars, "world") == 0);
+    
+    // Permanent strings survive every collection
+    test_roots[0] = NULL;
+    gc_collect_full(heap);
+    gc_collect_young(heap);
+    assert(heap->gc->young_gen->object_count + heap->gc->old_gen->object_count == 0);
+    assert(heap->allocation_count == 2);
+    assert(strcmp(interned_other->chars, "world") == 0);
+    
+    heap_destroy(heap);
+    class_destroy(string_class);
+    class_destroy(holder_class);
+    printf("String objects test passed!\n");
+}
+
+void test_string_ropes(void) {
+    printf("=== Testing String Ropes ===\n");
+    
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    assert(heap != NULL);
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    
+    Class* string_class = class_create("Test.String", 106, 0);
+    Class* rope_class = class_create("Test.Rope", 107, 0);
+    Class* builder_class = class_create("Test.StringBuilder", 108, sizeof(StringBuilderObject) - sizeof(ObjectHeader));
+    class_add_field(rope_class, field_create("left", FIELD_TYPE_STRING, offsetof(RopeObject, left) - sizeof(ObjectHeader), sizeof(StringObject*)));
+    class_add_field(rope_class, field_create("right", FIELD_TYPE_STRING, offsetof(RopeObject, right) - sizeof(ObjectHeader), sizeof(StringObject*)));
+    class_add_field(builder_class, field_create("buffer", FIELD_TYPE_STRING, 0, sizeof(StringObject*)));
+    class_set_superclass(rope_class, string_class);
+    
+    // Short concatenations are copied
+    test_roots[0] = (Object*)string_create(heap, string_class, "ab", 2);
+    test_roots[1] = (Object*)string_create(heap, string_class, "cd", 2);
+    StringObject* ab = string_concat(heap, rope_class, (StringObject*)test_roots[0], (StringObject*)test_roots[1]);
+    assert(ab && !string_is_rope(ab) && strcmp(ab->chars, "abcd") == 0);
+    assert(ab->hash == string_hash_bytes("abcd", 4));
+    
+    // Repeated appends build a rope whose hash matches the flat contents
+    char expected[1024];
+    size_t length = 0;
+    StringObject* text = string_create(heap, string_class, "", 0);
+    test_roots[0] = (Object*)text;
+    for (int i = 0; i < 100; i++) {
+        char part[16];
+        int part_length = snprintf(part, sizeof(part), "<%d>", i);
+        StringObject* piece = string_create(heap, string_class, part, part_length);
+        test_roots[1] = (Object*)piece;
+        text = string_concat(heap, rope_class, text, piece);
+        test_roots[0] = (Object*)text;
+        memcpy(expected + length, part, part_length);
+        length += part_length;
+    }
+    test_roots[1] = NULL;
+    expected[length] = '\0';
+    assert(string_is_rope(text) && text->length == length);
+    assert(text->hash == string_hash_bytes(expected, length));
+    assert(string_bytes(text) == NULL);
+    
+    // The parts stay alive until the rope is flattened
+    gc_collect_full(heap);
+    size_t live_unflattened = heap->gc->young_gen->object_count + heap->gc->old_gen->object_count;
+    assert(live_unflattened > 100);
+    
+    // Flattening copies once and forwards the node to the flat string
+    const char* flat = string_flatten(heap, text);
+    assert(flat && strcmp(flat, expected) == 0);
+    StringObject* forward = ((RopeObject*)text)->left;
+    assert(!string_is_rope(forward) && forward->hash == text->hash && string_bytes(text) == flat);
+    assert(string_flatten(heap, text) == flat);
+    gc_collect_full(heap);
+    assert(heap->gc->young_gen->object_count + heap->gc->old_gen->object_count == 2);
+    assert(strcmp(string_bytes(text), expected) == 0);
+    
+    // Builders grow geometrically and copy ropes without flattening them
+    test_roots[1] = (Object*)string_create(heap, string_class, "0123456789", 10);
+    test_roots[2] = (Object*)string_create(heap, string_class, "abcdefghij", 10);
+    StringObject* rope = string_concat(heap, rope_class, (StringObject*)test_roots[1], (StringObject*)test_roots[2]);
+    test_roots[1] = (Object*)rope;
+    StringBuilderObject* builder = string_builder_create(heap, builder_class);
+    test_roots[2] = (Object*)builder;
+    for (int i = 0; i < 50; i++) {
+        assert(string_builder_append(heap, string_class, builder, rope));
+        gc_collect_young(heap);
+    }
+    assert(string_is_rope(rope) && string_bytes(rope) == NULL);
+    assert(builder->length == 1000 && builder->buffer->length >= 1000 && builder->buffer->length < 2000);
+    StringObject* built = string_builder_to_string(heap, string_class, builder);
+    assert(built && built->length == 1000 && built->chars[1000] == '\0');
+    assert(memcmp(built->chars + 980, "0123456789abcdefghij", 20) == 0);
+    assert(built->hash == string_hash_bytes(built->chars, built->length));
+    
+    test_roots[0] = test_roots[1] = test_roots[2] = NULL;
+    heap_destroy(heap);
+    class_destroy(string_class);
+    class_destroy(rope_class);
+    class_destroy(builder_class);
+    printf("String ropes test passed!\n");
+}
+
+void test_string_slices(void) {
+    printf("=== Testing String Slices ===\n");
+    
+    Heap* heap = heap_create(16 * 1024 * 1024);
+    assert(heap != NULL);
+    gc_set_root_scanner(heap, test_root_scanner, NULL);
+    
+    Class* string_class = class_create("Test.String", 109, 0);
+    Class* slice_class = class_create("Test.Slice", 110, 0);
+    class_add_field(slice_class, field_create("parent", FIELD_TYPE_STRING, offsetof(SliceObject, parent) - sizeof(ObjectHeader), sizeof(StringObject*)));
+    class_set_superclass(slice_class, string_class);
+    
+    char text[200];
+    for (int i = 0; i < 200; i++) text[i] = (char)('a' + i % 26);
+    StringObject* parent = string_create(heap, string_class, text, sizeof(text));
+    test_roots[0] = (Object*)parent;
+    
+    // Long substrings share the parent's bytes, short ones are copied
+    StringObject* view = string_substring(heap, slice_class, parent, 10, 100);
+    assert(view && string_is_slice(view) && view->length == 100);
+    assert(string_bytes(view) == parent->chars + 10);
+    assert(view->hash == string_hash_bytes(text + 10, 100));
+    StringObject* small = string_substring(heap, slice_class, parent, 3, 5);
+    assert(small && !string_is_slice(small) && strcmp(small->chars, "defgh") == 0);
+    assert(string_substring(heap, slice_class, parent, 0, 200) == parent);
+    assert(string_substring(heap, slice_class, parent, 150, 51) == NULL);
+    
+    // A slice of a slice points at the original parent
+    test_roots[1] = (Object*)view;
+    StringObject* nested = string_substring(heap, slice_class, view, 20, 40);
+    assert(nested && string_is_slice(nested));
+    assert(((SliceObject*)nested)->parent == parent && string_bytes(nested) == parent->chars + 30);
+    
+    // Equal contents compare equal whatever the representation
+    StringObject* copy = string_create(heap, string_class, text + 30, 40);
+    assert(string_equals(nested, copy) && string_equals(copy, nested));
+    
+    // The view keeps its parent alive
+    test_roots[0] = NULL;
+    test_roots[1] = (Object*)nested;
+    gc_collect_full(heap);
+    assert(memcmp(string_bytes(nested), text + 30, 40) == 0);
+    
+    // A small slice of a huge parent is copied instead of pinning it
+    size_t huge_length = STRING_SLICE_PIN_LIMIT * 2;
+    char* huge_text = malloc(huge_length);
+    assert(huge_text != NULL);
+    memset(huge_text, 'x', huge_length);
+    StringObject* huge = string_create(heap, string_class, huge_text, huge_length);
+    test_roots[0] = (Object*)huge;
+    StringObject* pinned = string_substring(heap, slice_class, huge, 1000, 1000);
+    assert(pinned && !string_is_slice(pinned) && pinned->length == 1000);
+    StringObject* shared = string_substring(heap, slice_class, huge, 0, huge_length / 2);
+    assert(shared && string_is_slice(shared));
+    
+    // Search finds the first occurrence for short, long and periodic needles
+    assert(string_index_of("hello world", 11, "", 0) == 0);
+    assert(string_index_of("hello world", 11, "o", 1) == 4);
+    assert(string_index_of("hello world", 11, "world", 5) == 6);
+    assert(string_index_of("hello world", 11, "worlds", 6) == -1);
+    assert(string_index_of("hello world", 11, "z", 1) == -1);
+    memcpy(huge_text + huge_length - 8, "xxxxyxxx", 8);
+    assert(string_index_of(huge_text, huge_length, "xxxxyxxx", 8) == (int64_t)(huge_length - 8));
+    assert(string_index_of(huge_text, huge_length, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxz", 81) == -1);
+    char long_needle[301];
+    memset(long_needle, 'x', 300);
+    long_needle[300] = 'y';
+    assert(string_index_of(huge_text, huge_length, long_needle, 301) == (int64_t)(huge_length - 304));
+    for (int i = 0; i < 200; i++) {
+        // The text repeats every 26 bytes, so each window first occurs in the first period
+        size_t start = (size_t)(i * 7) % 180;
+        size_t length = 2 + (size_t)i % 20;
+        int64_t found = string_index_of(text, sizeof(text), text + start, length);
+        assert(found == (int64_t)(start % 26));
+    }
+    free(huge_text);
+    
+    test_roots[0] = test_roots[1] = NULL;
+    heap_destroy(heap);
+    class_destroy(string_class);
+    class_destroy(slice_class);
+    printf("String slices test passed!\n");
+}
+
+void test_utf8_kernels(void) {
+    printf("=== Testing UTF-8 Kernels ===\n");
+    
+    // Well-formed and ill-formed sequences at every position of a block
+    const char* valid[] = { "", "plain ascii", "Gr\xC3\xBC\xC3\x9F" "e", "\xE2\x82\xAC", "\xED\x9F\xBF",
+                            "\xEE\x80\x80", "\xF0\x90\x80\x80", "\xF4\x8F\xBF\xBF", "\xF0\x9F\x9A\x80" };
+    const char* invalid[] = { "\x80", "\xBF", "\xC0\x80", "\xC1\xBF", "\xC2", "\xC2\x41", "\xE0\x80\x80",
+                              "\xE0\x9F\xBF", "\xED\xA0\x80", "\xED\xBF\xBF", "\xE2\x82", "\xF0\x80\x80\x80",
+                              "\xF0\x8F\xBF\xBF", "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xFF", "\xF0\x90\x80" };
+    char buffer[128];
+    
+    for (Utf8KernelLevel level = UTF8_KERNELS_SCALAR; level <= utf8_best_kernel_level(); level++) {
+        assert(utf8_set_kernel_level(level));
+        for (size_t prefix = 0; prefix < 70; prefix++) {
+            memset(buffer, 'a', prefix);
+            for (size_t v = 0; v < sizeof(valid) / sizeof(valid[0]); v++) {
+                size_t length = strlen(valid[v]);
+                memcpy(buffer + prefix, valid[v], length);
+                memset(buffer + prefix + length, 'b', 40);
+                assert(utf8_validate(buffer, prefix + length, NULL));
+                assert(utf8_validate(buffer, prefix + length + 40, NULL));
+            }
+            for (size_t v = 0; v < sizeof(invalid) / sizeof(invalid[0]); v++) {
+                size_t length = strlen(invalid[v]);
+                memcpy(buffer + prefix, invalid[v], length);
+                memset(buffer + prefix + length, 'b', 40);
+                size_t offset = 0;
+                assert(!utf8_validate(buffer, prefix + length, &offset) && offset == prefix);
+                assert(!utf8_validate(buffer, prefix + length + 40, &offset) && offset == prefix);
+            }
+        }
+        
+        // Code points: 4 ASCII, 2 two-byte, 1 three-byte and 1 four-byte per repeat
+        const char* pattern = "abcd\xC3\xA9\xD0\x96\xE2\x82\xAC\xF0\x9F\x9A\x80";
+        char text[15 * 20];
+        for (int i = 0; i < 20; i++) memcpy(text + i * 15, pattern, 15);
+        for (size_t length = 0; length <= sizeof(text); length += 15) {
+            assert(utf8_count_code_points(text, length) == length / 15 * 8);
+        }
+        
+        // Case folding only touches ASCII letters
+        assert(utf8_compare_ignore_case("Hello, World", 12, "hELLO, wORLD", 12) == 0);
+        assert(utf8_compare_ignore_case("abc", 3, "ABD", 3) < 0);
+        assert(utf8_compare_ignore_case("abc", 3, "AB", 2) > 0);
+        assert(utf8_compare_ignore_case("[", 1, "{", 1) != 0);
+        assert(utf8_compare_ignore_case("\xC3\xA9", 2, "\xC3\x89", 2) != 0);
+        char upper[100];
+        char lower[100];
+        for (int i = 0; i < 100; i++) {
+            upper[i] = (char)('A' + i % 26);
+            lower[i] = (char)('a' + i % 26);
+        }
+        assert(utf8_compare_ignore_case(upper, 100, lower, 100) == 0);
+        lower[77] = '!';
+        assert(utf8_compare_ignore_case(upper, 100, lower, 100) > 0);
+        
+        assert(utf8_index_of_ignore_case("Hello World", 11, "WORLD", 5) == 6);
+        assert(utf8_index_of_ignore_case("Hello World", 11, "o w", 3) == 4);
+        assert(utf8_index_of_ignore_case("Hello World", 11, "x", 1) == -1);
+        assert(utf8_index_of_ignore_case("Hello World", 11, "", 0) == 0);
+        for (size_t at = 0; at + 3 <= 100; at += 7) {
+            lower[77] = (char)('a' + 77 % 26);
+            int64_t found = utf8_index_of_ignore_case(upper, 100, lower + at, 3);
+            assert(found == (int64_t)(at % 26));
+        }
+    }
+    assert(utf8_set_kernel_level(utf8_best_kernel_level()));
+    printf("Kernel level: %s\n", utf8_kernel_level_name(utf8_kernel_level()));
+    printf("UTF-8 kernels test passed!\n");
+}
+
+void test_slab_pools(void) {
+    printf("=== Testing Slab Pools ===\n");
+    
+    // Objects are aligned, released objects are reused and slabs are added
+    // only when the free list is empty
+    SlabPool pool;
+    slab_pool_init(&pool, 24, 4);
+    assert(pool.object_size == 32);
+    void* objects[10];
+    for (int i = 0; i < 10; i++) {
+        objects[i] = slab_pool_alloc(&pool);
+        assert(objects[i] != NULL);
+        assert(((uintptr_t)objects[i] % POOL_ALIGNMENT) == 0);
+        memset(objects[i], 0xAB, 24);
+    }
+    assert(pool.slab_count == 3 && pool.live_count == 10);
+    assert((char*)objects[1] - (char*)objects[0] == 32);
+    slab_pool_free(&pool, objects[5]);
+    slab_pool_free(&pool, objects[2]);
+    assert(pool.live_count == 8);
+    assert(slab_pool_alloc(&pool) == objects[2]);
+    assert(slab_pool_alloc(&pool) == objects[5]);
+    assert(pool.slab_count == 3);
+    slab_pool_destroy(&pool);
+    assert(pool.slabs == NULL && pool.live_count == 0);
+    
+    // Arena: aligned bump allocation, strings and oversized requests
+    Arena arena;
+    arena_init(&arena, 256);
+    char* first = arena_strdup(&arena, "System.String");
+    char* second = arena_strdup(&arena, "main");
+    assert(strcmp(first, "System.String") == 0 && strcmp(second, "main") == 0);
+    assert(second - first == 16);
+    char* large = arena_alloc(&arena, 1000);
+    assert(large != NULL && ((uintptr_t)large % POOL_ALIGNMENT) == 0);
+    memset(large, 0, 1000);
+    char* third = arena_strdup(&arena, "after");
+    assert(third - second == 16);
+    for (int i = 0; i < 100; i++) {
+        assert(arena_alloc(&arena, 24) != NULL);
+    }
+    arena_destroy(&arena);
+    assert(arena.chunks == NULL);
+    
+    // Heap allocation records come from the heap's pool
+    Heap* heap = heap_create(1024 * 1024);
+    assert(heap != NULL);
+    void* blocks[100];
+    for (int i = 0; i < 100; i++) {
+        blocks[i] = heap_allocate(heap, 64);
+        assert(blocks[i] != NULL);
+    }
+    assert(heap->allocation_count == 100);
+    assert(heap->allocation_pool.live_count == 100);
+    size_t slabs = heap->allocation_pool.slab_count;
+    for (int i = 0; i < 100; i += 2) {
+        heap_deallocate(heap, blocks[i]);
+    }
+    assert(heap->allocation_count == 50);
+    assert(heap->allocation_pool.live_count == 50);
+    for (int i = 0; i < 50; i++) {
+        assert(heap_allocate(heap, 64) != NULL);
+    }
+    assert(heap->allocation_pool.slab_count == slabs);
+    heap_destroy(heap);
+    
+    printf("Slab pools test passed!\n");
+}
+
 int main(void) {
     printf("He³ Memory Management Test Suite\n");
     printf("================================\n\n");
@@ -295,6 +1266,48 @@ int main(void) {
     test_stress_allocation();
     printf("\n");
     
+    test_card_marking();
+    printf("\n");
+    
+    test_concurrent_marking();
+    printf("\n");
+    
+    test_parallel_collection();
+    printf("\n");
+    
+    test_incremental_collection();
+    printf("\n");
+    
+    test_gc_telemetry();
+    printf("\n");
+    
+    test_growable_heap();
+    printf("\n");
+    
+    test_compact_header();
+    printf("\n");
+    
+    test_allocation_profiler();
+    printf("\n");
+    
+    test_heap_snapshot();
+    printf("\n");
+    
+    test_string_objects();
+    printf("\n");
+    
+    test_string_ropes();
+    printf("\n");
+    
+    test_string_slices();
+    printf("\n");
+    
+    test_utf8_kernels();
+    printf("\n");
+    
+    test_slab_pools();
+    printf("\n");
+    
     printf("All memory management tests passed! 🎉\n");
     return 0;
 }
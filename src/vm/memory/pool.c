@@ -0,0 +1,140 @@
+#include "pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define POOL_ALIGN_UP(n) (((n) + POOL_ALIGNMENT - 1) & ~(size_t)(POOL_ALIGNMENT - 1))
+
+// Offset of the first object in a slab
+#define SLAB_HEADER_SIZE POOL_ALIGN_UP(sizeof(PoolSlab))
+
+// Slab pool
+void slab_pool_init(SlabPool* pool, size_t object_size, size_t objects_per_slab) {
+    if (object_size < sizeof(void*)) object_size = sizeof(void*);
+    pool->object_size = POOL_ALIGN_UP(object_size);
+    pool->objects_per_slab = objects_per_slab ? objects_per_slab : SLAB_POOL_DEFAULT_OBJECTS;
+    pool->slabs = NULL;
+    pool->free_list = NULL;
+    pool->slab_count = 0;
+    pool->live_count = 0;
+}
+
+// Allocate a slab and thread its objects onto the free list
+static bool slab_pool_grow(SlabPool* pool) {
+    PoolSlab* slab = malloc(SLAB_HEADER_SIZE + pool->object_size * pool->objects_per_slab);
+    if (!slab) return false;
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->slab_count++;
+
+    // Push in reverse so objects are handed out in address order
+    char* objects = (char*)slab + SLAB_HEADER_SIZE;
+    for (size_t i = pool->objects_per_slab; i > 0; i--) {
+        void** object = (void**)(objects + (i - 1) * pool->object_size);
+        *object = pool->free_list;
+        pool->free_list = object;
+    }
+    return true;
+}
+
+void* slab_pool_alloc(SlabPool* pool) {
+    if (!pool->free_list && !slab_pool_grow(pool)) return NULL;
+
+    void** object = pool->free_list;
+    pool->free_list = *object;
+    pool->live_count++;
+    return object;
+}
+
+void slab_pool_free(SlabPool* pool, void* object) {
+    if (!object) return;
+
+    *(void**)object = pool->free_list;
+    pool->free_list = object;
+    pool->live_count--;
+}
+
+void slab_pool_destroy(SlabPool* pool) {
+    PoolSlab* slab = pool->slabs;
+    while (slab) {
+        PoolSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    pool->slabs = NULL;
+    pool->free_list = NULL;
+    pool->slab_count = 0;
+    pool->live_count = 0;
+}
+
+// Arena
+void arena_init(Arena* arena, size_t chunk_size) {
+    arena->chunks = NULL;
+    arena->chunk_size = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE;
+    arena->total_bytes = 0;
+}
+
+static char* arena_chunk_data(ArenaChunk* chunk) {
+    return (char*)chunk + POOL_ALIGN_UP(sizeof(ArenaChunk));
+}
+
+static ArenaChunk* arena_chunk_create(size_t capacity) {
+    ArenaChunk* chunk = malloc(POOL_ALIGN_UP(sizeof(ArenaChunk)) + capacity);
+    if (!chunk) return NULL;
+    chunk->next = NULL;
+    chunk->used = 0;
+    chunk->capacity = capacity;
+    return chunk;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    size = POOL_ALIGN_UP(size ? size : 1);
+
+    ArenaChunk* chunk = arena->chunks;
+    if (!chunk || chunk->capacity - chunk->used < size) {
+        if (size > arena->chunk_size / 4) {
+            // Large request: give it a chunk of its own behind the current
+            // one so the space left in the current chunk stays usable
+            ArenaChunk* large = arena_chunk_create(size);
+            if (!large) return NULL;
+            large->used = size;
+            if (chunk) {
+                large->next = chunk->next;
+                chunk->next = large;
+            } else {
+                arena->chunks = large;
+            }
+            arena->total_bytes += size;
+            return arena_chunk_data(large);
+        }
+
+        chunk = arena_chunk_create(arena->chunk_size);
+        if (!chunk) return NULL;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+    }
+
+    void* result = arena_chunk_data(chunk) + chunk->used;
+    chunk->used += size;
+    arena->total_bytes += size;
+    return result;
+}
+
+char* arena_strdup(Arena* arena, const char* string) {
+    size_t length = strlen(string);
+    char* copy = arena_alloc(arena, length + 1);
+    if (!copy) return NULL;
+    memcpy(copy, string, length + 1);
+    return copy;
+}
+
+void arena_destroy(Arena* arena) {
+    ArenaChunk* chunk = arena->chunks;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->chunks = NULL;
+    arena->total_bytes = 0;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Allocators for VM-internal metadata (call frames, registry entries,
+// allocation records, string registry nodes). These are small, numerous and
+// share the lifetime of their owner, so they are carved out of large blocks
+// and released all at once when the owner is destroyed instead of going
+// through malloc/free one by one. Neither allocator is thread-safe; the
+// owner serializes access the same way it already does for its lists.
+
+// Alignment of every slab object and arena allocation
+#define POOL_ALIGNMENT 16
+
+// Objects per slab unless the owner asks for another count
+#define SLAB_POOL_DEFAULT_OBJECTS 64
+
+// Arena chunk size unless the owner asks for another size
+#define ARENA_DEFAULT_CHUNK_SIZE (16 * 1024)
+
+// Block of objects_per_slab objects, followed by the objects
+typedef struct PoolSlab {
+    struct PoolSlab* next;          // Next slab of the pool
+} PoolSlab;
+
+// Fixed-size objects with a free list threaded through released objects
+typedef struct SlabPool {
+    size_t object_size;             // Object size rounded up to POOL_ALIGNMENT
+    size_t objects_per_slab;        // Objects carved from each slab
+    PoolSlab* slabs;                // All slabs, newest first
+    void* free_list;                // Released objects
+    size_t slab_count;              // Slabs allocated
+    size_t live_count;              // Objects handed out and not released
+} SlabPool;
+
+// Chunk of arena memory, followed by `capacity` bytes
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;        // Previous (full) chunk
+    size_t used;                    // Bytes handed out
+    size_t capacity;                // Bytes available
+} ArenaChunk;
+
+// Bump allocator for variable-size data that is never freed individually
+typedef struct Arena {
+    ArenaChunk* chunks;             // Current chunk first
+    size_t chunk_size;              // Default chunk capacity
+    size_t total_bytes;             // Bytes handed out
+} Arena;
+
+// Slab pool; objects_per_slab 0 selects SLAB_POOL_DEFAULT_OBJECTS
+void slab_pool_init(SlabPool* pool, size_t object_size, size_t objects_per_slab);
+void* slab_pool_alloc(SlabPool* pool);
+void slab_pool_free(SlabPool* pool, void* object);
+// Release every slab, including objects that were never freed
+void slab_pool_destroy(SlabPool* pool);
+
+// Arena; chunk_size 0 selects ARENA_DEFAULT_CHUNK_SIZE
+void arena_init(Arena* arena, size_t chunk_size);
+void* arena_alloc(Arena* arena, size_t size);
+char* arena_strdup(Arena* arena, const char* string);
+// Release every chunk
+void arena_destroy(Arena* arena);
@@ -0,0 +1,231 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "module_registry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Module link benchmark - builds a module with many classes, each with
+// methods and fields, and saves it once with a link index and once without.
+// Each copy is loaded and registered many times, the way the VM starts: a
+// module without the index has its type, method and field tables scanned,
+// grouped and its names hashed by discovery, while one with the index is
+// adopted from it. Then every method and field is looked up by name and
+// owning class, as the interpreter resolves calls and field accesses.
+// Finally a set of such libraries, saved without the index, is loaded
+// together on a growing number of threads.
+//
+// Usage: link_benchmark [classes] [methods-per-class] [fields-per-class] [rounds] [libraries]
+
+#define DEFAULT_CLASSES 2000
+#define DEFAULT_METHODS 12
+#define DEFAULT_FIELDS 6
+#define DEFAULT_ROUNDS 20
+#define DEFAULT_LIBRARIES 16
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Result of the lookups, so the work cannot be optimized away
+static volatile uintptr_t bench_sink;
+
+// Startup and lookup times of one saved module, in microseconds
+typedef struct {
+    double load_us;
+    double register_us;
+    double lookup_us;
+    uint64_t lookups;
+} LinkTiming;
+
+static HeliumModule* make_module(uint32_t classes, uint32_t methods, uint32_t fields) {
+    HeliumModule* module = helium_module_create();
+    char name[96];
+    uint32_t field_id = 1;
+    for (uint32_t c = 0; c < classes; c++) {
+        snprintf(name, sizeof(name), "app.generated.package%u.Class%u", c / 64, c);
+        uint32_t type_id = helium_module_add_type(module, name, "app.generated");
+        for (uint32_t m = 0; m < methods; m++) {
+            snprintf(name, sizeof(name), "method%uOf%u", m, c % 97);
+            helium_module_add_method(module, name, "():integer", type_id, false);
+        }
+        for (uint32_t f = 0; f < fields; f++) {
+            FieldEntry field = {0};
+            snprintf(name, sizeof(name), "field%u", f);
+            field.field_id = field_id++;
+            field.type_id = type_id;
+            field.name_offset = helium_module_add_string(module, name);
+            field.field_type_id = f % 4;
+            field.offset = f * 8;
+            field_table_add_field(module->field_table, &field);
+        }
+    }
+    return module;
+}
+
+static bool time_module(const char* path, uint32_t rounds, LinkTiming* timing) {
+    memset(timing, 0, sizeof(*timing));
+    for (uint32_t r = 0; r < rounds; r++) {
+        double start = now_us();
+        HeliumModule* module = helium_module_load(path);
+        double loaded = now_us();
+        if (!module) {
+            return false;
+        }
+        ModuleRegistry* registry = module_registry_create();
+        if (!module_registry_register_module(registry, path, module)) {
+            return false;
+        }
+        timing->load_us += loaded - start;
+        timing->register_us += now_us() - loaded;
+
+        // Every member by name and owning class, once per module load
+        start = now_us();
+        ModuleEntry* entry = module_registry_find_module_by_id(registry, 1);
+        for (uint32_t i = 0; i < module->method_table->count; i++) {
+            const MethodEntry* method = &module->method_table->entries[i];
+            const char* name = helium_module_get_string(module, method->name_offset);
+            uint32_t type_id = entry->type_ids[method->type_id];
+            bench_sink += (uintptr_t)method_registry_find_method_by_name_and_type(name, type_id);
+        }
+        for (uint32_t i = 0; i < module->field_table->count; i++) {
+            const FieldEntry* field = &module->field_table->entries[i];
+            const char* name = helium_module_get_string(module, field->name_offset);
+            uint32_t type_id = entry->type_ids[field->type_id];
+            bench_sink += (uintptr_t)field_registry_find_field_by_name_and_type(name, type_id);
+        }
+        timing->lookup_us += now_us() - start;
+        timing->lookups += module->method_table->count + module->field_table->count;
+
+        module_registry_destroy(registry);
+        module_registry_cleanup();
+        helium_module_destroy(module);
+    }
+    timing->load_us /= rounds;
+    timing->register_us /= rounds;
+    return true;
+}
+
+// Load `libraries` modules at once on 1, 2, 4... threads up to the core count
+static bool time_parallel_load(uint32_t classes, uint32_t methods, uint32_t fields, uint32_t libraries) {
+    char** paths = calloc(libraries, sizeof(char*));
+    HeliumModule** modules = calloc(libraries, sizeof(HeliumModule*));
+    bool ok = paths && modules;
+    HeliumModule* module = ok ? make_module(classes, methods, fields) : NULL;
+    for (uint32_t i = 0; ok && i < libraries; i++) {
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/he3_link_benchmark_%d_lib%u.helium3", (int)getpid(), i);
+        paths[i] = strdup(path);
+        ok = paths[i] && module && helium_module_save(module, paths[i]);
+    }
+    if (module) {
+        helium_module_destroy(module);
+    }
+    
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1) {
+        cores = 1;
+    }
+    printf("\nParallel load of %u libraries (without the index, %ld cores):\n", libraries, cores);
+    double serial_us = 0;
+    for (uint32_t threads = 1; ok; threads *= 2) {
+        if (threads > (uint32_t)cores) {
+            threads = (uint32_t)cores;
+        }
+        double start = now_us();
+        ModuleRegistry* registry = module_registry_create();
+        ok = module_registry_load_helium3_modules(registry, (const char* const*)paths, modules, libraries, threads);
+        double load_us = now_us() - start;
+        module_registry_destroy(registry);
+        module_registry_cleanup();
+        for (uint32_t i = 0; i < libraries; i++) {
+            if (modules[i]) {
+                helium_module_destroy(modules[i]);
+            }
+        }
+        if (!ok) {
+            fprintf(stderr, "Failed to load the benchmark libraries\n");
+            break;
+        }
+        if (threads == 1) {
+            serial_us = load_us;
+        }
+        printf("  %2u thread%s         %8.2f ms  (%.1fx)\n", threads, threads == 1 ? ": " : "s:",
+               load_us / 1e3, serial_us / load_us);
+        if (threads == (uint32_t)cores) {
+            break;
+        }
+    }
+    
+    for (uint32_t i = 0; paths && i < libraries; i++) {
+        if (paths[i]) {
+            unlink(paths[i]);
+            free(paths[i]);
+        }
+    }
+    free(paths);
+    free(modules);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t classes = argc > 1 ? (uint32_t)atol(argv[1]) : DEFAULT_CLASSES;
+    uint32_t methods = argc > 2 ? (uint32_t)atol(argv[2]) : DEFAULT_METHODS;
+    uint32_t fields = argc > 3 ? (uint32_t)atol(argv[3]) : DEFAULT_FIELDS;
+    uint32_t rounds = argc > 4 ? (uint32_t)atol(argv[4]) : DEFAULT_ROUNDS;
+    uint32_t libraries = argc > 5 ? (uint32_t)atol(argv[5]) : DEFAULT_LIBRARIES;
+    if (classes == 0 || rounds == 0 || libraries == 0) {
+        fprintf(stderr, "Usage: %s [classes] [methods-per-class] [fields-per-class] [rounds] [libraries]\n", argv[0]);
+        return 1;
+    }
+
+    printf("He³ Module Link Benchmark\n");
+    printf("=========================\n");
+    printf("Classes: %u, methods each: %u, fields each: %u, rounds: %u\n\n", classes, methods, fields, rounds);
+
+    // The same module saved without and with its link index
+    char plain_path[64];
+    char indexed_path[64];
+    snprintf(plain_path, sizeof(plain_path), "/tmp/he3_link_benchmark_%d.helium3", (int)getpid());
+    snprintf(indexed_path, sizeof(indexed_path), "/tmp/he3_link_benchmark_%d_indexed.helium3", (int)getpid());
+    HeliumModule* module = make_module(classes, methods, fields);
+    bool saved = helium_module_save(module, plain_path);
+    double start = now_us();
+    saved = saved && helium_module_build_link_index(module);
+    double build_us = now_us() - start;
+    uint32_t index_size = module->link_index_size;
+    saved = saved && helium_module_save(module, indexed_path);
+    helium_module_destroy(module);
+    if (!saved) {
+        fprintf(stderr, "Failed to save the benchmark modules\n");
+        unlink(plain_path);
+        unlink(indexed_path);
+        return 1;
+    }
+    printf("Index build:         %8.1f ms  (%u bytes, once at packaging)\n\n", build_us / 1e3, index_size);
+
+    LinkTiming plain;
+    LinkTiming indexed;
+    bool ok = time_module(plain_path, rounds, &plain) && time_module(indexed_path, rounds, &indexed);
+    unlink(plain_path);
+    unlink(indexed_path);
+    if (!ok) {
+        fprintf(stderr, "Failed to load the benchmark modules\n");
+        return 1;
+    }
+
+    printf("                       discovery    link index\n");
+    printf("Load:                %8.2f ms  %8.2f ms\n", plain.load_us / 1e3, indexed.load_us / 1e3);
+    printf("Register:            %8.2f ms  %8.2f ms\n", plain.register_us / 1e3, indexed.register_us / 1e3);
+    printf("Startup:             %8.2f ms  %8.2f ms  (%.1fx)\n",
+           (plain.load_us + plain.register_us) / 1e3, (indexed.load_us + indexed.register_us) / 1e3,
+           (plain.load_us + plain.register_us) / (indexed.load_us + indexed.register_us));
+    printf("Member lookup:       %8.1f ns  %8.1f ns\n",
+           plain.lookup_us * 1e3 / plain.lookups, indexed.lookup_us * 1e3 / indexed.lookups);
+    
+    return time_parallel_load(classes, methods, fields, libraries) ? 0 : 1;
+}
@@ -1,14 +1,190 @@
 #include "module_registry.h"
 #include "../objects/object.h"
+#include "../objects/string_object.h"
+#include "../../shared/bytecode/opcodes.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 // Global registries
 ModuleRegistry* g_module_registry = NULL;
-ClassRegistryEntry* g_class_registry = NULL;
-MethodRegistryEntry* g_method_registry = NULL;
-FieldRegistryEntry* g_field_registry = NULL;
+
+// Class, method and field entries by global ID and by name
+static RegistryIndex g_class_index;
+static RegistryIndex g_method_index;
+static RegistryIndex g_field_index;
+static RegistryNameMap g_class_names = { NULL, 0, 0, offsetof(ClassRegistryEntry, name_hash), offsetof(ClassRegistryEntry, name_next) };
+static RegistryNameMap g_method_names = { NULL, 0, 0, offsetof(MethodRegistryEntry, name_hash), offsetof(MethodRegistryEntry, name_next) };
+static RegistryNameMap g_field_names = { NULL, 0, 0, offsetof(FieldRegistryEntry, name_hash), offsetof(FieldRegistryEntry, name_next) };
+
+// Method names are resolved lazily, so the method name map is only built by
+// the first lookup by name
+static bool g_method_names_ready = false;
+
+// Module-local ID maps are bounded so a corrupt ID cannot request a huge map
+#define REGISTRY_MAX_SPARSE_IDS 4096
+
+// Storage for the global registries: entries, their Method/Field info and
+// names are never removed one at a time, so they live in pools released
+// together by module_registry_cleanup
+static SlabPool g_class_entry_pool;
+static SlabPool g_method_entry_pool;
+static SlabPool g_field_entry_pool;
+static SlabPool g_method_info_pool;
+static SlabPool g_field_info_pool;
+static Arena g_registry_names;
+static bool g_registry_pools_ready = false;
+
+// Methods registered as stubs, and how many of them have been materialized
+static uint32_t g_method_count = 0;
+static uint32_t g_methods_materialized = 0;
+
+static void registry_pools_init(void) {
+    if (g_registry_pools_ready) return;
+    slab_pool_init(&g_class_entry_pool, sizeof(ClassRegistryEntry), 0);
+    slab_pool_init(&g_method_entry_pool, sizeof(MethodRegistryEntry), 0);
+    slab_pool_init(&g_field_entry_pool, sizeof(FieldRegistryEntry), 0);
+    slab_pool_init(&g_method_info_pool, sizeof(Method), 0);
+    slab_pool_init(&g_field_info_pool, sizeof(Field), 0);
+    arena_init(&g_registry_names, 0);
+    g_registry_pools_ready = true;
+}
+
+// Assign the next global ID to an entry (NULL reserves the ID); 0 on failure
+static uint32_t registry_index_add(RegistryIndex* index, void* entry) {
+    if (index->next_id == 0) {
+        index->next_id = 1;
+    }
+    
+    if (index->next_id >= index->capacity) {
+        uint32_t capacity = index->capacity ? index->capacity * 2 : 64;
+        void** entries = realloc(index->entries, capacity * sizeof(void*));
+        if (!entries) {
+            return 0;
+        }
+        memset(entries + index->capacity, 0, (capacity - index->capacity) * sizeof(void*));
+        index->entries = entries;
+        index->capacity = capacity;
+    }
+    
+    index->entries[index->next_id] = entry;
+    return index->next_id++;
+}
+
+static void* registry_index_get(const RegistryIndex* index, uint32_t global_id) {
+    if (global_id == 0 || global_id >= index->next_id) {
+        return NULL;
+    }
+    return index->entries[global_id];
+}
+
+static void registry_index_destroy(RegistryIndex* index) {
+    free(index->entries);
+    index->entries = NULL;
+    index->next_id = 0;
+    index->capacity = 0;
+}
+
+#define REGISTRY_NAME_HASH(map, entry) (*(uint32_t*)((char*)(entry) + (map)->hash_offset))
+#define REGISTRY_NAME_LINK(map, entry) (*(void**)((char*)(entry) + (map)->link_offset))
+
+// Same hash as the link index records, so their hashes can be used as is
+static uint32_t registry_name_hash(const char* name) {
+    return string_hash(name);
+}
+
+// Add an entry at the head of its chain, doubling the buckets at load factor 1
+static bool registry_name_map_insert(RegistryNameMap* map, void* entry, uint32_t hash) {
+    if (map->count >= map->bucket_count) {
+        uint32_t bucket_count = map->bucket_count ? map->bucket_count * 2 : 64;
+        void** buckets = calloc(bucket_count, sizeof(void*));
+        if (!buckets) {
+            return false;
+        }
+        
+        for (uint32_t i = 0; i < map->bucket_count; i++) {
+            void* current = map->buckets[i];
+            while (current) {
+                void* next = REGISTRY_NAME_LINK(map, current);
+                uint32_t bucket = REGISTRY_NAME_HASH(map, current) & (bucket_count - 1);
+                REGISTRY_NAME_LINK(map, current) = buckets[bucket];
+                buckets[bucket] = current;
+                current = next;
+            }
+        }
+        free(map->buckets);
+        map->buckets = buckets;
+        map->bucket_count = bucket_count;
+    }
+    
+    uint32_t bucket = hash & (map->bucket_count - 1);
+    REGISTRY_NAME_HASH(map, entry) = hash;
+    REGISTRY_NAME_LINK(map, entry) = map->buckets[bucket];
+    map->buckets[bucket] = entry;
+    map->count++;
+    return true;
+}
+
+// First entry of the chain a name hash falls in
+static void* registry_name_map_chain(const RegistryNameMap* map, uint32_t hash) {
+    if (map->bucket_count == 0) {
+        return NULL;
+    }
+    return map->buckets[hash & (map->bucket_count - 1)];
+}
+
+static void registry_name_map_destroy(RegistryNameMap* map) {
+    free(map->buckets);
+    map->buckets = NULL;
+    map->bucket_count = 0;
+    map->count = 0;
+}
+
+// Module-local ID -> global ID map covering IDs 0..max_id, all unmapped
+static uint32_t* module_registry_create_id_map(ModuleRegistry* registry, uint32_t max_id, uint32_t count) {
+    if (max_id > count + REGISTRY_MAX_SPARSE_IDS) {
+        printf("Module IDs too sparse (largest %u for %u entries)\n", max_id, count);
+        return NULL;
+    }
+    
+    size_t size = ((size_t)max_id + 1) * sizeof(uint32_t);
+    uint32_t* map = arena_alloc(&registry->names, size);
+    if (map) {
+        memset(map, 0, size);
+    }
+    return map;
+}
+
+// Global ID of a type the module refers to by its own ID; 0 if unknown
+static uint32_t module_registry_global_type_id(ModuleEntry* module, uint32_t type_id) {
+    if (!module->type_ids || type_id > module->max_type_id) {
+        return 0;
+    }
+    return module->type_ids[type_id];
+}
+
+// Module name without directory and extension, copied into the registry's arena
+static char* module_registry_copy_name(ModuleRegistry* registry, const char* filename) {
+    const char* basename = strrchr(filename, '/');
+    if (basename) {
+        basename++;
+    } else {
+        basename = filename;
+    }
+    
+    char* module_name = arena_strdup(&registry->names, basename);
+    if (!module_name) {
+        return NULL;
+    }
+    
+    // Remove extension
+    char* dot = strrchr(module_name, '.');
+    if (dot) {
+        *dot = '\0';
+    }
+    return module_name;
+}
 
 // Module registry functions
 ModuleRegistry* module_registry_create(void) {
@@ -20,6 +196,8 @@ ModuleRegistry* module_registry_create(void) {
     registry->modules = NULL;
     registry->next_module_id = 1;
     registry->module_count = 0;
+    slab_pool_init(&registry->entry_pool, sizeof(ModuleEntry), 16);
+    arena_init(&registry->names, 1024);
     
     return registry;
 }
@@ -27,54 +205,28 @@ ModuleRegistry* module_registry_create(void) {
 void module_registry_destroy(ModuleRegistry* registry) {
     if (!registry) return;
     
-    ModuleEntry* current = registry->modules;
-    while (current) {
-        ModuleEntry* next = current->next;
-        
-        if (current->module_name) free(current->module_name);
-        if (current->module_version) free(current->module_version);
-        // Don't destroy helium_module here as it might be in use by the VM
-        // The VM will handle its own module cleanup
-        // if (current->helium_module) helium_module_destroy(current->helium_module);
-        // Don't destroy bytecode_file here as it might be in use by the VM
-        // The VM will handle its own bytecode file cleanup
-        
-        free(current);
-        current = next;
-    }
+    // Entries and their names are released with the pools. The helium
+    // modules and bytecode files are not destroyed here as they might be in
+    // use by the VM, which handles its own module cleanup.
+    slab_pool_destroy(&registry->entry_pool);
+    arena_destroy(&registry->names);
     
     free(registry);
 }
 
-bool module_registry_register_module(ModuleRegistry* registry, const char* filename, HeliumModule* module) {
+ModuleEntry* module_registry_add_module(ModuleRegistry* registry, const char* filename, HeliumModule* module) {
     if (!registry || !filename || !module) {
-        return false;
-    }
-    
-    ModuleEntry* entry = malloc(sizeof(ModuleEntry));
-    if (!entry) {
-        return false;
-    }
-    
-    // Extract module name from filename
-    const char* basename = strrchr(filename, '/');
-    if (basename) {
-        basename++;
-    } else {
-        basename = filename;
+        return NULL;
     }
     
-    // Remove extension
-    char* module_name = malloc(strlen(basename) + 1);
+    char* module_name = module_registry_copy_name(registry, filename);
     if (!module_name) {
-        free(entry);
-        return false;
+        return NULL;
     }
     
-    strcpy(module_name, basename);
-    char* dot = strrchr(module_name, '.');
-    if (dot) {
-        *dot = '\0';
+    ModuleEntry* entry = slab_pool_alloc(&registry->entry_pool);
+    if (!entry) {
+        return NULL;
     }
     
     entry->module_name = module_name;
@@ -82,14 +234,20 @@ bool module_registry_register_module(ModuleRegistry* registry, const char* filen
     // Handle null module version gracefully
     const char* version_str = helium_module_get_string(module, module->header.module_version_offset);
     if (version_str) {
-        entry->module_version = strdup(version_str);
+        entry->module_version = arena_strdup(&registry->names, version_str);
     } else {
-        entry->module_version = strdup("1.0.0"); // Default version
+        entry->module_version = arena_strdup(&registry->names, "1.0.0"); // Default version
     }
     
     entry->module_id = registry->next_module_id++;
     entry->helium_module = module;
     entry->bytecode_file = NULL;
+    entry->type_ids = NULL;
+    entry->max_type_id = 0;
+    entry->method_ids = NULL;
+    entry->max_method_id = 0;
+    entry->field_ids = NULL;
+    entry->max_field_id = 0;
     entry->next = registry->modules;
     
     registry->modules = entry;
@@ -98,7 +256,20 @@ bool module_registry_register_module(ModuleRegistry* registry, const char* filen
     // Debug output controlled by VM debug flag
     // printf("Registered module: %s (ID: %u)\n", module_name, entry->module_id);
     
-    // Discover classes, methods, and fields from this module
+    return entry;
+}
+
+bool module_registry_register_module(ModuleRegistry* registry, const char* filename, HeliumModule* module) {
+    ModuleEntry* entry = module_registry_add_module(registry, filename, module);
+    if (!entry) {
+        return false;
+    }
+    
+    // A link index gives the tables already grouped and hashed; otherwise
+    // discover classes, methods, and fields from this module
+    if (module->link_index) {
+        return module_registry_adopt_link_index(registry, entry);
+    }
     module_registry_discover_classes_from_module(registry, entry->module_id);
     module_registry_discover_methods_from_module(registry, entry->module_id);
     module_registry_discover_fields_from_module(registry, entry->module_id);
@@ -111,37 +282,27 @@ bool module_registry_register_bytecode(ModuleRegistry* registry, const char* fil
         return false;
     }
     
-    ModuleEntry* entry = malloc(sizeof(ModuleEntry));
-    if (!entry) {
-        return false;
-    }
-    
-    // Extract module name from filename
-    const char* basename = strrchr(filename, '/');
-    if (basename) {
-        basename++;
-    } else {
-        basename = filename;
-    }
-    
-    // Remove extension
-    char* module_name = malloc(strlen(basename) + 1);
+    char* module_name = module_registry_copy_name(registry, filename);
     if (!module_name) {
-        free(entry);
         return false;
     }
     
-    strcpy(module_name, basename);
-    char* dot = strrchr(module_name, '.');
-    if (dot) {
-        *dot = '\0';
+    ModuleEntry* entry = slab_pool_alloc(&registry->entry_pool);
+    if (!entry) {
+        return false;
     }
     
     entry->module_name = module_name;
-    entry->module_version = strdup("1.0.0"); // Default version for bytecode files
+    entry->module_version = arena_strdup(&registry->names, "1.0.0"); // Default version for bytecode files
     entry->module_id = registry->next_module_id++;
     entry->helium_module = NULL;
     entry->bytecode_file = file;
+    entry->type_ids = NULL;
+    entry->max_type_id = 0;
+    entry->method_ids = NULL;
+    entry->max_method_id = 0;
+    entry->field_ids = NULL;
+    entry->max_field_id = 0;
     entry->next = registry->modules;
     
     registry->modules = entry;
@@ -207,13 +368,22 @@ void module_registry_print_info(ModuleRegistry* registry) {
 }
 
 // Class registry functions
-bool class_registry_register_class(ClassRegistryEntry* entry) {
-    if (!entry) {
-        return false;
+static bool class_registry_insert(ClassRegistryEntry* entry, uint32_t hash) {
+    
+    // Discovery reserves global type IDs for every type of a module; other
+    // callers get a fresh one
+    if (entry->global_type_id) {
+        g_class_index.entries[entry->global_type_id] = entry;
+    } else {
+        entry->global_type_id = registry_index_add(&g_class_index, entry);
+        if (!entry->global_type_id) {
+            return false;
+        }
     }
     
-    entry->next = g_class_registry;
-    g_class_registry = entry;
+    if (!registry_name_map_insert(&g_class_names, entry, hash)) {
+        return false;
+    }
     
     // Debug output controlled by VM debug flag
     // printf("Registered class: %s (type_id=%u, module_id=%u)\n", 
@@ -222,32 +392,44 @@ bool class_registry_register_class(ClassRegistryEntry* entry) {
     return true;
 }
 
+bool class_registry_register_class(ClassRegistryEntry* entry) {
+    if (!entry) {
+        return false;
+    }
+    return class_registry_insert(entry, registry_name_hash(entry->class_name));
+}
+
 ClassRegistryEntry* class_registry_find_class(const char* class_name) {
     if (!class_name) {
         return NULL;
     }
     
-    ClassRegistryEntry* current = g_class_registry;
-    while (current) {
-        if (strcmp(current->class_name, class_name) == 0) {
-            return current;
+    // The most recently registered class wins, as it did with the old list
+    uint32_t hash = registry_name_hash(class_name);
+    ClassRegistryEntry* found = NULL;
+    for (ClassRegistryEntry* current = registry_name_map_chain(&g_class_names, hash); current; current = current->name_next) {
+        if (current->name_hash == hash && strcmp(current->class_name, class_name) == 0 &&
+            (!found || current->global_type_id > found->global_type_id)) {
+            found = current;
         }
-        current = current->next;
     }
     
-    return NULL;
+    return found;
 }
 
 ClassRegistryEntry* class_registry_find_class_by_id(uint32_t type_id) {
-    ClassRegistryEntry* current = g_class_registry;
-    while (current) {
-        if (current->type_id == type_id) {
-            return current;
-        }
-        current = current->next;
+    return registry_index_get(&g_class_index, type_id);
+}
+
+ClassRegistryEntry* class_registry_find_module_class(ModuleEntry* module, uint32_t type_id) {
+    if (!module) {
+        return class_registry_find_class_by_id(type_id);
     }
     
-    return NULL;
+    if (!module->type_ids || type_id > module->max_type_id) {
+        return NULL;
+    }
+    return class_registry_find_class_by_id(module->type_ids[type_id]);
 }
 
 ClassRegistryEntry* class_registry_find_class_by_name_and_module(const char* class_name, uint32_t module_id) {
@@ -255,12 +437,12 @@ ClassRegistryEntry* class_registry_find_class_by_name_and_module(const char* cla
         return NULL;
     }
     
-    ClassRegistryEntry* current = g_class_registry;
-    while (current) {
-        if (strcmp(current->class_name, class_name) == 0 && current->module_id == module_id) {
+    uint32_t hash = registry_name_hash(class_name);
+    for (ClassRegistryEntry* current = registry_name_map_chain(&g_class_names, hash); current; current = current->name_next) {
+        if (current->name_hash == hash && current->module_id == module_id &&
+            strcmp(current->class_name, class_name) == 0) {
             return current;
         }
-        current = current->next;
     }
     
     return NULL;
@@ -270,11 +452,13 @@ void class_registry_print_info(void) {
     printf("=== Class Registry ===\n");
     
     int count = 0;
-    ClassRegistryEntry* current = g_class_registry;
-    while (current) {
-        printf("Class %d: %s (type_id=%u, module_id=%u)\n", 
-               count++, current->class_name, current->type_id, current->module_id);
-        current = current->next;
+    for (uint32_t id = 1; id < g_class_index.next_id; id++) {
+        ClassRegistryEntry* current = g_class_index.entries[id];
+        if (!current) {
+            continue;
+        }
+        printf("Class %d: %s (type_id=%u, global_type_id=%u, module_id=%u)\n", 
+               count++, current->class_name, current->type_id, current->global_type_id, current->module_id);
     }
     
     printf("Total classes: %d\n", count);
@@ -286,8 +470,18 @@ bool method_registry_register_method(MethodRegistryEntry* entry) {
         return false;
     }
     
-    entry->next = g_method_registry;
-    g_method_registry = entry;
+    entry->global_id = registry_index_add(&g_method_index, entry);
+    if (!entry->global_id) {
+        return false;
+    }
+    
+    // Once the name map exists it is kept up to date, which resolves the name
+    if (g_method_names_ready) {
+        const char* name = method_registry_entry_name(entry);
+        if (name) {
+            registry_name_map_insert(&g_method_names, entry, registry_name_hash(name));
+        }
+    }
     
     // Debug output controlled by VM debug flag
     // printf("Registered method: %s (method_id=%u, type_id=%u, module_id=%u)\n", 
@@ -296,32 +490,200 @@ bool method_registry_register_method(MethodRegistryEntry* entry) {
     return true;
 }
 
+// String of the module that owns a method, straight from its string table
+static const char* method_registry_module_string(ModuleEntry* module, uint32_t offset) {
+    if (module->helium_module) {
+        return helium_module_get_string(module->helium_module, offset);
+    }
+    if (module->bytecode_file) {
+        return string_table_get_string(module->bytecode_file->string_table, offset);
+    }
+    return NULL;
+}
+
+// Method table entry a stub was registered for
+static const MethodEntry* method_registry_entry_record(MethodRegistryEntry* entry) {
+    MethodTable* method_table = NULL;
+    if (entry->module->helium_module) {
+        method_table = entry->module->helium_module->method_table;
+    } else if (entry->module->bytecode_file) {
+        method_table = entry->module->bytecode_file->method_table;
+    }
+    
+    if (!method_table || entry->method_index >= method_table->count) {
+        return NULL;
+    }
+    return &method_table->entries[entry->method_index];
+}
+
+const char* method_registry_entry_name(MethodRegistryEntry* entry) {
+    if (!entry) {
+        return NULL;
+    }
+    
+    // Names point into the module's string data, which outlives the entry
+    if (!entry->method_name) {
+        const MethodEntry* record = method_registry_entry_record(entry);
+        if (record) {
+            entry->method_name = method_registry_module_string(entry->module, record->name_offset);
+        }
+    }
+    return entry->method_name;
+}
+
+const char* method_registry_entry_signature(MethodRegistryEntry* entry) {
+    if (!entry) {
+        return NULL;
+    }
+    
+    if (!entry->signature) {
+        const MethodEntry* record = method_registry_entry_record(entry);
+        if (record) {
+            entry->signature = method_registry_module_string(entry->module, record->signature_offset);
+        }
+    }
+    return entry->signature;
+}
+
+Method* method_registry_materialize(MethodRegistryEntry* entry) {
+    if (!entry) {
+        return NULL;
+    }
+    
+    if (entry->method_info) {
+        return entry->method_info;
+    }
+    
+    const MethodEntry* record = method_registry_entry_record(entry);
+    const char* method_name = method_registry_entry_name(entry);
+    if (!record || !method_name) {
+        return NULL;
+    }
+    
+    // Locate the method's bytecode in its module and verify it before the
+    // first call: the range must lie inside the module and every instruction
+    // must be complete
+    uint8_t* bytecode = NULL;
+    if (record->bytecode_size > 0) {
+        uint8_t* module_bytecode = NULL;
+        size_t module_bytecode_size = 0;
+        if (entry->module->helium_module) {
+            module_bytecode = entry->module->helium_module->bytecode;
+            module_bytecode_size = entry->module->helium_module->bytecode_size;
+        } else if (entry->module->bytecode_file) {
+            module_bytecode = entry->module->bytecode_file->bytecode;
+            module_bytecode_size = entry->module->bytecode_file->bytecode_size;
+        }
+        
+        if (!module_bytecode ||
+            (uint64_t)record->bytecode_offset + record->bytecode_size > module_bytecode_size) {
+            printf("Runtime error: Bytecode of method %s is out of bounds\n", method_name);
+            return NULL;
+        }
+        bytecode = module_bytecode + record->bytecode_offset;
+        
+        if (!opcode_validate_all(bytecode, record->bytecode_size)) {
+            printf("Runtime error: Bytecode of method %s is invalid\n", method_name);
+            return NULL;
+        }
+    }
+    
+    registry_pools_init();
+    Method* method_info = slab_pool_alloc(&g_method_info_pool);
+    if (!method_info) {
+        return NULL;
+    }
+    
+    // The Method shares the module's strings and bytecode; neither is
+    // written through it
+    method_info->name = (char*)method_name;
+    method_info->signature = (char*)method_registry_entry_signature(entry);
+    method_info->bytecode = bytecode;
+    method_info->bytecode_size = bytecode ? record->bytecode_size : 0;
+    method_info->local_count = record->local_count;
+    method_info->param_count = record->param_count;
+    method_info->is_static = (record->flags & METHOD_FLAG_STATIC) != 0;
+    method_info->is_virtual = (record->flags & METHOD_FLAG_VIRTUAL) != 0;
+    method_info->is_abstract = (record->flags & METHOD_FLAG_ABSTRACT) != 0;
+    // Method records have no visibility flags; every method is public
+    method_info->is_private = false;
+    method_info->is_protected = false;
+    method_info->is_public = true;
+    method_info->next = NULL;
+    
+    entry->method_info = method_info;
+    g_methods_materialized++;
+    return method_info;
+}
+
+uint32_t method_registry_materialized_count(void) {
+    return g_methods_materialized;
+}
+
+uint32_t method_registry_method_count(void) {
+    return g_method_count;
+}
+
+uint32_t class_registry_id_count(void) {
+    return g_class_index.next_id;
+}
+
+uint32_t method_registry_id_count(void) {
+    return g_method_index.next_id;
+}
+
+uint32_t field_registry_id_count(void) {
+    return g_field_index.next_id;
+}
+
+// Build the method name map on the first lookup by name
+static void method_registry_index_names(void) {
+    if (g_method_names_ready) {
+        return;
+    }
+    
+    for (uint32_t id = 1; id < g_method_index.next_id; id++) {
+        MethodRegistryEntry* entry = g_method_index.entries[id];
+        const char* name = entry ? method_registry_entry_name(entry) : NULL;
+        if (name) {
+            registry_name_map_insert(&g_method_names, entry, registry_name_hash(name));
+        }
+    }
+    g_method_names_ready = true;
+}
+
 MethodRegistryEntry* method_registry_find_method(const char* method_name) {
     if (!method_name) {
         return NULL;
     }
     
-    MethodRegistryEntry* current = g_method_registry;
-    while (current) {
-        if (strcmp(current->method_name, method_name) == 0) {
-            return current;
+    // The most recently registered method wins, as it did with the old list
+    method_registry_index_names();
+    uint32_t hash = registry_name_hash(method_name);
+    MethodRegistryEntry* found = NULL;
+    for (MethodRegistryEntry* current = registry_name_map_chain(&g_method_names, hash); current; current = current->name_next) {
+        if (current->name_hash == hash && strcmp(current->method_name, method_name) == 0 &&
+            (!found || current->global_id > found->global_id)) {
+            found = current;
         }
-        current = current->next;
     }
     
-    return NULL;
+    return found;
 }
 
 MethodRegistryEntry* method_registry_find_method_by_id(uint32_t method_id) {
-    MethodRegistryEntry* current = g_method_registry;
-    while (current) {
-        if (current->method_id == method_id) {
-            return current;
-        }
-        current = current->next;
+    return registry_index_get(&g_method_index, method_id);
+}
+
+MethodRegistryEntry* method_registry_find_module_method(ModuleEntry* module, uint32_t method_id) {
+    if (!module) {
+        return method_registry_find_method_by_id(method_id);
     }
     
-    return NULL;
+    if (!module->method_ids || method_id > module->max_method_id) {
+        return NULL;
+    }
+    return method_registry_find_method_by_id(module->method_ids[method_id]);
 }
 
 MethodRegistryEntry* method_registry_find_method_by_name_and_type(const char* method_name, uint32_t type_id) {
@@ -329,42 +691,78 @@ MethodRegistryEntry* method_registry_find_method_by_name_and_type(const char* me
         return NULL;
     }
     
-    MethodRegistryEntry* current = g_method_registry;
-    while (current) {
-        if (strcmp(current->method_name, method_name) == 0 && current->type_id == type_id) {
-            return current;
+    // Classes adopted from a link index own a contiguous range of method
+    // IDs whose name hashes are known, so only the class's methods are
+    // compared and no name map is needed
+    uint32_t hash = registry_name_hash(method_name);
+    ClassRegistryEntry* class_entry = class_registry_find_class_by_id(type_id);
+    if (class_entry && class_entry->first_method_id) {
+        for (uint32_t i = class_entry->method_count; i > 0; i--) {
+            MethodRegistryEntry* current = registry_index_get(&g_method_index, class_entry->first_method_id + i - 1);
+            if (current && current->name_hash == hash && current->global_type_id == type_id) {
+                const char* name = method_registry_entry_name(current);
+                if (name && strcmp(name, method_name) == 0) {
+                    return current;
+                }
+            }
         }
-        current = current->next;
+        return NULL;
     }
     
-    return NULL;
+    method_registry_index_names();
+    MethodRegistryEntry* found = NULL;
+    for (MethodRegistryEntry* current = registry_name_map_chain(&g_method_names, hash); current; current = current->name_next) {
+        if (current->name_hash == hash && current->global_type_id == type_id &&
+            strcmp(current->method_name, method_name) == 0 &&
+            (!found || current->global_id > found->global_id)) {
+            found = current;
+        }
+    }
+    
+    return found;
 }
 
 void method_registry_print_info(void) {
     printf("=== Method Registry ===\n");
     
     int count = 0;
-    MethodRegistryEntry* current = g_method_registry;
-    while (current) {
-        printf("Method %d: %s (method_id=%u, type_id=%u, module_id=%u)\n", 
-               count++, current->method_name, current->method_id, current->type_id, current->module_id);
-        current = current->next;
+    for (uint32_t id = 1; id < g_method_index.next_id; id++) {
+        MethodRegistryEntry* current = g_method_index.entries[id];
+        if (!current) {
+            continue;
+        }
+        const char* name = method_registry_entry_name(current);
+        printf("Method %d: %s (method_id=%u, global_id=%u, type_id=%u, module_id=%u)\n", 
+               count++, name ? name : "NULL", current->method_id, current->global_id, current->type_id, current->module_id);
     }
     
     printf("Total methods: %d\n", count);
 }
 
+void method_registry_print_stats(void) {
+    printf("=== Method Linking ===\n");
+    printf("Methods registered: %u\n", g_method_count);
+    printf("Methods materialized: %u\n", g_methods_materialized);
+}
+
 // Field registry functions
 bool field_registry_register_field(FieldRegistryEntry* entry) {
     if (!entry) {
         return false;
     }
     
-    entry->next = g_field_registry;
-    g_field_registry = entry;
+    entry->global_id = registry_index_add(&g_field_index, entry);
+    if (!entry->global_id) {
+        return false;
+    }
     
-    printf("Registered field: %s (field_id=%u, type_id=%u, module_id=%u)\n", 
-           entry->field_name, entry->field_id, entry->type_id, entry->module_id);
+    if (!registry_name_map_insert(&g_field_names, entry, registry_name_hash(entry->field_name))) {
+        return false;
+    }
+    
+    // Debug output controlled by VM debug flag
+    // printf("Registered field: %s (field_id=%u, type_id=%u, module_id=%u)\n", 
+    //        entry->field_name, entry->field_id, entry->type_id, entry->module_id);
     
     return true;
 }
@@ -374,27 +772,32 @@ FieldRegistryEntry* field_registry_find_field(const char* field_name) {
         return NULL;
     }
     
-    FieldRegistryEntry* current = g_field_registry;
-    while (current) {
-        if (strcmp(current->field_name, field_name) == 0) {
-            return current;
+    // The most recently registered field wins, as it did with the old list
+    uint32_t hash = registry_name_hash(field_name);
+    FieldRegistryEntry* found = NULL;
+    for (FieldRegistryEntry* current = registry_name_map_chain(&g_field_names, hash); current; current = current->name_next) {
+        if (current->name_hash == hash && strcmp(current->field_name, field_name) == 0 &&
+            (!found || current->global_id > found->global_id)) {
+            found = current;
         }
-        current = current->next;
     }
     
-    return NULL;
+    return found;
 }
 
 FieldRegistryEntry* field_registry_find_field_by_id(uint32_t field_id) {
-    FieldRegistryEntry* current = g_field_registry;
-    while (current) {
-        if (current->field_id == field_id) {
-            return current;
-        }
-        current = current->next;
+    return registry_index_get(&g_field_index, field_id);
+}
+
+FieldRegistryEntry* field_registry_find_module_field(ModuleEntry* module, uint32_t field_id) {
+    if (!module) {
+        return field_registry_find_field_by_id(field_id);
     }
     
-    return NULL;
+    if (!module->field_ids || field_id > module->max_field_id) {
+        return NULL;
+    }
+    return field_registry_find_field_by_id(module->field_ids[field_id]);
 }
 
 FieldRegistryEntry* field_registry_find_field_by_name_and_type(const char* field_name, uint32_t type_id) {
@@ -402,26 +805,43 @@ FieldRegistryEntry* field_registry_find_field_by_name_and_type(const char* field
         return NULL;
     }
     
-    FieldRegistryEntry* current = g_field_registry;
-    while (current) {
-        if (strcmp(current->field_name, field_name) == 0 && current->type_id == type_id) {
-            return current;
+    // Classes adopted from a link index own a contiguous range of field IDs
+    uint32_t hash = registry_name_hash(field_name);
+    ClassRegistryEntry* class_entry = class_registry_find_class_by_id(type_id);
+    if (class_entry && class_entry->first_field_id) {
+        for (uint32_t i = class_entry->field_count; i > 0; i--) {
+            FieldRegistryEntry* current = registry_index_get(&g_field_index, class_entry->first_field_id + i - 1);
+            if (current && current->name_hash == hash && current->global_type_id == type_id &&
+                strcmp(current->field_name, field_name) == 0) {
+                return current;
+            }
         }
-        current = current->next;
+        return NULL;
     }
     
-    return NULL;
+    FieldRegistryEntry* found = NULL;
+    for (FieldRegistryEntry* current = registry_name_map_chain(&g_field_names, hash); current; current = current->name_next) {
+        if (current->name_hash == hash && current->global_type_id == type_id &&
+            strcmp(current->field_name, field_name) == 0 &&
+            (!found || current->global_id > found->global_id)) {
+            found = current;
+        }
+    }
+    
+    return found;
 }
 
 void field_registry_print_info(void) {
     printf("=== Field Registry ===\n");
     
     int count = 0;
-    FieldRegistryEntry* current = g_field_registry;
-    while (current) {
-        printf("Field %d: %s (field_id=%u, type_id=%u, module_id=%u)\n", 
-               count++, current->field_name, current->field_id, current->type_id, current->module_id);
-        current = current->next;
+    for (uint32_t id = 1; id < g_field_index.next_id; id++) {
+        FieldRegistryEntry* current = g_field_index.entries[id];
+        if (!current) {
+            continue;
+        }
+        printf("Field %d: %s (field_id=%u, global_id=%u, type_id=%u, module_id=%u)\n", 
+               count++, current->field_name, current->field_id, current->global_id, current->type_id, current->module_id);
     }
     
     printf("Total fields: %d\n", count);
@@ -442,6 +862,87 @@ bool module_registry_load_helium3_module(ModuleRegistry* registry, const char* f
     return result;
 }
 
+// Parallel module loading - every file is mapped, validated and given a
+// link index on its own, so workers take the next file from a shared
+// counter. Registration hands out global IDs and stays on the caller.
+typedef struct ModuleLoadJobs {
+    const char* const* filenames;
+    HeliumModule** modules;         // Loaded module per file (NULL = failed)
+    uint32_t count;
+    uint32_t next;                  // Next file to load (atomic)
+} ModuleLoadJobs;
+
+static void* module_load_worker_main(void* arg) {
+    ModuleLoadJobs* jobs = (ModuleLoadJobs*)arg;
+    uint32_t i;
+    while ((i = __atomic_fetch_add(&jobs->next, 1, __ATOMIC_RELAXED)) < jobs->count) {
+        HeliumModule* module = helium_module_load(jobs->filenames[i]);
+        // Grouping and hashing the tables here leaves registration an
+        // adoption; a module the index cannot describe is discovered instead
+        if (module && !module->link_index) {
+            helium_module_build_link_index(module);
+        }
+        jobs->modules[i] = module;
+    }
+    return NULL;
+}
+
+bool module_registry_load_helium3_modules(ModuleRegistry* registry, const char* const* filenames,
+                                          HeliumModule** modules, uint32_t count, uint32_t threads) {
+    if (!registry || (count > 0 && (!filenames || !modules))) {
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+    
+    memset(modules, 0, count * sizeof(HeliumModule*));
+    ModuleLoadJobs jobs = { filenames, modules, count, 0 };
+    
+    // Load on up to `threads` threads; worker 0 runs on the caller, and one
+    // that fails to start leaves its files to the others
+    if (threads > count) threads = count;
+    if (threads == 0) threads = 1;
+    pthread_t* workers = calloc(threads, sizeof(pthread_t));
+    bool* started = calloc(threads, sizeof(bool));
+    for (uint32_t i = 1; i < threads && workers && started; i++) {
+        started[i] = pthread_create(&workers[i], NULL, module_load_worker_main, &jobs) == 0;
+    }
+    module_load_worker_main(&jobs);
+    for (uint32_t i = 1; i < threads && workers && started; i++) {
+        if (started[i]) {
+            pthread_join(workers[i], NULL);
+        }
+    }
+    free(started);
+    free(workers);
+    
+    // Merge: register in the order given, so IDs do not depend on which
+    // file finished first. A missing module fails the whole set first.
+    bool loaded = true;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!modules[i]) {
+            fprintf(stderr, "Failed to load .helium3 module: %s\n", filenames[i]);
+            loaded = false;
+        }
+    }
+    uint32_t registered = 0;
+    while (loaded && registered < count &&
+           module_registry_register_module(registry, filenames[registered], modules[registered])) {
+        registered++;
+    }
+    
+    // A module whose registration failed may already have an entry; the
+    // ones after it were never seen by the registry
+    for (uint32_t i = registered + (loaded && registered < count); i < count; i++) {
+        if (modules[i]) {
+            helium_module_destroy(modules[i]);
+            modules[i] = NULL;
+        }
+    }
+    return registered == count;
+}
+
 bool module_registry_load_bytecode_file(ModuleRegistry* registry, const char* filename) {
     if (!registry || !filename) {
         return false;
@@ -455,6 +956,26 @@ bool module_registry_load_bytecode_file(ModuleRegistry* registry, const char* fi
     return module_registry_register_bytecode(registry, filename, file);
 }
 
+// Field info sharing the entry's name, with its storage and access taken
+// from the field table (fields without an access flag are public)
+static Field* field_registry_create_info(char* name, uint32_t type_id, uint32_t offset, uint32_t size, uint32_t flags) {
+    Field* field_info = slab_pool_alloc(&g_field_info_pool);
+    if (!field_info) {
+        return NULL;
+    }
+    
+    field_info->name = name;
+    field_info->type_id = type_id;
+    field_info->offset = offset;
+    field_info->size = size;
+    field_info->is_static = (flags & FIELD_FLAG_STATIC) != 0;
+    field_info->is_private = (flags & FIELD_FLAG_PRIVATE) != 0;
+    field_info->is_protected = (flags & FIELD_FLAG_PROTECTED) != 0;
+    field_info->is_public = !field_info->is_private && !field_info->is_protected;
+    field_info->next = NULL;
+    return field_info;
+}
+
 bool module_registry_discover_classes_from_module(ModuleRegistry* registry, uint32_t module_id) {
     if (!registry) {
         return false;
@@ -480,10 +1001,30 @@ bool module_registry_discover_classes_from_module(ModuleRegistry* registry, uint
         return false;
     }
     
+    // Every type of the module gets a global type ID, so method and field
+    // owners map even when the owner is not a class
+    uint32_t max_type_id = 0;
+    for (uint32_t i = 0; i < type_table->count; i++) {
+        if (type_table->entries[i].type_id > max_type_id) {
+            max_type_id = type_table->entries[i].type_id;
+        }
+    }
+    module_entry->type_ids = module_registry_create_id_map(registry, max_type_id, type_table->count);
+    if (!module_entry->type_ids) {
+        return false;
+    }
+    module_entry->max_type_id = max_type_id;
+    
     // Register each class from the type table
     for (uint32_t i = 0; i < type_table->count; i++) {
         TypeEntry* type_entry = &type_table->entries[i];
         
+        uint32_t global_type_id = registry_index_add(&g_class_index, NULL);
+        if (!global_type_id) {
+            return false;
+        }
+        module_entry->type_ids[type_entry->type_id] = global_type_id;
+        
         // Only register classes (not interfaces, records, etc.)
         if (!(type_entry->flags & TYPE_FLAG_CLASS)) {
             continue;
@@ -500,16 +1041,22 @@ bool module_registry_discover_classes_from_module(ModuleRegistry* registry, uint
             continue;
         }
         
-        ClassRegistryEntry* class_entry = malloc(sizeof(ClassRegistryEntry));
+        registry_pools_init();
+        ClassRegistryEntry* class_entry = slab_pool_alloc(&g_class_entry_pool);
         if (!class_entry) {
             continue;
         }
         
         class_entry->type_id = type_entry->type_id;
         class_entry->module_id = module_id;
-        class_entry->class_name = strdup(class_name);
+        class_entry->global_type_id = global_type_id;
+        class_entry->class_name = arena_strdup(&g_registry_names, class_name);
         class_entry->class_info = NULL; // Will be created when needed
-        class_entry->next = NULL;
+        class_entry->first_method_id = 0;
+        class_entry->method_count = 0;
+        class_entry->first_field_id = 0;
+        class_entry->field_count = 0;
+        class_entry->name_next = NULL;
         
         class_registry_register_class(class_entry);
     }
@@ -542,26 +1089,26 @@ bool module_registry_discover_methods_from_module(ModuleRegistry* registry, uint
         return false;
     }
     
-    // Register each method from the method table
+    uint32_t max_method_id = 0;
     for (uint32_t i = 0; i < method_table->count; i++) {
-        MethodEntry* method_entry = &method_table->entries[i];
-        
-        // Use offset-based access for helium modules
-        const char* method_name = NULL;
-        const char* signature = NULL;
-        if (module_entry->helium_module) {
-            method_name = helium_module_get_string(module_entry->helium_module, method_entry->name_offset);
-            signature = helium_module_get_string(module_entry->helium_module, method_entry->signature_offset);
-        } else {
-            method_name = string_table_get_string(string_table, method_entry->name_offset);
-            signature = string_table_get_string(string_table, method_entry->signature_offset);
-        }
-        
-        if (!method_name) {
-            continue;
+        if (method_table->entries[i].method_id > max_method_id) {
+            max_method_id = method_table->entries[i].method_id;
         }
+    }
+    module_entry->method_ids = module_registry_create_id_map(registry, max_method_id, method_table->count);
+    if (!module_entry->method_ids) {
+        return false;
+    }
+    module_entry->max_method_id = max_method_id;
+    
+    // Register a stub for each method from the method table. Names, flags
+    // and bytecode are only looked at when the method is first found by name
+    // or called (see method_registry_materialize)
+    for (uint32_t i = 0; i < method_table->count; i++) {
+        MethodEntry* method_entry = &method_table->entries[i];
         
-        MethodRegistryEntry* registry_entry = malloc(sizeof(MethodRegistryEntry));
+        registry_pools_init();
+        MethodRegistryEntry* registry_entry = slab_pool_alloc(&g_method_entry_pool);
         if (!registry_entry) {
             continue;
         }
@@ -569,30 +1116,19 @@ bool module_registry_discover_methods_from_module(ModuleRegistry* registry, uint
         registry_entry->method_id = method_entry->method_id;
         registry_entry->module_id = module_id;
         registry_entry->type_id = method_entry->type_id;
-        registry_entry->method_name = strdup(method_name);
-        registry_entry->signature = signature ? strdup(signature) : NULL;
-        
-        // Create the method info structure
-        Method* method_info = malloc(sizeof(Method));
-        if (method_info) {
-            method_info->name = strdup(method_name);
-            method_info->signature = signature ? strdup(signature) : NULL;
-            method_info->bytecode = NULL; // TODO: Extract bytecode from method entry
-            method_info->bytecode_size = 0; // TODO: Extract bytecode size from method entry
-            method_info->local_count = 0; // TODO: Extract from method entry
-            method_info->param_count = 0; // TODO: Extract from method entry
-            method_info->is_static = false; // TODO: Determine from method flags
-            method_info->is_virtual = false; // TODO: Determine from method flags
-            method_info->is_abstract = false; // TODO: Determine from method flags
-            method_info->is_private = false; // TODO: Determine from method flags
-            method_info->is_protected = false; // TODO: Determine from method flags
-            method_info->is_public = true; // Default to public
-            method_info->next = NULL;
-        }
-        registry_entry->method_info = method_info;
-        registry_entry->next = NULL;
+        registry_entry->global_type_id = module_registry_global_type_id(module_entry, method_entry->type_id);
+        registry_entry->method_name = NULL;
+        registry_entry->signature = NULL;
+        registry_entry->method_info = NULL;
+        registry_entry->module = module_entry;
+        registry_entry->method_index = i;
+        registry_entry->name_hash = 0;
+        registry_entry->name_next = NULL;
         
-        method_registry_register_method(registry_entry);
+        if (method_registry_register_method(registry_entry)) {
+            module_entry->method_ids[method_entry->method_id] = registry_entry->global_id;
+            g_method_count++;
+        }
     }
     
     return true;
@@ -623,6 +1159,18 @@ bool module_registry_discover_fields_from_module(ModuleRegistry* registry, uint3
         return false;
     }
     
+    uint32_t max_field_id = 0;
+    for (uint32_t i = 0; i < field_table->count; i++) {
+        if (field_table->entries[i].field_id > max_field_id) {
+            max_field_id = field_table->entries[i].field_id;
+        }
+    }
+    module_entry->field_ids = module_registry_create_id_map(registry, max_field_id, field_table->count);
+    if (!module_entry->field_ids) {
+        return false;
+    }
+    module_entry->max_field_id = max_field_id;
+    
     // Register each field from the field table
     for (uint32_t i = 0; i < field_table->count; i++) {
         FieldEntry* field_entry = &field_table->entries[i];
@@ -638,7 +1186,8 @@ bool module_registry_discover_fields_from_module(ModuleRegistry* registry, uint3
             continue;
         }
         
-        FieldRegistryEntry* registry_entry = malloc(sizeof(FieldRegistryEntry));
+        registry_pools_init();
+        FieldRegistryEntry* registry_entry = slab_pool_alloc(&g_field_entry_pool);
         if (!registry_entry) {
             continue;
         }
@@ -646,26 +1195,234 @@ bool module_registry_discover_fields_from_module(ModuleRegistry* registry, uint3
         registry_entry->field_id = field_entry->field_id;
         registry_entry->module_id = module_id;
         registry_entry->type_id = field_entry->type_id;
-        registry_entry->field_name = strdup(field_name);
+        registry_entry->global_type_id = module_registry_global_type_id(module_entry, field_entry->type_id);
+        registry_entry->field_name = arena_strdup(&g_registry_names, field_name);
         registry_entry->field_type_id = field_entry->field_type_id;
         
-        // Create the field info structure
-        Field* field_info = malloc(sizeof(Field));
-        if (field_info) {
-            field_info->name = strdup(field_name);
-            field_info->type_id = field_entry->field_type_id;
-            field_info->offset = field_entry->offset; // Use the offset from the field entry
-            field_info->size = 8; // Default size, TODO: Calculate based on type
-            field_info->is_static = false; // TODO: Determine from field flags
-            field_info->is_private = false; // TODO: Determine from field flags
-            field_info->is_protected = false; // TODO: Determine from field flags
-            field_info->is_public = true; // Default to public
-            field_info->next = NULL;
-        }
-        registry_entry->field_info = field_info;
-        registry_entry->next = NULL;
+        registry_entry->field_info = field_registry_create_info(registry_entry->field_name, field_entry->field_type_id,
+                                                                field_entry->offset,
+                                                                helium_field_size(field_entry->field_type_id),
+                                                                field_entry->flags);
+        registry_entry->name_next = NULL;
+        
+        if (field_registry_register_field(registry_entry)) {
+            module_entry->field_ids[field_entry->field_id] = registry_entry->global_id;
+        }
+    }
+    
+    return true;
+}
+
+// Register a module from its link index instead of discovering its tables:
+// the largest IDs size the ID maps without a scan, each type's methods and
+// fields are registered one after another so the class owns a contiguous
+// range of global IDs, and names hash and field storage come from the
+// index. Names point into the module's string data, which outlives the
+// registry entries like the lazily resolved method names do.
+bool module_registry_adopt_link_index(ModuleRegistry* registry, ModuleEntry* module_entry) {
+    if (!registry || !module_entry || !module_entry->helium_module || !module_entry->helium_module->link_index) {
+        return false;
+    }
+    
+    HeliumModule* module = module_entry->helium_module;
+    const HeliumLinkHeader* index = module->link_index;
+    const HeliumLinkType* types = HELIUM_LINK_TYPES(index);
+    const HeliumLinkMember* methods = HELIUM_LINK_METHODS(index);
+    const HeliumLinkField* fields = HELIUM_LINK_FIELDS(index);
+    
+    module_entry->type_ids = module_registry_create_id_map(registry, index->max_type_id, index->type_count);
+    module_entry->method_ids = module_registry_create_id_map(registry, index->max_method_id, index->method_count);
+    module_entry->field_ids = module_registry_create_id_map(registry, index->max_field_id, index->field_count);
+    if (!module_entry->type_ids || !module_entry->method_ids || !module_entry->field_ids) {
+        return false;
+    }
+    module_entry->max_type_id = index->max_type_id;
+    module_entry->max_method_id = index->max_method_id;
+    module_entry->max_field_id = index->max_field_id;
+    registry_pools_init();
+    
+    // Every type gets a global type ID before its members map their owners
+    for (uint32_t i = 0; i < index->type_count; i++) {
+        uint32_t type_id = module->type_table->entries[i].type_id;
+        if (type_id > index->max_type_id) {
+            return false;
+        }
+        module_entry->type_ids[type_id] = registry_index_add(&g_class_index, NULL);
+        if (!module_entry->type_ids[type_id]) {
+            return false;
+        }
+    }
+    
+    // Methods in index order; an entry that cannot be allocated still takes
+    // its ID so the ranges stay contiguous
+    uint32_t method_base = 0;
+    for (uint32_t i = 0; i < index->method_count; i++) {
+        const MethodEntry* method_entry = &module->method_table->entries[methods[i].table_index];
+        if (method_entry->method_id > index->max_method_id) {
+            return false;
+        }
         
-        field_registry_register_field(registry_entry);
+        uint32_t global_id;
+        MethodRegistryEntry* registry_entry = slab_pool_alloc(&g_method_entry_pool);
+        if (registry_entry) {
+            registry_entry->method_id = method_entry->method_id;
+            registry_entry->module_id = module_entry->module_id;
+            registry_entry->type_id = method_entry->type_id;
+            registry_entry->global_type_id = module_registry_global_type_id(module_entry, method_entry->type_id);
+            registry_entry->method_name = NULL;
+            registry_entry->signature = NULL;
+            registry_entry->method_info = NULL;
+            registry_entry->module = module_entry;
+            registry_entry->method_index = methods[i].table_index;
+            registry_entry->name_hash = methods[i].name_hash;
+            registry_entry->name_next = NULL;
+            global_id = method_registry_register_method(registry_entry) ? registry_entry->global_id : 0;
+            g_method_count += global_id != 0;
+        } else {
+            global_id = registry_index_add(&g_method_index, NULL);
+        }
+        if (!global_id) {
+            return false;
+        }
+        if (i == 0) {
+            method_base = global_id;
+        }
+        module_entry->method_ids[method_entry->method_id] = global_id;
+    }
+    
+    // Fields likewise, with their storage from the index
+    uint32_t field_base = 0;
+    for (uint32_t i = 0; i < index->field_count; i++) {
+        const FieldEntry* field_entry = &module->field_table->entries[fields[i].table_index];
+        char* field_name = (char*)helium_module_get_string(module, field_entry->name_offset);
+        if (field_entry->field_id > index->max_field_id) {
+            return false;
+        }
+        
+        uint32_t global_id = 0;
+        FieldRegistryEntry* registry_entry = field_name ? slab_pool_alloc(&g_field_entry_pool) : NULL;
+        if (registry_entry) {
+            registry_entry->field_id = field_entry->field_id;
+            registry_entry->module_id = module_entry->module_id;
+            registry_entry->type_id = field_entry->type_id;
+            registry_entry->global_type_id = module_registry_global_type_id(module_entry, field_entry->type_id);
+            registry_entry->field_name = field_name;
+            registry_entry->field_type_id = field_entry->field_type_id;
+            registry_entry->field_info = field_registry_create_info(field_name, field_entry->field_type_id,
+                                                                    fields[i].offset, fields[i].size, fields[i].flags);
+            registry_entry->name_next = NULL;
+            
+            registry_entry->global_id = registry_index_add(&g_field_index, registry_entry);
+            if (registry_entry->global_id &&
+                registry_name_map_insert(&g_field_names, registry_entry, fields[i].name_hash)) {
+                global_id = registry_entry->global_id;
+            }
+        } else {
+            global_id = registry_index_add(&g_field_index, NULL);
+        }
+        if (!global_id) {
+            return false;
+        }
+        if (i == 0) {
+            field_base = global_id;
+        }
+        if (registry_entry) {
+            module_entry->field_ids[field_entry->field_id] = global_id;
+        }
+    }
+    
+    // Classes, with the ranges their members were registered in
+    for (uint32_t i = 0; i < index->type_count; i++) {
+        const TypeEntry* type_entry = &module->type_table->entries[i];
+        char* class_name = (char*)helium_module_get_string(module, type_entry->name_offset);
+        if (!(type_entry->flags & TYPE_FLAG_CLASS) || !class_name) {
+            continue;
+        }
+        
+        ClassRegistryEntry* class_entry = slab_pool_alloc(&g_class_entry_pool);
+        if (!class_entry) {
+            continue;
+        }
+        
+        class_entry->type_id = type_entry->type_id;
+        class_entry->module_id = module_entry->module_id;
+        class_entry->global_type_id = module_entry->type_ids[type_entry->type_id];
+        class_entry->class_name = class_name;
+        class_entry->class_info = NULL; // Will be created when needed
+        class_entry->first_method_id = types[i].method_count ? method_base + types[i].first_method : 0;
+        class_entry->method_count = types[i].method_count;
+        class_entry->first_field_id = types[i].field_count ? field_base + types[i].first_field : 0;
+        class_entry->field_count = types[i].field_count;
+        class_entry->name_next = NULL;
+        
+        class_registry_insert(class_entry, types[i].name_hash);
+    }
+    
+    return true;
+}
+
+// Reserve global IDs 1..id_count-1 of an empty index
+static bool registry_index_reserve(RegistryIndex* index, uint32_t id_count) {
+    if (index->next_id > 1) {
+        return false;
+    }
+    while (index->next_id < (id_count ? id_count : 1)) {
+        if (!registry_index_add(index, NULL)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Put an entry at its reserved global ID; fails for a used or unknown ID
+static bool registry_index_place(RegistryIndex* index, uint32_t global_id, void* entry) {
+    if (global_id == 0 || global_id >= index->next_id || index->entries[global_id]) {
+        return false;
+    }
+    index->entries[global_id] = entry;
+    return true;
+}
+
+// Install entries saved in a VM image. The entries stay where they are (in
+// the image) and keep the global IDs they were saved with, so the global
+// registries must still be empty; names are indexed by their saved hashes.
+bool module_registry_restore_entries(const RegistryEntries* entries) {
+    if (!entries) {
+        return false;
+    }
+    if (!registry_index_reserve(&g_class_index, entries->class_ids) ||
+        !registry_index_reserve(&g_method_index, entries->method_ids) ||
+        !registry_index_reserve(&g_field_index, entries->field_ids)) {
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < entries->class_count; i++) {
+        ClassRegistryEntry* entry = &entries->classes[i];
+        entry->name_next = NULL;
+        if (!registry_index_place(&g_class_index, entry->global_type_id, entry) ||
+            !registry_name_map_insert(&g_class_names, entry, entry->name_hash)) {
+            return false;
+        }
+    }
+    
+    // The method name map is built on the first lookup by name, as usual
+    for (uint32_t i = 0; i < entries->method_count; i++) {
+        MethodRegistryEntry* entry = &entries->methods[i];
+        entry->name_next = NULL;
+        if (!registry_index_place(&g_method_index, entry->global_id, entry)) {
+            return false;
+        }
+        g_method_count++;
+        g_methods_materialized += entry->method_info != NULL;
+    }
+    
+    for (uint32_t i = 0; i < entries->field_count; i++) {
+        FieldRegistryEntry* entry = &entries->fields[i];
+        entry->name_next = NULL;
+        if (!registry_index_place(&g_field_index, entry->global_id, entry) ||
+            !registry_name_map_insert(&g_field_names, entry, entry->name_hash)) {
+            return false;
+        }
     }
     
     return true;
@@ -705,34 +1462,23 @@ uint32_t module_registry_get_next_module_id(ModuleRegistry* registry) {
 }
 
 void module_registry_cleanup(void) {
-    // Clean up class registry
-    ClassRegistryEntry* class_current = g_class_registry;
-    while (class_current) {
-        ClassRegistryEntry* next = class_current->next;
-        if (class_current->class_name) free(class_current->class_name);
-        free(class_current);
-        class_current = next;
-    }
-    g_class_registry = NULL;
-    
-    // Clean up method registry
-    MethodRegistryEntry* method_current = g_method_registry;
-    while (method_current) {
-        MethodRegistryEntry* next = method_current->next;
-        if (method_current->method_name) free(method_current->method_name);
-        if (method_current->signature) free(method_current->signature);
-        free(method_current);
-        method_current = next;
-    }
-    g_method_registry = NULL;
-    
-    // Clean up field registry
-    FieldRegistryEntry* field_current = g_field_registry;
-    while (field_current) {
-        FieldRegistryEntry* next = field_current->next;
-        if (field_current->field_name) free(field_current->field_name);
-        free(field_current);
-        field_current = next;
-    }
-    g_field_registry = NULL;
+    // Entries, Method/Field info and names are released with their pools
+    registry_index_destroy(&g_class_index);
+    registry_index_destroy(&g_method_index);
+    registry_index_destroy(&g_field_index);
+    registry_name_map_destroy(&g_class_names);
+    registry_name_map_destroy(&g_method_names);
+    registry_name_map_destroy(&g_field_names);
+    g_method_names_ready = false;
+    g_method_count = 0;
+    g_methods_materialized = 0;
+    
+    if (!g_registry_pools_ready) return;
+    slab_pool_destroy(&g_class_entry_pool);
+    slab_pool_destroy(&g_method_entry_pool);
+    slab_pool_destroy(&g_field_entry_pool);
+    slab_pool_destroy(&g_method_info_pool);
+    slab_pool_destroy(&g_field_info_pool);
+    arena_destroy(&g_registry_names);
+    g_registry_pools_ready = false;
 }
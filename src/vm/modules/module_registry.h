@@ -5,6 +5,7 @@
 #include <stddef.h>
 #include "../../shared/bytecode/bytecode_format.h"
 #include "../../shared/bytecode/helium_format.h"
+#include "../memory/pool.h"
 
 // Forward declarations
 struct VM;
@@ -19,6 +20,12 @@ typedef struct ModuleEntry {
     uint32_t module_id;                   // Unique module identifier
     HeliumModule* helium_module;          // Helium3 module data
     BytecodeFile* bytecode_file;          // Bytecode file data
+    uint32_t* type_ids;                   // Module type ID -> global type ID (0 = none)
+    uint32_t max_type_id;                 // Largest module type ID in type_ids
+    uint32_t* method_ids;                 // Module method ID -> global method ID
+    uint32_t max_method_id;               // Largest module method ID in method_ids
+    uint32_t* field_ids;                  // Module field ID -> global field ID
+    uint32_t max_field_id;                // Largest module field ID in field_ids
     struct ModuleEntry* next;             // Next module in list
 } ModuleEntry;
 
@@ -27,15 +34,43 @@ typedef struct ModuleRegistry {
     ModuleEntry* modules;                 // Linked list of loaded modules
     uint32_t next_module_id;              // Next available module ID
     uint32_t module_count;                // Number of loaded modules
+    SlabPool entry_pool;                  // Storage for ModuleEntry nodes
+    Arena names;                          // Module names, versions and id maps
 } ModuleRegistry;
 
+// Registry entries are indexed twice: densely by global ID, which modules map
+// their own IDs to at load so that IDs of different modules never collide,
+// and by name in a hash table chained through the entries themselves.
+
+// Entries by global ID; ID 0 is never assigned
+typedef struct RegistryIndex {
+    void** entries;                       // Global ID -> entry (NULL = unused ID)
+    uint32_t next_id;                     // Next global ID to assign
+    uint32_t capacity;                    // Slots in entries
+} RegistryIndex;
+
+// Entries by name hash, chained through a link field of the entry
+typedef struct RegistryNameMap {
+    void** buckets;                       // Chains (power-of-two count)
+    uint32_t bucket_count;                // Number of buckets
+    uint32_t count;                       // Entries in the map
+    size_t hash_offset;                   // Offset of the entry's name hash
+    size_t link_offset;                   // Offset of the entry's chain link
+} RegistryNameMap;
+
 // Class registry entry (for runtime class discovery)
 typedef struct ClassRegistryEntry {
     uint32_t type_id;                     // Type ID from module
     uint32_t module_id;                   // Owning module ID
+    uint32_t global_type_id;              // Global type ID
     char* class_name;                     // Class name
     struct Class* class_info;             // Runtime class information
-    struct ClassRegistryEntry* next;      // Next class in list
+    uint32_t first_method_id;             // Global ID of the class's first method (0 = no range)
+    uint32_t method_count;                // Methods from first_method_id on
+    uint32_t first_field_id;              // Global ID of the class's first field (0 = no range)
+    uint32_t field_count;                 // Fields from first_field_id on
+    uint32_t name_hash;                   // Hash of class_name
+    struct ClassRegistryEntry* name_next; // Next class in name hash chain
 } ClassRegistryEntry;
 
 // Method registry entry (for runtime method discovery)
@@ -43,10 +78,15 @@ typedef struct MethodRegistryEntry {
     uint32_t method_id;                   // Method ID from module
     uint32_t module_id;                   // Owning module ID
     uint32_t type_id;                     // Owning type ID
-    char* method_name;                    // Method name
-    char* signature;                      // Method signature
-    struct Method* method_info;           // Runtime method information
-    struct MethodRegistryEntry* next;     // Next method in list
+    uint32_t global_id;                   // Global method ID
+    uint32_t global_type_id;              // Global ID of the owning type
+    const char* method_name;              // Method name (resolved on first use)
+    const char* signature;                // Method signature (resolved on first use)
+    struct Method* method_info;           // Runtime method information (NULL until materialized)
+    ModuleEntry* module;                  // Owning module
+    uint32_t method_index;                // Index in the owning module's method table
+    uint32_t name_hash;                   // Hash of method_name
+    struct MethodRegistryEntry* name_next; // Next method in name hash chain
 } MethodRegistryEntry;
 
 // Field registry entry (for runtime field discovery)
@@ -54,22 +94,38 @@ typedef struct FieldRegistryEntry {
     uint32_t field_id;                    // Field ID from module
     uint32_t module_id;                   // Owning module ID
     uint32_t type_id;                     // Owning type ID
+    uint32_t global_id;                   // Global field ID
+    uint32_t global_type_id;              // Global ID of the owning type
     char* field_name;                     // Field name
     uint32_t field_type_id;               // Field type ID
     struct Field* field_info;             // Runtime field information
-    struct FieldRegistryEntry* next;      // Next field in list
+    uint32_t name_hash;                   // Hash of field_name
+    struct FieldRegistryEntry* name_next; // Next field in name hash chain
 } FieldRegistryEntry;
 
+// Registry entries saved in a VM image, installed in place by
+// module_registry_restore_entries
+typedef struct RegistryEntries {
+    ClassRegistryEntry* classes;          // Class entries
+    uint32_t class_count;                 // Entries in classes
+    uint32_t class_ids;                   // Global type IDs assigned (next ID)
+    MethodRegistryEntry* methods;         // Method entries
+    uint32_t method_count;                // Entries in methods
+    uint32_t method_ids;                  // Global method IDs assigned (next ID)
+    FieldRegistryEntry* fields;           // Field entries
+    uint32_t field_count;                 // Entries in fields
+    uint32_t field_ids;                   // Global field IDs assigned (next ID)
+} RegistryEntries;
+
 // Global module registry
 extern ModuleRegistry* g_module_registry;
-extern ClassRegistryEntry* g_class_registry;
-extern MethodRegistryEntry* g_method_registry;
-extern FieldRegistryEntry* g_field_registry;
 
 // Module registry functions
 ModuleRegistry* module_registry_create(void);
 void module_registry_destroy(ModuleRegistry* registry);
 bool module_registry_register_module(ModuleRegistry* registry, const char* filename, HeliumModule* module);
+// Module entry without discovering the module's classes, methods and fields
+ModuleEntry* module_registry_add_module(ModuleRegistry* registry, const char* filename, HeliumModule* module);
 bool module_registry_register_bytecode(ModuleRegistry* registry, const char* filename, BytecodeFile* file);
 ModuleEntry* module_registry_find_module(ModuleRegistry* registry, const char* module_name);
 ModuleEntry* module_registry_find_module_by_id(ModuleRegistry* registry, uint32_t module_id);
@@ -78,30 +134,57 @@ void module_registry_print_info(ModuleRegistry* registry);
 // Class registry functions
 bool class_registry_register_class(ClassRegistryEntry* entry);
 ClassRegistryEntry* class_registry_find_class(const char* class_name);
+// By global type ID, or by the ID a module's bytecode uses
 ClassRegistryEntry* class_registry_find_class_by_id(uint32_t type_id);
+ClassRegistryEntry* class_registry_find_module_class(ModuleEntry* module, uint32_t type_id);
 ClassRegistryEntry* class_registry_find_class_by_name_and_module(const char* class_name, uint32_t module_id);
 void class_registry_print_info(void);
+// Next global ID of each registry (IDs below it have been assigned)
+uint32_t class_registry_id_count(void);
+uint32_t method_registry_id_count(void);
+uint32_t field_registry_id_count(void);
 
 // Method registry functions
 bool method_registry_register_method(MethodRegistryEntry* entry);
 MethodRegistryEntry* method_registry_find_method(const char* method_name);
+// By global method ID, or by the ID a module's bytecode uses
 MethodRegistryEntry* method_registry_find_method_by_id(uint32_t method_id);
+MethodRegistryEntry* method_registry_find_module_method(ModuleEntry* module, uint32_t method_id);
+// type_id is a global type ID
 MethodRegistryEntry* method_registry_find_method_by_name_and_type(const char* method_name, uint32_t type_id);
 void method_registry_print_info(void);
+// Methods are registered as stubs; names and Method info are created on demand
+const char* method_registry_entry_name(MethodRegistryEntry* entry);
+const char* method_registry_entry_signature(MethodRegistryEntry* entry);
+struct Method* method_registry_materialize(MethodRegistryEntry* entry);
+uint32_t method_registry_materialized_count(void);
+uint32_t method_registry_method_count(void);
+void method_registry_print_stats(void);
 
 // Field registry functions
 bool field_registry_register_field(FieldRegistryEntry* entry);
 FieldRegistryEntry* field_registry_find_field(const char* field_name);
+// By global field ID, or by the ID a module's bytecode uses
 FieldRegistryEntry* field_registry_find_field_by_id(uint32_t field_id);
+FieldRegistryEntry* field_registry_find_module_field(ModuleEntry* module, uint32_t field_id);
+// type_id is a global type ID
 FieldRegistryEntry* field_registry_find_field_by_name_and_type(const char* field_name, uint32_t type_id);
 void field_registry_print_info(void);
 
 // Module loading and discovery
 bool module_registry_load_helium3_module(ModuleRegistry* registry, const char* filename);
+// Load files on up to `threads` threads, then register them in order.
+// modules[i] receives each registered module, which the caller owns; on
+// failure the modules that were not registered are destroyed.
+bool module_registry_load_helium3_modules(ModuleRegistry* registry, const char* const* filenames,
+                                          HeliumModule** modules, uint32_t count, uint32_t threads);
 bool module_registry_load_bytecode_file(ModuleRegistry* registry, const char* filename);
 bool module_registry_discover_classes_from_module(ModuleRegistry* registry, uint32_t module_id);
 bool module_registry_discover_methods_from_module(ModuleRegistry* registry, uint32_t module_id);
 bool module_registry_discover_fields_from_module(ModuleRegistry* registry, uint32_t module_id);
+// Register a module's classes, methods and fields from its link index
+bool module_registry_adopt_link_index(ModuleRegistry* registry, ModuleEntry* module_entry);
+bool module_registry_restore_entries(const RegistryEntries* entries);
 
 // Utility functions
 const char* module_registry_get_string_from_module(ModuleRegistry* registry, uint32_t module_id, uint32_t string_offset);
@@ -0,0 +1,781 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../vm.h"
+#include "module_registry.h"
+#include "../string_manager/global_string_registry.h"
+#include "../../shared/bytecode/helium_format.h"
+#include "../../shared/bytecode/opcodes.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// Module tests - build a small module by hand, save it, and check that
+// loading, registering and running it round-trips
+
+// Method IDs of the test module; the interpreter reserves the Sys IDs
+#define MAIN_METHOD_ID 1
+#define ANSWER_METHOD_ID 10
+#define UNUSED_METHOD_ID 11
+
+// main() { return answer() + 2; } and answer() { return 40; }
+static const uint8_t main_code[] = {
+    OP_CALL_STATIC, ANSWER_METHOD_ID, 0, 0, 0,
+    OP_PUSH_INT8, 2,
+    OP_ADD,
+    OP_RETURN
+};
+static const uint8_t answer_code[] = { OP_PUSH_INT8, 40, OP_RETURN };
+
+static void add_method(HeliumModule* module, uint32_t method_id, uint32_t type_id, const char* name,
+                       uint32_t flags, uint32_t bytecode_offset, uint32_t bytecode_size) {
+    MethodEntry method;
+    memset(&method, 0, sizeof(method));
+    method.method_id = method_id;
+    method.type_id = type_id;
+    method.name_offset = helium_module_add_string(module, name);
+    method.signature_offset = helium_module_add_string(module, "():integer");
+    method.bytecode_offset = bytecode_offset;
+    method.bytecode_size = bytecode_size;
+    method.flags = flags;
+    bool added = method_table_add_method(module->method_table, &method);
+    assert(added);
+}
+
+// A module `name` with class `name`.Program: static main and answer, a
+// virtual method that is never called, and one field
+static HeliumModule* make_module(const char* name) {
+    HeliumModule* module = helium_module_create();
+    assert(module != NULL);
+    char class_name[64];
+    snprintf(class_name, sizeof(class_name), "%s.Program", name);
+    uint32_t type_id = helium_module_add_type(module, class_name, name);
+    assert(type_id != 0);
+    
+    module->bytecode_size = sizeof(main_code) + sizeof(answer_code);
+    module->bytecode = malloc(module->bytecode_size);
+    assert(module->bytecode != NULL);
+    memcpy(module->bytecode, main_code, sizeof(main_code));
+    memcpy(module->bytecode + sizeof(main_code), answer_code, sizeof(answer_code));
+    add_method(module, MAIN_METHOD_ID, type_id, "main", METHOD_FLAG_STATIC, 0, sizeof(main_code));
+    add_method(module, ANSWER_METHOD_ID, type_id, "answer", METHOD_FLAG_STATIC,
+               sizeof(main_code), sizeof(answer_code));
+    add_method(module, UNUSED_METHOD_ID, type_id, "unused", METHOD_FLAG_VIRTUAL, 0, 0);
+    
+    FieldEntry field;
+    memset(&field, 0, sizeof(field));
+    field.field_id = 1;
+    field.type_id = type_id;
+    field.name_offset = helium_module_add_string(module, "count");
+    field.field_type_id = 1;
+    bool added = field_table_add_field(module->field_table, &field);
+    assert(added);
+    
+    module->header.flags = HELIUM_FLAG_EXECUTABLE;
+    module->header.module_name_offset = helium_module_add_string(module, name);
+    module->header.bytecode_size = module->bytecode_size;
+    module->header.entry_point_method_id = MAIN_METHOD_ID;
+    return module;
+}
+
+static void module_path(char* path, size_t size, const char* tag) {
+    snprintf(path, size, "/tmp/he3_module_test_%d_%s.helium3", (int)getpid(), tag);
+}
+
+// Save a fresh module `name` to `path`
+static void save_module(const char* name, const char* path) {
+    HeliumModule* built = make_module(name);
+    bool saved = helium_module_save(built, path);
+    helium_module_destroy(built);
+    assert(saved);
+}
+
+static bool in_image(const HeliumModule* module, const void* ptr, size_t size) {
+    const char* start = module->image;
+    return (const char*)ptr >= start && (const char*)ptr + size <= start + module->image_size;
+}
+
+// Read a whole file into a malloc'd buffer
+static uint8_t* read_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    assert(file != NULL);
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    assert(length > 0);
+    uint8_t* buffer = malloc((size_t)length);
+    assert(buffer != NULL);
+    size_t read = fread(buffer, 1, (size_t)length, file);
+    fclose(file);
+    assert(read == (size_t)length);
+    *size = (size_t)length;
+    return buffer;
+}
+
+// Load a saved module in a fresh VM and run it; returns main's result
+static int run_module(const char* path) {
+    VM* vm = vm_create();
+    assert(vm != NULL);
+    vm_initialize_object_system(vm);
+    bool loaded = vm_load_helium3_module(vm, path);
+    assert(loaded);
+    int result = vm_execute(vm);
+    vm_destroy(vm);
+    return result;
+}
+
+static void check_tables_in_image(HeliumModule* module) {
+    assert(module->method_table->count == 3);
+    assert(in_image(module, module->string_table_obj->entries,
+                    module->string_table_obj->count * sizeof(StringEntry)));
+    assert(in_image(module, module->string_table_obj->data, module->string_table_obj->total_size));
+    assert(in_image(module, module->type_table->entries, module->type_table->count * sizeof(TypeEntry)));
+    assert(in_image(module, module->method_table->entries, module->method_table->count * sizeof(MethodEntry)));
+    assert(in_image(module, module->field_table->entries, module->field_table->count * sizeof(FieldEntry)));
+    assert(in_image(module, module->bytecode, module->bytecode_size));
+    
+    const MethodEntry* answer = &module->method_table->entries[1];
+    assert(answer->method_id == ANSWER_METHOD_ID);
+    assert(strcmp(helium_module_get_string(module, answer->name_offset), "answer") == 0);
+    assert(memcmp(module->bytecode + answer->bytecode_offset, answer_code, sizeof(answer_code)) == 0);
+}
+
+// Test that a loaded module's tables point into the mapped file
+void test_mmap_load(void) {
+    printf("=== Testing Mapped Module Load ===\n");
+    
+    char path[96];
+    module_path(path, sizeof(path), "mmap");
+    save_module("app", path);
+    
+    HeliumModule* module = helium_module_load(path);
+    assert(module != NULL);
+    assert(module->image_mapped && !module->image_borrowed);
+    check_tables_in_image(module);
+    helium_module_destroy(module);
+    
+    // The same file from a caller's buffer, which the module borrows
+    size_t size;
+    uint8_t* buffer = read_file(path, &size);
+    module = helium_module_load_image(buffer, size);
+    assert(module != NULL);
+    assert(module->image == buffer && module->image_borrowed && !module->image_mapped);
+    check_tables_in_image(module);
+    helium_module_destroy(module);
+    assert(memcmp(buffer, HELIUM_MAGIC, 7) == 0);
+    free(buffer);
+    
+    // And run from the mapping
+    int result = run_module(path);
+    printf("Result: %d\n", result);
+    assert(result == 42);
+    unlink(path);
+    
+    printf("Mapped module load test passed!\n");
+}
+
+// Test the version 2 layout: a header, the section directory, and each
+// section aligned, inside the file and clear of the others
+void test_section_layout(void) {
+    printf("=== Testing Section Layout ===\n");
+    
+    char path[96];
+    module_path(path, sizeof(path), "layout");
+    save_module("app", path);
+    
+    size_t size;
+    uint8_t* image = read_file(path, &size);
+    const HeliumHeaderV2* header = (const HeliumHeaderV2*)image;
+    assert(size >= sizeof(HeliumHeaderV2));
+    assert(memcmp(header->magic, HELIUM_MAGIC, 7) == 0);
+    assert(header->version_major == HELIUM_VERSION_MAJOR);
+    assert(header->byte_order == HELIUM_BYTE_ORDER_MARK);
+    assert(header->header_size == sizeof(HeliumHeaderV2));
+    assert(header->entry_point_method_id == MAIN_METHOD_ID);
+    assert(header->section_directory_offset == sizeof(HeliumHeaderV2));
+    
+    uint64_t directory_end = header->section_directory_offset + header->section_count * sizeof(HeliumSection);
+    assert(directory_end <= size);
+    const HeliumSection* sections = (const HeliumSection*)(image + header->section_directory_offset);
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        const HeliumSection* section = &sections[i];
+        assert(section->kind >= 1 && section->kind <= HELIUM_SECTION_KIND_COUNT);
+        assert(!(seen & (1u << section->kind)));
+        seen |= 1u << section->kind;
+        uint32_t alignment = section->kind == HELIUM_SECTION_BYTECODE ? HELIUM_BYTECODE_ALIGNMENT
+                                                                     : HELIUM_SECTION_ALIGNMENT;
+        assert(section->alignment == alignment);
+        assert(section->offset % alignment == 0);
+        assert(section->size == (uint64_t)section->count * section->record_size);
+        assert(section->offset >= directory_end && section->offset + section->size <= size);
+        for (uint32_t j = 0; j < i; j++) {
+            assert(section->offset >= sections[j].offset + sections[j].size ||
+                   sections[j].offset >= section->offset + section->size);
+        }
+        if (section->kind == HELIUM_SECTION_METHODS) {
+            assert(section->record_size == sizeof(MethodEntry) && section->count == 3);
+        } else if (section->kind == HELIUM_SECTION_BYTECODE) {
+            assert(section->count == sizeof(main_code) + sizeof(answer_code));
+            assert(memcmp(image + section->offset, main_code, sizeof(main_code)) == 0);
+        }
+    }
+    assert(seen & (1u << HELIUM_SECTION_STRING_ENTRIES));
+    assert(seen & (1u << HELIUM_SECTION_TYPES));
+    assert(seen & (1u << HELIUM_SECTION_METHODS));
+    assert(seen & (1u << HELIUM_SECTION_FIELDS));
+    assert(seen & (1u << HELIUM_SECTION_BYTECODE));
+    
+    // Offsets are from the start of the file, so a copy at another
+    // address loads the same tables
+    uint8_t* copy = malloc(size);
+    assert(copy != NULL);
+    memcpy(copy, image, size);
+    HeliumModule* first = helium_module_load_image(image, size);
+    HeliumModule* second = helium_module_load_image(copy, size);
+    assert(first != NULL && second != NULL);
+    assert((uint8_t*)second->method_table->entries - copy == (uint8_t*)first->method_table->entries - image);
+    assert(memcmp(first->method_table->entries, second->method_table->entries, 3 * sizeof(MethodEntry)) == 0);
+    assert(strcmp(helium_module_get_string(second, second->method_table->entries[0].name_offset), "main") == 0);
+    helium_module_destroy(first);
+    helium_module_destroy(second);
+    free(copy);
+    free(image);
+    unlink(path);
+    
+    printf("Section layout test passed!\n");
+}
+
+// Test that registering a module links no method, and that a method is
+// decoded from its record on first use
+void test_lazy_link(void) {
+    printf("=== Testing Lazy Method Linking ===\n");
+    
+    char path[96];
+    module_path(path, sizeof(path), "lazy");
+    save_module("app", path);
+    
+    HeliumModule* module = helium_module_load(path);
+    assert(module != NULL);
+    ModuleRegistry* registry = module_registry_create();
+    assert(registry != NULL);
+    bool registered = module_registry_register_module(registry, path, module);
+    assert(registered);
+    assert(method_registry_method_count() == 3);
+    assert(method_registry_materialized_count() == 0);
+    
+    MethodRegistryEntry* answer = method_registry_find_method("answer");
+    MethodRegistryEntry* unused = method_registry_find_method("unused");
+    assert(answer != NULL && unused != NULL);
+    assert(answer->method_info == NULL && unused->method_info == NULL);
+    
+    Method* method = method_registry_materialize(answer);
+    assert(method != NULL);
+    assert(strcmp(method->name, "answer") == 0 && strcmp(method->signature, "():integer") == 0);
+    assert(method->is_static && !method->is_virtual && method->is_public && !method->is_private);
+    assert(method->bytecode == module->bytecode + sizeof(main_code));
+    assert(method->bytecode_size == sizeof(answer_code));
+    Method* again = method_registry_materialize(answer);
+    assert(again == method);
+    assert(method_registry_materialized_count() == 1);
+    
+    method = method_registry_materialize(unused);
+    assert(method != NULL && method->is_virtual && !method->is_static && method->bytecode == NULL);
+    assert(method_registry_materialized_count() == 2);
+    
+    module_registry_destroy(registry);
+    module_registry_cleanup();
+    helium_module_destroy(module);
+    
+    // Running main links answer, which it calls, and nothing else
+    VM* vm = vm_create();
+    assert(vm != NULL);
+    vm_initialize_object_system(vm);
+    bool loaded = vm_load_helium3_module(vm, path);
+    assert(loaded);
+    int result = vm_execute(vm);
+    printf("Result: %d\n", result);
+    assert(result == 42);
+    answer = method_registry_find_method("answer");
+    unused = method_registry_find_method("unused");
+    assert(answer != NULL && answer->method_info != NULL);
+    assert(unused != NULL && unused->method_info == NULL);
+    vm_destroy(vm);
+    unlink(path);
+    
+    printf("Lazy method linking test passed!\n");
+}
+
+// Test that two modules get distinct global IDs, and that classes, methods
+// and fields resolve by global ID, by module ID and by name
+void test_registry_lookup(void) {
+    printf("=== Testing Registry Lookup ===\n");
+    
+    const char* names[2] = { "app", "lib" };
+    char paths[2][96];
+    HeliumModule* modules[2];
+    ModuleRegistry* registry = module_registry_create();
+    assert(registry != NULL);
+    for (int i = 0; i < 2; i++) {
+        module_path(paths[i], sizeof(paths[i]), names[i]);
+        save_module(names[i], paths[i]);
+        modules[i] = helium_module_load(paths[i]);
+        assert(modules[i] != NULL);
+        bool registered = module_registry_register_module(registry, paths[i], modules[i]);
+        assert(registered);
+    }
+    
+    uint32_t class_ids[2];
+    uint32_t answer_ids[2];
+    for (int i = 0; i < 2; i++) {
+        ModuleEntry* entry = module_registry_find_module_by_id(registry, (uint32_t)i + 1);
+        assert(entry != NULL && entry->helium_module == modules[i]);
+        
+        char class_name[64];
+        snprintf(class_name, sizeof(class_name), "%s.Program", names[i]);
+        ClassRegistryEntry* class_entry = class_registry_find_class(class_name);
+        assert(class_entry != NULL && class_entry->module_id == entry->module_id);
+        assert(class_registry_find_class_by_id(class_entry->global_type_id) == class_entry);
+        assert(class_registry_find_module_class(entry, 1) == class_entry);
+        assert(entry->type_ids[1] == class_entry->global_type_id);
+        class_ids[i] = class_entry->global_type_id;
+        
+        MethodRegistryEntry* answer = method_registry_find_module_method(entry, ANSWER_METHOD_ID);
+        assert(answer != NULL && answer->global_type_id == class_entry->global_type_id);
+        assert(method_registry_find_method_by_id(answer->global_id) == answer);
+        assert(entry->method_ids[ANSWER_METHOD_ID] == answer->global_id);
+        assert(method_registry_find_method_by_name_and_type("answer", class_entry->global_type_id) == answer);
+        assert(method_registry_find_module_method(entry, 5) == NULL);
+        answer_ids[i] = answer->global_id;
+        
+        FieldRegistryEntry* field = field_registry_find_field_by_name_and_type("count", class_entry->global_type_id);
+        assert(field != NULL && field->module_id == entry->module_id);
+        assert(field_registry_find_field_by_id(field->global_id) == field);
+        assert(field_registry_find_module_field(entry, 1) == field);
+    }
+    assert(class_ids[0] != class_ids[1] && answer_ids[0] != answer_ids[1]);
+    assert(class_registry_id_count() > class_ids[1] && method_registry_id_count() > answer_ids[1]);
+    assert(method_registry_find_method_by_id(0) == NULL);
+    assert(method_registry_find_method_by_id(method_registry_id_count()) == NULL);
+    
+    // A bare name resolves to the most recently registered method
+    assert(method_registry_find_method("answer")->global_id == answer_ids[1]);
+    
+    // Modules are named after their files
+    char lib_name[96];
+    snprintf(lib_name, sizeof(lib_name), "he3_module_test_%d_lib", (int)getpid());
+    assert(module_registry_find_module(registry, lib_name) == module_registry_find_module_by_id(registry, 2));
+    
+    module_registry_destroy(registry);
+    module_registry_cleanup();
+    for (int i = 0; i < 2; i++) {
+        helium_module_destroy(modules[i]);
+        unlink(paths[i]);
+    }
+    
+    printf("Registry lookup test passed!\n");
+}
+
+// Test that global strings resolve by ID, content and module offset as
+// the registry grows past its initial hash table
+void test_global_strings(void) {
+    printf("=== Testing Global String Registry ===\n");
+    
+    GlobalStringRegistry* registry = global_string_registry_create(NULL);
+    assert(registry != NULL);
+    uint32_t count = GLOBAL_STRING_INITIAL_BUCKETS * 4;
+    char text[32];
+    for (uint32_t i = 0; i < count; i++) {
+        snprintf(text, sizeof(text), "string%u", i);
+        uint32_t id = global_string_registry_register_string(registry, 1, i * 16, text);
+        assert(id == i + 1);
+    }
+    assert(registry->total_strings == count);
+    assert(registry->hash_table_size > GLOBAL_STRING_INITIAL_BUCKETS);
+    assert((registry->hash_table_size & (registry->hash_table_size - 1)) == 0);
+    assert(registry->total_strings <= registry->hash_table_size / 4 * 3);
+    
+    for (uint32_t i = 0; i < count; i++) {
+        snprintf(text, sizeof(text), "string%u", i);
+        assert(strcmp(global_string_registry_get_string(registry, i + 1), text) == 0);
+        assert(global_string_registry_find_string(registry, text) == i + 1);
+        assert(global_string_registry_get_global_id(registry, 1, i * 16) == i + 1);
+    }
+    
+    // Another module's copy of a string shares its ID
+    uint32_t id = global_string_registry_register_string(registry, 2, 0, "string5");
+    assert(id == 6 && registry->total_strings == count);
+    assert(global_string_registry_get_global_id(registry, 2, 0) == 6);
+    assert(global_string_registry_get_module_map(registry, 2) != NULL);
+    
+    assert(global_string_registry_get_string(registry, 0) == NULL);
+    assert(global_string_registry_get_string(registry, count + 1) == NULL);
+    assert(global_string_registry_find_string(registry, "missing") == 0);
+    assert(global_string_registry_get_global_id(registry, 3, 0) == 0);
+    global_string_registry_destroy(registry);
+    
+    printf("Global string registry test passed!\n");
+}
+
+// Test hashed string tables: adding deduplicates, a saved module's index
+// is used from the image, and adding to a loaded table copies it first
+void test_string_tables(void) {
+    printf("=== Testing String Tables ===\n");
+    
+    StringTable* table = string_table_create();
+    assert(table != NULL);
+    char text[32];
+    for (uint32_t i = 0; i < 1000; i++) {
+        snprintf(text, sizeof(text), "name%u", i);
+        uint32_t index = string_table_add_string(table, text);
+        assert(index == i);
+    }
+    uint32_t duplicate = string_table_add_string(table, "name500");
+    assert(duplicate == 500 && table->count == 1000);
+    assert(string_table_find_string(table, "name999") == 999);
+    assert(string_table_find_string(table, "name1000") == -1);
+    assert(table->index_owned && table->index_size >= 2 * table->count);
+    assert((table->index_size & (table->index_size - 1)) == 0);
+    string_table_destroy(table);
+    
+    char path[96];
+    module_path(path, sizeof(path), "strings");
+    HeliumModule* built = make_module("app");
+    for (uint32_t i = 0; i < 200; i++) {
+        snprintf(text, sizeof(text), "name%u", i);
+        helium_module_add_string(built, text);
+    }
+    bool saved = helium_module_save(built, path);
+    helium_module_destroy(built);
+    assert(saved);
+    
+    HeliumModule* module = helium_module_load(path);
+    assert(module != NULL);
+    StringTable* strings = module->string_table_obj;
+    assert(strings->index != NULL && !strings->index_owned);
+    assert(in_image(module, strings->index, strings->index_size * sizeof(uint32_t)));
+    assert(helium_module_find_string(module, "answer") == module->method_table->entries[1].name_offset);
+    assert(helium_module_find_string(module, "name199") != UINT32_MAX);
+    assert(helium_module_find_string(module, "missing") == UINT32_MAX);
+    
+    uint32_t count = strings->count;
+    uint32_t offset = helium_module_add_string(module, "added");
+    assert(strings->count == count + 1 && offset == strings->entries[count].offset);
+    assert(!in_image(module, strings->entries, sizeof(StringEntry)));
+    assert(!in_image(module, strings->data, 1) && strings->index_owned);
+    assert(helium_module_find_string(module, "added") == offset);
+    assert(strcmp(helium_module_get_string(module, helium_module_find_string(module, "name7")), "name7") == 0);
+    helium_module_destroy(module);
+    unlink(path);
+    
+    printf("String table test passed!\n");
+}
+
+// What a registered module resolved to, to compare two registrations
+typedef struct {
+    uint32_t class_id;
+    uint32_t first_method_id;
+    uint32_t method_count;
+    uint32_t first_field_id;
+    uint32_t field_count;
+    uint32_t method_ids[3];
+    uint32_t field_id;
+} LinkResult;
+
+static void register_and_resolve(const char* path, bool expect_index, LinkResult* result) {
+    HeliumModule* module = helium_module_load(path);
+    assert(module != NULL);
+    assert((module->link_index != NULL) == expect_index);
+    ModuleRegistry* registry = module_registry_create();
+    assert(registry != NULL);
+    bool registered = module_registry_register_module(registry, path, module);
+    assert(registered);
+    ModuleEntry* entry = module_registry_find_module_by_id(registry, 1);
+    
+    ClassRegistryEntry* class_entry = class_registry_find_class("app.Program");
+    assert(class_entry != NULL && class_registry_find_module_class(entry, 1) == class_entry);
+    result->class_id = class_entry->global_type_id;
+    result->first_method_id = class_entry->first_method_id;
+    result->method_count = class_entry->method_count;
+    result->first_field_id = class_entry->first_field_id;
+    result->field_count = class_entry->field_count;
+    const char* names[3] = { "main", "answer", "unused" };
+    for (int i = 0; i < 3; i++) {
+        MethodRegistryEntry* method = method_registry_find_method_by_name_and_type(names[i], result->class_id);
+        assert(method != NULL && method_registry_find_module_method(entry, method->method_id) == method);
+        result->method_ids[i] = method->global_id;
+    }
+    FieldRegistryEntry* field = field_registry_find_field_by_name_and_type("count", result->class_id);
+    assert(field != NULL && field_registry_find_module_field(entry, 1) == field);
+    result->field_id = field->global_id;
+    
+    module_registry_destroy(registry);
+    module_registry_cleanup();
+    helium_module_destroy(module);
+}
+
+// Test that a module saved with a link index registers from it exactly as
+// discovery registers the same module without one
+void test_link_index(void) {
+    printf("=== Testing Link Index ===\n");
+    
+    char plain_path[96];
+    char indexed_path[96];
+    module_path(plain_path, sizeof(plain_path), "plain");
+    module_path(indexed_path, sizeof(indexed_path), "indexed");
+    HeliumModule* built = make_module("app");
+    bool saved = helium_module_save(built, plain_path);
+    assert(saved);
+    
+    bool indexed = helium_module_build_link_index(built);
+    const HeliumLinkHeader* index = built->link_index;
+    assert(indexed && index != NULL);
+    assert(index->type_count == 1 && index->method_count == 3 && index->field_count == 1);
+    assert(index->max_type_id == 1 && index->max_method_id == UNUSED_METHOD_ID && index->max_field_id == 1);
+    const HeliumLinkType* type = &HELIUM_LINK_TYPES(index)[0];
+    assert(type->name_hash == string_hash("app.Program"));
+    assert(type->method_count == 3 && type->field_count == 1);
+    assert(HELIUM_LINK_METHODS(index)[type->first_method].name_hash == string_hash("main"));
+    saved = helium_module_save(built, indexed_path);
+    assert(saved);
+    
+    // Changing a table discards the index
+    helium_module_add_method(built, "later", "():integer", 1, true);
+    assert(built->link_index == NULL);
+    helium_module_destroy(built);
+    
+    HeliumModule* module = helium_module_load(indexed_path);
+    assert(module != NULL && module->link_index != NULL);
+    assert(in_image(module, module->link_index, module->link_index_size));
+    helium_module_destroy(module);
+    
+    LinkResult discovered;
+    LinkResult adopted;
+    register_and_resolve(plain_path, false, &discovered);
+    register_and_resolve(indexed_path, true, &adopted);
+    assert(discovered.class_id == adopted.class_id && discovered.field_id == adopted.field_id);
+    assert(memcmp(discovered.method_ids, adopted.method_ids, sizeof(adopted.method_ids)) == 0);
+    
+    // Only an adopted class knows the range of its members
+    assert(discovered.first_method_id == 0 && discovered.first_field_id == 0);
+    assert(adopted.method_count == 3 && adopted.field_count == 1 && adopted.first_field_id == adopted.field_id);
+    for (int i = 0; i < 3; i++) {
+        assert(adopted.method_ids[i] >= adopted.first_method_id &&
+               adopted.method_ids[i] < adopted.first_method_id + adopted.method_count);
+    }
+    unlink(plain_path);
+    unlink(indexed_path);
+    
+    printf("Link index test passed!\n");
+}
+
+static bool in_snapshot(const VM* vm, const void* ptr) {
+    const char* start = vm->snapshot_image;
+    return (const char*)ptr >= start && (const char*)ptr < start + vm->snapshot_image_size;
+}
+
+// Test that a VM image written after loading a module restores in a fresh
+// VM with its entries used in place and their pointers fixed up, and runs
+void test_vm_image(void) {
+    printf("=== Testing VM Image ===\n");
+    
+    char path[96];
+    char image_path[96];
+    module_path(path, sizeof(path), "image_module");
+    snprintf(image_path, sizeof(image_path), "/tmp/he3_module_test_%d.he3image", (int)getpid());
+    save_module("app", path);
+    
+    VM* vm = vm_create();
+    assert(vm != NULL);
+    vm_initialize_object_system(vm);
+    bool loaded = vm_load_helium3_module(vm, path);
+    assert(loaded);
+    bool written = vm_image_write(vm, image_path);
+    assert(written);
+    vm_destroy(vm);
+    unlink(path);
+    
+    vm = vm_create();
+    assert(vm != NULL);
+    vm_initialize_object_system(vm);
+    bool restored = vm_image_load(vm, image_path);
+    assert(restored);
+    assert(vm->snapshot_image != NULL && vm->current_module != NULL);
+    HeliumModule* module = vm->current_module;
+    assert(in_snapshot(vm, module->image) && in_snapshot(vm, module->bytecode));
+    
+    // Entries live in the image; their pointers lead into it or the module
+    ClassRegistryEntry* class_entry = class_registry_find_class("app.Program");
+    assert(class_entry != NULL && in_snapshot(vm, class_entry));
+    assert(strcmp(class_entry->class_name, "app.Program") == 0);
+    MethodRegistryEntry* answer = method_registry_find_method_by_name_and_type("answer", class_entry->global_type_id);
+    assert(answer != NULL && in_snapshot(vm, answer));
+    assert(answer == method_registry_find_module_method(vm->current_module_entry, ANSWER_METHOD_ID));
+    assert(answer->module == vm->current_module_entry);
+    Method* method = answer->method_info;
+    assert(method != NULL && in_snapshot(vm, method));
+    assert(strcmp(method->name, "answer") == 0 && method->is_static);
+    assert(method->bytecode == module->bytecode + sizeof(main_code));
+    assert(method->bytecode_size == sizeof(answer_code));
+    
+    int result = vm_execute(vm);
+    printf("Result: %d\n", result);
+    assert(result == 42);
+    vm_destroy(vm);
+    
+    // An image whose header does not match is refused
+    size_t size;
+    uint8_t* image = read_file(image_path, &size);
+    image[0] ^= 0xFF;
+    FILE* file = fopen(image_path, "wb");
+    assert(file != NULL);
+    size_t copied = fwrite(image, 1, size, file);
+    fclose(file);
+    assert(copied == size);
+    free(image);
+    vm = vm_create();
+    assert(vm != NULL);
+    vm_initialize_object_system(vm);
+    restored = vm_image_load(vm, image_path);
+    assert(!restored);
+    vm_destroy(vm);
+    unlink(image_path);
+    
+    printf("VM image test passed!\n");
+}
+
+#define PROJECT_MODULES 4
+
+static void write_text(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+    assert(file != NULL);
+    fputs(text, file);
+    fclose(file);
+}
+
+// Load the project on `threads` threads; records each module's global
+// class and answer() IDs in registration order
+static void load_project(const char* project, uint32_t threads, const char* const* names,
+                         uint32_t* class_ids, uint32_t* method_ids) {
+    VM* vm = vm_create();
+    assert(vm != NULL);
+    vm_initialize_object_system(vm);
+    vm_set_load_threads(vm, threads);
+    bool loaded = vm_load_project_modules(vm, project);
+    assert(loaded);
+    assert(vm->library_count == PROJECT_MODULES);
+    for (uint32_t i = 0; i < PROJECT_MODULES; i++) {
+        ModuleEntry* entry = module_registry_find_module_by_id(vm->module_registry, i + 1);
+        assert(entry != NULL && strcmp(entry->module_name, names[i]) == 0);
+        assert(entry->helium_module == vm->library_modules[i]);
+        ClassRegistryEntry* class_entry = class_registry_find_module_class(entry, 1);
+        MethodRegistryEntry* answer = method_registry_find_module_method(entry, ANSWER_METHOD_ID);
+        assert(class_entry != NULL && answer != NULL);
+        class_ids[i] = class_entry->global_type_id;
+        method_ids[i] = answer->global_id;
+    }
+    vm_destroy(vm);
+}
+
+// Test that a project's dependencies, including a library project and a
+// module two projects share, load once each, dependencies first, and get
+// the same IDs whatever the number of loading threads
+void test_project_load(void) {
+    printf("=== Testing Project Load ===\n");
+    
+    char dir[64];
+    char path[128];
+    snprintf(dir, sizeof(dir), "/tmp/he3_module_test_%d_project", (int)getpid());
+    int made = mkdir(dir, 0700);
+    assert(made == 0);
+    snprintf(path, sizeof(path), "%s/lib", dir);
+    made = mkdir(path, 0700);
+    assert(made == 0);
+    
+    // Registration order: the library's dependency, the library, then the
+    // program's own dependencies in the order listed
+    const char* names[PROJECT_MODULES] = { "shared", "lib", "b", "a" };
+    const char* files[PROJECT_MODULES] = { "shared.helium3", "lib/lib.helium3", "b.helium3", "a.helium3" };
+    for (int i = 0; i < PROJECT_MODULES; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, files[i]);
+        save_module(names[i], path);
+    }
+    snprintf(path, sizeof(path), "%s/lib/he3project.json", dir);
+    write_text(path, "{\n  \"dependencies\": [\"../shared.helium3\"],\n  \"output\": \"lib.helium3\"\n}\n");
+    char project[128];
+    snprintf(project, sizeof(project), "%s/he3project.json", dir);
+    write_text(project, "{\n  \"dependencies\": [\"lib\", \"b.helium3\", {\"path\": \"a.helium3\"}, "
+                        "\"shared.helium3\"]\n}\n");
+    
+    uint32_t serial_classes[PROJECT_MODULES];
+    uint32_t serial_methods[PROJECT_MODULES];
+    uint32_t parallel_classes[PROJECT_MODULES];
+    uint32_t parallel_methods[PROJECT_MODULES];
+    load_project(project, 1, names, serial_classes, serial_methods);
+    load_project(project, PROJECT_MODULES, names, parallel_classes, parallel_methods);
+    assert(memcmp(serial_classes, parallel_classes, sizeof(serial_classes)) == 0);
+    assert(memcmp(serial_methods, parallel_methods, sizeof(serial_methods)) == 0);
+    for (int i = 1; i < PROJECT_MODULES; i++) {
+        assert(serial_classes[i] > serial_classes[i - 1] && serial_methods[i] > serial_methods[i - 1]);
+    }
+    
+    // A project that depends on itself is refused
+    snprintf(path, sizeof(path), "%s/lib/he3project.json", dir);
+    write_text(path, "{\n  \"dependencies\": [\".\"],\n  \"output\": \"lib.helium3\"\n}\n");
+    VM* vm = vm_create();
+    assert(vm != NULL);
+    bool loaded = vm_load_project_modules(vm, project);
+    bool resolved = vm_resolve_dependencies(vm, project);
+    assert(!loaded && !resolved);
+    vm_destroy(vm);
+    
+    for (int i = 0; i < PROJECT_MODULES; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, files[i]);
+        unlink(path);
+    }
+    snprintf(path, sizeof(path), "%s/lib/he3project.json", dir);
+    unlink(path);
+    unlink(project);
+    snprintf(path, sizeof(path), "%s/lib", dir);
+    rmdir(path);
+    rmdir(dir);
+    
+    printf("Project load test passed!\n");
+}
+
+int main(void) {
+    printf("He³ Module Test Suite\n");
+    printf("=====================\n\n");
+    
+    test_mmap_load();
+    printf("\n");
+    
+    test_section_layout();
+    printf("\n");
+    
+    test_lazy_link();
+    printf("\n");
+    
+    test_registry_lookup();
+    printf("\n");
+    
+    test_global_strings();
+    printf("\n");
+    
+    test_string_tables();
+    printf("\n");
+    
+    test_link_index();
+    printf("\n");
+    
+    test_vm_image();
+    printf("\n");
+    
+    test_project_load();
+    printf("\n");
+    
+    printf("All module tests passed!\n");
+    return 0;
+}
@@ -1,22 +1,51 @@
+// MAP_ANONYMOUS and strdup are hidden under -std=c99
+#define _DEFAULT_SOURCE
+
 #include "object.h"
 #include "../vm.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <sys/mman.h>
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
 
 // Global class registry
 static Class* class_registry = NULL;
 static uint32_t next_type_id = 1;
 
-// Object creation and destruction
-Object* object_create(struct Heap* heap, Class* class_info) {
-    if (!heap || !class_info) {
-        return NULL;
+// Class table - classes are appended by class_create and cleared by
+// class_destroy; slots are never reused so a stale index stays NULL. The
+// table is reserved once at its full size and never moves, so a class
+// created while the concurrent or parallel markers run cannot free the
+// table they read through object_class()
+#define CLASS_TABLE_LIMIT (1u << 20)
+
+Class** object_class_table = NULL;
+static uint32_t class_table_count = 1;
+
+static uint32_t class_table_add(Class* class_info) {
+    if (!object_class_table) {
+        // Pages are committed by the kernel as slots are first written
+        void* table = mmap(NULL, CLASS_TABLE_LIMIT * sizeof(Class*), PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (table == MAP_FAILED) return 0;
+        object_class_table = (Class**)table;
     }
-    
-    // Calculate total object size
-    size_t object_size = sizeof(ObjectHeader) + class_info->size;
+    if (class_table_count >= CLASS_TABLE_LIMIT) return 0;
+    object_class_table[class_table_count] = class_info;
+    return class_table_count++;
+}
+
+static Object* object_allocate(struct Heap* heap, Class* class_info, size_t object_size, uint32_t flags) {
+    // Give the collector a chance to run before the new object exists
+    gc_allocation_check(heap, object_size);
     
     // Allocate object memory
     Object* object = (Object*)heap_allocate(heap, object_size);
@@ -25,23 +54,80 @@ Object* object_create(struct Heap* heap, Class* class_info) {
     }
     
     // Initialize object header
-    object->header.type_id = class_info->type_id;
-    object->header.ref_count = 1;
-    object->header.size = object_size;
-    object->header.flags = 0;
-    object->header.class_info = class_info;
+    object->header.class_index = class_info->class_index;
+    object->header.flags = flags;
     
     // Initialize object data to zero
-    memset(object->data, 0, class_info->size);
+    memset(object->data, 0, object_size - sizeof(ObjectHeader));
+    
+    if (heap_profile_sample(heap)) {
+        heap_profile_allocation(heap, object, object_size, class_info->type_id, class_info->name);
+    }
     
     return object;
 }
 
-void object_destroy(Object* object) {
-    if (!object) return;
+// Object creation and destruction
+Object* object_create(struct Heap* heap, Class* class_info) {
+    if (!heap || !class_info || !class_info->class_index) {
+        return NULL;
+    }
+    
+    Object* object = object_allocate(heap, class_info, sizeof(ObjectHeader) + class_info->size, 0);
+    if (!object) {
+        return NULL;
+    }
+    
+    // Track the object in the young generation
+    gc_register_object(heap, object);
     
-    // Decrement reference count
-    object_remove_reference(object);
+    return object;
+}
+
+// Variable-size objects (arrays, strings) keep their total size in the
+// first 8 bytes of data; their payload of data_size bytes follows it.
+Object* object_create_sized(struct Heap* heap, Class* class_info, size_t data_size) {
+    if (!heap || !class_info || !class_info->class_index) {
+        return NULL;
+    }
+    
+    size_t object_size = sizeof(ObjectHeader) + sizeof(uint64_t) + data_size;
+    Object* object = object_allocate(heap, class_info, object_size, OBJECT_FLAG_SIZED);
+    if (!object) {
+        return NULL;
+    }
+    *(uint64_t*)object->data = object_size;
+    
+    gc_register_object(heap, object);
+    
+    return object;
+}
+
+// Permanent objects (interned strings) are sized objects in the permanent
+// generation and are never collected
+Object* object_create_permanent(struct Heap* heap, Class* class_info, size_t data_size) {
+    if (!heap || !class_info || !class_info->class_index) {
+        return NULL;
+    }
+    
+    size_t object_size = sizeof(ObjectHeader) + sizeof(uint64_t) + data_size;
+    Object* object = object_allocate(heap, class_info, object_size, OBJECT_FLAG_SIZED);
+    if (!object) {
+        return NULL;
+    }
+    *(uint64_t*)object->data = object_size;
+    
+    if (!gc_register_permanent(heap, object)) {
+        heap_deallocate(heap, object);
+        return NULL;
+    }
+    
+    return object;
+}
+
+void object_destroy(Object* object) {
+    // Objects are reclaimed by the garbage collector
+    (void)object;
 }
 
 Object* object_clone(Object* object) {
@@ -54,49 +140,28 @@ Object* object_clone(Object* object) {
     if (!clone) return NULL;
     
     // Copy object data
-    memcpy(clone->data, object->data, object->header.class_info->size);
+    memcpy(clone->data, object->data, object_size(object) - sizeof(ObjectHeader));
     
     return clone;
 }
 
-// Reference counting
-void object_add_reference(Object* object) {
-    if (object) {
-        object->header.ref_count++;
-    }
-}
-
-void object_remove_reference(Object* object) {
-    if (!object) return;
-    
-    object->header.ref_count--;
-    if (object->header.ref_count == 0) {
-        // Object can be garbage collected
-        // TODO: Add to GC queue
-    }
-}
-
-uint32_t object_get_ref_count(Object* object) {
-    return object ? object->header.ref_count : 0;
-}
-
 // Object properties
 Class* object_get_class(Object* object) {
-    return object ? object->header.class_info : NULL;
+    return object ? object_class(object) : NULL;
 }
 
 uint32_t object_get_type_id(Object* object) {
-    return object ? object->header.type_id : 0;
+    return object ? object_class(object)->type_id : 0;
 }
 
 size_t object_get_size(Object* object) {
-    return object ? object->header.size : 0;
+    return object ? object_size(object) : 0;
 }
 
 bool object_is_instance_of(Object* object, Class* class_info) {
     if (!object || !class_info) return false;
     
-    Class* current = object->header.class_info;
+    Class* current = object_class(object);
     while (current) {
         if (current == class_info) {
             return true;
@@ -109,7 +174,7 @@ bool object_is_instance_of(Object* object, Class* class_info) {
 bool object_is_instance_of_interface(Object* object, Interface* interface) {
     if (!object || !interface) return false;
     
-    Class* class_info = object->header.class_info;
+    Class* class_info = object_class(object);
     for (uint32_t i = 0; i < class_info->interface_count; i++) {
         if (class_info->interfaces[i] == interface) {
             return true;
@@ -133,12 +198,12 @@ bool object_is_instance_of_interface(Object* object, Interface* interface) {
 // Field access
 struct Value object_get_field(Object* object, const char* field_name) {
     if (!object || !field_name) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
-    Field* field = class_find_field(object->header.class_info, field_name);
+    Field* field = class_find_field(object_class(object), field_name);
     if (!field || field->is_static) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
     // Calculate field address
@@ -146,13 +211,13 @@ struct Value object_get_field(Object* object, const char* field_name) {
     
     // TODO: Read field value based on type
     // For now, return null
-    return (struct Value){VALUE_NULL, {0}};
+    return (struct Value){ .type = VALUE_NULL };
 }
 
 void object_set_field(Object* object, const char* field_name, struct Value value) {
     if (!object || !field_name) return;
     
-    Field* field = class_find_field(object->header.class_info, field_name);
+    Field* field = class_find_field(object_class(object), field_name);
     if (!field || field->is_static) return;
     
     // Calculate field address
@@ -163,16 +228,16 @@ void object_set_field(Object* object, const char* field_name, struct Value value
 
 struct Value object_get_static_field(Class* class_info, const char* field_name) {
     if (!class_info || !field_name) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
     Field* field = class_find_field(class_info, field_name);
     if (!field || !field->is_static) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
     // TODO: Read static field value
-    return (struct Value){VALUE_NULL, {0}};
+    return (struct Value){ .type = VALUE_NULL };
 }
 
 void object_set_static_field(Class* class_info, const char* field_name, struct Value value) {
@@ -187,12 +252,12 @@ void object_set_static_field(Class* class_info, const char* field_name, struct V
 // Method calls
 struct Value object_call_method(Object* object, const char* method_name, struct Value* args, size_t arg_count) {
     if (!object || !method_name) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
-    Method* method = class_find_method(object->header.class_info, method_name);
+    Method* method = class_find_method(object_class(object), method_name);
     if (!method) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
     if (method->is_virtual) {
@@ -204,12 +269,12 @@ struct Value object_call_method(Object* object, const char* method_name, struct
 
 struct Value object_call_static_method(Class* class_info, const char* method_name, struct Value* args, size_t arg_count) {
     if (!class_info || !method_name) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
     Method* method = class_find_method(class_info, method_name);
     if (!method || !method->is_static) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
     return method_dispatch_static(method, args, arg_count);
@@ -217,11 +282,11 @@ struct Value object_call_static_method(Class* class_info, const char* method_nam
 
 struct Value object_call_virtual_method(Object* object, const char* method_name, struct Value* args, size_t arg_count) {
     if (!object || !method_name) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
     // Find method in class hierarchy
-    Class* current = object->header.class_info;
+    Class* current = object_class(object);
     while (current) {
         Method* method = class_find_method(current, method_name);
         if (method && method->is_virtual) {
@@ -230,7 +295,7 @@ struct Value object_call_virtual_method(Object* object, const char* method_name,
         current = current->superclass;
     }
     
-    return (struct Value){VALUE_NULL, {0}};
+    return (struct Value){ .type = VALUE_NULL };
 }
 
 // Class management
@@ -241,6 +306,7 @@ Class* class_create(const char* name, uint32_t type_id, uint32_t size) {
     if (!class_info) return NULL;
     
     class_info->type_id = type_id;
+    class_info->class_index = class_table_add(class_info);
     class_info->name = strdup(name);
     class_info->size = size;
     class_info->superclass = NULL;
@@ -261,6 +327,10 @@ Class* class_create(const char* name, uint32_t type_id, uint32_t size) {
 void class_destroy(Class* class_info) {
     if (!class_info) return;
     
+    if (class_info->class_index) {
+        object_class_table[class_info->class_index] = NULL;
+    }
+    
     // Free name
     if (class_info->name) {
         free(class_info->name);
@@ -498,36 +568,36 @@ Method* interface_find_method(Interface* interface, const char* name) {
 // Method dispatch
 struct Value method_dispatch_static(Method* method, struct Value* args, size_t arg_count) {
     if (!method) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
     // TODO: Implement static method dispatch
     // This would involve setting up a call frame and executing bytecode
-    return (struct Value){VALUE_NULL, {0}};
+    return (struct Value){ .type = VALUE_NULL };
 }
 
 struct Value method_dispatch_virtual(Object* object, Method* method, struct Value* args, size_t arg_count) {
     if (!object || !method) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
     // TODO: Implement virtual method dispatch
     // This would involve setting up a call frame with 'this' pointer and executing bytecode
-    return (struct Value){VALUE_NULL, {0}};
+    return (struct Value){ .type = VALUE_NULL };
 }
 
 struct Value method_dispatch_interface(Object* object, Interface* interface, const char* method_name, struct Value* args, size_t arg_count) {
     if (!object || !interface || !method_name) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
     Method* method = interface_find_method(interface, method_name);
     if (!method) {
-        return (struct Value){VALUE_NULL, {0}};
+        return (struct Value){ .type = VALUE_NULL };
     }
     
     // TODO: Implement interface method dispatch
-    return (struct Value){VALUE_NULL, {0}};
+    return (struct Value){ .type = VALUE_NULL };
 }
 
 // Object utilities
@@ -537,11 +607,10 @@ void object_print(Object* object) {
         return;
     }
     
-    printf("Object: %s (type_id=%u, ref_count=%u, size=%zu)\n",
-           object->header.class_info->name,
-           object->header.type_id,
-           object->header.ref_count,
-           object->header.size);
+    printf("Object: %s (type_id=%u, size=%zu)\n",
+           object_class(object)->name,
+           object_class(object)->type_id,
+           object_size(object));
 }
 
 void object_print_class_hierarchy(Class* class_info) {
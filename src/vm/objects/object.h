@@ -14,14 +14,30 @@ struct Value;
 struct Heap;
 
 // Object header - every object inherits from System.Object
+// 8 bytes: the class and type id come from the class table, the size from
+// the class (or the size word of a variable-size object).
 typedef struct ObjectHeader {
-    uint32_t type_id;           // Type identifier
-    uint32_t ref_count;         // Reference count for GC
-    uint32_t size;              // Object size in bytes
-    uint32_t flags;             // Object flags (immutable, pinned, etc.)
-    struct Class* class_info;   // Pointer to class metadata
+    uint32_t class_index;       // Index into the class table
+    uint32_t flags;             // GC mark/age bits and object flags
 } ObjectHeader;
 
+// Object header flags
+#define OBJECT_FLAG_MARKED      0x0001  // Reached during the current GC mark phase
+#define OBJECT_FLAG_OLD         0x0002  // Promoted to the old generation
+#define OBJECT_FLAG_SIZED       0x0004  // Variable size: data starts with a uint64_t total size
+#define OBJECT_FLAG_INTERNED    0x0008  // Canonical string from the string registry
+#define OBJECT_FLAG_ROPE        0x0010  // String concatenation node (RopeObject)
+#define OBJECT_FLAG_SLICE       0x0020  // Substring view (SliceObject)
+#define OBJECT_AGE_SHIFT        8       // Minor collections survived (bits 8-11)
+#define OBJECT_AGE_MASK         0x0F00
+
+// Field storage kinds (Field.type_id)
+#define FIELD_TYPE_I64          1
+#define FIELD_TYPE_F64          2
+#define FIELD_TYPE_BOOL         3
+#define FIELD_TYPE_STRING       4       // StringObject reference (traced by the GC)
+#define FIELD_TYPE_OBJECT       5       // Object reference (traced by the GC)
+
 // Complete object structure
 typedef struct Object {
     ObjectHeader header;        // Common header
@@ -41,6 +57,12 @@ typedef struct Field {
     struct Field* next;         // Linked list
 } Field;
 
+// Instance fields holding a heap reference (objects and strings)
+static inline bool field_is_reference(const Field* field) {
+    return !field->is_static &&
+           (field->type_id == FIELD_TYPE_OBJECT || field->type_id == FIELD_TYPE_STRING);
+}
+
 // Method information
 typedef struct Method {
     char* name;                 // Method name
@@ -72,6 +94,7 @@ typedef struct Interface {
 // Class metadata structure
 typedef struct Class {
     uint32_t type_id;           // Unique type identifier
+    uint32_t class_index;       // Slot in the class table (ObjectHeader.class_index)
     char* name;                 // Class name (e.g., "System.String")
     uint32_t size;              // Instance size
     struct Class* superclass;   // Parent class (for inheritance)
@@ -87,16 +110,28 @@ typedef struct Class {
     struct Class* next;         // Linked list for class registry
 } Class;
 
+// Class table - indexed by ObjectHeader.class_index, slot 0 is unused
+extern Class** object_class_table;
+
+static inline Class* object_class(const Object* object) {
+    return object_class_table[object->header.class_index];
+}
+
+// Total size of an object including its header
+static inline size_t object_size(const Object* object) {
+    if (object->header.flags & OBJECT_FLAG_SIZED) {
+        return (size_t)*(const uint64_t*)object->data;
+    }
+    return sizeof(ObjectHeader) + object_class(object)->size;
+}
+
 // Object creation and destruction
 Object* object_create(struct Heap* heap, Class* class_info);
+Object* object_create_sized(struct Heap* heap, Class* class_info, size_t data_size);
+Object* object_create_permanent(struct Heap* heap, Class* class_info, size_t data_size);
 void object_destroy(Object* object);
 Object* object_clone(Object* object);
 
-// Reference counting
-void object_add_reference(Object* object);
-void object_remove_reference(Object* object);
-uint32_t object_get_ref_count(Object* object);
-
 // Object properties
 Class* object_get_class(Object* object);
 uint32_t object_get_type_id(Object* object);
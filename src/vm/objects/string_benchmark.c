@@ -0,0 +1,133 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "utf8.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// String kernel benchmark - runs each UTF-8 kernel (code point count,
+// validation, case-insensitive compare and search) at every level the CPU
+// supports over large ASCII and mixed-script inputs, and reports the
+// throughput and the speedup over the scalar version.
+//
+// Usage: string_benchmark [megabytes] [repeats]
+
+#define DEFAULT_MEGABYTES 64
+#define DEFAULT_REPEATS 5
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Fill with whole copies of `pattern`, padding the end with ASCII
+static void fill_text(char* text, size_t length, const char* pattern) {
+    size_t pattern_length = strlen(pattern);
+    size_t i = 0;
+    for (; i + pattern_length <= length; i += pattern_length) {
+        memcpy(text + i, pattern, pattern_length);
+    }
+    memset(text + i, ' ', length - i);
+}
+
+typedef enum {
+    KERNEL_COUNT,
+    KERNEL_VALIDATE,
+    KERNEL_COMPARE,
+    KERNEL_SEARCH
+} Kernel;
+
+static const char* kernel_names[] = { "count code points", "validate", "compare ignore case", "index of ignore case" };
+
+// Result of one run, so the work cannot be optimized away
+static volatile int64_t bench_sink;
+
+static void run_kernel(Kernel kernel, const char* text, const char* other, size_t length,
+                       const char* needle, size_t needle_length) {
+    switch (kernel) {
+        case KERNEL_COUNT:
+            bench_sink = (int64_t)utf8_count_code_points(text, length);
+            break;
+        case KERNEL_VALIDATE:
+            bench_sink = utf8_validate(text, length, NULL);
+            break;
+        case KERNEL_COMPARE:
+            bench_sink = utf8_compare_ignore_case(text, length, other, length);
+            break;
+        case KERNEL_SEARCH:
+            bench_sink = utf8_index_of_ignore_case(text, length, needle, needle_length);
+            break;
+    }
+}
+
+// Best time of `repeats` runs
+static double time_kernel(Kernel kernel, int repeats, const char* text, const char* other, size_t length,
+                          const char* needle, size_t needle_length) {
+    double best = 0;
+    for (int r = 0; r < repeats; r++) {
+        double start = now_us();
+        run_kernel(kernel, text, other, length, needle, needle_length);
+        double elapsed = now_us() - start;
+        if (r == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+static void bench_input(const char* label, const char* pattern, size_t length, int repeats) {
+    char* text = malloc(length);
+    char* other = malloc(length);
+    if (!text || !other) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    fill_text(text, length, pattern);
+
+    // The compared copy differs only in case; the needle occurs at the end
+    memcpy(other, text, length);
+    for (size_t i = 0; i < length; i++) {
+        if (other[i] >= 'a' && other[i] <= 'z') other[i] = (char)(other[i] - 'a' + 'A');
+    }
+    const char* needle = "Needle In The Haystack";
+    size_t needle_length = strlen(needle);
+    memcpy(text + length - needle_length, "NEEDLE in the haystack", needle_length);
+
+    printf("%s (%zu MB):\n", label, length / (1024 * 1024));
+    printf("  kernel                 level     GB/s    speedup\n");
+    for (Kernel kernel = KERNEL_COUNT; kernel <= KERNEL_SEARCH; kernel++) {
+        double scalar_us = 0;
+        for (Utf8KernelLevel level = UTF8_KERNELS_SCALAR; level <= utf8_best_kernel_level(); level++) {
+            utf8_set_kernel_level(level);
+            double us = time_kernel(kernel, repeats, text, other, length, needle, needle_length);
+            if (level == UTF8_KERNELS_SCALAR) scalar_us = us;
+            printf("  %-22s %-7s %7.2f %8.1fx\n", kernel_names[kernel], utf8_kernel_level_name(level),
+                   length / (us * 1e3), scalar_us / us);
+        }
+    }
+    printf("\n");
+
+    free(text);
+    free(other);
+}
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = argc > 1 ? (size_t)atol(argv[1]) : DEFAULT_MEGABYTES;
+    int repeats = argc > 2 ? atoi(argv[2]) : DEFAULT_REPEATS;
+    if (megabytes == 0 || repeats <= 0) {
+        fprintf(stderr, "Usage: %s [megabytes] [repeats]\n", argv[0]);
+        return 1;
+    }
+
+    printf("He³ String Kernel Benchmark\n");
+    printf("===========================\n");
+    printf("Input: %zu MB, best of %d runs, best level: %s\n\n",
+           megabytes, repeats, utf8_kernel_level_name(utf8_best_kernel_level()));
+
+    size_t length = megabytes * 1024 * 1024;
+    bench_input("ASCII text", "The quick brown fox jumps over the lazy dog. ", length, repeats);
+    bench_input("Mixed-script text", "Grüße, 世界! Привет, мир. Γειά σου κόσμε. 🚀 ", length, repeats);
+
+    utf8_set_kernel_level(utf8_best_kernel_level());
+    return 0;
+}
@@ -0,0 +1,414 @@
+#include "string_object.h"
+#include "../memory/heap.h"
+#include <stdlib.h>
+
+uint32_t string_hash_bytes(const char* chars, size_t length) {
+    uint32_t hash = 5381;
+    for (size_t i = 0; i < length; i++) {
+        hash = ((hash << 5) + hash) + (uint8_t)chars[i]; // hash * 33 + c
+    }
+    return hash;
+}
+
+// 33^exponent modulo 2^32
+static uint32_t string_hash_power(uint32_t exponent) {
+    uint32_t result = 1;
+    uint32_t base = 33;
+    while (exponent) {
+        if (exponent & 1) result *= base;
+        base *= base;
+        exponent >>= 1;
+    }
+    return result;
+}
+
+// djb2 of a concatenation from the hashes of its parts:
+// hash(ab) = (hash(a) - 5381) * 33^|b| + hash(b)
+static uint32_t string_hash_concat(uint32_t left_hash, uint32_t right_hash, uint32_t right_length) {
+    return (left_hash - 5381) * string_hash_power(right_length) + right_hash;
+}
+
+// Payload after the object layer's size word
+static size_t string_data_size(size_t length) {
+    return sizeof(StringObject) - sizeof(ObjectHeader) - sizeof(uint64_t) + length + 1;
+}
+
+// Uninitialized string with room for `length` bytes
+static StringObject* string_allocate(struct Heap* heap, Class* string_class, size_t length) {
+    if (length > UINT32_MAX) return NULL;
+
+    StringObject* string = (StringObject*)object_create_sized(heap, string_class, string_data_size(length));
+    if (string) {
+        string->length = (uint32_t)length;
+    }
+    return string;
+}
+
+static StringObject* string_init(Object* object, const char* chars, size_t length) {
+    StringObject* string = (StringObject*)object;
+    string->length = (uint32_t)length;
+    string->hash = string_hash_bytes(chars, length);
+    memcpy(string->chars, chars, length);
+    string->chars[length] = '\0';
+    return string;
+}
+
+StringObject* string_create(struct Heap* heap, Class* string_class, const char* chars, size_t length) {
+    if (!chars || length > UINT32_MAX) return NULL;
+
+    Object* object = object_create_sized(heap, string_class, string_data_size(length));
+    return object ? string_init(object, chars, length) : NULL;
+}
+
+StringObject* string_create_permanent(struct Heap* heap, Class* string_class, const char* chars, size_t length) {
+    if (!chars || length > UINT32_MAX) return NULL;
+
+    Object* object = object_create_permanent(heap, string_class, string_data_size(length));
+    if (!object) return NULL;
+    object->header.flags |= OBJECT_FLAG_INTERNED;
+    return string_init(object, chars, length);
+}
+
+// Copy the bytes of a string into `out` without allocating. Both children of
+// a node start at known offsets, so a leaf child is copied directly and only
+// nodes whose children are both ropes defer one of them.
+static bool string_copy_chars(const StringObject* string, char* out) {
+    const StringObject* local_nodes[32];
+    size_t local_offsets[32];
+    const StringObject** nodes = local_nodes;
+    size_t* offsets = local_offsets;
+    size_t capacity = 32;
+    size_t count = 0;
+    bool ok = true;
+
+    const StringObject* node = string;
+    size_t offset = 0;
+    for (;;) {
+        const char* bytes = string_bytes(node);
+        if (bytes) {
+            memcpy(out + offset, bytes, node->length);
+        } else {
+            const RopeObject* rope = (const RopeObject*)node;
+            const StringObject* left = rope->left;
+            const StringObject* right = rope->right;
+            const char* left_bytes = string_bytes(left);
+            const char* right_bytes = string_bytes(right);
+            size_t right_offset = offset + left->length;
+
+            if (right_bytes) {
+                memcpy(out + right_offset, right_bytes, right->length);
+                node = left;
+                continue;
+            }
+            if (left_bytes) {
+                memcpy(out + offset, left_bytes, left->length);
+                node = right;
+                offset = right_offset;
+                continue;
+            }
+
+            if (count == capacity) {
+                size_t new_capacity = capacity * 2;
+                const StringObject** new_nodes = malloc(new_capacity * sizeof(*new_nodes));
+                size_t* new_offsets = malloc(new_capacity * sizeof(*new_offsets));
+                if (!new_nodes || !new_offsets) {
+                    free(new_nodes);
+                    free(new_offsets);
+                    ok = false;
+                    break;
+                }
+                memcpy(new_nodes, nodes, count * sizeof(*nodes));
+                memcpy(new_offsets, offsets, count * sizeof(*offsets));
+                if (nodes != local_nodes) {
+                    free(nodes);
+                    free(offsets);
+                }
+                nodes = new_nodes;
+                offsets = new_offsets;
+                capacity = new_capacity;
+            }
+            nodes[count] = right;
+            offsets[count] = right_offset;
+            count++;
+            node = left;
+            continue;
+        }
+
+        if (count == 0) break;
+        count--;
+        node = nodes[count];
+        offset = offsets[count];
+    }
+
+    if (nodes != local_nodes) {
+        free(nodes);
+        free(offsets);
+    }
+    return ok;
+}
+
+StringObject* string_concat(struct Heap* heap, Class* rope_class, StringObject* left, StringObject* right) {
+    if (!heap || !rope_class || !left || !right) return NULL;
+    if (left->length == 0) return right;
+    if (right->length == 0) return left;
+
+    size_t length = (size_t)left->length + right->length;
+    if (length > UINT32_MAX) return NULL;
+    uint32_t hash = string_hash_concat(left->hash, right->hash, right->length);
+
+    if (length < STRING_ROPE_MIN_LENGTH) {
+        // Neither part is a rope: ropes are never this short
+        StringObject* string = string_allocate(heap, rope_class->superclass, length);
+        if (!string) return NULL;
+        memcpy(string->chars, string_bytes(left), left->length);
+        memcpy(string->chars + left->length, string_bytes(right), right->length);
+        string->chars[length] = '\0';
+        string->hash = hash;
+        return string;
+    }
+
+    RopeObject* rope = (RopeObject*)object_create_sized(heap, rope_class,
+        sizeof(RopeObject) - sizeof(ObjectHeader) - sizeof(uint64_t));
+    if (!rope) return NULL;
+    rope->header.flags |= OBJECT_FLAG_ROPE;
+    rope->length = (uint32_t)length;
+    rope->hash = hash;
+    rope->left = left;
+    rope->right = right;
+    return (StringObject*)rope;
+}
+
+const char* string_flatten_rope(struct Heap* heap, StringObject* string) {
+    if (!heap || !string) return NULL;
+
+    const char* bytes = string_bytes(string);
+    if (bytes) return bytes;
+
+    RopeObject* rope = (RopeObject*)string;
+    Class* string_class = object_class((Object*)rope)->superclass;
+    StringObject* flat = string_allocate(heap, string_class, rope->length);
+    if (!flat) return NULL;
+    if (!string_copy_chars(string, flat->chars)) return NULL;
+    flat->chars[rope->length] = '\0';
+    flat->hash = rope->hash;
+
+    // Forward to the flat copy so the parts can be collected
+    gc_satb_barrier(heap, (Object*)rope->left);
+    gc_satb_barrier(heap, (Object*)rope->right);
+    rope->left = flat;
+    rope->right = NULL;
+    gc_write_barrier(heap, (Object*)rope);
+    return flat->chars;
+}
+
+// The flat string that owns the bytes of a string whose bytes are available
+static StringObject* string_owner(StringObject* string) {
+    if (string_is_slice(string)) return ((SliceObject*)string)->parent;
+    if (string_is_rope(string)) return ((RopeObject*)string)->left;
+    return string;
+}
+
+StringObject* string_substring(struct Heap* heap, Class* slice_class, StringObject* string,
+                               size_t start, size_t length) {
+    if (!heap || !slice_class || !string) return NULL;
+    if (start > string->length || length > string->length - start) return NULL;
+    if (start == 0 && length == string->length) return string;
+
+    const char* bytes = string_flatten(heap, string);
+    if (!bytes) return NULL;
+
+    StringObject* parent = string_owner(string);
+    size_t offset = (size_t)(bytes - parent->chars) + start;
+    bool pins_parent = parent->length >= STRING_SLICE_PIN_LIMIT &&
+                       length * STRING_SLICE_PIN_RATIO < parent->length;
+
+    if (length < STRING_SLICE_MIN_LENGTH || pins_parent) {
+        StringObject* copy = string_allocate(heap, slice_class->superclass, length);
+        if (!copy) return NULL;
+        // The parent is reachable from `string`, so its bytes survive the allocation
+        memcpy(copy->chars, parent->chars + offset, length);
+        copy->chars[length] = '\0';
+        copy->hash = string_hash_bytes(copy->chars, length);
+        return copy;
+    }
+
+    SliceObject* slice = (SliceObject*)object_create_sized(heap, slice_class,
+        sizeof(SliceObject) - sizeof(ObjectHeader) - sizeof(uint64_t));
+    if (!slice) return NULL;
+    parent = string_owner(string);
+    slice->header.flags |= OBJECT_FLAG_SLICE;
+    slice->length = (uint32_t)length;
+    slice->hash = string_hash_bytes(parent->chars + offset, length);
+    slice->parent = parent;
+    slice->offset = offset;
+    return (StringObject*)slice;
+}
+
+#define STRING_BYTE_BIT(set, byte) ((set)[(byte) / (8 * sizeof(size_t))] & ((size_t)1 << ((byte) % (8 * sizeof(size_t)))))
+
+// Two-way string matching (Crochemore-Perrin): linear time and constant
+// space for any needle. `needle_length` is at least 2.
+static const unsigned char* string_two_way_search(const unsigned char* haystack, const unsigned char* end,
+                                                  const unsigned char* needle, size_t needle_length) {
+    size_t byte_set[256 / (8 * sizeof(size_t))] = { 0 };
+    size_t shift[256];
+    for (size_t i = 0; i < needle_length; i++) {
+        byte_set[needle[i] / (8 * sizeof(size_t))] |= (size_t)1 << (needle[i] % (8 * sizeof(size_t)));
+        shift[needle[i]] = i + 1;
+    }
+
+    // Critical factorization: the maximal suffix under both byte orders
+    size_t suffix[2];
+    size_t period[2];
+    for (int order = 0; order < 2; order++) {
+        size_t ip = (size_t)-1, jp = 0, k = 1, p = 1;
+        while (jp + k < needle_length) {
+            unsigned char a = needle[ip + k];
+            unsigned char b = needle[jp + k];
+            if (a == b) {
+                if (k == p) {
+                    jp += p;
+                    k = 1;
+                } else {
+                    k++;
+                }
+            } else if (order == 0 ? a > b : a < b) {
+                jp += k;
+                k = 1;
+                p = jp - ip;
+            } else {
+                ip = jp++;
+                k = p = 1;
+            }
+        }
+        suffix[order] = ip;
+        period[order] = p;
+    }
+    size_t split = suffix[0];
+    size_t p = period[0];
+    if (suffix[1] + 1 > suffix[0] + 1) {
+        split = suffix[1];
+        p = period[1];
+    }
+
+    // A periodic needle remembers how much of its prefix already matched
+    size_t memory_reset;
+    if (memcmp(needle, needle + p, split + 1) != 0) {
+        memory_reset = 0;
+        size_t right = needle_length - split - 1;
+        p = (split > right ? split : right) + 1;
+    } else {
+        memory_reset = needle_length - p;
+    }
+
+    size_t memory = 0;
+    const unsigned char* h = haystack;
+    for (;;) {
+        if ((size_t)(end - h) < needle_length) return NULL;
+
+        // Skip on the last byte of the window first
+        unsigned char last = h[needle_length - 1];
+        if (!STRING_BYTE_BIT(byte_set, last)) {
+            h += needle_length;
+            memory = 0;
+            continue;
+        }
+        size_t k = needle_length - shift[last];
+        if (k) {
+            if (k < memory) k = memory;
+            h += k;
+            memory = 0;
+            continue;
+        }
+
+        // Right half, then left half
+        for (k = (split + 1 > memory ? split + 1 : memory); k < needle_length && needle[k] == h[k]; k++);
+        if (k < needle_length) {
+            h += k - split;
+            memory = 0;
+            continue;
+        }
+        for (k = split + 1; k > memory && needle[k - 1] == h[k - 1]; k--);
+        if (k <= memory) return h;
+        h += p;
+        memory = memory_reset;
+    }
+}
+
+int64_t string_index_of(const char* haystack, size_t haystack_length,
+                        const char* needle, size_t needle_length) {
+    if (needle_length == 0) return 0;
+    if (!haystack || !needle || needle_length > haystack_length) return -1;
+
+    const unsigned char* h = (const unsigned char*)haystack;
+    const unsigned char* end = h + haystack_length;
+    const unsigned char* n = (const unsigned char*)needle;
+
+    // Candidates come from the C library's vectorized memchr on the first
+    // byte. Once verifying false candidates has cost more than the scan
+    // itself, the rest is searched with the linear-time two-way algorithm.
+    size_t budget = 256;
+    const unsigned char* last_start = end - needle_length;
+    const unsigned char* at = h;
+    while (at <= last_start) {
+        at = memchr(at, n[0], (size_t)(last_start - at) + 1);
+        if (!at) return -1;
+        if (needle_length == 1) return at - h;
+
+        size_t k = 1;
+        while (k < needle_length && at[k] == n[k]) k++;
+        if (k == needle_length) return at - h;
+
+        if (k > budget) {
+            const unsigned char* found = string_two_way_search(at + 1, end, n, needle_length);
+            return found ? found - h : -1;
+        }
+        budget = budget - k + 16;
+        at++;
+    }
+    return -1;
+}
+
+StringBuilderObject* string_builder_create(struct Heap* heap, Class* builder_class) {
+    return (StringBuilderObject*)object_create(heap, builder_class);
+}
+
+bool string_builder_append(struct Heap* heap, Class* string_class, StringBuilderObject* builder,
+                           const StringObject* string) {
+    if (!heap || !string_class || !builder || !string) return false;
+
+    size_t needed = builder->length + string->length;
+    if (needed > UINT32_MAX) return false;
+
+    StringObject* buffer = builder->buffer;
+    size_t capacity = buffer ? buffer->length : 0;
+    if (needed > capacity) {
+        // Geometric growth keeps appends amortized O(1)
+        size_t new_capacity = capacity ? capacity * 2 : 16;
+        if (new_capacity < needed) new_capacity = needed;
+        if (new_capacity > UINT32_MAX) new_capacity = UINT32_MAX;
+
+        StringObject* grown = string_allocate(heap, string_class, new_capacity);
+        if (!grown) return false;
+        if (builder->length) {
+            memcpy(grown->chars, builder->buffer->chars, builder->length);
+        }
+
+        gc_satb_barrier(heap, (Object*)builder->buffer);
+        builder->buffer = grown;
+        gc_write_barrier(heap, (Object*)builder);
+        buffer = grown;
+    }
+
+    if (!string_copy_chars(string, buffer->chars + builder->length)) return false;
+    builder->length = needed;
+    return true;
+}
+
+StringObject* string_builder_to_string(struct Heap* heap, Class* string_class, StringBuilderObject* builder) {
+    if (!builder) return NULL;
+
+    static const char empty[] = "";
+    const char* chars = builder->buffer ? builder->buffer->chars : empty;
+    return string_create(heap, string_class, chars, builder->length);
+}
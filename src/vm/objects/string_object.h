@@ -0,0 +1,147 @@
+#pragma once
+
+#include "object.h"
+#include <string.h>
+
+// Immutable string object (System.String). A variable-size object: the
+// object layer's size word comes first, then the length, the cached hash
+// and the NUL-terminated UTF-8 bytes.
+typedef struct StringObject {
+    ObjectHeader header;
+    uint64_t size;              // Total object size (OBJECT_FLAG_SIZED)
+    uint32_t length;            // Length in bytes, excluding the terminator
+    uint32_t hash;              // string_hash_bytes of the contents
+    char chars[];               // UTF-8 bytes, NUL-terminated
+} StringObject;
+
+// Concatenation node (System.Rope, a subclass of System.String). Shares the
+// size, length and hash prefix of StringObject; the bytes are copied into a
+// flat string the first time they are needed and the node then forwards to
+// it through `left`.
+typedef struct RopeObject {
+    ObjectHeader header;
+    uint64_t size;              // Total object size (OBJECT_FLAG_SIZED)
+    uint32_t length;            // left->length + right->length
+    uint32_t hash;              // Hash of the concatenated contents
+    struct StringObject* left;  // First part, or the flat string once flattened
+    struct StringObject* right; // Second part, NULL once flattened
+} RopeObject;
+
+// Substring view (System.Slice, a subclass of System.String). Shares the
+// bytes of a flat parent string instead of copying them, so its bytes are
+// not NUL-terminated.
+typedef struct SliceObject {
+    ObjectHeader header;
+    uint64_t size;              // Total object size (OBJECT_FLAG_SIZED)
+    uint32_t length;            // Length in bytes
+    uint32_t hash;              // Hash of the slice contents
+    struct StringObject* parent; // Flat string holding the bytes
+    uint64_t offset;            // Byte offset of the slice in parent
+} SliceObject;
+
+// Growable character buffer behind System.StringBuilder. Appends double the
+// buffer when it is full; the result is copied out once by
+// string_builder_to_string.
+typedef struct StringBuilderObject {
+    ObjectHeader header;
+    struct StringObject* buffer; // Character storage, capacity buffer->length (NULL = empty)
+    uint64_t length;             // Bytes appended so far
+} StringBuilderObject;
+
+// Concatenations shorter than this are copied instead of building a rope
+#define STRING_ROPE_MIN_LENGTH  16
+
+// Substrings shorter than this are copied; the copy is no larger than a view
+#define STRING_SLICE_MIN_LENGTH 32
+
+// A view into a parent of at least STRING_SLICE_PIN_LIMIT bytes must cover
+// 1/STRING_SLICE_PIN_RATIO of it. Smaller slices are copied so that they do
+// not keep a huge parent alive.
+#define STRING_SLICE_PIN_LIMIT  (64 * 1024)
+#define STRING_SLICE_PIN_RATIO  64
+
+// Hash of a byte string (djb2)
+uint32_t string_hash_bytes(const char* chars, size_t length);
+
+// Create a string on the GC heap (young generation)
+StringObject* string_create(struct Heap* heap, Class* string_class, const char* chars, size_t length);
+
+// Create a string that is never collected. Used for interned strings;
+// returns NULL if the heap has no permanent generation.
+StringObject* string_create_permanent(struct Heap* heap, Class* string_class, const char* chars, size_t length);
+
+// Concatenate two strings. Short results are copied into a flat string,
+// longer ones become a rope node referencing both parts; the caller keeps
+// `left` and `right` rooted across the allocation.
+StringObject* string_concat(struct Heap* heap, Class* rope_class, StringObject* left, StringObject* right);
+
+// Copy a rope into a new flat string (of the rope class's superclass) and
+// forward the rope to it; returns the contents. The caller keeps `string`
+// rooted across the allocation. Returns NULL only if the allocation fails.
+const char* string_flatten_rope(struct Heap* heap, StringObject* string);
+
+// Substring of `length` bytes at byte offset `start`, which the caller has
+// bounds-checked. Long substrings are views sharing the parent's bytes
+// (see STRING_SLICE_*); a rope is flattened first. The caller keeps
+// `string` rooted across the allocation.
+StringObject* string_substring(struct Heap* heap, Class* slice_class, StringObject* string,
+                               size_t start, size_t length);
+
+// Byte offset of the first occurrence of `needle` in `haystack`, or -1
+int64_t string_index_of(const char* haystack, size_t haystack_length,
+                        const char* needle, size_t needle_length);
+
+// Create an empty StringBuilder
+StringBuilderObject* string_builder_create(struct Heap* heap, Class* builder_class);
+
+// Append the contents of `string` (flat or rope, without flattening it).
+// The caller keeps `builder` and `string` rooted across the allocation.
+bool string_builder_append(struct Heap* heap, Class* string_class, StringBuilderObject* builder,
+                           const StringObject* string);
+
+// The appended contents as a new string
+StringObject* string_builder_to_string(struct Heap* heap, Class* string_class, StringBuilderObject* builder);
+
+static inline bool string_is_interned(const StringObject* string) {
+    return (string->header.flags & OBJECT_FLAG_INTERNED) != 0;
+}
+
+static inline bool string_is_rope(const StringObject* string) {
+    return (string->header.flags & OBJECT_FLAG_ROPE) != 0;
+}
+
+static inline bool string_is_slice(const StringObject* string) {
+    return (string->header.flags & OBJECT_FLAG_SLICE) != 0;
+}
+
+// Contiguous bytes of a string: its own characters, the parent's bytes of a
+// slice, the forwarded contents of a flattened rope, or NULL for a rope
+// that has not been flattened yet. Only a plain string is NUL-terminated.
+static inline const char* string_bytes(const StringObject* string) {
+    if (string_is_slice(string)) {
+        const SliceObject* slice = (const SliceObject*)string;
+        return slice->parent->chars + slice->offset;
+    }
+    if (string_is_rope(string)) {
+        const RopeObject* rope = (const RopeObject*)string;
+        return rope->right ? NULL : rope->left->chars;
+    }
+    return string->chars;
+}
+
+// Contiguous bytes of a string, flattening a rope on first use
+static inline const char* string_flatten(struct Heap* heap, StringObject* string) {
+    const char* bytes = string_bytes(string);
+    return bytes ? bytes : string_flatten_rope(heap, string);
+}
+
+// Content equality of strings whose bytes are available (see
+// string_flatten). Identical references are equal and two distinct
+// interned strings never are, so only mixed pairs compare bytes.
+static inline bool string_equals(const StringObject* a, const StringObject* b) {
+    if (a == b) return true;
+    if (!a || !b) return false;
+    if (string_is_interned(a) && string_is_interned(b)) return false;
+    return a->length == b->length && a->hash == b->hash &&
+           memcmp(string_bytes(a), string_bytes(b), a->length) == 0;
+}
@@ -0,0 +1,490 @@
+#include "utf8.h"
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define UTF8_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+typedef struct Utf8Kernels {
+    size_t (*count_code_points)(const unsigned char* bytes, size_t length);
+    bool (*validate)(const unsigned char* bytes, size_t length);
+    // Length of the common prefix of two buffers, ignoring ASCII case
+    size_t (*mismatch_ignore_case)(const unsigned char* a, const unsigned char* b, size_t length);
+    int64_t (*index_of_ignore_case)(const unsigned char* haystack, size_t haystack_length,
+                                    const unsigned char* needle, size_t needle_length);
+} Utf8Kernels;
+
+static inline unsigned char utf8_fold(unsigned char byte) {
+    return (byte >= 'A' && byte <= 'Z') ? (unsigned char)(byte | 0x20) : byte;
+}
+
+// ============================================================================
+// SCALAR KERNELS
+// ============================================================================
+
+static size_t utf8_scalar_count_code_points(const unsigned char* bytes, size_t length) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++) {
+        count += (bytes[i] & 0xC0) != 0x80;
+    }
+    return count;
+}
+
+// Length of the well-formed sequence starting at `bytes`, or 0
+static size_t utf8_sequence_length(const unsigned char* bytes, size_t remaining) {
+    unsigned char lead = bytes[0];
+    if (lead < 0x80) return 1;
+
+    size_t continuations;
+    uint32_t code_point;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        continuations = 1;
+        code_point = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        continuations = 2;
+        code_point = lead & 0x0F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        continuations = 3;
+        code_point = lead & 0x07;
+    } else {
+        return 0;
+    }
+    if (remaining <= continuations) return 0;
+
+    for (size_t k = 1; k <= continuations; k++) {
+        if ((bytes[k] & 0xC0) != 0x80) return 0;
+        code_point = (code_point << 6) | (bytes[k] & 0x3F);
+    }
+    if (continuations == 2 && (code_point < 0x800 || (code_point >= 0xD800 && code_point <= 0xDFFF))) return 0;
+    if (continuations == 3 && (code_point < 0x10000 || code_point > 0x10FFFF)) return 0;
+    return continuations + 1;
+}
+
+// Offset of the first ill-formed sequence, or `length`
+static size_t utf8_scalar_error_offset(const unsigned char* bytes, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        size_t sequence = utf8_sequence_length(bytes + i, length - i);
+        if (sequence == 0) return i;
+        i += sequence;
+    }
+    return length;
+}
+
+static bool utf8_scalar_validate(const unsigned char* bytes, size_t length) {
+    return utf8_scalar_error_offset(bytes, length) == length;
+}
+
+static size_t utf8_scalar_mismatch_ignore_case(const unsigned char* a, const unsigned char* b, size_t length) {
+    size_t i = 0;
+    while (i < length && utf8_fold(a[i]) == utf8_fold(b[i])) i++;
+    return i;
+}
+
+static int64_t utf8_scalar_index_of_ignore_case(const unsigned char* haystack, size_t haystack_length,
+                                                const unsigned char* needle, size_t needle_length) {
+    unsigned char first = utf8_fold(needle[0]);
+    for (size_t i = 0; i + needle_length <= haystack_length; i++) {
+        if (utf8_fold(haystack[i]) == first &&
+            utf8_scalar_mismatch_ignore_case(haystack + i + 1, needle + 1, needle_length - 1) == needle_length - 1) {
+            return (int64_t)i;
+        }
+    }
+    return -1;
+}
+
+static const Utf8Kernels utf8_scalar_kernels = {
+    utf8_scalar_count_code_points,
+    utf8_scalar_validate,
+    utf8_scalar_mismatch_ignore_case,
+    utf8_scalar_index_of_ignore_case
+};
+
+#ifdef UTF8_X86_KERNELS
+
+// ============================================================================
+// SSE2 KERNELS (baseline on x86-64)
+// ============================================================================
+
+static size_t utf8_sse2_count_code_points(const unsigned char* bytes, size_t length) {
+    // Continuation bytes 0x80-0xBF are the signed bytes -128..-65
+    const __m128i continuation_limit = _mm_set1_epi8(-65);
+    size_t count = 0;
+    size_t i = 0;
+    while (length - i >= 16) {
+        // Per-byte counters are summed before they can overflow
+        size_t blocks = (length - i) / 16;
+        if (blocks > 255) blocks = 255;
+        __m128i counters = _mm_setzero_si128();
+        for (size_t b = 0; b < blocks; b++, i += 16) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)(bytes + i));
+            counters = _mm_sub_epi8(counters, _mm_cmpgt_epi8(chunk, continuation_limit));
+        }
+        __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+        count += (size_t)_mm_cvtsi128_si64(sums) + (size_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+    }
+    return count + utf8_scalar_count_code_points(bytes + i, length - i);
+}
+
+// ASCII runs are checked 16 bytes at a time; multi-byte sequences one by one
+static bool utf8_sse2_validate(const unsigned char* bytes, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        if (length - i >= 16) {
+            int non_ascii = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(bytes + i)));
+            if (non_ascii == 0) {
+                i += 16;
+                continue;
+            }
+            i += (size_t)__builtin_ctz((unsigned)non_ascii);
+        }
+        size_t sequence = utf8_sequence_length(bytes + i, length - i);
+        if (sequence == 0) return false;
+        i += sequence;
+    }
+    return true;
+}
+
+static inline __m128i utf8_sse2_fold(__m128i chunk) {
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('A' - 1)),
+                                  _mm_cmplt_epi8(chunk, _mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(chunk, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+static size_t utf8_sse2_mismatch_ignore_case(const unsigned char* a, const unsigned char* b, size_t length) {
+    size_t i = 0;
+    for (; length - i >= 16; i += 16) {
+        __m128i folded_a = utf8_sse2_fold(_mm_loadu_si128((const __m128i*)(a + i)));
+        __m128i folded_b = utf8_sse2_fold(_mm_loadu_si128((const __m128i*)(b + i)));
+        unsigned equal = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(folded_a, folded_b));
+        if (equal != 0xFFFF) return i + (size_t)__builtin_ctz(~equal);
+    }
+    return i + utf8_scalar_mismatch_ignore_case(a + i, b + i, length - i);
+}
+
+// Candidates must match the needle's first and last bytes; the 16 windows
+// starting in a chunk are filtered at once
+static int64_t utf8_sse2_index_of_ignore_case(const unsigned char* haystack, size_t haystack_length,
+                                              const unsigned char* needle, size_t needle_length) {
+    const __m128i first = _mm_set1_epi8((char)utf8_fold(needle[0]));
+    const __m128i last = _mm_set1_epi8((char)utf8_fold(needle[needle_length - 1]));
+    size_t middle = needle_length > 2 ? needle_length - 2 : 0;
+    size_t i = 0;
+    for (; i + needle_length - 1 + 16 <= haystack_length; i += 16) {
+        __m128i starts = utf8_sse2_fold(_mm_loadu_si128((const __m128i*)(haystack + i)));
+        __m128i ends = utf8_sse2_fold(_mm_loadu_si128((const __m128i*)(haystack + i + needle_length - 1)));
+        unsigned candidates = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(starts, first), _mm_cmpeq_epi8(ends, last)));
+        while (candidates) {
+            size_t at = i + (size_t)__builtin_ctz(candidates);
+            if (utf8_sse2_mismatch_ignore_case(haystack + at + 1, needle + 1, middle) == middle) {
+                return (int64_t)at;
+            }
+            candidates &= candidates - 1;
+        }
+    }
+    int64_t rest = utf8_scalar_index_of_ignore_case(haystack + i, haystack_length - i, needle, needle_length);
+    return rest < 0 ? -1 : (int64_t)i + rest;
+}
+
+static const Utf8Kernels utf8_sse2_kernels = {
+    utf8_sse2_count_code_points,
+    utf8_sse2_validate,
+    utf8_sse2_mismatch_ignore_case,
+    utf8_sse2_index_of_ignore_case
+};
+
+// ============================================================================
+// AVX2 KERNELS (selected at run time)
+// ============================================================================
+
+#define UTF8_AVX2 __attribute__((target("avx2")))
+
+UTF8_AVX2 static size_t utf8_avx2_count_code_points(const unsigned char* bytes, size_t length) {
+    const __m256i continuation_limit = _mm256_set1_epi8(-65);
+    size_t count = 0;
+    size_t i = 0;
+    while (length - i >= 32) {
+        size_t blocks = (length - i) / 32;
+        if (blocks > 255) blocks = 255;
+        __m256i counters = _mm256_setzero_si256();
+        for (size_t b = 0; b < blocks; b++, i += 32) {
+            __m256i chunk = _mm256_loadu_si256((const __m256i*)(bytes + i));
+            counters = _mm256_sub_epi8(counters, _mm256_cmpgt_epi8(chunk, continuation_limit));
+        }
+        __m256i sums = _mm256_sad_epu8(counters, _mm256_setzero_si256());
+        count += (size_t)_mm256_extract_epi64(sums, 0) + (size_t)_mm256_extract_epi64(sums, 1) +
+                 (size_t)_mm256_extract_epi64(sums, 2) + (size_t)_mm256_extract_epi64(sums, 3);
+    }
+    return count + utf8_scalar_count_code_points(bytes + i, length - i);
+}
+
+// Error classes of a byte pair (Keiser and Lemire, "Validating UTF-8 in less
+// than one instruction per byte"). Each table maps a nibble of the pair to
+// the errors it is compatible with; a pair is ill-formed when all three
+// lookups agree on some error.
+#define UTF8_TOO_SHORT      (1 << 0)  // Lead byte not followed by a continuation
+#define UTF8_TOO_LONG       (1 << 1)  // ASCII followed by a continuation
+#define UTF8_OVERLONG_3     (1 << 2)  // E0 80..9F
+#define UTF8_TOO_LARGE      (1 << 3)  // F4 90..BF, F5..FF
+#define UTF8_SURROGATE      (1 << 4)  // ED A0..BF
+#define UTF8_OVERLONG_2     (1 << 5)  // C0, C1
+#define UTF8_TOO_LARGE_1000 (1 << 6)  // F5..FF 80..8F
+#define UTF8_OVERLONG_4     (1 << 6)  // F0 80..8F
+#define UTF8_TWO_CONTS      (1 << 7)  // Two continuations, valid only inside a 3- or 4-byte sequence
+#define UTF8_CARRY          (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+#define UTF8_TABLE(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+
+UTF8_AVX2 static inline __m256i utf8_avx2_previous(__m256i input, __m256i previous_input, int distance) {
+    __m256i shifted_in = _mm256_permute2x128_si256(previous_input, input, 0x21);
+    switch (distance) {
+        case 1: return _mm256_alignr_epi8(input, shifted_in, 15);
+        case 2: return _mm256_alignr_epi8(input, shifted_in, 14);
+        default: return _mm256_alignr_epi8(input, shifted_in, 13);
+    }
+}
+
+UTF8_AVX2 static inline __m256i utf8_avx2_check_block(__m256i input, __m256i previous_input) {
+    const __m256i byte_1_high_table = UTF8_TABLE(
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+        UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        (char)(UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4));
+    const __m256i byte_1_low_table = UTF8_TABLE(
+        (char)(UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4),
+        (char)(UTF8_CARRY | UTF8_OVERLONG_2),
+        (char)UTF8_CARRY,
+        (char)UTF8_CARRY,
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000));
+    const __m256i byte_2_high_table = UTF8_TABLE(
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4),
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE),
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE),
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE),
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT);
+    const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+
+    __m256i previous_1 = utf8_avx2_previous(input, previous_input, 1);
+    __m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_table,
+        _mm256_and_si256(_mm256_srli_epi16(previous_1, 4), low_nibble));
+    __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(previous_1, low_nibble));
+    __m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_table,
+        _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+    __m256i special_cases = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    // Two continuations in a row are expected exactly at the third and
+    // fourth bytes of longer sequences
+    __m256i third_byte = _mm256_subs_epu8(utf8_avx2_previous(input, previous_input, 2), _mm256_set1_epi8((char)(0xE0 - 0x80)));
+    __m256i fourth_byte = _mm256_subs_epu8(utf8_avx2_previous(input, previous_input, 3), _mm256_set1_epi8((char)(0xF0 - 0x80)));
+    __m256i must_be_continuation = _mm256_and_si256(_mm256_or_si256(third_byte, fourth_byte), _mm256_set1_epi8((char)0x80));
+    return _mm256_xor_si256(must_be_continuation, special_cases);
+}
+
+UTF8_AVX2 static bool utf8_avx2_validate(const unsigned char* bytes, size_t length) {
+    // Non-zero where one of the last three bytes starts a sequence that
+    // does not fit in the block
+    const __m256i incomplete_limit = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+    __m256i error = _mm256_setzero_si256();
+    __m256i previous_input = _mm256_setzero_si256();
+    __m256i previous_incomplete = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (;;) {
+        __m256i input;
+        bool last = length - i < 32;
+        if (last) {
+            // The tail is padded with NULs, which end any open sequence
+            unsigned char tail[32] = { 0 };
+            memcpy(tail, bytes + i, length - i);
+            input = _mm256_loadu_si256((const __m256i*)tail);
+        } else {
+            input = _mm256_loadu_si256((const __m256i*)(bytes + i));
+        }
+
+        if (_mm256_movemask_epi8(input) == 0) {
+            error = _mm256_or_si256(error, previous_incomplete);
+        } else {
+            error = _mm256_or_si256(error, utf8_avx2_check_block(input, previous_input));
+            previous_incomplete = _mm256_subs_epu8(input, incomplete_limit);
+        }
+        previous_input = input;
+        if (last) break;
+        i += 32;
+    }
+    return _mm256_testz_si256(error, error);
+}
+
+UTF8_AVX2 static inline __m256i utf8_avx2_fold(__m256i chunk) {
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(chunk, _mm256_set1_epi8('A' - 1)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), chunk));
+    return _mm256_or_si256(chunk, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+UTF8_AVX2 static size_t utf8_avx2_mismatch_ignore_case(const unsigned char* a, const unsigned char* b, size_t length) {
+    size_t i = 0;
+    for (; length - i >= 32; i += 32) {
+        __m256i folded_a = utf8_avx2_fold(_mm256_loadu_si256((const __m256i*)(a + i)));
+        __m256i folded_b = utf8_avx2_fold(_mm256_loadu_si256((const __m256i*)(b + i)));
+        uint32_t equal = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded_a, folded_b));
+        if (equal != 0xFFFFFFFFu) return i + (size_t)__builtin_ctz(~equal);
+    }
+    return i + utf8_sse2_mismatch_ignore_case(a + i, b + i, length - i);
+}
+
+UTF8_AVX2 static int64_t utf8_avx2_index_of_ignore_case(const unsigned char* haystack, size_t haystack_length,
+                                                        const unsigned char* needle, size_t needle_length) {
+    const __m256i first = _mm256_set1_epi8((char)utf8_fold(needle[0]));
+    const __m256i last = _mm256_set1_epi8((char)utf8_fold(needle[needle_length - 1]));
+    size_t middle = needle_length > 2 ? needle_length - 2 : 0;
+    size_t i = 0;
+    for (; i + needle_length - 1 + 32 <= haystack_length; i += 32) {
+        __m256i starts = utf8_avx2_fold(_mm256_loadu_si256((const __m256i*)(haystack + i)));
+        __m256i ends = utf8_avx2_fold(_mm256_loadu_si256((const __m256i*)(haystack + i + needle_length - 1)));
+        uint32_t candidates = (uint32_t)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(starts, first), _mm256_cmpeq_epi8(ends, last)));
+        while (candidates) {
+            size_t at = i + (size_t)__builtin_ctz(candidates);
+            if (utf8_avx2_mismatch_ignore_case(haystack + at + 1, needle + 1, middle) == middle) {
+                return (int64_t)at;
+            }
+            candidates &= candidates - 1;
+        }
+    }
+    int64_t rest = utf8_sse2_index_of_ignore_case(haystack + i, haystack_length - i, needle, needle_length);
+    return rest < 0 ? -1 : (int64_t)i + rest;
+}
+
+static const Utf8Kernels utf8_avx2_kernels = {
+    utf8_avx2_count_code_points,
+    utf8_avx2_validate,
+    utf8_avx2_mismatch_ignore_case,
+    utf8_avx2_index_of_ignore_case
+};
+
+#endif // UTF8_X86_KERNELS
+
+// ============================================================================
+// DISPATCH
+// ============================================================================
+
+static const Utf8Kernels* utf8_kernels_selected = &utf8_scalar_kernels;
+static Utf8KernelLevel utf8_level_selected = UTF8_KERNELS_SCALAR;
+static pthread_once_t utf8_kernels_once = PTHREAD_ONCE_INIT;
+
+Utf8KernelLevel utf8_best_kernel_level(void) {
+#ifdef UTF8_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return UTF8_KERNELS_AVX2;
+    return UTF8_KERNELS_SSE2;
+#else
+    return UTF8_KERNELS_SCALAR;
+#endif
+}
+
+static void utf8_select_kernels(Utf8KernelLevel level) {
+    utf8_level_selected = level;
+    switch (level) {
+#ifdef UTF8_X86_KERNELS
+        case UTF8_KERNELS_AVX2:
+            utf8_kernels_selected = &utf8_avx2_kernels;
+            break;
+        case UTF8_KERNELS_SSE2:
+            utf8_kernels_selected = &utf8_sse2_kernels;
+            break;
+#endif
+        default:
+            utf8_kernels_selected = &utf8_scalar_kernels;
+            utf8_level_selected = UTF8_KERNELS_SCALAR;
+            break;
+    }
+}
+
+static void utf8_select_best_kernels(void) {
+    utf8_select_kernels(utf8_best_kernel_level());
+}
+
+static inline const Utf8Kernels* utf8_kernels(void) {
+    pthread_once(&utf8_kernels_once, utf8_select_best_kernels);
+    return utf8_kernels_selected;
+}
+
+Utf8KernelLevel utf8_kernel_level(void) {
+    utf8_kernels();
+    return utf8_level_selected;
+}
+
+bool utf8_set_kernel_level(Utf8KernelLevel level) {
+    utf8_kernels();
+    if (level > utf8_best_kernel_level()) return false;
+    utf8_select_kernels(level);
+    return true;
+}
+
+const char* utf8_kernel_level_name(Utf8KernelLevel level) {
+    switch (level) {
+        case UTF8_KERNELS_SCALAR: return "scalar";
+        case UTF8_KERNELS_SSE2: return "sse2";
+        case UTF8_KERNELS_AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+size_t utf8_count_code_points(const char* bytes, size_t length) {
+    if (!bytes || length == 0) return 0;
+    return utf8_kernels()->count_code_points((const unsigned char*)bytes, length);
+}
+
+bool utf8_validate(const char* bytes, size_t length, size_t* error_offset) {
+    if (!bytes || length == 0) return true;
+    if (utf8_kernels()->validate((const unsigned char*)bytes, length)) return true;
+
+    // Invalid input is rare, so the offset is found by a second, scalar pass
+    if (error_offset) {
+        *error_offset = utf8_scalar_error_offset((const unsigned char*)bytes, length);
+    }
+    return false;
+}
+
+int utf8_compare_ignore_case(const char* a, size_t a_length, const char* b, size_t b_length) {
+    size_t common = a_length < b_length ? a_length : b_length;
+    size_t same = common ? utf8_kernels()->mismatch_ignore_case((const unsigned char*)a,
+                                                                (const unsigned char*)b, common) : 0;
+    if (same < common) {
+        return (int)utf8_fold((unsigned char)a[same]) - (int)utf8_fold((unsigned char)b[same]);
+    }
+    return (a_length > b_length) - (a_length < b_length);
+}
+
+int64_t utf8_index_of_ignore_case(const char* haystack, size_t haystack_length,
+                                  const char* needle, size_t needle_length) {
+    if (needle_length == 0) return 0;
+    if (!haystack || !needle || needle_length > haystack_length) return -1;
+    return utf8_kernels()->index_of_ignore_case((const unsigned char*)haystack, haystack_length,
+                                                (const unsigned char*)needle, needle_length);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// UTF-8 string kernels. Every kernel has a scalar version and, on x86-64,
+// SSE2 and AVX2 versions; the best level the CPU supports is selected on
+// first use. Case-insensitive operations fold the ASCII letters A-Z only,
+// which keeps the byte length of both operands unchanged.
+
+typedef enum {
+    UTF8_KERNELS_SCALAR,
+    UTF8_KERNELS_SSE2,
+    UTF8_KERNELS_AVX2
+} Utf8KernelLevel;
+
+// Level used by the kernels below
+Utf8KernelLevel utf8_kernel_level(void);
+
+// Highest level the CPU supports
+Utf8KernelLevel utf8_best_kernel_level(void);
+
+// Force a level (tests and benchmarks). Fails if the CPU does not support
+// it. Not safe while other threads are running kernels.
+bool utf8_set_kernel_level(Utf8KernelLevel level);
+
+const char* utf8_kernel_level_name(Utf8KernelLevel level);
+
+// Number of code points in valid UTF-8 (bytes that are not continuation bytes)
+size_t utf8_count_code_points(const char* bytes, size_t length);
+
+// Whether `bytes` is well-formed UTF-8: no overlong forms, surrogates,
+// code points above U+10FFFF or truncated sequences. On failure
+// `error_offset` (if not NULL) receives the offset of the first bad sequence.
+bool utf8_validate(const char* bytes, size_t length, size_t* error_offset);
+
+// Order of two strings with ASCII letters folded to lower case: negative,
+// zero or positive
+int utf8_compare_ignore_case(const char* a, size_t a_length, const char* b, size_t b_length);
+
+// Byte offset of the first occurrence of `needle` in `haystack` with ASCII
+// letters folded to lower case, or -1
+int64_t utf8_index_of_ignore_case(const char* haystack, size_t haystack_length,
+                                  const char* needle, size_t needle_length);
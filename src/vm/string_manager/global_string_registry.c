@@ -1,5 +1,6 @@
 #include "global_string_registry.h"
 #include "../../vm/vm.h"
+#include "../objects/string_object.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,16 +9,89 @@
 // GLOBAL STRING REGISTRY IMPLEMENTATION
 // ============================================================================
 
-// Hash function for strings
+// Content hash in the style of wyhash: 8 or 16 bytes at a time, each step a
+// 64x64->128-bit multiply whose halves are folded together. String objects
+// keep their own polynomial hash, which ropes need to combine hashes.
+#define GLOBAL_STRING_HASH_K0 0xa0761d6478bd642fULL
+#define GLOBAL_STRING_HASH_K1 0xe7037ed1a0b428dbULL
+
+static uint64_t global_string_hash_mix(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+    uint64_t high = (a >> 32) * (b >> 32);
+    uint64_t low = (a & 0xffffffffULL) * (b & 0xffffffffULL);
+    uint64_t cross = (a >> 32) * (b & 0xffffffffULL) + (a & 0xffffffffULL) * (b >> 32);
+    return (low + (cross << 32)) ^ (high + (cross >> 32));
+#endif
+}
+
+static uint64_t global_string_read64(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint64_t global_string_read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t global_string_hash_bytes(const char* chars, size_t length) {
+    const uint8_t* p = (const uint8_t*)chars;
+    uint64_t seed = GLOBAL_STRING_HASH_K0;
+    uint64_t a, b;
+    
+    if (length <= 16) {
+        if (length >= 4) {
+            // Two overlapping 4-byte reads from each end cover 4..16 bytes
+            size_t step = (length >> 3) << 2;
+            a = (global_string_read32(p) << 32) | global_string_read32(p + step);
+            b = (global_string_read32(p + length - 4) << 32) | global_string_read32(p + length - 4 - step);
+        } else if (length > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1];
+            b = 0;
+        } else {
+            a = 0;
+            b = 0;
+        }
+    } else {
+        size_t remaining = length;
+        while (remaining > 16) {
+            seed = global_string_hash_mix(global_string_read64(p) ^ GLOBAL_STRING_HASH_K1,
+                                          global_string_read64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        // The last 16 bytes, overlapping bytes already mixed if need be
+        a = global_string_read64(p + remaining - 16);
+        b = global_string_read64(p + remaining - 8);
+    }
+    
+    uint64_t hash = global_string_hash_mix(a ^ GLOBAL_STRING_HASH_K1, b ^ seed);
+    hash = global_string_hash_mix(hash ^ GLOBAL_STRING_HASH_K0, (uint64_t)length ^ GLOBAL_STRING_HASH_K1);
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
 static uint32_t global_string_hash(const char* str) {
     if (!str) return 0;
     
-    uint32_t hash = 5381;
-    int c;
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+    return global_string_hash_bytes(str, strlen(str));
+}
+
+static GlobalStringEntry* global_string_registry_find_entry(GlobalStringRegistry* registry, 
+                                                            const char* string_data, 
+                                                            uint32_t hash) {
+    GlobalStringEntry* entry = registry->hash_table[hash & (registry->hash_table_size - 1)];
+    while (entry) {
+        if (entry->hash == hash && strcmp(entry->string_data, string_data) == 0) {
+            return entry;
+        }
+        entry = entry->next;
     }
-    return hash;
+    return NULL;
 }
 
 // Create global string registry
@@ -25,17 +99,23 @@ GlobalStringRegistry* global_string_registry_create(struct VM* vm) {
     GlobalStringRegistry* registry = malloc(sizeof(GlobalStringRegistry));
     if (!registry) return NULL;
     
-    registry->hash_table_size = 1024; // Start with 1024 buckets
+    registry->hash_table_size = GLOBAL_STRING_INITIAL_BUCKETS;
     registry->hash_table = calloc(registry->hash_table_size, sizeof(GlobalStringEntry*));
     if (!registry->hash_table) {
         free(registry);
         return NULL;
     }
+    registry->entries_by_id = NULL;
+    registry->id_capacity = 0;
     
     registry->next_global_id = 1; // Start from 1 (0 is reserved for errors)
     registry->total_strings = 0;
     registry->module_maps = NULL;
+    registry->maps_by_module = NULL;
+    registry->module_map_capacity = 0;
     registry->vm = vm;
+    slab_pool_init(&registry->entry_pool, sizeof(GlobalStringEntry), 256);
+    arena_init(&registry->string_arena, 0);
     
     return registry;
 }
@@ -44,20 +124,12 @@ GlobalStringRegistry* global_string_registry_create(struct VM* vm) {
 void global_string_registry_destroy(GlobalStringRegistry* registry) {
     if (!registry) return;
     
-    // Free hash table entries
-    for (uint32_t i = 0; i < registry->hash_table_size; i++) {
-        GlobalStringEntry* entry = registry->hash_table[i];
-        while (entry) {
-            GlobalStringEntry* next = entry->next;
-            if (entry->string_data) {
-                free(entry->string_data);
-            }
-            free(entry);
-            entry = next;
-        }
-    }
-    
+    // Entries and their strings are released with the pools
+    slab_pool_destroy(&registry->entry_pool);
+    arena_destroy(&registry->string_arena);
     free(registry->hash_table);
+    free(registry->entries_by_id);
+    free(registry->maps_by_module);
     
     // Free module maps
     ModuleStringMap* map = registry->module_maps;
@@ -73,6 +145,86 @@ void global_string_registry_destroy(GlobalStringRegistry* registry) {
     free(registry);
 }
 
+// Double the buckets once the table is more than 3/4 full
+static bool global_string_registry_grow_table(GlobalStringRegistry* registry) {
+    if ((uint64_t)registry->total_strings * 4 < (uint64_t)registry->hash_table_size * 3) {
+        return true;
+    }
+    
+    uint32_t new_size = registry->hash_table_size * 2;
+    GlobalStringEntry** new_table = calloc(new_size, sizeof(GlobalStringEntry*));
+    if (!new_table) return false;
+    
+    for (uint32_t i = 0; i < registry->hash_table_size; i++) {
+        GlobalStringEntry* entry = registry->hash_table[i];
+        while (entry) {
+            GlobalStringEntry* next = entry->next;
+            uint32_t bucket = entry->hash & (new_size - 1);
+            entry->next = new_table[bucket];
+            new_table[bucket] = entry;
+            entry = next;
+        }
+    }
+    
+    free(registry->hash_table);
+    registry->hash_table = new_table;
+    registry->hash_table_size = new_size;
+    return true;
+}
+
+// Make room in the id index for the next global ID
+static bool global_string_registry_grow_ids(GlobalStringRegistry* registry) {
+    if (registry->next_global_id < registry->id_capacity) {
+        return true;
+    }
+    
+    uint32_t new_capacity = registry->id_capacity ? registry->id_capacity * 2 : GLOBAL_STRING_INITIAL_BUCKETS;
+    GlobalStringEntry** new_ids = realloc(registry->entries_by_id, new_capacity * sizeof(GlobalStringEntry*));
+    if (!new_ids) return false;
+    
+    memset(new_ids + registry->id_capacity, 0, (new_capacity - registry->id_capacity) * sizeof(GlobalStringEntry*));
+    registry->entries_by_id = new_ids;
+    registry->id_capacity = new_capacity;
+    return true;
+}
+
+// Add a new entry to the hash table
+static GlobalStringEntry* global_string_registry_add_entry(GlobalStringRegistry* registry, 
+                                                           uint32_t module_id, 
+                                                           uint32_t module_offset, 
+                                                           const char* string_data, 
+                                                           uint32_t hash) {
+    if (!global_string_registry_grow_table(registry) || !global_string_registry_grow_ids(registry)) {
+        return NULL;
+    }
+    
+    GlobalStringEntry* entry = slab_pool_alloc(&registry->entry_pool);
+    if (!entry) return NULL;
+    
+    entry->global_string_id = registry->next_global_id++;
+    entry->module_id = module_id;
+    entry->module_string_offset = module_offset;
+    entry->string_data = arena_strdup(&registry->string_arena, string_data);
+    entry->string_object = NULL;
+    entry->hash = hash;
+    entry->next = NULL;
+    
+    if (!entry->string_data) {
+        registry->next_global_id--;
+        slab_pool_free(&registry->entry_pool, entry);
+        return NULL;
+    }
+    
+    // Add to hash table and id index
+    uint32_t bucket = entry->hash & (registry->hash_table_size - 1);
+    entry->next = registry->hash_table[bucket];
+    registry->hash_table[bucket] = entry;
+    registry->entries_by_id[entry->global_string_id] = entry;
+    
+    registry->total_strings++;
+    return entry;
+}
+
 // Register a string from a module
 uint32_t global_string_registry_register_string(GlobalStringRegistry* registry, 
                                                uint32_t module_id, 
@@ -89,28 +241,10 @@ uint32_t global_string_registry_register_string(GlobalStringRegistry* registry,
     }
     
     // Create new global string entry
-    GlobalStringEntry* entry = malloc(sizeof(GlobalStringEntry));
+    GlobalStringEntry* entry = global_string_registry_add_entry(registry, module_id, module_offset, 
+                                                                string_data, global_string_hash(string_data));
     if (!entry) return 0;
     
-    entry->global_string_id = registry->next_global_id++;
-    entry->module_id = module_id;
-    entry->module_string_offset = module_offset;
-    entry->string_data = strdup(string_data);
-    entry->hash = global_string_hash(string_data);
-    entry->next = NULL;
-    
-    if (!entry->string_data) {
-        free(entry);
-        return 0;
-    }
-    
-    // Add to hash table
-    uint32_t bucket = entry->hash % registry->hash_table_size;
-    entry->next = registry->hash_table[bucket];
-    registry->hash_table[bucket] = entry;
-    
-    registry->total_strings++;
-    
     // Update module mapping
     global_string_registry_update_module_mapping(registry, module_id, module_offset, entry->global_string_id);
     
@@ -125,29 +259,53 @@ void global_string_registry_update_module_mapping(GlobalStringRegistry* registry
     // Find or create module map
     ModuleStringMap* map = global_string_registry_get_module_map(registry, module_id);
     if (!map) {
+        // Module IDs are handed out in sequence, so mappings are indexed by them
+        if (module_id >= registry->module_map_capacity) {
+            uint32_t new_capacity = registry->module_map_capacity ? registry->module_map_capacity : 16;
+            while (new_capacity <= module_id && new_capacity < UINT32_MAX / 2) {
+                new_capacity *= 2;
+            }
+            if (new_capacity <= module_id) return;
+            ModuleStringMap** new_maps = realloc(registry->maps_by_module, new_capacity * sizeof(ModuleStringMap*));
+            if (!new_maps) return;
+            memset(new_maps + registry->module_map_capacity, 0, 
+                   (new_capacity - registry->module_map_capacity) * sizeof(ModuleStringMap*));
+            registry->maps_by_module = new_maps;
+            registry->module_map_capacity = new_capacity;
+        }
+        
         map = malloc(sizeof(ModuleStringMap));
         if (!map) return;
         
         map->module_id = module_id;
         map->offset_to_global_id = NULL;
         map->max_offset = 0;
+        map->capacity = 0;
         map->next = registry->module_maps;
         registry->module_maps = map;
+        registry->maps_by_module[module_id] = map;
     }
     
-    // Resize offset array if needed
-    if (module_offset >= map->max_offset) {
-        uint32_t new_size = module_offset + 1;
-        uint32_t* new_array = realloc(map->offset_to_global_id, new_size * sizeof(uint32_t));
+    // Resize offset array if needed, geometrically so that registering a
+    // module's strings in offset order does not reallocate for each one
+    if (module_offset >= map->capacity) {
+        uint32_t new_capacity = map->capacity ? map->capacity : 64;
+        while (new_capacity <= module_offset && new_capacity < UINT32_MAX / 2) {
+            new_capacity *= 2;
+        }
+        if (new_capacity <= module_offset) new_capacity = module_offset + 1;
+        uint32_t* new_array = realloc(map->offset_to_global_id, (size_t)new_capacity * sizeof(uint32_t));
         if (!new_array) return;
         
+        map->offset_to_global_id = new_array;
+        map->capacity = new_capacity;
+    }
+    if (module_offset >= map->max_offset) {
         // Initialize new entries to 0
-        for (uint32_t i = map->max_offset; i < new_size; i++) {
-            new_array[i] = 0;
+        for (uint32_t i = map->max_offset; i <= module_offset; i++) {
+            map->offset_to_global_id[i] = 0;
         }
-        
-        map->offset_to_global_id = new_array;
-        map->max_offset = new_size;
+        map->max_offset = module_offset + 1;
     }
     
     map->offset_to_global_id[module_offset] = global_id;
@@ -168,20 +326,10 @@ uint32_t global_string_registry_get_global_id(GlobalStringRegistry* registry,
 // Get string data by global ID
 const char* global_string_registry_get_string(GlobalStringRegistry* registry, 
                                              uint32_t global_string_id) {
-    if (!registry || global_string_id == 0) return NULL;
+    if (!registry || global_string_id == 0 || global_string_id >= registry->next_global_id) return NULL;
     
-    // Search through all hash table buckets
-    for (uint32_t i = 0; i < registry->hash_table_size; i++) {
-        GlobalStringEntry* entry = registry->hash_table[i];
-        while (entry) {
-            if (entry->global_string_id == global_string_id) {
-                return entry->string_data;
-            }
-            entry = entry->next;
-        }
-    }
-    
-    return NULL;
+    GlobalStringEntry* entry = registry->entries_by_id[global_string_id];
+    return entry ? entry->string_data : NULL;
 }
 
 // Find string by content (for deduplication)
@@ -189,34 +337,38 @@ uint32_t global_string_registry_find_string(GlobalStringRegistry* registry,
                                            const char* string_data) {
     if (!registry || !string_data) return 0;
     
-    uint32_t hash = global_string_hash(string_data);
-    uint32_t bucket = hash % registry->hash_table_size;
+    GlobalStringEntry* entry = global_string_registry_find_entry(registry, string_data, 
+                                                                 global_string_hash(string_data));
+    return entry ? entry->global_string_id : 0;
+}
+
+// Intern a string
+struct StringObject* global_string_registry_intern(GlobalStringRegistry* registry, 
+                                                   const char* string_data) {
+    if (!registry || !string_data || !registry->vm) return NULL;
     
-    GlobalStringEntry* entry = registry->hash_table[bucket];
-    while (entry) {
-        if (entry->hash == hash && strcmp(entry->string_data, string_data) == 0) {
-            return entry->global_string_id;
-        }
-        entry = entry->next;
+    uint32_t hash = global_string_hash(string_data);
+    GlobalStringEntry* entry = global_string_registry_find_entry(registry, string_data, hash);
+    if (!entry) {
+        // Strings interned at runtime belong to no module
+        entry = global_string_registry_add_entry(registry, 0, 0, string_data, hash);
+        if (!entry) return NULL;
     }
     
-    return 0;
+    if (!entry->string_object) {
+        struct VM* vm = registry->vm;
+        entry->string_object = string_create_permanent(vm->heap, vm->string_class, 
+                                                       string_data, strlen(string_data));
+    }
+    return entry->string_object;
 }
 
 // Get module string mapping
 ModuleStringMap* global_string_registry_get_module_map(GlobalStringRegistry* registry, 
                                                       uint32_t module_id) {
-    if (!registry) return NULL;
+    if (!registry || module_id >= registry->module_map_capacity) return NULL;
     
-    ModuleStringMap* map = registry->module_maps;
-    while (map) {
-        if (map->module_id == module_id) {
-            return map;
-        }
-        map = map->next;
-    }
-    
-    return NULL;
+    return registry->maps_by_module[module_id];
 }
 
 // Print registry statistics
@@ -352,6 +504,14 @@ uint32_t string_manager_add_string(StringManager* manager,
                                                 string_data);
 }
 
+// Intern a string
+struct StringObject* string_manager_intern(StringManager* manager, 
+                                          const char* string_data) {
+    if (!manager || !manager->initialized) return NULL;
+    
+    return global_string_registry_intern(manager->global_registry, string_data);
+}
+
 // Print string manager statistics
 void string_manager_print_stats(StringManager* manager) {
     if (!manager || !manager->initialized) {
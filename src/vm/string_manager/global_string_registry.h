@@ -4,9 +4,11 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "../../shared/bytecode/bytecode_format.h"
+#include "../memory/pool.h"
 
 // Forward declarations
 struct VM;
+struct StringObject;
 
 // Global string registry entry
 typedef struct GlobalStringEntry {
@@ -14,6 +16,7 @@ typedef struct GlobalStringEntry {
     uint32_t module_id;               // Owning module ID
     uint32_t module_string_offset;    // Offset in module's string table
     char* string_data;                // Cached string data
+    struct StringObject* string_object; // Interned string object (created on first use)
     uint32_t hash;                    // String hash for fast lookup
     struct GlobalStringEntry* next;   // Next entry in hash chain
 } GlobalStringEntry;
@@ -23,17 +26,27 @@ typedef struct ModuleStringMap {
     uint32_t module_id;               // Module ID
     uint32_t* offset_to_global_id;    // Array mapping module offsets to global IDs
     uint32_t max_offset;              // Maximum offset in this module
+    uint32_t capacity;                // Slots allocated in offset_to_global_id
     struct ModuleStringMap* next;     // Next module mapping
 } ModuleStringMap;
 
+// Buckets of a new registry; the table doubles past a 3/4 load factor
+#define GLOBAL_STRING_INITIAL_BUCKETS 256
+
 // Global string registry
 typedef struct GlobalStringRegistry {
     GlobalStringEntry** hash_table;   // Hash table for string lookup
-    uint32_t hash_table_size;         // Size of hash table
+    uint32_t hash_table_size;         // Size of hash table (power of two)
+    GlobalStringEntry** entries_by_id; // Global string ID -> entry
+    uint32_t id_capacity;             // Slots allocated in entries_by_id
     uint32_t next_global_id;          // Next available global string ID
     uint32_t total_strings;           // Total number of strings
     ModuleStringMap* module_maps;     // Module string mappings
+    ModuleStringMap** maps_by_module; // Module ID -> mapping
+    uint32_t module_map_capacity;     // Slots allocated in maps_by_module
     struct VM* vm;                    // Reference to VM
+    SlabPool entry_pool;              // Storage for GlobalStringEntry nodes
+    Arena string_arena;               // Copies of the registered strings
 } GlobalStringRegistry;
 
 // String manager (main interface)
@@ -69,6 +82,11 @@ const char* global_string_registry_get_string(GlobalStringRegistry* registry,
 uint32_t global_string_registry_find_string(GlobalStringRegistry* registry, 
                                            const char* string_data);
 
+// Canonical string object for the given contents, registering the string if
+// it is new. Interned strings live in the permanent generation.
+struct StringObject* global_string_registry_intern(GlobalStringRegistry* registry, 
+                                                   const char* string_data);
+
 // Get module string mapping
 ModuleStringMap* global_string_registry_get_module_map(GlobalStringRegistry* registry, 
                                                       uint32_t module_id);
@@ -76,6 +94,9 @@ ModuleStringMap* global_string_registry_get_module_map(GlobalStringRegistry* reg
 // Print registry statistics
 void global_string_registry_print_stats(GlobalStringRegistry* registry);
 
+// Hash used for the content table (64-bit multiply-mix, folded to 32 bits)
+uint32_t global_string_hash_bytes(const char* chars, size_t length);
+
 // Internal function for updating module mappings
 void global_string_registry_update_module_mapping(GlobalStringRegistry* registry, 
                                                  uint32_t module_id, 
@@ -110,5 +131,9 @@ uint32_t string_manager_add_string(StringManager* manager,
                                   uint32_t module_id, 
                                   const char* string_data);
 
+// Intern a string (see global_string_registry_intern)
+struct StringObject* string_manager_intern(StringManager* manager, 
+                                          const char* string_data);
+
 // Print string manager statistics
 void string_manager_print_stats(StringManager* manager);
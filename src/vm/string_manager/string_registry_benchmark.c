@@ -0,0 +1,164 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "global_string_registry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Global string registry benchmark - registers the string tables of many
+// synthetic modules whose strings largely overlap (shared class, method and
+// library names plus a few strings of their own), the way a program with
+// many library modules loads. Reports the registration rate, then the cost
+// of resolving global IDs and module offsets to strings, and of looking
+// strings up by content. The by-ID lookup is also timed with a scan over the
+// hash buckets, which is what it cost before the registry kept an ID index.
+//
+// Usage: string_registry_benchmark [modules] [strings-per-module] [shared-percent]
+
+#define DEFAULT_MODULES 200
+#define DEFAULT_STRINGS 2000
+#define DEFAULT_SHARED_PERCENT 75
+
+// Bucket scans are slow; they only resolve this many IDs
+#define SCAN_LOOKUPS 2000
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Result of the lookups, so the work cannot be optimized away
+static volatile uintptr_t bench_sink;
+
+// Module string table: shared strings are picked from a vocabulary of
+// `strings` names common to every module, the others are unique to it
+static StringTable* make_module_strings(uint32_t module, uint32_t strings, uint32_t shared_percent,
+                                        unsigned int* seed) {
+    StringTable* table = malloc(sizeof(StringTable));
+    table->count = strings;
+    table->entries = malloc(strings * sizeof(StringEntry));
+    table->data = malloc((size_t)strings * 64);
+    table->total_size = 0;
+
+    for (uint32_t i = 0; i < strings; i++) {
+        char* text = table->data + table->total_size;
+        int length;
+        if ((uint32_t)(rand_r(seed) % 100) < shared_percent) {
+            uint32_t name = (uint32_t)rand_r(seed) % strings;
+            length = sprintf(text, "System.Library.Type%u.member%u", name / 16, name);
+        } else {
+            length = sprintf(text, "app.module%u.Local%u", module, i);
+        }
+        table->entries[i].offset = table->total_size;
+        table->entries[i].length = (uint32_t)length;
+        table->total_size += (uint32_t)length + 1;
+    }
+    return table;
+}
+
+static void free_module_strings(StringTable* table) {
+    free(table->entries);
+    free(table->data);
+    free(table);
+}
+
+// How get_string found an ID before the ID index: walk every bucket
+static const char* scan_buckets(GlobalStringRegistry* registry, uint32_t global_id) {
+    for (uint32_t i = 0; i < registry->hash_table_size; i++) {
+        for (GlobalStringEntry* entry = registry->hash_table[i]; entry; entry = entry->next) {
+            if (entry->global_string_id == global_id) return entry->string_data;
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t modules = argc > 1 ? (uint32_t)atol(argv[1]) : DEFAULT_MODULES;
+    uint32_t strings = argc > 2 ? (uint32_t)atol(argv[2]) : DEFAULT_STRINGS;
+    uint32_t shared_percent = argc > 3 ? (uint32_t)atol(argv[3]) : DEFAULT_SHARED_PERCENT;
+    if (modules == 0 || strings == 0 || shared_percent > 100) {
+        fprintf(stderr, "Usage: %s [modules] [strings-per-module] [shared-percent]\n", argv[0]);
+        return 1;
+    }
+
+    printf("He³ Global String Registry Benchmark\n");
+    printf("====================================\n");
+    printf("Modules: %u, strings per module: %u, shared: %u%%\n\n", modules, strings, shared_percent);
+
+    StringTable** tables = malloc(modules * sizeof(StringTable*));
+    unsigned int seed = 42;
+    for (uint32_t m = 0; m < modules; m++) {
+        tables[m] = make_module_strings(m + 1, strings, shared_percent, &seed);
+    }
+
+    // Registration, as string_manager_register_module_strings does at load
+    GlobalStringRegistry* registry = global_string_registry_create(NULL);
+    double start = now_us();
+    for (uint32_t m = 0; m < modules; m++) {
+        StringTable* table = tables[m];
+        for (uint32_t i = 0; i < table->count; i++) {
+            uint32_t offset = table->entries[i].offset;
+            global_string_registry_register_string(registry, m + 1, offset, table->data + offset);
+        }
+    }
+    double register_us = now_us() - start;
+    uint64_t registered = (uint64_t)modules * strings;
+    printf("Registration:        %8.1f ms  %7.1f ns/string  (%u unique of %llu, %u buckets)\n",
+           register_us / 1e3, register_us * 1e3 / registered, registry->total_strings,
+           (unsigned long long)registered, registry->hash_table_size);
+
+    // Global ID -> string through the ID index
+    uint32_t ids = registry->next_global_id - 1;
+    uint64_t lookups = 0;
+    start = now_us();
+    for (int round = 0; round < 10; round++) {
+        for (uint32_t id = 1; id <= ids; id++) {
+            bench_sink += (uintptr_t)global_string_registry_get_string(registry, id);
+        }
+        lookups += ids;
+    }
+    double index_ns = (now_us() - start) * 1e3 / lookups;
+
+    // Global ID -> string by scanning the buckets
+    uint32_t scans = ids < SCAN_LOOKUPS ? ids : SCAN_LOOKUPS;
+    start = now_us();
+    for (uint32_t i = 0; i < scans; i++) {
+        bench_sink += (uintptr_t)scan_buckets(registry, 1 + (uint32_t)((uint64_t)i * ids / scans));
+    }
+    double scan_ns = (now_us() - start) * 1e3 / scans;
+    printf("ID -> string:        %8.1f ns  (bucket scan %.1f ns, %.0fx)\n", index_ns, scan_ns, scan_ns / index_ns);
+
+    // Module offset -> string, as string_manager_get_string resolves it
+    start = now_us();
+    lookups = 0;
+    for (uint32_t m = 0; m < modules; m++) {
+        StringTable* table = tables[m];
+        for (uint32_t i = 0; i < table->count; i++) {
+            uint32_t global_id = global_string_registry_get_global_id(registry, m + 1, table->entries[i].offset);
+            bench_sink += (uintptr_t)global_string_registry_get_string(registry, global_id);
+        }
+        lookups += table->count;
+    }
+    printf("Module offset -> string: %4.1f ns\n", (now_us() - start) * 1e3 / lookups);
+
+    // Content -> ID, as deduplication and interning look strings up
+    start = now_us();
+    lookups = 0;
+    for (uint32_t m = 0; m < modules; m++) {
+        StringTable* table = tables[m];
+        for (uint32_t i = 0; i < table->count; i++) {
+            bench_sink += global_string_registry_find_string(registry, table->data + table->entries[i].offset);
+        }
+        lookups += table->count;
+    }
+    printf("Content -> ID:       %8.1f ns\n", (now_us() - start) * 1e3 / lookups);
+
+    global_string_registry_destroy(registry);
+    for (uint32_t m = 0; m < modules; m++) {
+        free_module_strings(tables[m]);
+    }
+    free(tables);
+    return 0;
+}
@@ -1,3 +1,6 @@
+// realpath and PATH_MAX are hidden under -std=c99
+#define _DEFAULT_SOURCE
+
 #include "vm.h"
 #include "loader/bytecode_loader.h"
 #include "execution/stack.h"
@@ -5,9 +8,73 @@
 #include "execution/context.h"
 #include "modules/module_registry.h"
 #include "../shared/bytecode/helium_format.h"
+#include "objects/string_object.h"
+#include "objects/utf8.h"
+#include <ctype.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// Heap sizing: each VM reserves address space up to VM_HEAP_MAX_SIZE but
+// commits only what it uses, growing freely up to the soft limit
+#define VM_HEAP_INITIAL_SIZE (2 * 1024 * 1024)      // 2MB
+#define VM_HEAP_SOFT_LIMIT (64 * 1024 * 1024)       // 64MB
+#define VM_HEAP_MAX_SIZE (1024 * 1024 * 1024)       // 1GB
+
+// The heap object an Option or Result holds directly: an object payload or
+// the box of a nested payload
+static struct Object* value_payload_reference(const Value* value) {
+    if (value->type != VALUE_OPTION && value->type != VALUE_RESULT) return NULL;
+    switch (value->payload_type) {
+        case VALUE_STRING:
+        case VALUE_OBJECT:
+        case VALUE_OPTION:
+        case VALUE_RESULT:
+            return value->data.object_value;
+        default:
+            return NULL;
+    }
+}
+
+// GC root scanning
+static void vm_mark_value(Heap* heap, const Value* value) {
+    switch (value->type) {
+        case VALUE_STRING:
+            gc_mark_object(heap, (struct Object*)value->data.string_value);
+            break;
+        case VALUE_OBJECT:
+            gc_mark_object(heap, value->data.object_value);
+            break;
+        case VALUE_OPTION:
+        case VALUE_RESULT:
+            // A box traces its own payload
+            gc_mark_object(heap, value_payload_reference(value));
+            break;
+        default:
+            break;
+    }
+}
+
+static void vm_scan_roots(Heap* heap, void* context) {
+    VM* vm = (VM*)context;
+    
+    // Operand stack
+    for (size_t i = 0; i < vm->stack->top; i++) {
+        vm_mark_value(heap, &vm->stack->values[i]);
+    }
+    
+    // Call frame locals and receivers
+    for (size_t i = 0; i < vm->context->frame_count; i++) {
+        CallFrame* frame = vm->context->frames[i];
+        for (size_t j = 0; j < frame->local_count; j++) {
+            vm_mark_value(heap, &frame->locals[j]);
+        }
+        gc_mark_object(heap, frame->this_object);
+    }
+}
 
 // VM Creation and Destruction
 VM* vm_create(void) {
@@ -19,6 +86,7 @@ VM* vm_create(void) {
     
     // Initialize VM
     vm->current_module = NULL;
+    vm->current_module_entry = NULL;
     
     vm->stack = stack_create(1024); // Initial stack capacity
     if (!vm->stack) {
@@ -33,7 +101,7 @@ VM* vm_create(void) {
         return NULL;
     }
     
-    vm->heap = heap_create(16 * 1024 * 1024); // 16MB heap
+    vm->heap = heap_create_growable(VM_HEAP_INITIAL_SIZE, VM_HEAP_SOFT_LIMIT, VM_HEAP_MAX_SIZE);
     if (!vm->heap) {
         execution_context_destroy(vm->context);
         stack_destroy(vm->stack);
@@ -41,8 +109,28 @@ VM* vm_create(void) {
         return NULL;
     }
     
+    gc_set_root_scanner(vm->heap, vm_scan_roots, vm);
+    
     vm->classes = NULL;
+    vm->string_class = NULL;
+    vm->rope_class = NULL;
+    vm->string_builder_class = NULL;
+    vm->slice_class = NULL;
+    vm->box_class = NULL;
+    vm->literal_module = NULL;
+    vm->literal_strings = NULL;
+    vm->literal_count = 0;
     vm->debug = false;
+    vm->gc_log = NULL;
+    vm->heap_profile_path = NULL;
+    vm->heap_snapshot_path = NULL;
+    vm->program_argc = 0;
+    vm->program_argv = NULL;
+    vm->snapshot_image = NULL;
+    vm->snapshot_image_size = 0;
+    vm->library_modules = NULL;
+    vm->library_count = 0;
+    vm->load_threads = 0;
     
     vm->module_registry = module_registry_create();
     if (!vm->module_registry) {
@@ -80,10 +168,28 @@ VM* vm_create(void) {
 void vm_destroy(VM* vm) {
     if (!vm) return;
     
+    // The profile and snapshot name methods and classes, so write them
+    // while they exist
+    if (vm->heap_snapshot_path) {
+        vm_write_heap_snapshot(vm);
+        free(vm->heap_snapshot_path);
+    }
+    if (vm->heap_profile_path) {
+        vm_write_heap_profile(vm);
+        free(vm->heap_profile_path);
+    }
+    free(vm->literal_strings);
+    
     // Destroy components
     if (vm->current_module) {
         helium_module_destroy(vm->current_module);
     }
+    for (uint32_t i = 0; i < vm->library_count; i++) {
+        if (vm->library_modules[i]) {
+            helium_module_destroy(vm->library_modules[i]);
+        }
+    }
+    free(vm->library_modules);
     
     if (vm->stack) {
         stack_destroy(vm->stack);
@@ -97,6 +203,10 @@ void vm_destroy(VM* vm) {
         heap_destroy(vm->heap);
     }
     
+    if (vm->gc_log) {
+        fclose(vm->gc_log);
+    }
+    
     // Clean up object system
     vm_cleanup_object_system(vm);
     
@@ -111,6 +221,9 @@ void vm_destroy(VM* vm) {
     // Clean up global registries
     module_registry_cleanup();
     
+    // Registry entries and the module of a restored VM live in its image
+    vm_image_release(vm);
+    
     free(vm);
 }
 
@@ -121,6 +234,157 @@ void vm_set_debug(VM* vm, bool debug) {
     }
 }
 
+void vm_set_gc_concurrent(VM* vm, bool concurrent) {
+    if (vm && vm->heap && vm->heap->gc) {
+        vm->heap->gc->concurrent_mode = concurrent;
+    }
+}
+
+void vm_set_gc_threads(VM* vm, uint32_t threads) {
+    if (vm && vm->heap) {
+        gc_set_worker_count(vm->heap, threads);
+    }
+}
+
+void vm_set_gc_incremental(VM* vm, bool incremental) {
+    if (vm && vm->heap && vm->heap->gc) {
+        vm->heap->gc->incremental_mode = incremental;
+    }
+}
+
+void vm_set_gc_pause_target(VM* vm, uint32_t target_us) {
+    if (vm && vm->heap) {
+        gc_set_pause_target(vm->heap, target_us);
+    }
+}
+
+void vm_set_load_threads(VM* vm, uint32_t threads) {
+    if (vm) {
+        vm->load_threads = threads;
+    }
+}
+
+bool vm_set_heap_limits(VM* vm, size_t soft_limit, size_t hard_limit) {
+    return vm && vm->heap && heap_set_limits(vm->heap, soft_limit, hard_limit);
+}
+
+bool vm_set_heap_huge_pages(VM* vm, bool enabled) {
+    return vm && vm->heap && heap_set_huge_pages(vm->heap, enabled);
+}
+
+bool vm_set_gc_log(VM* vm, const char* path) {
+    if (!vm || !vm->heap || !path) return false;
+    
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+    
+    if (vm->gc_log) {
+        fclose(vm->gc_log);
+    }
+    vm->gc_log = file;
+    gc_set_log_file(vm->heap, file);
+    return true;
+}
+
+// Copy of a path; strdup is not declared under -std=c99
+static char* vm_copy_path(const char* path) {
+    size_t length = strlen(path) + 1;
+    char* copy = malloc(length);
+    if (copy) {
+        memcpy(copy, path, length);
+    }
+    return copy;
+}
+
+volatile sig_atomic_t vm_heap_profile_requested = 0;
+
+bool vm_set_heap_profile(VM* vm, const char* path, uint32_t rate) {
+    if (!vm || !vm->heap || !path) return false;
+    
+    char* copy = vm_copy_path(path);
+    if (!copy || !heap_profiler_enable(vm->heap, rate)) {
+        free(copy);
+        return false;
+    }
+    
+    free(vm->heap_profile_path);
+    vm->heap_profile_path = copy;
+    return true;
+}
+
+// Write the allocation profile report, replacing any earlier one
+bool vm_write_heap_profile(VM* vm) {
+    vm_heap_profile_requested = 0;
+    if (!vm || !vm->heap || !vm->heap_profile_path) return false;
+    
+    FILE* file = fopen(vm->heap_profile_path, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot write allocation profile '%s'\n", vm->heap_profile_path);
+        return false;
+    }
+    heap_profile_report(vm->heap, file);
+    fclose(file);
+    return true;
+}
+
+volatile sig_atomic_t vm_heap_snapshot_requested = 0;
+
+// Dump the heap once when an allocation is about to fail
+static void vm_snapshot_on_oom(Heap* heap, size_t size, void* context) {
+    VM* vm = (VM*)context;
+    heap_set_oom_handler(heap, NULL, NULL);
+    fprintf(stderr, "Error: Out of memory allocating %zu bytes, writing heap snapshot '%s'\n",
+            size, vm->heap_snapshot_path);
+    vm_write_heap_snapshot(vm);
+}
+
+bool vm_set_heap_snapshot(VM* vm, const char* path) {
+    if (!vm || !vm->heap || !path) return false;
+    
+    char* copy = vm_copy_path(path);
+    if (!copy) return false;
+    
+    free(vm->heap_snapshot_path);
+    vm->heap_snapshot_path = copy;
+    heap_set_oom_handler(vm->heap, vm_snapshot_on_oom, vm);
+    return true;
+}
+
+// Arguments passed to the program. They become strings, so each must be
+// valid UTF-8.
+bool vm_set_program_args(VM* vm, int argc, char** argv) {
+    if (!vm || argc < 0 || (argc > 0 && !argv)) return false;
+    
+    for (int i = 0; i < argc; i++) {
+        size_t error_offset = 0;
+        if (!utf8_validate(argv[i], strlen(argv[i]), &error_offset)) {
+            fprintf(stderr, "Error: Program argument %d is not valid UTF-8 (byte %zu)\n", i, error_offset);
+            return false;
+        }
+    }
+    vm->program_argc = argc;
+    vm->program_argv = argv;
+    return true;
+}
+
+// Write a heap snapshot, replacing any earlier one
+bool vm_write_heap_snapshot(VM* vm) {
+    vm_heap_snapshot_requested = 0;
+    if (!vm || !vm->heap || !vm->heap_snapshot_path) return false;
+    
+    FILE* file = fopen(vm->heap_snapshot_path, "wb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot write heap snapshot '%s'\n", vm->heap_snapshot_path);
+        return false;
+    }
+    bool written = heap_write_snapshot(vm->heap, file);
+    if (fclose(file) != 0) written = false;
+    if (!written) {
+        fprintf(stderr, "Error: Failed to write heap snapshot '%s'\n", vm->heap_snapshot_path);
+    }
+    return written;
+}
+
 // VM Execution
 int vm_load_helium3_module(VM* vm, const char* filename) {
     
@@ -171,6 +435,10 @@ int vm_load_helium3_module(VM* vm, const char* filename) {
         return 0;
     }
     
+    // Method and field IDs in the module's bytecode are mapped through its entry
+    vm->current_module_entry = module_registry_find_module_by_id(vm->module_registry,
+        module_registry_get_next_module_id(vm->module_registry) - 1);
+    
     printf("Loaded .helium3 module: %s\n", filename);
     printf("Module Name: %s\n", module_name);
     printf("Entry Point Method ID: %u\n", module->header.entry_point_method_id);
@@ -250,7 +518,7 @@ int vm_execute_method(VM* vm, HeliumModule* module, uint32_t method_id) {
     
     
     // Create call frame for the method
-    CallFrame* method_frame = call_frame_create(
+    CallFrame* method_frame = call_frame_create(vm->context,
         module->bytecode + method->bytecode_offset,
         method->local_count
     );
@@ -263,27 +531,35 @@ int vm_execute_method(VM* vm, HeliumModule* module, uint32_t method_id) {
     // Push frame onto execution context
     if (!execution_context_push_frame(vm->context, method_frame)) {
         fprintf(stderr, "Failed to push method frame onto execution context\n");
-        call_frame_destroy(method_frame);
+        call_frame_destroy(vm->context, method_frame);
         return 1;
     }
     
-    // Execute bytecode
+    // Execute bytecode, profiling allocations under the method's name
+    AllocProfiler* profiler = vm->heap ? vm->heap->profiler : NULL;
+    const char* caller_method = profiler ? profiler->site_method : NULL;
+    if (profiler) {
+        profiler->site_method = helium_module_get_string(module, method->name_offset);
+    }
     InterpretResult result = interpret_bytecode(vm,
         module->bytecode + method->bytecode_offset,
         method->bytecode_size);
+    if (profiler) {
+        profiler->site_method = caller_method;
+    }
     
     if (result != INTERPRET_OK) {
         fprintf(stderr, "Runtime error: %s\n", interpret_result_to_string(result));
         // Clean up call frame
         CallFrame* frame = execution_context_pop_frame(vm->context);
-        if (frame) call_frame_destroy(frame);
+        if (frame) call_frame_destroy(vm->context, frame);
         return 1;
     }
 
     // Clean up call frame
     CallFrame* frame = execution_context_pop_frame(vm->context);
     if (frame) {
-        call_frame_destroy(frame);
+        call_frame_destroy(vm->context, frame);
     }
     
     vm->running = false;
@@ -315,12 +591,12 @@ int vm_call_function(VM* vm, const char* function_name, Value* args, size_t arg_
         return 1;
     }
     
-    // Find function in current module
+    // Find function in current module. The string table is deduplicated,
+    // so methods with this name share the offset of its one entry.
     MethodEntry* method = NULL;
-    for (uint32_t i = 0; i < vm->current_module->method_table->count; i++) {
-        const char* method_name = helium_module_get_string(vm->current_module, 
-            vm->current_module->method_table->entries[i].name_offset);
-        if (method_name && strcmp(method_name, function_name) == 0) {
+    uint32_t name_offset = helium_module_find_string(vm->current_module, function_name);
+    for (uint32_t i = 0; name_offset != UINT32_MAX && i < vm->current_module->method_table->count; i++) {
+        if (vm->current_module->method_table->entries[i].name_offset == name_offset) {
             method = &vm->current_module->method_table->entries[i];
             break;
         }
@@ -347,169 +623,206 @@ int vm_call_function(VM* vm, const char* function_name, Value* args, size_t arg_
 
 // Value Operations
 Value value_create_null(void) {
-    Value value = { VALUE_NULL, { .i64_value = 0 } };
+    Value value = { .type = VALUE_NULL, .data.i64_value = 0 };
     return value;
 }
 
 Value value_create_bool(bool value) {
-    Value val = { VALUE_BOOL, { .bool_value = value } };
+    Value val = { .type = VALUE_BOOL, .data.bool_value = value };
     return val;
 }
 
 Value value_create_i64(int64_t value) {
-    Value val = { VALUE_I64, { .i64_value = value } };
+    Value val = { .type = VALUE_I64, .data.i64_value = value };
     return val;
 }
 
 Value value_create_f64(double value) {
-    Value val = { VALUE_F64, { .f64_value = value } };
+    Value val = { .type = VALUE_F64, .data.f64_value = value };
     return val;
 }
 
-Value value_create_string(const char* value) {
-    Value val = { VALUE_STRING, { .string_value = NULL } };
-    if (value) {
-        val.data.string_value = malloc(strlen(value) + 1);
-        if (val.data.string_value) {
-            strcpy(val.data.string_value, value);
-        }
+// A new (not interned) string on the VM's heap
+Value value_create_string(VM* vm, const char* value) {
+    if (!vm || !value) {
+        return value_create_null();
     }
+    
+    StringObject* string = vm->string_class
+        ? string_create(vm->heap, vm->string_class, value, strlen(value)) : NULL;
+    if (!string) {
+        fprintf(stderr, "Runtime error: Cannot allocate string\n");
+        return value_create_null();
+    }
+    return value_create_string_object(string);
+}
+
+Value value_create_string_object(struct StringObject* string) {
+    if (!string) {
+        return value_create_null();
+    }
+    Value val = { .type = VALUE_STRING, .data.string_value = string };
     return val;
 }
 
 Value value_create_object(struct Object* object) {
-    Value val = { VALUE_OBJECT, { .object_value = object } };
+    Value val = { .type = VALUE_OBJECT, .data.object_value = object };
     return val;
 }
 
+// Wrap a payload in an Option or Result. Primitive, string and object
+// payloads are stored inline; a nested Option or Result is copied into a
+// System.Box on the VM's heap. The caller keeps the payload rooted while the
+// box is allocated.
+static Value value_wrap(VM* vm, ValueType type, uint8_t variant, const Value* payload) {
+    Value wrapped = { .type = type, .variant = variant, .payload_type = (uint8_t)payload->type,
+                      .data = payload->data };
+    
+    if (payload->type == VALUE_OPTION || payload->type == VALUE_RESULT) {
+        struct Object* box = vm && vm->box_class ? object_create(vm->heap, vm->box_class) : NULL;
+        if (!box) {
+            fprintf(stderr, "Runtime error: Cannot box nested %s value\n", value_type_to_string(payload->type));
+            return value_create_null();
+        }
+        ValueBox* contents = (ValueBox*)box->data;
+        contents->reference = value_payload_reference(payload);
+        contents->value = *payload;
+        wrapped.data.object_value = box;
+    }
+    return wrapped;
+}
+
+// The payload of a Some, Ok or Err
+static Value value_payload(const Value* value) {
+    if (value->payload_type == VALUE_OPTION || value->payload_type == VALUE_RESULT) {
+        return ((ValueBox*)value->data.object_value->data)->value;
+    }
+    Value payload = { .type = (ValueType)value->payload_type, .data = value->data };
+    return payload;
+}
+
 // Option value creation
-Value value_create_option_some(const Value* value) {
+Value value_create_option_some(VM* vm, const Value* value) {
     if (!value) {
         return value_create_null();
     }
-    
-    // Create proper Option value with Some variant
-    // We need to allocate memory for the wrapped value
-    struct Value* wrapped_value = malloc(sizeof(struct Value));
-    if (!wrapped_value) {
-        return value_create_null();
-    }
-    *wrapped_value = *value; // Copy the value
-    Value option = { VALUE_OPTION, { .option_value = wrapped_value } };
-    return option;
+    return value_wrap(vm, VALUE_OPTION, VALUE_VARIANT_SOME, value);
 }
 
 Value value_create_option_none(void) {
-    // Create proper Option value with None variant
-    Value option = { VALUE_OPTION, { .option_value = NULL } };
+    Value option = { .type = VALUE_OPTION, .variant = VALUE_VARIANT_NONE, .payload_type = VALUE_NULL };
     return option;
 }
 
-// Result value creation  
-Value value_create_result_ok(const Value* value) {
+// Result value creation
+Value value_create_result_ok(VM* vm, const Value* value) {
     if (!value) {
         return value_create_null();
     }
-    
-    // Create proper Result value with Ok variant
-    Value result = { VALUE_RESULT, { .result_value = (struct Value*)value } };
-    return result;
+    return value_wrap(vm, VALUE_RESULT, VALUE_VARIANT_OK, value);
 }
 
-Value value_create_result_err(const Value* error) {
+Value value_create_result_err(VM* vm, const Value* error) {
     if (!error) {
         return value_create_null();
     }
-    
-    // Create proper Result value with Err variant
-    Value result = { VALUE_RESULT, { .result_value = (struct Value*)error } };
-    return result;
+    return value_wrap(vm, VALUE_RESULT, VALUE_VARIANT_ERR, error);
 }
 
 void value_destroy(Value* value) {
     if (!value) return;
     
-    if (value->type == VALUE_STRING && value->data.string_value) {
-        free(value->data.string_value);
-        value->data.string_value = NULL;
-    }
+    // Values own no memory: strings and boxes are reclaimed by the GC
 }
 
+// Strings are immutable, so copies share them
 Value value_copy(Value value) {
-    Value copy = value;
-    if (value.type == VALUE_STRING && value.data.string_value) {
-        copy.data.string_value = malloc(strlen(value.data.string_value) + 1);
-        if (copy.data.string_value) {
-            strcpy(copy.data.string_value, value.data.string_value);
-        }
-    }
-    return copy;
+    return value;
 }
 
 // Option operations
 bool value_option_is_some(const Value* value) {
     if (!value || value->type != VALUE_OPTION) return false;
-    return value->data.option_value != NULL;
+    return value->variant == VALUE_VARIANT_SOME;
 }
 
 bool value_option_is_none(const Value* value) {
     if (!value || value->type != VALUE_OPTION) return true;
-    return value->data.option_value == NULL;
+    return value->variant == VALUE_VARIANT_NONE;
 }
 
 Value value_option_unwrap(const Value* value) {
-    if (!value || value->type != VALUE_OPTION || value->data.option_value == NULL) {
+    if (!value_option_is_some(value)) {
         // Panic - unwrapping None
         fprintf(stderr, "Runtime error: Attempted to unwrap None value\n");
         return value_create_null();
     }
-    return *(value->data.option_value);
+    return value_payload(value);
 }
 
 Value value_option_unwrap_or(const Value* value, const Value* default_value) {
-    if (!value || value->type != VALUE_OPTION || value->data.option_value == NULL) {
+    if (!value_option_is_some(value)) {
         return *default_value;
     }
-    return *(value->data.option_value);
+    return value_payload(value);
 }
 
 // Result operations
 bool value_result_is_ok(const Value* value) {
     if (!value || value->type != VALUE_RESULT) return false;
-    return value->data.result_value != NULL;
+    return value->variant == VALUE_VARIANT_OK;
 }
 
 bool value_result_is_err(const Value* value) {
     if (!value || value->type != VALUE_RESULT) return true;
-    return value->data.result_value == NULL;
+    return value->variant == VALUE_VARIANT_ERR;
 }
 
 Value value_result_unwrap(const Value* value) {
-    if (!value || value->type != VALUE_RESULT || value->data.result_value == NULL) {
+    if (!value_result_is_ok(value)) {
         // Panic - unwrapping Err
         fprintf(stderr, "Runtime error: Attempted to unwrap Err value\n");
         return value_create_null();
     }
-    return *(value->data.result_value);
+    return value_payload(value);
 }
 
 Value value_result_unwrap_or(const Value* value, const Value* default_value) {
-    if (!value || value->type != VALUE_RESULT || value->data.result_value == NULL) {
+    if (!value_result_is_ok(value)) {
         return *default_value;
     }
-    return *(value->data.result_value);
+    return value_payload(value);
 }
 
 Value value_result_unwrap_err(const Value* value) {
-    if (!value || value->type != VALUE_RESULT || value->data.result_value != NULL) {
+    if (!value || value->type != VALUE_RESULT || value->variant != VALUE_VARIANT_ERR) {
         // Panic - unwrapping Ok as Err
         fprintf(stderr, "Runtime error: Attempted to unwrap Ok value as Err\n");
         return value_create_null();
     }
-    return value_create_null(); // Err variant has no value
+    return value_payload(value);
 }
 
-bool value_equals(Value a, Value b) {
+// Bytes of a string value, flattening a rope on the VM's heap on first use.
+// Without a VM an unflattened rope has no bytes.
+static const char* value_string_bytes(VM* vm, struct StringObject* string) {
+    return vm ? string_flatten(vm->heap, string) : string_bytes(string);
+}
+
+static const char* value_string_chars(VM* vm, struct StringObject* string) {
+    const char* bytes = value_string_bytes(vm, string);
+    return bytes ? bytes : "";
+}
+
+static bool value_string_equals(VM* vm, struct StringObject* a, struct StringObject* b) {
+    if (a == b) return true;
+    if (!a || !b || a->length != b->length || a->hash != b->hash) return false;
+    const char* bytes_a = value_string_bytes(vm, a);
+    const char* bytes_b = value_string_bytes(vm, b);
+    return bytes_a && bytes_b && memcmp(bytes_a, bytes_b, a->length) == 0;
+}
+
+bool value_equals(VM* vm, Value a, Value b) {
     if (a.type != b.type) {
         return false;
     }
@@ -524,30 +837,20 @@ bool value_equals(Value a, Value b) {
         case VALUE_F64:
             return a.data.f64_value == b.data.f64_value;
         case VALUE_STRING:
-            if (!a.data.string_value || !b.data.string_value) {
-                return a.data.string_value == b.data.string_value;
-            }
-            return strcmp(a.data.string_value, b.data.string_value) == 0;
+            return value_string_equals(vm, a.data.string_value, b.data.string_value);
         case VALUE_OBJECT:
             return a.data.object_value == b.data.object_value;
         case VALUE_ARRAY:
             return a.data.array_value == b.data.array_value;
         case VALUE_OPTION:
-            if (a.data.option_value == NULL && b.data.option_value == NULL) {
-                return true;
-            }
-            if (a.data.option_value == NULL || b.data.option_value == NULL) {
+        case VALUE_RESULT:
+            if (a.variant != b.variant) {
                 return false;
             }
-            return value_equals(*(a.data.option_value), *(b.data.option_value));
-        case VALUE_RESULT:
-            if (a.data.result_value == NULL && b.data.result_value == NULL) {
+            if (a.type == VALUE_OPTION && a.variant == VALUE_VARIANT_NONE) {
                 return true;
             }
-            if (a.data.result_value == NULL || b.data.result_value == NULL) {
-                return false;
-            }
-            return value_equals(*(a.data.result_value), *(b.data.result_value));
+            return value_equals(vm, value_payload(&a), value_payload(&b));
         default:
             return false;
     }
@@ -568,7 +871,7 @@ const char* value_type_to_string(ValueType type) {
     }
 }
 
-void value_print(Value value) {
+void value_print(VM* vm, Value value) {
     switch (value.type) {
         case VALUE_NULL:
             printf("null");
@@ -584,7 +887,8 @@ void value_print(Value value) {
             break;
         case VALUE_STRING:
             if (value.data.string_value) {
-                printf("\"%s\"", value.data.string_value);
+                printf("\"%.*s\"", (int)value.data.string_value->length,
+                       value_string_chars(vm, value.data.string_value));
             } else {
                 printf("null");
             }
@@ -596,22 +900,18 @@ void value_print(Value value) {
             printf("array@%p", value.data.array_value);
             break;
         case VALUE_OPTION:
-            if (value.data.option_value) {
+            if (value.variant == VALUE_VARIANT_SOME) {
                 printf("Some(");
-                value_print(*(value.data.option_value));
+                value_print(vm, value_payload(&value));
                 printf(")");
             } else {
                 printf("None");
             }
             break;
         case VALUE_RESULT:
-            if (value.data.result_value) {
-                printf("Ok(");
-                value_print(*(value.data.result_value));
-                printf(")");
-            } else {
-                printf("Err");
-            }
+            printf(value.variant == VALUE_VARIANT_OK ? "Ok(" : "Err(");
+            value_print(vm, value_payload(&value));
+            printf(")");
             break;
         default:
             printf("unknown");
@@ -629,7 +929,7 @@ void vm_print_stack(VM* vm) {
     printf("Stack (size: %zu):\n", stack_size(vm->stack));
     for (size_t i = 0; i < stack_size(vm->stack); i++) {
         printf("  [%zu]: ", i);
-        value_print(stack_peek(vm->stack, stack_size(vm->stack) - 1 - i));
+        value_print(vm, stack_peek(vm->stack, stack_size(vm->stack) - 1 - i));
         printf("\n");
     }
 }
@@ -719,12 +1019,14 @@ void vm_initialize_object_system(VM* vm) {
     }
     
     // Create basic types
-    struct Class* string_class = class_create("System.String", 2, 64);
+    // Strings are variable-size objects
+    struct Class* string_class = class_create("System.String", 2, 0);
     if (string_class) {
         class_set_superclass(string_class, object_class);
         object_registry_register_class(string_class);
         string_class->next = vm->classes;
         vm->classes = string_class;
+        vm->string_class = string_class;
     }
     
     struct Class* integer_class = class_create("System.Int64", 3, 8);
@@ -750,6 +1052,55 @@ void vm_initialize_object_system(VM* vm) {
         boolean_class->next = vm->classes;
         vm->classes = boolean_class;
     }
+    
+    // Boxes for nested Option/Result payloads
+    struct Class* box_class = class_create("System.Box", 6, sizeof(ValueBox));
+    if (box_class) {
+        class_add_field(box_class, field_create("reference", FIELD_TYPE_OBJECT, 0, sizeof(struct Object*)));
+        class_set_superclass(box_class, object_class);
+        object_registry_register_class(box_class);
+        box_class->next = vm->classes;
+        vm->classes = box_class;
+        vm->box_class = box_class;
+    }
+    
+    // Concatenation nodes are strings whose bytes are copied out on demand
+    struct Class* rope_class = class_create("System.Rope", 7, 0);
+    if (rope_class) {
+        class_add_field(rope_class, field_create("left", FIELD_TYPE_STRING,
+            offsetof(RopeObject, left) - offsetof(Object, data), sizeof(struct StringObject*)));
+        class_add_field(rope_class, field_create("right", FIELD_TYPE_STRING,
+            offsetof(RopeObject, right) - offsetof(Object, data), sizeof(struct StringObject*)));
+        class_set_superclass(rope_class, string_class);
+        object_registry_register_class(rope_class);
+        rope_class->next = vm->classes;
+        vm->classes = rope_class;
+        vm->rope_class = rope_class;
+    }
+    
+    struct Class* string_builder_class = class_create("System.StringBuilder", 8,
+        sizeof(StringBuilderObject) - sizeof(ObjectHeader));
+    if (string_builder_class) {
+        class_add_field(string_builder_class, field_create("buffer", FIELD_TYPE_STRING,
+            offsetof(StringBuilderObject, buffer) - offsetof(Object, data), sizeof(struct StringObject*)));
+        class_set_superclass(string_builder_class, object_class);
+        object_registry_register_class(string_builder_class);
+        string_builder_class->next = vm->classes;
+        vm->classes = string_builder_class;
+        vm->string_builder_class = string_builder_class;
+    }
+    
+    // Substring views are strings whose bytes belong to a parent string
+    struct Class* slice_class = class_create("System.Slice", 9, 0);
+    if (slice_class) {
+        class_add_field(slice_class, field_create("parent", FIELD_TYPE_STRING,
+            offsetof(SliceObject, parent) - offsetof(Object, data), sizeof(struct StringObject*)));
+        class_set_superclass(slice_class, string_class);
+        object_registry_register_class(slice_class);
+        slice_class->next = vm->classes;
+        vm->classes = slice_class;
+        vm->slice_class = slice_class;
+    }
 }
 
 void vm_cleanup_object_system(VM* vm) {
@@ -765,6 +1116,11 @@ void vm_cleanup_object_system(VM* vm) {
         current = next;
     }
     vm->classes = NULL;
+    vm->string_class = NULL;
+    vm->rope_class = NULL;
+    vm->string_builder_class = NULL;
+    vm->slice_class = NULL;
+    vm->box_class = NULL;
     
     // Clean up object registry (just clear the registry pointer, classes already destroyed)
     object_registry_clear();
@@ -791,6 +1147,34 @@ struct Object* vm_create_object(VM* vm, const char* class_name) {
     return object_create(vm->heap, class_info);
 }
 
+// Interned string for a string constant of the current module. The first
+// use interns it through the string registry; later uses hit the cache.
+struct StringObject* vm_intern_literal(VM* vm, uint32_t constant_index, const char* chars) {
+    if (!vm || !chars) return NULL;
+    
+    HeliumModule* module = vm->current_module;
+    uint32_t count = module && module->constant_table ? module->constant_table->count : 0;
+    if (vm->literal_module != module || vm->literal_count != count) {
+        free(vm->literal_strings);
+        vm->literal_strings = count ? calloc(count, sizeof(struct StringObject*)) : NULL;
+        vm->literal_count = vm->literal_strings ? count : 0;
+        vm->literal_module = module;
+    }
+    
+    if (constant_index < vm->literal_count && vm->literal_strings[constant_index]) {
+        return vm->literal_strings[constant_index];
+    }
+    
+    StringObject* string = string_manager_intern(&vm->string_manager, chars);
+    if (!string) {
+        // No permanent generation to intern into
+        string = string_create(vm->heap, vm->string_class, chars, strlen(chars));
+    } else if (constant_index < vm->literal_count) {
+        vm->literal_strings[constant_index] = string;
+    }
+    return string;
+}
+
 struct Object* vm_create_object_by_class(VM* vm, struct Class* class_info) {
     if (!vm || !class_info) return NULL;
     
@@ -982,22 +1366,284 @@ int vm_load_library(VM* vm, const char* library_path) {
     return 1;
 }
 
+// Project dependency graph. A project's "dependencies" are .helium3 module
+// paths or library projects (a directory or its he3project.json), relative
+// to the project file, given as strings or objects with a "path". A library
+// project contributes its own dependencies, then the module named by its
+// build "output". Module files do not record imports, so the modules found
+// are loaded independently of each other; the list keeps dependencies before
+// their dependents, the order in which they are registered.
+
+#define VM_PROJECT_MAX_DEPTH 32
+
+typedef struct ProjectGraph {
+    char** modules;                 // Module paths in dependency order (owned)
+    uint32_t count;
+    uint32_t capacity;
+    const char* walking[VM_PROJECT_MAX_DEPTH]; // Projects being walked
+    uint32_t depth;
+    bool failed;
+} ProjectGraph;
+
+static void vm_project_walk(ProjectGraph* graph, const char* project_file, char* output, size_t output_size);
+
+static char* vm_read_project_file(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    
+    char* text = NULL;
+    long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+    if (size >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        text = malloc((size_t)size + 1);
+        if (text && fread(text, 1, (size_t)size, file) == (size_t)size) {
+            text[size] = '\0';
+        } else {
+            free(text);
+            text = NULL;
+        }
+    }
+    fclose(file);
+    return text;
+}
+
+// Value of "key" in a JSON text, past the colon and white space, or NULL
+static const char* vm_project_find_key(const char* json, const char* key) {
+    size_t length = strlen(key);
+    for (const char* p = strchr(json, '"'); p; p = strchr(p + 1, '"')) {
+        if (strncmp(p + 1, key, length) != 0 || p[length + 1] != '"') continue;
+        
+        const char* value = p + length + 2;
+        while (isspace((unsigned char)*value)) value++;
+        if (*value != ':') continue;
+        value++;
+        while (isspace((unsigned char)*value)) value++;
+        return value;
+    }
+    return NULL;
+}
+
+// Copy the JSON string at `p` into `out`; returns the position after it,
+// or NULL if it is not a string or does not fit
+static const char* vm_project_read_string(const char* p, char* out, size_t size) {
+    if (*p != '"') return NULL;
+    
+    size_t length = 0;
+    for (p++; *p && *p != '"'; p++) {
+        if (*p == '\\' && p[1]) p++;
+        if (length + 1 >= size) return NULL;
+        out[length++] = *p;
+    }
+    if (*p != '"') return NULL;
+    out[length] = '\0';
+    return p + 1;
+}
+
+// Position after the JSON object starting at `p`, or NULL
+static const char* vm_project_object_end(const char* p) {
+    int depth = 0;
+    for (; *p; p++) {
+        if (*p == '"') {
+            for (p++; *p && *p != '"'; p++) {
+                if (*p == '\\' && p[1]) p++;
+            }
+            if (!*p) return NULL;
+        } else if (*p == '{') {
+            depth++;
+        } else if (*p == '}' && --depth == 0) {
+            return p + 1;
+        }
+    }
+    return NULL;
+}
+
+// Read one dependency: a path string, or an object with a "path"
+static const char* vm_project_read_dependency(const char* p, char* out, size_t size) {
+    if (*p != '{') {
+        return vm_project_read_string(p, out, size);
+    }
+    
+    const char* end = vm_project_object_end(p);
+    char* object = end ? malloc((size_t)(end - p) + 1) : NULL;
+    if (!object) return NULL;
+    memcpy(object, p, (size_t)(end - p));
+    object[end - p] = '\0';
+    const char* path = vm_project_find_key(object, "path");
+    bool found = path && vm_project_read_string(path, out, size);
+    free(object);
+    return found ? end : NULL;
+}
+
+// `relative` resolved against the directory `dir`
+static bool vm_project_path(const char* dir, const char* relative, char* out, size_t size) {
+    int written = relative[0] == '/' ? snprintf(out, size, "%s", relative)
+                                     : snprintf(out, size, "%s/%s", dir, relative);
+    return written > 0 && (size_t)written < size;
+}
+
+// Add a module once; dependencies shared by several projects load once
+static void vm_project_add_module(ProjectGraph* graph, const char* path) {
+    char resolved[PATH_MAX];
+    const char* key = realpath(path, resolved) ? resolved : path;
+    for (uint32_t i = 0; i < graph->count; i++) {
+        if (strcmp(graph->modules[i], key) == 0) return;
+    }
+    
+    if (graph->count == graph->capacity) {
+        uint32_t capacity = graph->capacity ? graph->capacity * 2 : 8;
+        char** modules = realloc(graph->modules, capacity * sizeof(char*));
+        if (!modules) {
+            graph->failed = true;
+            return;
+        }
+        graph->modules = modules;
+        graph->capacity = capacity;
+    }
+    graph->modules[graph->count] = vm_copy_path(key);
+    if (!graph->modules[graph->count]) {
+        graph->failed = true;
+        return;
+    }
+    graph->count++;
+}
+
+static void vm_project_add_dependency(ProjectGraph* graph, const char* path) {
+    size_t length = strlen(path);
+    if (length > 8 && strcmp(path + length - 8, ".helium3") == 0) {
+        vm_project_add_module(graph, path);
+        return;
+    }
+    
+    // A library project: its dependencies first, then the module it builds
+    char project_file[PATH_MAX];
+    struct stat st;
+    bool is_dir = stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+    int written = snprintf(project_file, sizeof(project_file), is_dir ? "%s/he3project.json" : "%s", path);
+    if (written <= 0 || (size_t)written >= sizeof(project_file)) {
+        graph->failed = true;
+        return;
+    }
+    
+    char output[PATH_MAX];
+    vm_project_walk(graph, project_file, output, sizeof(output));
+    if (!graph->failed) {
+        vm_project_add_module(graph, output);
+    }
+}
+
+// Walk a project file's dependencies; `output` receives its build output
+static void vm_project_walk(ProjectGraph* graph, const char* project_file, char* output, size_t output_size) {
+    char resolved[PATH_MAX];
+    const char* key = realpath(project_file, resolved) ? resolved : project_file;
+    for (uint32_t i = 0; i < graph->depth; i++) {
+        if (strcmp(graph->walking[i], key) == 0) {
+            fprintf(stderr, "Error: Project dependency cycle through %s\n", project_file);
+            graph->failed = true;
+            return;
+        }
+    }
+    if (graph->depth == VM_PROJECT_MAX_DEPTH) {
+        fprintf(stderr, "Error: Project dependencies nested too deeply at %s\n", project_file);
+        graph->failed = true;
+        return;
+    }
+    
+    char* json = vm_read_project_file(project_file);
+    if (!json) {
+        fprintf(stderr, "Error: Cannot read project file '%s'\n", project_file);
+        graph->failed = true;
+        return;
+    }
+    
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), "%s", project_file);
+    char* slash = strrchr(dir, '/');
+    if (slash) {
+        *slash = '\0';
+    } else {
+        strcpy(dir, ".");
+    }
+    
+    graph->walking[graph->depth++] = key;
+    const char* p = vm_project_find_key(json, "dependencies");
+    if (p && *p == '[') {
+        char dependency[PATH_MAX];
+        char path[PATH_MAX];
+        for (p++; !graph->failed; ) {
+            while (isspace((unsigned char)*p) || *p == ',') p++;
+            if (*p == ']') break;
+            p = vm_project_read_dependency(p, dependency, sizeof(dependency));
+            if (!p || !vm_project_path(dir, dependency, path, sizeof(path))) {
+                fprintf(stderr, "Error: Cannot read a dependency path in '%s'\n", project_file);
+                graph->failed = true;
+                break;
+            }
+            vm_project_add_dependency(graph, path);
+        }
+    }
+    graph->depth--;
+    
+    if (output && !graph->failed) {
+        char relative[PATH_MAX];
+        p = vm_project_find_key(json, "output");
+        if (!p || !vm_project_read_string(p, relative, sizeof(relative)) ||
+            !vm_project_path(dir, relative, output, output_size)) {
+            fprintf(stderr, "Error: Library project '%s' has no build output\n", project_file);
+            graph->failed = true;
+        }
+    }
+    free(json);
+}
+
+static void vm_project_graph_destroy(ProjectGraph* graph) {
+    for (uint32_t i = 0; i < graph->count; i++) {
+        free(graph->modules[i]);
+    }
+    free(graph->modules);
+}
+
 int vm_load_project_modules(VM* vm, const char* project_file) {
     if (!vm || !project_file) {
         return 0;
     }
     
+    if (!vm->module_registry) {
+        vm_initialize_module_registry(vm);
+    }
+    
     printf("Loading project modules from: %s\n", project_file);
     
-    // TODO: Parse project file and load all modules
-    // For now, this is a placeholder that would:
-    // 1. Parse the he3project.json file
-    // 2. Load all source files as modules
-    // 3. Load all dependencies as libraries
-    // 4. Resolve cross-module references
+    ProjectGraph graph;
+    memset(&graph, 0, sizeof(graph));
+    vm_project_walk(&graph, project_file, NULL, 0);
+    if (graph.failed) {
+        vm_project_graph_destroy(&graph);
+        return 0;
+    }
     
-    printf("Project module loading not yet implemented\n");
-    return 0;
+    // Files are mapped, validated and indexed on a thread per core; the
+    // registry merge runs here, in dependency order
+    uint32_t threads = vm->load_threads;
+    if (threads == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 0 ? (uint32_t)cores : 1;
+    }
+    int result = graph.count == 0;
+    HeliumModule** modules = graph.count ?
+        realloc(vm->library_modules, (vm->library_count + graph.count) * sizeof(HeliumModule*)) : NULL;
+    if (modules) {
+        vm->library_modules = modules;
+        result = module_registry_load_helium3_modules(vm->module_registry, (const char* const*)graph.modules,
+                                                      modules + vm->library_count, graph.count, threads);
+        vm->library_count += graph.count;
+    }
+    
+    if (result) {
+        printf("Loaded %u project modules\n", graph.count);
+    } else {
+        fprintf(stderr, "Failed to load project modules: %s\n", project_file);
+    }
+    vm_project_graph_destroy(&graph);
+    return result;
 }
 
 bool vm_resolve_dependencies(VM* vm, const char* project_file) {
@@ -1007,15 +1653,19 @@ bool vm_resolve_dependencies(VM* vm, const char* project_file) {
     
     printf("Resolving dependencies for project: %s\n", project_file);
     
-    // TODO: Implement dependency resolution
-    // This would:
-    // 1. Parse project dependencies
-    // 2. Load required libraries
-    // 3. Resolve cross-module class/method references
-    // 4. Validate all dependencies are satisfied
-    
-    printf("Dependency resolution not yet implemented\n");
-    return false;
+    // Every module of the graph must be readable; nothing is loaded
+    ProjectGraph graph;
+    memset(&graph, 0, sizeof(graph));
+    vm_project_walk(&graph, project_file, NULL, 0);
+    bool resolved = !graph.failed;
+    for (uint32_t i = 0; i < graph.count; i++) {
+        if (access(graph.modules[i], R_OK) != 0) {
+            fprintf(stderr, "Missing dependency: %s\n", graph.modules[i]);
+            resolved = false;
+        }
+    }
+    vm_project_graph_destroy(&graph);
+    return resolved;
 }
 
 ClassRegistryEntry* vm_find_class_anywhere(VM* vm, const char* class_name) {
@@ -1050,7 +1700,7 @@ MethodRegistryEntry* vm_find_method_anywhere(VM* vm, const char* method_name, co
     }
     
     // Then find the method in that class
-    return method_registry_find_method_by_name_and_type(method_name, class_entry->type_id);
+    return method_registry_find_method_by_name_and_type(method_name, class_entry->global_type_id);
 }
 
 FieldRegistryEntry* vm_find_field_anywhere(VM* vm, const char* field_name, const char* class_name) {
@@ -1065,5 +1715,5 @@ FieldRegistryEntry* vm_find_field_anywhere(VM* vm, const char* field_name, const
     }
     
     // Then find the field in that class
-    return field_registry_find_field_by_name_and_type(field_name, class_entry->type_id);
+    return field_registry_find_field_by_name_and_type(field_name, class_entry->global_type_id);
 }
@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <signal.h>
 #include "../shared/bytecode/helium_format.h"
 #include "../shared/bytecode/opcodes.h"
 
@@ -13,9 +14,11 @@ struct Stack;
 struct Heap;
 struct Object;
 struct Class;
+struct StringObject;
 
 // Include heap and object headers
 #include "memory/heap.h"
+#include "memory/pool.h"
 #include "objects/object.h"
 #include "modules/module_registry.h"
 #include "string_manager/global_string_registry.h"
@@ -33,24 +36,44 @@ typedef enum {
     VALUE_RESULT
 } ValueType;
 
-// VM Value structure
+// Option and Result variants
+#define VALUE_VARIANT_NONE 0
+#define VALUE_VARIANT_SOME 1
+#define VALUE_VARIANT_OK 0
+#define VALUE_VARIANT_ERR 1
+
+// VM Value structure. Option and Result are unboxed: the variant and the
+// payload's type live in the padding after the type, and a primitive,
+// string or object payload lives in data. Only a nested Option or Result
+// payload is boxed, in a GC-managed System.Box object held in object_value.
 typedef struct Value {
     ValueType type;
+    uint8_t variant;                // Option/Result variant (VALUE_VARIANT_*)
+    uint8_t payload_type;           // ValueType of the Option/Result payload
     union {
         bool bool_value;
         int64_t i64_value;
         double f64_value;
-        char* string_value;
+        struct StringObject* string_value;  // Shared, immutable GC string
         struct Object* object_value;
         struct Array* array_value;
-        struct Value* option_value;  // For Option<T>: NULL for None, pointer to Value for Some
-        struct Value* result_value;  // For Result<T,E>: pointer to Value for Ok/Err
     } data;
 } Value;
 
+// System.Box layout: the reference the collector traces (the payload's own
+// box, if any) followed by the boxed payload
+typedef struct ValueBox {
+    struct Object* reference;
+    Value value;
+} ValueBox;
+
 // Forward declaration for Stack (defined in stack.h)
 struct Stack;
 
+// Locals stored inside a pooled call frame; frames with more locals
+// allocate them separately
+#define CALL_FRAME_INLINE_LOCALS 8
+
 // VM Call Frame
 typedef struct CallFrame {
     uint8_t* ip;                    // Instruction pointer
@@ -66,28 +89,76 @@ typedef struct ExecutionContext {
     size_t frame_count;             // Number of frames
     size_t frame_capacity;          // Frame capacity
     struct CallFrame* current_frame; // Current frame
+    SlabPool frame_pool;            // Frames with CALL_FRAME_INLINE_LOCALS locals each
 } ExecutionContext;
 
 // VM Main Structure
 typedef struct VM {
     HeliumModule* current_module;   // Currently executing .helium3 module
+    ModuleEntry* current_module_entry; // Registry entry of current_module (maps its IDs)
     struct Stack* stack;            // Operand stack
     struct ExecutionContext* context; // Execution context
     struct Heap* heap;              // Memory heap
     struct Class* classes;          // Loaded classes
+    struct Class* string_class;     // System.String
+    struct Class* rope_class;       // System.Rope (concatenation nodes)
+    struct Class* string_builder_class; // System.StringBuilder
+    struct Class* slice_class;      // System.Slice (substring views)
+    struct Class* box_class;        // System.Box (nested Option/Result payloads)
     ModuleRegistry* module_registry; // Module registry
     StringManager string_manager;   // String manager
+    HeliumModule* literal_module;   // Module whose literals are cached
+    struct StringObject** literal_strings; // Interned string per constant (NULL = not yet)
+    uint32_t literal_count;         // Entries in literal_strings
     bool running;                   // VM running state
     int exit_code;                  // VM exit code
     bool debug;                     // Debug output flag
+    FILE* gc_log;                   // GC log file (owned, NULL = off)
+    char* heap_profile_path;        // Allocation profile report (NULL = off)
+    char* heap_snapshot_path;       // Heap snapshot file (NULL = off)
+    int program_argc;               // Arguments for Sys.argc/Sys.argv
+    char** program_argv;            // (borrowed from main, valid UTF-8)
+    void* snapshot_image;           // VM image the VM was restored from (NULL = none)
+    size_t snapshot_image_size;     // Size of the mapped image
+    HeliumModule** library_modules; // Project dependencies loaded (owned)
+    uint32_t library_count;         // Entries in library_modules
+    uint32_t load_threads;          // Module loading threads (0 = one per core)
 } VM;
 
+// Set from a signal handler to have the running VM write its allocation
+// profile at the next instruction boundary
+extern volatile sig_atomic_t vm_heap_profile_requested;
+
+// Set from a signal handler to have the running VM write a heap snapshot
+// at the next instruction boundary
+extern volatile sig_atomic_t vm_heap_snapshot_requested;
+
 // VM Creation and Destruction
 VM* vm_create(void);
 void vm_destroy(VM* vm);
 
 // VM Configuration
 void vm_set_debug(VM* vm, bool debug);
+void vm_set_gc_concurrent(VM* vm, bool concurrent);
+void vm_set_gc_threads(VM* vm, uint32_t threads);
+void vm_set_gc_incremental(VM* vm, bool incremental);
+void vm_set_gc_pause_target(VM* vm, uint32_t target_us);
+bool vm_set_gc_log(VM* vm, const char* path);
+bool vm_set_heap_limits(VM* vm, size_t soft_limit, size_t hard_limit);
+bool vm_set_heap_huge_pages(VM* vm, bool enabled);
+bool vm_set_heap_profile(VM* vm, const char* path, uint32_t rate);
+bool vm_write_heap_profile(VM* vm);
+bool vm_set_heap_snapshot(VM* vm, const char* path);
+bool vm_set_program_args(VM* vm, int argc, char** argv);
+void vm_set_load_threads(VM* vm, uint32_t threads);
+bool vm_write_heap_snapshot(VM* vm);
+
+// VM snapshot images (vm_image.c): an initialized VM written after its
+// module is loaded, linked and its literals interned, and restored in
+// place of loading the module
+bool vm_image_write(VM* vm, const char* path);
+bool vm_image_load(VM* vm, const char* path);
+void vm_image_release(VM* vm);
 
 // VM Execution
 int vm_load_helium3_module(VM* vm, const char* filename);
@@ -109,14 +180,15 @@ Value value_create_null(void);
 Value value_create_bool(bool value);
 Value value_create_i64(int64_t value);
 Value value_create_f64(double value);
-Value value_create_string(const char* value);
+Value value_create_string(VM* vm, const char* value);
+Value value_create_string_object(struct StringObject* string);
 Value value_create_object(struct Object* object);
 void value_destroy(Value* value);
 Value value_copy(Value value);
-bool value_equals(Value a, Value b);
+bool value_equals(VM* vm, Value a, Value b);
 
 // Option value operations
-Value value_create_option_some(const Value* value);
+Value value_create_option_some(VM* vm, const Value* value);
 Value value_create_option_none(void);
 bool value_option_is_some(const Value* value);
 bool value_option_is_none(const Value* value);
@@ -124,15 +196,15 @@ Value value_option_unwrap(const Value* value);
 Value value_option_unwrap_or(const Value* value, const Value* default_value);
 
 // Result value operations
-Value value_create_result_ok(const Value* value);
-Value value_create_result_err(const Value* error);
+Value value_create_result_ok(VM* vm, const Value* value);
+Value value_create_result_err(VM* vm, const Value* error);
 bool value_result_is_ok(const Value* value);
 bool value_result_is_err(const Value* value);
 Value value_result_unwrap(const Value* value);
 Value value_result_unwrap_or(const Value* value, const Value* default_value);
 Value value_result_unwrap_err(const Value* value);
 const char* value_type_to_string(ValueType type);
-void value_print(Value value);
+void value_print(VM* vm, Value value);
 
 // VM Debugging
 void vm_print_stack(VM* vm);
@@ -151,6 +223,7 @@ struct Class* vm_find_class(VM* vm, const char* name);
 struct Class* vm_find_class_by_id(VM* vm, uint32_t type_id);
 struct Object* vm_create_object(VM* vm, const char* class_name);
 struct Object* vm_create_object_by_class(VM* vm, struct Class* class_info);
+struct StringObject* vm_intern_literal(VM* vm, uint32_t constant_index, const char* chars);
 void vm_print_object_system(VM* vm);
 void vm_print_classes(VM* vm);
 void vm_print_objects(VM* vm);
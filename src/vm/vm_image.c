@@ -0,0 +1,571 @@
+#include "vm.h"
+#include "../shared/build_info.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// VM snapshot images. An image holds an initialized VM: the module file,
+// the module's ID maps, every class, method and field registry entry, the
+// Method info of methods already linked and the string literals already
+// interned. Restoring maps the file privately and uses the entries in place;
+// their pointers are saved as offsets from the start of the image and fixed
+// up once, instead of being recreated by module loading and discovery.
+//
+// Heap objects are not saved: the only ones an initialized VM holds are
+// interned literals, which are interned again from the saved list.
+
+#define VM_IMAGE_MAGIC "HE3IMG"
+#define VM_IMAGE_VERSION 1
+
+// Sections start on this alignment; the module needs its bytecode alignment
+#define VM_IMAGE_ALIGNMENT HELIUM_BYTECODE_ALIGNMENT
+
+typedef enum {
+    VM_IMAGE_MODULE = 0,        // The .helium3 file (bytes)
+    VM_IMAGE_TYPE_IDS,          // Module type ID -> global type ID (uint32_t)
+    VM_IMAGE_METHOD_IDS,        // Module method ID -> global method ID (uint32_t)
+    VM_IMAGE_FIELD_IDS,         // Module field ID -> global field ID (uint32_t)
+    VM_IMAGE_CLASSES,           // ClassRegistryEntry records
+    VM_IMAGE_METHODS,           // MethodRegistryEntry records
+    VM_IMAGE_METHOD_INFO,       // Method records of linked methods
+    VM_IMAGE_FIELDS,            // FieldRegistryEntry records
+    VM_IMAGE_FIELD_INFO,        // Field records
+    VM_IMAGE_LITERALS,          // Constant indexes of interned literals (uint32_t)
+    VM_IMAGE_STRINGS,           // Names that are not in the module (bytes, NUL-terminated)
+    VM_IMAGE_SECTION_COUNT
+} VmImageSectionKind;
+
+typedef struct VmImageSection {
+    uint64_t offset;            // From the start of the image
+    uint32_t count;             // Records
+    uint32_t record_size;       // Bytes per record; must match the restoring VM
+} VmImageSection;
+
+typedef struct VmImageHeader {
+    char magic[8];              // VM_IMAGE_MAGIC
+    uint32_t version;           // VM_IMAGE_VERSION
+    uint32_t byte_order;        // HELIUM_BYTE_ORDER_MARK
+    uint32_t pointer_size;      // sizeof(void*) of the writing VM
+    uint32_t module_name;       // Offset of the module name (in VM_IMAGE_STRINGS)
+    uint64_t image_size;        // Size of the whole image
+    char build[64];             // HE3_BUILD_INFO_STRING of the writing VM
+    uint32_t class_ids;         // Next global type ID
+    uint32_t method_ids;        // Next global method ID
+    uint32_t field_ids;         // Next global field ID
+    uint32_t reserved;          // Zero
+    VmImageSection sections[VM_IMAGE_SECTION_COUNT];
+} VmImageHeader;
+
+// Pointers are saved as image offsets; offset 0 (the header) stands for NULL
+#define VM_IMAGE_OFFSET(offset) ((void*)(uintptr_t)(offset))
+#define VM_IMAGE_OFFSET_OF(ptr) ((uint64_t)(uintptr_t)(ptr))
+
+// ============================================================================
+// WRITING
+// ============================================================================
+
+typedef struct VmImageWriter {
+    VmImageHeader* header;      // Start of data
+    uint8_t* data;              // Every section but the strings
+    size_t size;                // Bytes in data
+    char* strings;              // The strings section, appended to data
+    size_t strings_size;
+    size_t strings_capacity;
+    const HeliumModule* module;
+    bool failed;
+} VmImageWriter;
+
+static size_t vm_image_align(size_t size) {
+    return (size + VM_IMAGE_ALIGNMENT - 1) & ~(size_t)(VM_IMAGE_ALIGNMENT - 1);
+}
+
+// Lay a section out after the previous ones
+static void vm_image_add_section(VmImageHeader* header, size_t* size, VmImageSectionKind kind,
+                                 uint32_t count, uint32_t record_size) {
+    *size = vm_image_align(*size);
+    header->sections[kind].offset = *size;
+    header->sections[kind].count = count;
+    header->sections[kind].record_size = record_size;
+    *size += (size_t)count * record_size;
+}
+
+static void* vm_image_section(VmImageWriter* writer, VmImageSectionKind kind) {
+    return writer->data + writer->header->sections[kind].offset;
+}
+
+// Image offset of a string: inside the module's copy when it comes from
+// the module file, otherwise a copy in the strings section
+static uint64_t vm_image_string(VmImageWriter* writer, const char* str) {
+    if (!str) return 0;
+
+    uintptr_t start = (uintptr_t)writer->module->image;
+    if ((uintptr_t)str >= start && (uintptr_t)str < start + writer->module->image_size) {
+        return writer->header->sections[VM_IMAGE_MODULE].offset + ((uintptr_t)str - start);
+    }
+
+    size_t length = strlen(str) + 1;
+    if (writer->strings_size + length > writer->strings_capacity) {
+        size_t capacity = writer->strings_capacity ? writer->strings_capacity * 2 : 1024;
+        while (capacity < writer->strings_size + length) capacity *= 2;
+        char* strings = realloc(writer->strings, capacity);
+        if (!strings) {
+            writer->failed = true;
+            return 0;
+        }
+        writer->strings = strings;
+        writer->strings_capacity = capacity;
+    }
+    memcpy(writer->strings + writer->strings_size, str, length);
+    writer->strings_size += length;
+    return writer->size + writer->strings_size - length;
+}
+
+// Image offset of a pointer into the module's bytecode
+static uint64_t vm_image_bytecode(VmImageWriter* writer, const uint8_t* bytecode) {
+    if (!bytecode) return 0;
+
+    uintptr_t start = (uintptr_t)writer->module->image;
+    if ((uintptr_t)bytecode < start || (uintptr_t)bytecode >= start + writer->module->image_size) {
+        writer->failed = true;
+        return 0;
+    }
+    return writer->header->sections[VM_IMAGE_MODULE].offset + ((uintptr_t)bytecode - start);
+}
+
+// Link every method and intern every string literal, as running the
+// program would on first use
+static void vm_image_warm_up(VM* vm, ModuleEntry* module_entry) {
+    for (uint32_t id = 1; id < method_registry_id_count(); id++) {
+        MethodRegistryEntry* entry = method_registry_find_method_by_id(id);
+        if (entry && entry->module == module_entry) {
+            method_registry_materialize(entry);
+        }
+    }
+
+    ConstantTable* constants = vm->current_module->constant_table;
+    for (uint32_t i = 0; constants && i < constants->count; i++) {
+        if (constants->entries[i].type == CONSTANT_TYPE_STRING) {
+            const char* chars = helium_module_get_string(vm->current_module, constants->entries[i].value.string_offset);
+            if (chars) {
+                vm_intern_literal(vm, i, chars);
+            }
+        }
+    }
+}
+
+bool vm_image_write(VM* vm, const char* path) {
+    if (!vm || !path || !vm->current_module || !vm->current_module_entry) return false;
+
+    HeliumModule* module = vm->current_module;
+    ModuleEntry* module_entry = vm->current_module_entry;
+    if (!module->image || vm->module_registry->module_count != 1) {
+        fprintf(stderr, "Error: A VM image holds exactly one module loaded from a file\n");
+        return false;
+    }
+
+    vm_image_warm_up(vm, module_entry);
+
+    // Count what goes into the image
+    uint32_t class_ids = class_registry_id_count();
+    uint32_t method_ids = method_registry_id_count();
+    uint32_t field_ids = field_registry_id_count();
+    uint32_t classes = 0, methods = 0, linked = 0, fields = 0, field_infos = 0, literals = 0;
+    for (uint32_t id = 1; id < class_ids; id++) {
+        classes += class_registry_find_class_by_id(id) != NULL;
+    }
+    for (uint32_t id = 1; id < method_ids; id++) {
+        MethodRegistryEntry* entry = method_registry_find_method_by_id(id);
+        methods += entry != NULL;
+        linked += entry && entry->method_info;
+    }
+    for (uint32_t id = 1; id < field_ids; id++) {
+        FieldRegistryEntry* entry = field_registry_find_field_by_id(id);
+        fields += entry != NULL;
+        field_infos += entry && entry->field_info;
+    }
+    for (uint32_t i = 0; vm->literal_module == module && i < vm->literal_count; i++) {
+        literals += vm->literal_strings[i] != NULL;
+    }
+
+    // Lay the sections out; the strings go last as they are collected while
+    // the entries are written
+    VmImageHeader layout;
+    memset(&layout, 0, sizeof(layout));
+    size_t size = sizeof(VmImageHeader);
+    vm_image_add_section(&layout, &size, VM_IMAGE_MODULE, (uint32_t)module->image_size, 1);
+    vm_image_add_section(&layout, &size, VM_IMAGE_TYPE_IDS, module_entry->max_type_id + 1, sizeof(uint32_t));
+    vm_image_add_section(&layout, &size, VM_IMAGE_METHOD_IDS, module_entry->max_method_id + 1, sizeof(uint32_t));
+    vm_image_add_section(&layout, &size, VM_IMAGE_FIELD_IDS, module_entry->max_field_id + 1, sizeof(uint32_t));
+    vm_image_add_section(&layout, &size, VM_IMAGE_CLASSES, classes, sizeof(ClassRegistryEntry));
+    vm_image_add_section(&layout, &size, VM_IMAGE_METHODS, methods, sizeof(MethodRegistryEntry));
+    vm_image_add_section(&layout, &size, VM_IMAGE_METHOD_INFO, linked, sizeof(Method));
+    vm_image_add_section(&layout, &size, VM_IMAGE_FIELDS, fields, sizeof(FieldRegistryEntry));
+    vm_image_add_section(&layout, &size, VM_IMAGE_FIELD_INFO, field_infos, sizeof(Field));
+    vm_image_add_section(&layout, &size, VM_IMAGE_LITERALS, literals, sizeof(uint32_t));
+    size = vm_image_align(size);
+
+    VmImageWriter writer;
+    memset(&writer, 0, sizeof(writer));
+    writer.data = calloc(1, size);
+    writer.size = size;
+    writer.module = module;
+    if (!writer.data) return false;
+    writer.header = (VmImageHeader*)writer.data;
+    *writer.header = layout;
+
+    VmImageHeader* header = writer.header;
+    memcpy(header->magic, VM_IMAGE_MAGIC, sizeof(VM_IMAGE_MAGIC));
+    header->version = VM_IMAGE_VERSION;
+    header->byte_order = HELIUM_BYTE_ORDER_MARK;
+    header->pointer_size = sizeof(void*);
+    strncpy(header->build, HE3_BUILD_INFO_STRING, sizeof(header->build) - 1);
+    header->class_ids = class_ids;
+    header->method_ids = method_ids;
+    header->field_ids = field_ids;
+
+    memcpy(vm_image_section(&writer, VM_IMAGE_MODULE), module->image, module->image_size);
+    memcpy(vm_image_section(&writer, VM_IMAGE_TYPE_IDS), module_entry->type_ids,
+           (module_entry->max_type_id + 1) * sizeof(uint32_t));
+    memcpy(vm_image_section(&writer, VM_IMAGE_METHOD_IDS), module_entry->method_ids,
+           (module_entry->max_method_id + 1) * sizeof(uint32_t));
+    memcpy(vm_image_section(&writer, VM_IMAGE_FIELD_IDS), module_entry->field_ids,
+           (module_entry->max_field_id + 1) * sizeof(uint32_t));
+
+    // Entries, with their pointers turned into image offsets
+    ClassRegistryEntry* class_out = vm_image_section(&writer, VM_IMAGE_CLASSES);
+    for (uint32_t id = 1; id < class_ids; id++) {
+        ClassRegistryEntry* entry = class_registry_find_class_by_id(id);
+        if (!entry) continue;
+        *class_out = *entry;
+        class_out->class_name = VM_IMAGE_OFFSET(vm_image_string(&writer, entry->class_name));
+        class_out->class_info = NULL; // Created when needed, as after loading
+        class_out->name_next = NULL;
+        class_out++;
+    }
+
+    MethodRegistryEntry* method_out = vm_image_section(&writer, VM_IMAGE_METHODS);
+    Method* info_out = vm_image_section(&writer, VM_IMAGE_METHOD_INFO);
+    for (uint32_t id = 1; id < method_ids; id++) {
+        MethodRegistryEntry* entry = method_registry_find_method_by_id(id);
+        if (!entry) continue;
+        *method_out = *entry;
+        method_out->method_name = NULL; // Resolved from the module on first use
+        method_out->signature = NULL;
+        method_out->module = NULL;
+        method_out->name_next = NULL;
+        if (entry->method_info) {
+            *info_out = *entry->method_info;
+            info_out->name = VM_IMAGE_OFFSET(vm_image_string(&writer, entry->method_info->name));
+            info_out->signature = VM_IMAGE_OFFSET(vm_image_string(&writer, entry->method_info->signature));
+            info_out->bytecode = VM_IMAGE_OFFSET(vm_image_bytecode(&writer, entry->method_info->bytecode));
+            info_out->next = NULL;
+            method_out->method_info = VM_IMAGE_OFFSET((uint8_t*)info_out - writer.data);
+            info_out++;
+        }
+        method_out++;
+    }
+
+    FieldRegistryEntry* field_out = vm_image_section(&writer, VM_IMAGE_FIELDS);
+    Field* field_info_out = vm_image_section(&writer, VM_IMAGE_FIELD_INFO);
+    for (uint32_t id = 1; id < field_ids; id++) {
+        FieldRegistryEntry* entry = field_registry_find_field_by_id(id);
+        if (!entry) continue;
+        *field_out = *entry;
+        field_out->field_name = VM_IMAGE_OFFSET(vm_image_string(&writer, entry->field_name));
+        field_out->name_next = NULL;
+        if (entry->field_info) {
+            *field_info_out = *entry->field_info;
+            field_info_out->name = field_out->field_name;
+            field_info_out->next = NULL;
+            field_out->field_info = VM_IMAGE_OFFSET((uint8_t*)field_info_out - writer.data);
+            field_info_out++;
+        }
+        field_out++;
+    }
+
+    uint32_t* literal_out = vm_image_section(&writer, VM_IMAGE_LITERALS);
+    for (uint32_t i = 0; vm->literal_module == module && i < vm->literal_count; i++) {
+        if (vm->literal_strings[i]) {
+            *literal_out++ = i;
+        }
+    }
+
+    header->module_name = (uint32_t)vm_image_string(&writer, module_entry->module_name);
+    header->sections[VM_IMAGE_STRINGS].offset = writer.size;
+    header->sections[VM_IMAGE_STRINGS].count = (uint32_t)writer.strings_size;
+    header->sections[VM_IMAGE_STRINGS].record_size = 1;
+    header->image_size = writer.size + writer.strings_size;
+
+    bool written = false;
+    FILE* file = writer.failed ? NULL : fopen(path, "wb");
+    if (file) {
+        written = fwrite(writer.data, 1, writer.size, file) == writer.size &&
+                  fwrite(writer.strings, 1, writer.strings_size, file) == writer.strings_size;
+        if (fclose(file) != 0) written = false;
+    }
+    free(writer.data);
+    free(writer.strings);
+    return written;
+}
+
+// ============================================================================
+// RESTORING
+// ============================================================================
+
+typedef struct VmImageReader {
+    uint8_t* base;
+    size_t size;
+    const VmImageHeader* header;
+    HeliumModule* module;
+    bool failed;
+} VmImageReader;
+
+// Section records, or NULL (and failure) if the section does not describe
+// `record_size` records inside the image
+static void* vm_image_records(VmImageReader* reader, VmImageSectionKind kind, size_t record_size) {
+    const VmImageSection* section = &reader->header->sections[kind];
+    if (section->record_size != record_size || section->offset % VM_IMAGE_ALIGNMENT != 0 ||
+        section->offset + (uint64_t)section->count * record_size > reader->size) {
+        reader->failed = true;
+        return NULL;
+    }
+    return reader->base + section->offset;
+}
+
+// Pointer for a saved string offset: into the module's string data or the
+// strings section, both of which hold NUL-terminated strings
+static char* vm_image_fix_string(VmImageReader* reader, const void* saved) {
+    uint64_t offset = VM_IMAGE_OFFSET_OF(saved);
+    if (offset == 0) return NULL;
+
+    const VmImageSection* strings = &reader->header->sections[VM_IMAGE_STRINGS];
+    if (offset >= strings->offset && offset < strings->offset + strings->count) {
+        return (char*)reader->base + offset;
+    }
+
+    const StringTable* table = reader->module->string_table_obj;
+    uintptr_t pointer = (uintptr_t)reader->base + offset;
+    if (offset < reader->size && table->data && pointer >= (uintptr_t)table->data &&
+        pointer < (uintptr_t)table->data + table->total_size) {
+        return (char*)pointer;
+    }
+    reader->failed = true;
+    return NULL;
+}
+
+// Pointer for a saved record offset, which must name a record of `kind`
+static void* vm_image_fix_record(VmImageReader* reader, const void* saved, VmImageSectionKind kind, size_t record_size) {
+    uint64_t offset = VM_IMAGE_OFFSET_OF(saved);
+    if (offset == 0) return NULL;
+
+    const VmImageSection* section = &reader->header->sections[kind];
+    if (offset < section->offset || offset >= section->offset + (uint64_t)section->count * record_size ||
+        (offset - section->offset) % record_size != 0) {
+        reader->failed = true;
+        return NULL;
+    }
+    return reader->base + offset;
+}
+
+// Fix up a linked method; its bytecode must be exactly its method entry's
+static void vm_image_fix_method(VmImageReader* reader, MethodRegistryEntry* entry) {
+    Method* method = vm_image_fix_record(reader, entry->method_info, VM_IMAGE_METHOD_INFO, sizeof(Method));
+    entry->method_info = method;
+    if (!method) return;
+
+    const MethodEntry* record = &reader->module->method_table->entries[entry->method_index];
+    uint8_t* bytecode = record->bytecode_size ? reader->module->bytecode + record->bytecode_offset : NULL;
+    uint64_t offset = VM_IMAGE_OFFSET_OF(method->bytecode);
+    method->name = vm_image_fix_string(reader, method->name);
+    method->signature = vm_image_fix_string(reader, method->signature);
+    method->bytecode = offset ? reader->base + offset : NULL;
+    method->next = NULL;
+    if (method->bytecode != bytecode || method->bytecode_size != (bytecode ? record->bytecode_size : 0)) {
+        reader->failed = true;
+    }
+}
+
+// Point the entries at the restored module and fix their pointers up
+static bool vm_image_fix_entries(VmImageReader* reader, ModuleEntry* module_entry, RegistryEntries* entries) {
+    const VmImageHeader* header = reader->header;
+    uint32_t method_count = reader->module->method_table->count;
+
+    for (uint32_t i = 0; i < entries->class_count && !reader->failed; i++) {
+        ClassRegistryEntry* entry = &entries->classes[i];
+        entry->class_name = vm_image_fix_string(reader, entry->class_name);
+        entry->class_info = NULL;
+        if (!entry->class_name || entry->module_id != module_entry->module_id ||
+            (entry->first_method_id && (uint64_t)entry->first_method_id + entry->method_count > header->method_ids) ||
+            (entry->first_field_id && (uint64_t)entry->first_field_id + entry->field_count > header->field_ids)) {
+            reader->failed = true;
+        }
+    }
+
+    for (uint32_t i = 0; i < entries->method_count && !reader->failed; i++) {
+        MethodRegistryEntry* entry = &entries->methods[i];
+        entry->module = module_entry;
+        entry->method_name = NULL;
+        entry->signature = NULL;
+        if (entry->module_id != module_entry->module_id || entry->method_index >= method_count ||
+            entry->global_type_id >= header->class_ids) {
+            reader->failed = true;
+            break;
+        }
+        vm_image_fix_method(reader, entry);
+    }
+
+    for (uint32_t i = 0; i < entries->field_count && !reader->failed; i++) {
+        FieldRegistryEntry* entry = &entries->fields[i];
+        entry->field_name = vm_image_fix_string(reader, entry->field_name);
+        entry->field_info = vm_image_fix_record(reader, entry->field_info, VM_IMAGE_FIELD_INFO, sizeof(Field));
+        if (entry->field_info) {
+            entry->field_info->name = entry->field_name;
+            entry->field_info->next = NULL;
+        }
+        if (!entry->field_name || entry->module_id != module_entry->module_id ||
+            entry->global_type_id >= header->class_ids) {
+            reader->failed = true;
+        }
+    }
+
+    return !reader->failed;
+}
+
+// Check an ID map section against the next global ID of its registry;
+// 0 marks a module ID without an entry
+static uint32_t* vm_image_id_map(VmImageReader* reader, VmImageSectionKind kind, uint32_t id_count, uint32_t* max_id) {
+    uint32_t* map = vm_image_records(reader, kind, sizeof(uint32_t));
+    uint32_t count = reader->header->sections[kind].count;
+    if (!map || count == 0) {
+        reader->failed = true;
+        return NULL;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (map[i] != 0 && map[i] >= id_count) {
+            reader->failed = true;
+            return NULL;
+        }
+    }
+    *max_id = count - 1;
+    return map;
+}
+
+static void* vm_image_map_file(const char* path, size_t* size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    void* image = NULL;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && (size_t)st.st_size >= sizeof(VmImageHeader)) {
+        *size = (size_t)st.st_size;
+        // Private and writable: the pages holding entries are copied as
+        // their pointers are fixed up, the module's pages stay shared
+        image = mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (image == MAP_FAILED) image = NULL;
+    }
+    close(fd);
+    return image;
+}
+
+bool vm_image_load(VM* vm, const char* path) {
+    if (!vm || !path || vm->current_module || vm->snapshot_image) return false;
+
+    VmImageReader reader;
+    memset(&reader, 0, sizeof(reader));
+    reader.base = vm_image_map_file(path, &reader.size);
+    if (!reader.base) {
+        fprintf(stderr, "Error: Cannot map VM image '%s'\n", path);
+        return false;
+    }
+    reader.header = (const VmImageHeader*)reader.base;
+    vm->snapshot_image = reader.base;
+    vm->snapshot_image_size = reader.size;
+
+    // The image must come from this build of the VM
+    const VmImageHeader* header = reader.header;
+    char build[sizeof(header->build)] = {0};
+    strncpy(build, HE3_BUILD_INFO_STRING, sizeof(build) - 1);
+    if (memcmp(header->magic, VM_IMAGE_MAGIC, sizeof(VM_IMAGE_MAGIC)) != 0 ||
+        header->version != VM_IMAGE_VERSION || header->byte_order != HELIUM_BYTE_ORDER_MARK ||
+        header->pointer_size != sizeof(void*) || header->image_size != reader.size ||
+        memcmp(header->build, build, sizeof(build)) != 0) {
+        fprintf(stderr, "Error: '%s' is not a VM image of this VM build\n", path);
+        return false;
+    }
+
+    const VmImageSection* strings = &header->sections[VM_IMAGE_STRINGS];
+    uint8_t* module_image = vm_image_records(&reader, VM_IMAGE_MODULE, 1);
+    if (reader.failed || strings->record_size != 1 || strings->count == 0 ||
+        strings->offset + strings->count != reader.size || reader.base[reader.size - 1] != '\0' ||
+        header->module_name < strings->offset || header->module_name >= reader.size) {
+        fprintf(stderr, "Error: VM image '%s' is corrupt\n", path);
+        return false;
+    }
+
+    // The module is used in place inside the image, validated as on load
+    reader.module = helium_module_load_image(module_image, header->sections[VM_IMAGE_MODULE].count);
+    if (!reader.module) {
+        fprintf(stderr, "Error: VM image '%s' holds an invalid module\n", path);
+        return false;
+    }
+
+    ModuleEntry* module_entry = module_registry_add_module(vm->module_registry,
+        (const char*)reader.base + header->module_name, reader.module);
+    if (!module_entry) {
+        helium_module_destroy(reader.module);
+        return false;
+    }
+    vm->current_module = reader.module;
+    vm->current_module_entry = module_entry;
+
+    RegistryEntries entries;
+    entries.classes = vm_image_records(&reader, VM_IMAGE_CLASSES, sizeof(ClassRegistryEntry));
+    entries.class_count = header->sections[VM_IMAGE_CLASSES].count;
+    entries.class_ids = header->class_ids;
+    entries.methods = vm_image_records(&reader, VM_IMAGE_METHODS, sizeof(MethodRegistryEntry));
+    entries.method_count = header->sections[VM_IMAGE_METHODS].count;
+    entries.method_ids = header->method_ids;
+    entries.fields = vm_image_records(&reader, VM_IMAGE_FIELDS, sizeof(FieldRegistryEntry));
+    entries.field_count = header->sections[VM_IMAGE_FIELDS].count;
+    entries.field_ids = header->field_ids;
+    vm_image_records(&reader, VM_IMAGE_METHOD_INFO, sizeof(Method));
+    vm_image_records(&reader, VM_IMAGE_FIELD_INFO, sizeof(Field));
+    uint32_t* literals = vm_image_records(&reader, VM_IMAGE_LITERALS, sizeof(uint32_t));
+
+    module_entry->type_ids = vm_image_id_map(&reader, VM_IMAGE_TYPE_IDS, header->class_ids, &module_entry->max_type_id);
+    module_entry->method_ids = vm_image_id_map(&reader, VM_IMAGE_METHOD_IDS, header->method_ids, &module_entry->max_method_id);
+    module_entry->field_ids = vm_image_id_map(&reader, VM_IMAGE_FIELD_IDS, header->field_ids, &module_entry->max_field_id);
+
+    if (reader.failed || !vm_image_fix_entries(&reader, module_entry, &entries) ||
+        !module_registry_restore_entries(&entries)) {
+        fprintf(stderr, "Error: VM image '%s' has invalid registry entries\n", path);
+        return false;
+    }
+
+    // Intern the literals the image was saved with
+    ConstantTable* constants = reader.module->constant_table;
+    for (uint32_t i = 0; i < header->sections[VM_IMAGE_LITERALS].count; i++) {
+        uint32_t index = literals[i];
+        if (index < constants->count && constants->entries[index].type == CONSTANT_TYPE_STRING) {
+            const char* chars = helium_module_get_string(reader.module, constants->entries[index].value.string_offset);
+            if (chars) {
+                vm_intern_literal(vm, index, chars);
+            }
+        }
+    }
+
+    return true;
+}
+
+// Unmap the image once nothing points into it any more
+void vm_image_release(VM* vm) {
+    if (!vm || !vm->snapshot_image) return;
+
+    munmap(vm->snapshot_image, vm->snapshot_image_size);
+    vm->snapshot_image = NULL;
+    vm->snapshot_image_size = 0;
+}
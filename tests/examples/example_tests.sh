@@ -159,6 +159,8 @@ run_example_tests() {
             case "$name" in
                 "02_arithmetic") expected_result="50" ;;
                 "04_print_test") expected_result="42" ;;
+                "06_control_flow") expected_result="45" ;;
+                "07_string_builder") expected_result="22" ;;
             esac
             
             if test_example "$dir" "$expected_result"; then